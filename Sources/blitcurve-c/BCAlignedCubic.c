@@ -59,100 +59,105 @@ bc_float_t BCAlignedCubicKappa(BCAlignedCubic c, bc_float_t t) {
     return (n2_n1.y - n2_n1.x) / d2;
 }
 
-/**
- @throws Private function uses bug type, checks \c t for \c 0<=t<=1, and a complicated divide-by-zero expression.  rvalue is \c BC_FLOAT_LARGE
+/*
+ Derivative of kappa for each lane of t, with the aligned cubic's coordinates given per lane, so lanes can be different cubics.
+ Powers are computed with a single square root rather than bc_pow.  Lanes where the derivative of the cubic vanishes are BC_FLOAT_LARGE.
+ This defines the function for a lane width, so that every width does the same math.
  */
-__BC_MAYBESTATIC bc_float_t __BCAlignedCubicKappaPrime(BCAlignedCubic c, bc_float_t t) {
-    __BC_BUGASSERT(t >= 0 && t <= 1,BC_FLOAT_LARGE);
-    const bc_float2_t c3 = c.c * 3;
-    const bc_float_t p1 = -t;
-    const bc_float_t p2 = 1 + p1;
-    const bc_float4_t cd_p2 = bc_make_float4(c.c,c.d) * p2;
-    const bc_float4_t cd_p2_t = cd_p2 * t;
-    const bc_float2_t p3_p4 = bc_make_float2(t,p2) * bc_make_float2(t,p2);
-    const bc_float2_t p5_p17 = -12 * cd_p2.xy;
-    const bc_float2_t p6_p18 = 6 * cd_p2.zw;
-    const bc_float_t p7 = 6 * c.b_x * t;
-    const bc_float2_t p8_p19 = 6 * c.c * t;
-    const bc_float2_t p9_p20 = -12 * c.d * t;
-    bc_float2_t p10_p21 = p5_p17 + p6_p18 + p8_p19 + p9_p20;
-    p10_p21.x += p7;
-    const bc_float2_t p11_p22 = c3 * p3_p4.y;
-    const bc_float2_t p12_p23 = -6 * cd_p2_t.xy;
-    const bc_float2_t p13_p24 = 6 * cd_p2_t.zw;
-    const bc_float_t p14 = 3 * c.b_x * p3_p4.x;
-    const bc_float2_t p15_p25 = -3 * c.d * p3_p4.x;
-    bc_float2_t p16_p26 = p11_p22 + p12_p23 + p13_p24 + p15_p25;
-    p16_p26.x += p14;
-    const bc_float2_t p27_p28 = p16_p26 * p16_p26;
-    const bc_float_t p29 = bc_reduce_add(p27_p28);
-    
-    /*
-     x  y   z  w
-     10 21 10 21
-   x 16 26 26 16
-     -----------
-     
-     */
-    const bc_float4_t p10_p21_by_p16_p26 = bc_make_float4(p10_p21, p10_p21) *  bc_make_float4(p16_p26, bc_make_float2(p16_p26.y, p16_p26.x));
-    
-    const bc_float_t n1_1 = -3 * (p10_p21_by_p16_p26.w - p10_p21_by_p16_p26.z);
-    const bc_float_t n1_2 = 2 * p10_p21_by_p16_p26.x + 2 * p10_p21_by_p16_p26.y;
-    const bc_float_t n2_1 = (c.c.y - c.d.y) * p16_p26.x * 18;
-    const bc_float_t n2_2 = (c.b_x + c3.x - 3 * c.d.x) * 6 * p16_p26.y;
-    bc_float2_t d = bc_pow(bc_make_float2(p29,p29), bc_make_float2(5.0/2.0,3.0/2.0));
-    d.x *= 2;
-    const bc_float2_t n = bc_make_float2(n1_1 * n1_2,n2_1-n2_2);
-    __BC_BUGASSERT(d.x!=0&&d.y!=0,BC_FLOAT_LARGE);
-    return bc_reduce_add(n/d);
+#define __BC_ALIGNED_CUBIC_KAPPA_PRIME(NAME, VECTOR, LANES) \
+static inline VECTOR NAME(VECTOR c_x, VECTOR c_y, VECTOR d_x, VECTOR d_y, VECTOR b_x, VECTOR t) { \
+    const VECTOR p2 = 1 - t; \
+    const VECTOR p2_t = p2 * t; \
+    const VECTOR t_squared = t * t; \
+    const VECTOR p2_squared = p2 * p2; \
+    /*first derivative*/ \
+    const VECTOR dx = 3 * c_x * p2_squared + 6 * (d_x - c_x) * p2_t + 3 * (b_x - d_x) * t_squared; \
+    const VECTOR dy = 3 * c_y * p2_squared + 6 * (d_y - c_y) * p2_t - 3 * d_y * t_squared; \
+    /*second derivative*/ \
+    const VECTOR ddx = (-12 * c_x + 6 * d_x) * p2 + (6 * c_x - 12 * d_x + 6 * b_x) * t; \
+    const VECTOR ddy = (-12 * c_y + 6 * d_y) * p2 + (6 * c_y - 12 * d_y) * t; \
+    const VECTOR p29 = dx * dx + dy * dy; \
+    const VECTOR n1 = -3 * (ddy * dx - ddx * dy) * 2 * (ddx * dx + ddy * dy); \
+    const VECTOR n2 = (c_y - d_y) * 18 * dx - (b_x + 3 * c_x - 3 * d_x) * 6 * dy; \
+    const VECTOR root = bc_vsqrt(p29); \
+    const VECTOR d3 = p29 * root; \
+    VECTOR r = n1 / (2 * p29 * d3) + n2 / d3; \
+    for (int i = 0; i < LANES; i++) { \
+        if (p29[i] == 0) { r[i] = BC_FLOAT_LARGE; } \
+    } \
+    return r; \
 }
 
+__BC_ALIGNED_CUBIC_KAPPA_PRIME(__BCAlignedCubicKappaPrimeLanes4, bc_float4_t, 4)
+
 /**
- @throws Internal func uses \c bugassert, rvalue is \c BC_FLOAT_LARGE_NEGATIVE.  Note that \c BC_FLOAT_LARGE is a sentinel return value for \em valid input.
-    Generally, the problem here is to do with upper/lower, or in some cases a bug in another function.
+ Derivative of kappa for 4 bezier parameters of one cubic.
+ @throws Lanes where the derivative vanishes are \c BC_FLOAT_LARGE.
  */
-static bc_float_t KappaSearch(BCAlignedCubic c, bc_float_t lower, bc_float_t upper, bc_float_t accuracy) {
-    __BC_BUGASSERT(upper >= lower,BC_FLOAT_LARGE_NEGATIVE);
-    while (upper - lower > accuracy) {
-        const bc_float_t lowerPrime = __BCAlignedCubicKappaPrime(c, lower);
-        __BC_TRY_IF(lowerPrime==BC_FLOAT_LARGE, BC_FLOAT_LARGE_NEGATIVE);
-        const bc_float_t upperPrime = __BCAlignedCubicKappaPrime(c, upper);
-        __BC_TRY_IF(upperPrime==BC_FLOAT_LARGE, BC_FLOAT_LARGE_NEGATIVE);
-
-        if (bc_signbit(lowerPrime) == bc_signbit(upperPrime)) {
-            return BC_FLOAT_LARGE;
-        }
-        const bc_float_t midpoint = (upper - lower) / 2 + lower;
-        const bc_float_t midPrime = __BCAlignedCubicKappaPrime(c, midpoint);
-        __BC_TRY_IF(midPrime==BC_FLOAT_LARGE, BC_FLOAT_LARGE_NEGATIVE);
-        
-        if (bc_signbit(midPrime) == bc_signbit(upperPrime)) {
-            upper = midpoint;
-        }
-        else {
-            lower = midpoint;
-        }
-    }
-    return lower;
+__BC_MAYBESTATIC bc_float4_t __BCAlignedCubicKappaPrime4(BCAlignedCubic c, bc_float4_t t) {
+    return __BCAlignedCubicKappaPrimeLanes4(c.c.x, c.c.y, c.d.x, c.d.y, c.b_x, t);
 }
 
-bc_float_t BCAlignedCubicMaxKappaParameter(BCAlignedCubic c,bc_float_t accuracy) {
+bc_float_t BCAlignedCubicMaxKappaParameterWithBrackets(BCAlignedCubic c, bc_float_t accuracy, uint8_t brackets) {
+    __BC_ASSERT(brackets > 0, (-1-BCErrorArg2));
     float maxKappa = 0;
     float param = BC_FLOAT_LARGE;
-    for(unsigned char i_t = 0; i_t < 5; i_t++) {
-        bc_float_t l = i_t * 0.2;
-        bc_float_t r = (i_t + 1) * 0.2;
-        const bc_float_t itry = KappaSearch(c, l, r, accuracy);
-        __BC_TRY_IF(itry==BC_FLOAT_LARGE_NEGATIVE, (-1-BCErrorLogic));
-        
-        if (itry != BC_FLOAT_LARGE) {
-            const bc_float_t proposedKappaPreabs = BCAlignedCubicKappa(c, itry);
+    //brackets are searched 4 at a time, one per lane
+    for (int group = 0; group < brackets; group += 4) {
+        bc_float4_t lower;
+        bc_float4_t upper;
+        for (int i = 0; i < 4; i++) {
+            //lanes past the last bracket repeat the end of the range
+            const int index = group + i < brackets ? group + i : brackets - 1;
+            lower[i] = (bc_float_t) index / brackets;
+            upper[i] = (bc_float_t) (index + 1) / brackets;
+        }
+        //adjacent brackets share an endpoint, so evaluate each endpoint once
+        bc_float4_t lowerPrime = __BCAlignedCubicKappaPrime4(c, lower);
+        const bc_float4_t lastUpper = upper.w;
+        const bc_float_t lastUpperPrime = __BCAlignedCubicKappaPrime4(c, lastUpper).x;
+        bc_float4_t upperPrime;
+        for (int i = 0; i < 4; i++) {
+            //the last bracket in the group, or in the range, ends at lastUpper
+            upperPrime[i] = (i < 3 && group + i + 1 < brackets) ? lowerPrime[i + 1] : lastUpperPrime;
+        }
+        bool searching[4];
+        bool found[4];
+        for (int i = 0; i < 4; i++) {
+            __BC_TRY_IF(lowerPrime[i] == BC_FLOAT_LARGE || upperPrime[i] == BC_FLOAT_LARGE, (-1-BCErrorLogic));
+            const bool inRange = group + i < brackets;
+            searching[i] = inRange && upper[i] - lower[i] > accuracy;
+            //a bracket with no sign change has no extremum
+            found[i] = inRange && (!searching[i] || bc_signbit(lowerPrime[i]) != bc_signbit(upperPrime[i]));
+            searching[i] = searching[i] && found[i];
+        }
+        while (searching[0] || searching[1] || searching[2] || searching[3]) {
+            const bc_float4_t midpoint = (upper - lower) / 2 + lower;
+            //only the midpoint is new; the endpoints' derivatives are kept from earlier iterations
+            const bc_float4_t midPrime = __BCAlignedCubicKappaPrime4(c, midpoint);
+            for (int i = 0; i < 4; i++) {
+                if (!searching[i]) { continue; }
+                __BC_TRY_IF(midPrime[i] == BC_FLOAT_LARGE, (-1-BCErrorLogic));
+                if (bc_signbit(midPrime[i]) == bc_signbit(upperPrime[i])) {
+                    upper[i] = midpoint[i];
+                    upperPrime[i] = midPrime[i];
+                }
+                else {
+                    lower[i] = midpoint[i];
+                    lowerPrime[i] = midPrime[i];
+                }
+                searching[i] = upper[i] - lower[i] > accuracy;
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            if (!found[i]) { continue; }
+            const bc_float_t proposedKappaPreabs = BCAlignedCubicKappa(c, lower[i]);
             __BC_TRY_IF(proposedKappaPreabs==BC_FLOAT_LARGE, (-1-BCErrorUnknown));
-            
+
             const bc_float_t proposedKappa = bc_abs(proposedKappaPreabs);
             if (proposedKappa > maxKappa) {
                 maxKappa = proposedKappa;
-                param = itry;
+                param = lower[i];
             }
         }
     }
@@ -162,6 +167,95 @@ bc_float_t BCAlignedCubicMaxKappaParameter(BCAlignedCubic c,bc_float_t accuracy)
     return param;
 }
 
+bc_float_t BCAlignedCubicMaxKappaParameter(BCAlignedCubic c,bc_float_t accuracy) {
+    //rvalue is compatible; passthrough
+    return BCAlignedCubicMaxKappaParameterWithBrackets(c, accuracy, 5);
+}
+
+#ifndef __METAL_VERSION__
+#include "BCLanes8.h"
+
+__BC_ALIGNED_CUBIC_KAPPA_PRIME(__BCAlignedCubicKappaPrimeLanes8, bc_float8_t, 8)
+
+void BCAlignedCubicMaxKappaParameterBatch(const BCAlignedCubic *cubics, size_t count, bc_float_t accuracy, uint8_t brackets, bc_float_t *output) {
+    //8 cubics at a time, one per lane, searching the same bracket in every lane
+    for (size_t first = 0; first < count; first += 8) {
+        const size_t lanes = count - first < 8 ? count - first : 8;
+        bc_float8_t c_x, c_y, d_x, d_y, b_x;
+        /*
+         Lanes that hit an error are searched again with BCAlignedCubicMaxKappaParameterWithBrackets, so their rvalue is the same.
+         That includes cubics BCAlignedCubicKappa rejects, and every cubic if there are no brackets.
+         */
+        __BCMask8 retry = 0;
+        for (size_t i = 0; i < 8; i++) {
+            //lanes past the end repeat the last cubic
+            const BCAlignedCubic c = cubics[first + (i < lanes ? i : lanes - 1)];
+            c_x[i] = c.c.x;
+            c_y[i] = c.c.y;
+            d_x[i] = c.d.x;
+            d_y[i] = c.d.y;
+            b_x[i] = c.b_x;
+            const bool kappaDefined = bc_abs(c.b_x) > 0 && (bc_abs(c.c.x) > 0 || bc_abs(c.c.y) > 0) && (bc_abs(c.d.x - c.b_x) > 0 || bc_abs(c.d.y) > 0);
+            retry[i] = brackets == 0 || !kappaDefined ? -1 : 0;
+        }
+        bc_float_t maxKappa[8] = {0};
+        bc_float_t param[8];
+        for (int i = 0; i < 8; i++) { param[i] = BC_FLOAT_LARGE; }
+        //adjacent brackets share an endpoint, so evaluate each endpoint once
+        bc_float8_t nextLowerPrime = __BCAlignedCubicKappaPrimeLanes8(c_x, c_y, d_x, d_y, b_x, 0);
+        for (int bracket = 0; bracket < brackets; bracket++) {
+            bc_float8_t lower = (bc_float_t) bracket / brackets;
+            bc_float8_t upper = (bc_float_t) (bracket + 1) / brackets;
+            bc_float8_t lowerPrime = nextLowerPrime;
+            bc_float8_t upperPrime = __BCAlignedCubicKappaPrimeLanes8(c_x, c_y, d_x, d_y, b_x, upper);
+            nextLowerPrime = upperPrime;
+            retry |= (lowerPrime == BC_FLOAT_LARGE) | (upperPrime == BC_FLOAT_LARGE);
+            //a bracket with no sign change has no extremum, unless it is already within accuracy
+            const bool narrow = !(upper[0] - lower[0] > accuracy);
+            const __BCMask8 found = narrow ? (__BCMask8) -1 : (((__BCMask8) lowerPrime ^ (__BCMask8) upperPrime) < 0);
+            __BCMask8 searching = narrow ? (__BCMask8) 0 : found;
+            while (__BCMask8Any(searching)) {
+                const bc_float8_t midpoint = (upper - lower) / 2 + lower;
+                //only the midpoint is new; the endpoints' derivatives are kept from earlier iterations
+                const bc_float8_t midPrime = __BCAlignedCubicKappaPrimeLanes8(c_x, c_y, d_x, d_y, b_x, midpoint);
+                retry |= searching & (midPrime == BC_FLOAT_LARGE);
+                //the extremum is between the midpoint and whichever endpoint has the other sign
+                const __BCMask8 towardLower = ((__BCMask8) midPrime ^ (__BCMask8) upperPrime) >= 0;
+                const __BCMask8 moveUpper = searching & towardLower;
+                const __BCMask8 moveLower = searching & ~towardLower;
+                upper = __BCMask8Select(moveUpper, midpoint, upper);
+                upperPrime = __BCMask8Select(moveUpper, midPrime, upperPrime);
+                lower = __BCMask8Select(moveLower, midpoint, lower);
+                lowerPrime = __BCMask8Select(moveLower, midPrime, lowerPrime);
+                searching &= (upper - lower) > accuracy;
+            }
+            //kappa itself is only evaluated at the extrema found, with the same function BCAlignedCubicMaxKappaParameterWithBrackets compares
+            for (size_t i = 0; i < lanes; i++) {
+                if (!found[i] || retry[i]) { continue; }
+                const bc_float_t proposedKappaPreabs = BCAlignedCubicKappa(cubics[first + i], lower[i]);
+                if (proposedKappaPreabs == BC_FLOAT_LARGE) {
+                    retry[i] = -1;
+                    continue;
+                }
+                const bc_float_t proposedKappa = bc_abs(proposedKappaPreabs);
+                if (proposedKappa > maxKappa[i]) {
+                    maxKappa[i] = proposedKappa;
+                    param[i] = lower[i];
+                }
+            }
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            if (retry[i]) {
+                output[first + i] = BCAlignedCubicMaxKappaParameterWithBrackets(cubics[first + i], accuracy, brackets);
+            }
+            else {
+                output[first + i] = param[i] == BC_FLOAT_LARGE ? 0 : param[i];
+            }
+        }
+    }
+}
+#endif
+
 char BCAlignedCubicIsNormalizedForCurvature(BCAlignedCubic cubic, bc_float_t straightAngle, bc_float_t curvatureError) {
     const float expectedDistance = BCNormalizationDistanceForCubicCurvatureError(bc_abs(cubic.b_x), straightAngle, curvatureError);
     //somewhat conveniently, expectedDistance uses the same rvalue scheme as we do
@@ -0,0 +1,199 @@
+//BCAlignedCubicCache.c: Shape-keyed cache of BCAlignedCubic results
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCAlignedCubicCache.h"
+#include "BCMetalC.h"
+#include "BCTrap.h"
+
+#define __BC_CACHE_NONE UINT32_MAX
+//largest magnitude of a quantized coordinate.  Past 2^24, float can't resolve one quantum, so cells would merge.
+#define __BC_CACHE_KEY_LIMIT 16777216.0f
+
+struct __BCAlignedCubicCacheEntry {
+    //quantized c.x, c.y, d.x, d.y, b_x
+    int32_t key[5];
+    uint32_t hash;
+    uint32_t nextInBucket;
+    uint32_t lruPrev;
+    uint32_t lruNext;
+    BCAlignedCubicCacheValue value;
+};
+
+static inline uint32_t __BCAlignedCubicCacheBucketCount(size_t capacity) {
+    //load factor at most 1/2
+    uint32_t buckets = 1;
+    while (buckets < capacity * 2) { buckets <<= 1; }
+    return buckets;
+}
+
+size_t BCAlignedCubicCacheStorageSize(size_t capacity) {
+    __BC_ASSERT(capacity > 0 && capacity < UINT32_MAX / 2, 0);
+    return capacity * sizeof(struct __BCAlignedCubicCacheEntry) + __BCAlignedCubicCacheBucketCount(capacity) * sizeof(uint32_t);
+}
+
+__attribute__((unused))
+static inline BCAlignedCubicCache __BCAlignedCubicCacheErrorMake(void) {
+    BCAlignedCubicCache c = {0};
+    return c;
+}
+
+BCAlignedCubicCache BCAlignedCubicCacheMake(void *storage, size_t capacity, bc_float_t quantum, bc_float_t kappaAccuracy, bc_float_t straightAngle, bc_float_t curvatureError) {
+    __BC_ASSERT(storage != NULL, __BCAlignedCubicCacheErrorMake());
+    __BC_ASSERT(capacity > 0 && capacity < UINT32_MAX / 2, __BCAlignedCubicCacheErrorMake());
+    __BC_ASSERT(quantum > 0, __BCAlignedCubicCacheErrorMake());
+    BCAlignedCubicCache cache;
+    cache.entries = storage;
+    cache.buckets = (uint32_t *)(cache.entries + capacity);
+    cache.capacity = (uint32_t) capacity;
+    cache.bucketMask = __BCAlignedCubicCacheBucketCount(capacity) - 1;
+    cache.count = 0;
+    cache.lruHead = __BC_CACHE_NONE;
+    cache.lruTail = __BC_CACHE_NONE;
+    cache.quantum = quantum;
+    cache.kappaAccuracy = kappaAccuracy;
+    cache.straightAngle = straightAngle;
+    cache.curvatureError = curvatureError;
+    cache.hits = 0;
+    cache.misses = 0;
+    for (uint32_t i = 0; i <= cache.bucketMask; i++) { cache.buckets[i] = __BC_CACHE_NONE; }
+    return cache;
+}
+
+///Whether \c value can be quantized without losing resolution.  This is false for NaN.
+static inline bool __BCAlignedCubicCacheQuantizable(bc_float_t value, bc_float_t quantum) {
+    return bc_abs(value / quantum) <= __BC_CACHE_KEY_LIMIT;
+}
+
+static inline int32_t __BCAlignedCubicCacheQuantize(bc_float_t value, bc_float_t quantum) {
+    return (int32_t) bc_floor(value / quantum + 0.5f);
+}
+
+static inline uint32_t __BCAlignedCubicCacheHash(const int32_t key[5]) {
+    //FNV-1a over the key words, then a murmur finalizer to spread the low bits we mask with
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 5; i++) {
+        h ^= (uint32_t) key[i];
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static void __BCAlignedCubicCacheUnlink(BCAlignedCubicCache *cache, uint32_t index) {
+    struct __BCAlignedCubicCacheEntry *e = cache->entries + index;
+    if (e->lruPrev == __BC_CACHE_NONE) { cache->lruHead = e->lruNext; }
+    else { cache->entries[e->lruPrev].lruNext = e->lruNext; }
+    if (e->lruNext == __BC_CACHE_NONE) { cache->lruTail = e->lruPrev; }
+    else { cache->entries[e->lruNext].lruPrev = e->lruPrev; }
+}
+
+static void __BCAlignedCubicCachePushTail(BCAlignedCubicCache *cache, uint32_t index) {
+    struct __BCAlignedCubicCacheEntry *e = cache->entries + index;
+    e->lruPrev = cache->lruTail;
+    e->lruNext = __BC_CACHE_NONE;
+    if (cache->lruTail == __BC_CACHE_NONE) { cache->lruHead = index; }
+    else { cache->entries[cache->lruTail].lruNext = index; }
+    cache->lruTail = index;
+}
+
+static void __BCAlignedCubicCacheRemoveFromBucket(BCAlignedCubicCache *cache, uint32_t index) {
+    uint32_t *link = cache->buckets + (cache->entries[index].hash & cache->bucketMask);
+    while (*link != index) { link = &cache->entries[*link].nextInBucket; }
+    *link = cache->entries[index].nextInBucket;
+}
+
+static BCAlignedCubicCacheValue __BCAlignedCubicCacheCompute(const BCAlignedCubicCache *cache, BCAlignedCubic c) {
+    BCAlignedCubicCacheValue v;
+    //kappa is undefined when an arm has 0 length, and its functions trap on that
+    const bool kappaDefined = c.b_x != 0 && (c.c.x != 0 || c.c.y != 0) && (c.d.x != c.b_x || c.d.y != 0);
+    if (kappaDefined) {
+        v.maxKappaParameter = BCAlignedCubicMaxKappaParameter(c, cache->kappaAccuracy);
+        v.maxKappa = (v.maxKappaParameter >= 0 && v.maxKappaParameter <= 1) ? BCAlignedCubicKappa(c, v.maxKappaParameter) : BC_FLOAT_LARGE;
+    }
+    else {
+        v.maxKappaParameter = BC_FLOAT_LARGE;
+        v.maxKappa = BC_FLOAT_LARGE;
+    }
+    const BCCubic cubic = {bc_make_float2(0, 0), bc_make_float2(c.b_x, 0), c.c, c.d};
+    v.length = BCCubicLengthWithStrategy(cubic, cache->quantum, BCStrategyAccurate);
+    v.isNormalizedForCurvature = c.b_x != 0 ? BCAlignedCubicIsNormalizedForCurvature(c, cache->straightAngle, cache->curvatureError) : false;
+    return v;
+}
+
+__attribute__((unused))
+static inline BCAlignedCubicCacheValue __BCAlignedCubicCacheValueErrorMake(BCError error) {
+    BCAlignedCubicCacheValue v;
+    v.maxKappaParameter = (-1-error);
+    v.maxKappa = (-1-error);
+    v.length = (-1-error);
+    v.isNormalizedForCurvature = (-1-error);
+    return v;
+}
+
+BCAlignedCubicCacheValue BCAlignedCubicCacheLookup(BCAlignedCubicCache *cache, BCAlignedCubic cubic) {
+    __BC_ASSERT(cache != NULL && cache->capacity > 0, __BCAlignedCubicCacheValueErrorMake(BCErrorArg0));
+    const bc_float_t q = cache->quantum;
+    //too large for the key, so compute on the cubic itself and don't store it
+    if (!(__BCAlignedCubicCacheQuantizable(cubic.c.x, q) && __BCAlignedCubicCacheQuantizable(cubic.c.y, q) && __BCAlignedCubicCacheQuantizable(cubic.d.x, q) && __BCAlignedCubicCacheQuantizable(cubic.d.y, q) && __BCAlignedCubicCacheQuantizable(cubic.b_x, q))) {
+        cache->misses++;
+        return __BCAlignedCubicCacheCompute(cache, cubic);
+    }
+    const int32_t key[5] = {
+        __BCAlignedCubicCacheQuantize(cubic.c.x, q),
+        __BCAlignedCubicCacheQuantize(cubic.c.y, q),
+        __BCAlignedCubicCacheQuantize(cubic.d.x, q),
+        __BCAlignedCubicCacheQuantize(cubic.d.y, q),
+        __BCAlignedCubicCacheQuantize(cubic.b_x, q),
+    };
+    const uint32_t hash = __BCAlignedCubicCacheHash(key);
+    for (uint32_t i = cache->buckets[hash & cache->bucketMask]; i != __BC_CACHE_NONE; i = cache->entries[i].nextInBucket) {
+        const struct __BCAlignedCubicCacheEntry *e = cache->entries + i;
+        if (e->hash == hash && e->key[0] == key[0] && e->key[1] == key[1] && e->key[2] == key[2] && e->key[3] == key[3] && e->key[4] == key[4]) {
+            if (cache->lruTail != i) {
+                __BCAlignedCubicCacheUnlink(cache, i);
+                __BCAlignedCubicCachePushTail(cache, i);
+            }
+            cache->hits++;
+            return e->value;
+        }
+    }
+    cache->misses++;
+    uint32_t index;
+    if (cache->count < cache->capacity) {
+        index = cache->count++;
+    }
+    else {
+        index = cache->lruHead;
+        __BCAlignedCubicCacheUnlink(cache, index);
+        __BCAlignedCubicCacheRemoveFromBucket(cache, index);
+    }
+    struct __BCAlignedCubicCacheEntry *e = cache->entries + index;
+    for (int k = 0; k < 5; k++) { e->key[k] = key[k]; }
+    e->hash = hash;
+    uint32_t *bucket = cache->buckets + (hash & cache->bucketMask);
+    e->nextInBucket = *bucket;
+    *bucket = index;
+    __BCAlignedCubicCachePushTail(cache, index);
+    //results are for the cell's representative, so they don't depend on which cubic in the cell arrived first
+    BCAlignedCubic representative;
+    representative.c = bc_make_float2(key[0] * q, key[1] * q);
+    representative.d = bc_make_float2(key[2] * q, key[3] * q);
+    representative.b_x = key[4] * q;
+    e->value = __BCAlignedCubicCacheCompute(cache, representative);
+    return e->value;
+}
+
+void BCAlignedCubicCacheLookupBatch(BCAlignedCubicCache *cache, const BCCubic *cubics, size_t count, BCAlignedCubic *aligned, BCAlignedCubicCacheValue *output) {
+    __BC_ASSERT_CUSTOM(cache != NULL && cache->capacity > 0, return);
+    __BC_ASSERT_CUSTOM(cubics != NULL || count == 0, return);
+    __BC_ASSERT_CUSTOM(output != NULL || count == 0, return);
+    for (size_t i = 0; i < count; i++) {
+        const BCAlignedCubic a = BCAlignedCubicMake(cubics[i]);
+        if (aligned) { aligned[i] = a; }
+        output[i] = BCAlignedCubicCacheLookup(cache, a);
+    }
+}
@@ -0,0 +1,160 @@
+//BCAlignedRectSweep.c: Sweep-and-prune broad phase over BCAlignedRect
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCAlignedRectSweep.h"
+#include "BCParallel.h"
+#include "BCMetalC.h"
+#include "BCLanes8.h"
+#include "BCTrap.h"
+#include <string.h>
+
+//sweep arrays are padded so 8-wide loads past the last rect stay in bounds
+#define __BC_SWEEP_PAD 8
+//pairs found by a worker are published this many at a time
+#define __BC_SWEEP_LOCAL_PAIRS 64
+
+struct __BCAlignedRectSweepEntry {
+    bc_float_t minX;
+    uint32_t id;
+};
+typedef struct __BCAlignedRectSweepEntry __BCSweepEntry;
+
+
+size_t BCAlignedRectSweepStorageSize(size_t count) {
+    __BC_ASSERT(count > 0 && count < UINT32_MAX, 0);
+    return count * sizeof(__BCSweepEntry) + 4 * (count + __BC_SWEEP_PAD) * sizeof(bc_float_t);
+}
+
+__attribute__((unused))
+static inline BCAlignedRectSweep __BCAlignedRectSweepErrorMake(void) {
+    BCAlignedRectSweep s = {0};
+    return s;
+}
+
+static int __BCSweepEntryCompare(const void *l, const void *r) {
+    const __BCSweepEntry *a = l;
+    const __BCSweepEntry *b = r;
+    if (a->minX != b->minX) { return a->minX < b->minX ? -1 : 1; }
+    return a->id < b->id ? -1 : a->id > b->id;
+}
+
+//gathers the bounds into sorted order for the sweep
+static void __BCAlignedRectSweepGather(BCAlignedRectSweep *s, const BCAlignedRect *rects) {
+    for (uint32_t p = 0; p < s->count; p++) {
+        const BCAlignedRect r = rects[s->entries[p].id];
+        s->minX[p] = r.min.x;
+        s->maxX[p] = r.max.x;
+        s->minY[p] = r.min.y;
+        s->maxY[p] = r.max.y;
+    }
+}
+
+BCAlignedRectSweep BCAlignedRectSweepMake(void *storage, const BCAlignedRect *rects, size_t count) {
+    __BC_ASSERT(storage != NULL && rects != NULL, __BCAlignedRectSweepErrorMake());
+    __BC_ASSERT(count > 0 && count < UINT32_MAX, __BCAlignedRectSweepErrorMake());
+    BCAlignedRectSweep s;
+    s.entries = storage;
+    s.minX = (bc_float_t *) (s.entries + count);
+    s.maxX = s.minX + count + __BC_SWEEP_PAD;
+    s.minY = s.maxX + count + __BC_SWEEP_PAD;
+    s.maxY = s.minY + count + __BC_SWEEP_PAD;
+    s.count = (uint32_t) count;
+    for (uint32_t i = 0; i < count; i++) {
+        s.entries[i].minX = rects[i].min.x;
+        s.entries[i].id = i;
+    }
+    qsort(s.entries, count, sizeof(__BCSweepEntry), __BCSweepEntryCompare);
+    //padding starts after every rect and overlaps nothing
+    for (size_t p = count; p < count + __BC_SWEEP_PAD; p++) {
+        s.minX[p] = BC_FLOAT_LARGE;
+        s.maxX[p] = -BC_FLOAT_LARGE;
+        s.minY[p] = BC_FLOAT_LARGE;
+        s.maxY[p] = -BC_FLOAT_LARGE;
+    }
+    __BCAlignedRectSweepGather(&s, rects);
+    return s;
+}
+
+size_t BCAlignedRectSweepUpdate(BCAlignedRectSweep *sweep, const BCAlignedRect *rects) {
+    __BC_ASSERT(sweep != NULL && sweep->count > 0, 0);
+    __BC_ASSERT(rects != NULL, 0);
+    __BCSweepEntry *entries = sweep->entries;
+    for (uint32_t p = 0; p < sweep->count; p++) {
+        entries[p].minX = rects[entries[p].id].min.x;
+    }
+    //insertion sort is about linear when the order is nearly right
+    size_t moved = 0;
+    for (uint32_t p = 1; p < sweep->count; p++) {
+        const __BCSweepEntry e = entries[p];
+        uint32_t q = p;
+        while (q > 0 && __BCSweepEntryCompare(&entries[q - 1], &e) > 0) {
+            entries[q] = entries[q - 1];
+            q--;
+        }
+        entries[q] = e;
+        moved += p - q;
+    }
+    __BCAlignedRectSweepGather(sweep, rects);
+    return moved;
+}
+
+typedef struct {
+    const BCAlignedRectSweep *sweep;
+    BCRectPair *pairs;
+    size_t capacity;
+    size_t found;
+} __BCAlignedRectSweepPairs;
+
+static void __BCAlignedRectSweepPublish(__BCAlignedRectSweepPairs *p, const BCRectPair *local, size_t count) {
+    const size_t at = __atomic_fetch_add(&p->found, count, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < count && at + i < p->capacity; i++) {
+        p->pairs[at + i] = local[i];
+    }
+}
+
+static void __BCAlignedRectSweepWork(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    __BCAlignedRectSweepPairs *p = context;
+    const BCAlignedRectSweep *s = p->sweep;
+    BCRectPair local[__BC_SWEEP_LOCAL_PAIRS];
+    size_t localCount = 0;
+    for (size_t i = begin; i < end; i++) {
+        const bc_float_t right = s->maxX[i];
+        const bc_float_t bottom = s->minY[i];
+        const bc_float_t top = s->maxY[i];
+        const uint32_t id = s->entries[i].id;
+        for (size_t j = i + 1; j < s->count; j += 8) {
+            const uint32_t inX = __BCMask8Bits(__bc_load8(s->minX + j) <= right);
+            if (!inX) { break; }
+            const uint32_t inY = __BCMask8Bits((__bc_load8(s->minY + j) <= top) & (__bc_load8(s->maxY + j) >= bottom));
+            uint32_t hits = inX & inY;
+            while (hits) {
+                const int lane = __builtin_ctz(hits);
+                hits &= hits - 1;
+                if (j + lane >= s->count) { break; }
+                const uint32_t other = s->entries[j + lane].id;
+                local[localCount].a = id < other ? id : other;
+                local[localCount].b = id < other ? other : id;
+                if (++localCount == __BC_SWEEP_LOCAL_PAIRS) {
+                    __BCAlignedRectSweepPublish(p, local, localCount);
+                    localCount = 0;
+                }
+            }
+            //sorted by min.x, so once a lane is past, every later rect is too
+            if (inX != 0xff) { break; }
+        }
+    }
+    if (localCount) { __BCAlignedRectSweepPublish(p, local, localCount); }
+}
+
+size_t BCAlignedRectSweepOverlappingPairs(const BCAlignedRectSweep *sweep, unsigned threads, BCRectPair *pairs, size_t capacity) {
+    __BC_ASSERT(sweep != NULL && sweep->count > 0, 0);
+    __BC_ASSERT(pairs != NULL || capacity == 0, 0);
+    __BCAlignedRectSweepPairs p;
+    p.sweep = sweep;
+    p.pairs = pairs;
+    p.capacity = capacity;
+    p.found = 0;
+    __BCParallelFor(sweep->count, 2048, threads, __BCAlignedRectSweepWork, &p);
+    return p.found;
+}
@@ -0,0 +1,454 @@
+//BCAlignedRectTree.c: Dynamic bounding volume tree over BCAlignedRect
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCAlignedRectTree.h"
+#include "BCParallel.h"
+#include "BCMetalC.h"
+#include "BCTrap.h"
+
+//a query holds at most height+1 nodes, and balancing keeps the height well under this for any capacity we allow
+#define __BC_TREE_STACK 128
+//pairs found by a worker are published this many at a time
+#define __BC_TREE_LOCAL_PAIRS 64
+
+struct __BCAlignedRectTreeNode {
+    BCAlignedRect bounds;
+    //next free node, for a free node
+    uint32_t parent;
+    //BCAlignedRectTreeNull for a leaf
+    uint32_t left;
+    uint32_t right;
+    //0 for a leaf, -1 for a free node
+    int32_t height;
+    uint32_t data;
+};
+typedef struct __BCAlignedRectTreeNode __BCNode;
+
+static inline BCAlignedRect __BCAlignedRectUnion(BCAlignedRect a, BCAlignedRect b) {
+    BCAlignedRect r;
+    r.min = bc_make_float2(bc_min(a.min.x, b.min.x), bc_min(a.min.y, b.min.y));
+    r.max = bc_make_float2(bc_max(a.max.x, b.max.x), bc_max(a.max.y, b.max.y));
+    return r;
+}
+
+//half the perimeter, the 2D analog of surface area for the insertion cost
+static inline bc_float_t __BCAlignedRectCost(BCAlignedRect a) {
+    const bc_float2_t size = a.max - a.min;
+    return size.x + size.y;
+}
+
+static inline bool __BCAlignedRectOverlaps(BCAlignedRect a, BCAlignedRect b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+static inline bool __BCAlignedRectContains(BCAlignedRect outer, BCAlignedRect inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+static inline bool __BCNodeIsLeaf(const __BCNode *n) { return n->left == BCAlignedRectTreeNull; }
+
+size_t BCAlignedRectTreeStorageSize(size_t leafCapacity) {
+    __BC_ASSERT(leafCapacity > 0 && leafCapacity < UINT32_MAX / 2, 0);
+    //n leaves need n-1 internal nodes
+    return 2 * leafCapacity * sizeof(__BCNode);
+}
+
+__attribute__((unused))
+static inline BCAlignedRectTree __BCAlignedRectTreeErrorMake(void) {
+    BCAlignedRectTree t = {0};
+    t.root = BCAlignedRectTreeNull;
+    t.freeList = BCAlignedRectTreeNull;
+    return t;
+}
+
+BCAlignedRectTree BCAlignedRectTreeMake(void *storage, size_t leafCapacity, bc_float_t margin) {
+    __BC_ASSERT(storage != NULL, __BCAlignedRectTreeErrorMake());
+    __BC_ASSERT(leafCapacity > 0 && leafCapacity < UINT32_MAX / 2, __BCAlignedRectTreeErrorMake());
+    __BC_ASSERT(margin >= 0, __BCAlignedRectTreeErrorMake());
+    BCAlignedRectTree tree;
+    tree.nodes = storage;
+    tree.nodeCapacity = (uint32_t) (2 * leafCapacity);
+    tree.root = BCAlignedRectTreeNull;
+    tree.leafCount = 0;
+    tree.margin = margin;
+    for (uint32_t i = 0; i < tree.nodeCapacity; i++) {
+        tree.nodes[i].parent = i + 1 < tree.nodeCapacity ? i + 1 : BCAlignedRectTreeNull;
+        tree.nodes[i].height = -1;
+    }
+    tree.freeList = 0;
+    return tree;
+}
+
+static uint32_t __BCAlignedRectTreeAllocate(BCAlignedRectTree *tree) {
+    const uint32_t index = tree->freeList;
+    __BCNode *n = tree->nodes + index;
+    tree->freeList = n->parent;
+    n->parent = BCAlignedRectTreeNull;
+    n->left = BCAlignedRectTreeNull;
+    n->right = BCAlignedRectTreeNull;
+    n->height = 0;
+    return index;
+}
+
+static void __BCAlignedRectTreeFree(BCAlignedRectTree *tree, uint32_t index) {
+    tree->nodes[index].parent = tree->freeList;
+    tree->nodes[index].height = -1;
+    tree->freeList = index;
+}
+
+static void __BCAlignedRectTreeReplaceChild(BCAlignedRectTree *tree, uint32_t parent, uint32_t oldChild, uint32_t newChild) {
+    if (parent == BCAlignedRectTreeNull) { tree->root = newChild; }
+    else if (tree->nodes[parent].left == oldChild) { tree->nodes[parent].left = newChild; }
+    else { tree->nodes[parent].right = newChild; }
+}
+
+/*
+ If a's children differ in height by more than 1, rotates the taller child up to a's place.  Returns the node now in a's place.
+ With the taller child t, its taller child stays under t and its shorter child moves under a:
+ 
+        a                t
+       / \              / \
+      s   t     =>     a   tt
+         / \          / \
+       tt   ts       s   ts
+ */
+static uint32_t __BCAlignedRectTreeBalance(BCAlignedRectTree *tree, uint32_t iA) {
+    __BCNode *nodes = tree->nodes;
+    __BCNode *a = nodes + iA;
+    if (__BCNodeIsLeaf(a) || a->height < 2) { return iA; }
+    const int32_t balance = nodes[a->right].height - nodes[a->left].height;
+    if (balance >= -1 && balance <= 1) { return iA; }
+    const bool rightTaller = balance > 1;
+    const uint32_t iT = rightTaller ? a->right : a->left;
+    const uint32_t iS = rightTaller ? a->left : a->right;
+    __BCNode *t = nodes + iT;
+    const uint32_t iTT = nodes[t->left].height > nodes[t->right].height ? t->left : t->right;
+    const uint32_t iTS = iTT == t->left ? t->right : t->left;
+
+    //t takes a's place
+    t->parent = a->parent;
+    __BCAlignedRectTreeReplaceChild(tree, a->parent, iA, iT);
+    t->left = iA;
+    t->right = iTT;
+    a->parent = iT;
+    //a keeps s on its side, and gets ts in place of t
+    if (rightTaller) { a->right = iTS; }
+    else { a->left = iTS; }
+    nodes[iTS].parent = iA;
+    a->bounds = __BCAlignedRectUnion(nodes[iS].bounds, nodes[iTS].bounds);
+    a->height = 1 + (nodes[iS].height > nodes[iTS].height ? nodes[iS].height : nodes[iTS].height);
+    t->bounds = __BCAlignedRectUnion(a->bounds, nodes[iTT].bounds);
+    t->height = 1 + (a->height > nodes[iTT].height ? a->height : nodes[iTT].height);
+    return iT;
+}
+
+//refits bounds and heights from index to the root, balancing on the way
+static void __BCAlignedRectTreeRefit(BCAlignedRectTree *tree, uint32_t index) {
+    __BCNode *nodes = tree->nodes;
+    while (index != BCAlignedRectTreeNull) {
+        index = __BCAlignedRectTreeBalance(tree, index);
+        __BCNode *n = nodes + index;
+        const __BCNode *l = nodes + n->left;
+        const __BCNode *r = nodes + n->right;
+        n->height = 1 + (l->height > r->height ? l->height : r->height);
+        n->bounds = __BCAlignedRectUnion(l->bounds, r->bounds);
+        index = n->parent;
+    }
+}
+
+static void __BCAlignedRectTreeInsertLeaf(BCAlignedRectTree *tree, uint32_t leaf) {
+    __BCNode *nodes = tree->nodes;
+    if (tree->root == BCAlignedRectTreeNull) {
+        tree->root = leaf;
+        nodes[leaf].parent = BCAlignedRectTreeNull;
+        return;
+    }
+    //descend to the sibling that costs least.  Pairing with a node costs the new parent's perimeter, and every ancestor grows by the same amount.
+    const BCAlignedRect bounds = nodes[leaf].bounds;
+    uint32_t index = tree->root;
+    while (!__BCNodeIsLeaf(nodes + index)) {
+        const __BCNode *n = nodes + index;
+        const bc_float_t combined = __BCAlignedRectCost(__BCAlignedRectUnion(n->bounds, bounds));
+        const bc_float_t here = 2 * combined;
+        const bc_float_t inheritance = 2 * (combined - __BCAlignedRectCost(n->bounds));
+        const __BCNode *l = nodes + n->left;
+        const __BCNode *r = nodes + n->right;
+        bc_float_t costLeft = __BCAlignedRectCost(__BCAlignedRectUnion(l->bounds, bounds)) + inheritance;
+        if (!__BCNodeIsLeaf(l)) { costLeft -= __BCAlignedRectCost(l->bounds); }
+        bc_float_t costRight = __BCAlignedRectCost(__BCAlignedRectUnion(r->bounds, bounds)) + inheritance;
+        if (!__BCNodeIsLeaf(r)) { costRight -= __BCAlignedRectCost(r->bounds); }
+        if (here < costLeft && here < costRight) { break; }
+        index = costLeft < costRight ? n->left : n->right;
+    }
+    const uint32_t sibling = index;
+    const uint32_t oldParent = nodes[sibling].parent;
+    const uint32_t newParent = __BCAlignedRectTreeAllocate(tree);
+    __BCNode *p = nodes + newParent;
+    p->parent = oldParent;
+    p->bounds = __BCAlignedRectUnion(nodes[sibling].bounds, bounds);
+    p->height = nodes[sibling].height + 1;
+    p->left = sibling;
+    p->right = leaf;
+    __BCAlignedRectTreeReplaceChild(tree, oldParent, sibling, newParent);
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+    __BCAlignedRectTreeRefit(tree, newParent);
+}
+
+static void __BCAlignedRectTreeRemoveLeaf(BCAlignedRectTree *tree, uint32_t leaf) {
+    __BCNode *nodes = tree->nodes;
+    if (leaf == tree->root) {
+        tree->root = BCAlignedRectTreeNull;
+        return;
+    }
+    const uint32_t parent = nodes[leaf].parent;
+    const uint32_t grandparent = nodes[parent].parent;
+    const uint32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+    __BCAlignedRectTreeReplaceChild(tree, grandparent, parent, sibling);
+    nodes[sibling].parent = grandparent;
+    __BCAlignedRectTreeFree(tree, parent);
+    __BCAlignedRectTreeRefit(tree, grandparent);
+}
+
+static inline BCAlignedRect __BCAlignedRectTreeFatten(const BCAlignedRectTree *tree, BCAlignedRect rect) {
+    BCAlignedRect r;
+    r.min = rect.min - tree->margin;
+    r.max = rect.max + tree->margin;
+    return r;
+}
+
+uint32_t BCAlignedRectTreeInsert(BCAlignedRectTree *tree, BCAlignedRect rect, uint32_t data) {
+    __BC_ASSERT(tree != NULL && tree->nodeCapacity > 0, BCAlignedRectTreeNull);
+    //a full tree has used all but one node, which could never be a parent
+    __BC_PRECONDITION(tree->leafCount < tree->nodeCapacity / 2, BCAlignedRectTreeNull);
+    const uint32_t leaf = __BCAlignedRectTreeAllocate(tree);
+    tree->nodes[leaf].bounds = __BCAlignedRectTreeFatten(tree, rect);
+    tree->nodes[leaf].data = data;
+    __BCAlignedRectTreeInsertLeaf(tree, leaf);
+    tree->leafCount++;
+    return leaf;
+}
+
+uint32_t BCAlignedRectTreeInsertCubic(BCAlignedRectTree *tree, BCCubic cubic, uint32_t data) {
+    return BCAlignedRectTreeInsert(tree, BCAlignedRectCreateFromCubic(cubic, BCStrategyFastest), data);
+}
+
+static inline bool __BCAlignedRectTreeIsLeaf(const BCAlignedRectTree *tree, uint32_t leaf) {
+    return leaf < tree->nodeCapacity && tree->nodes[leaf].height == 0;
+}
+
+void BCAlignedRectTreeRemove(BCAlignedRectTree *tree, uint32_t leaf) {
+    __BC_ASSERT_CUSTOM(tree != NULL && tree->nodeCapacity > 0, return);
+    __BC_ASSERT_CUSTOM(__BCAlignedRectTreeIsLeaf(tree, leaf), return);
+    __BCAlignedRectTreeRemoveLeaf(tree, leaf);
+    __BCAlignedRectTreeFree(tree, leaf);
+    tree->leafCount--;
+}
+
+bool BCAlignedRectTreeUpdate(BCAlignedRectTree *tree, uint32_t leaf, BCAlignedRect rect) {
+    __BC_ASSERT(tree != NULL && tree->nodeCapacity > 0, false);
+    __BC_ASSERT(__BCAlignedRectTreeIsLeaf(tree, leaf), false);
+    if (__BCAlignedRectContains(tree->nodes[leaf].bounds, rect)) { return false; }
+    __BCAlignedRectTreeRemoveLeaf(tree, leaf);
+    tree->nodes[leaf].bounds = __BCAlignedRectTreeFatten(tree, rect);
+    __BCAlignedRectTreeInsertLeaf(tree, leaf);
+    return true;
+}
+
+size_t BCAlignedRectTreeUpdateCubics(BCAlignedRectTree *tree, const uint32_t *leaves, const BCCubic *cubics, size_t count) {
+    __BC_ASSERT((leaves != NULL && cubics != NULL) || count == 0, 0);
+    size_t moved = 0;
+    for (size_t i = 0; i < count; i++) {
+        moved += BCAlignedRectTreeUpdate(tree, leaves[i], BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest));
+    }
+    return moved;
+}
+
+BCAlignedRect BCAlignedRectTreeFatRect(const BCAlignedRectTree *tree, uint32_t leaf) {
+    BCAlignedRect zero;
+    zero.min = 0;
+    zero.max = 0;
+    __BC_ASSERT(tree != NULL && __BCAlignedRectTreeIsLeaf(tree, leaf), zero);
+    return tree->nodes[leaf].bounds;
+}
+
+size_t BCAlignedRectTreeQuery(const BCAlignedRectTree *tree, BCAlignedRect region, uint32_t *output, size_t capacity) {
+    __BC_ASSERT(tree != NULL, 0);
+    __BC_ASSERT(output != NULL || capacity == 0, 0);
+    if (tree->root == BCAlignedRectTreeNull) { return 0; }
+    const __BCNode *nodes = tree->nodes;
+    uint32_t stack[__BC_TREE_STACK];
+    int top = 0;
+    stack[top++] = tree->root;
+    size_t found = 0;
+    while (top > 0) {
+        const __BCNode *n = nodes + stack[--top];
+        if (!__BCAlignedRectOverlaps(n->bounds, region)) { continue; }
+        if (__BCNodeIsLeaf(n)) {
+            if (found < capacity) { output[found] = n->data; }
+            found++;
+        }
+        else {
+            __BC_BUGASSERT(top + 2 <= __BC_TREE_STACK, found);
+            stack[top++] = n->left;
+            stack[top++] = n->right;
+        }
+    }
+    return found;
+}
+
+/*
+ Pairs are found by traversing the tree against itself.  A task is either "self" (a==b), all pairs within one subtree, or "cross", all pairs between two disjoint subtrees.
+ self(n) is self(left), self(right), cross(left,right).  cross(a,b) is nothing if their bounds don't overlap, a pair if both are leaves, and otherwise crosses the children of the taller one against the other.
+ This visits each overlapping pair of nodes once, rather than querying the whole tree from every leaf.
+ */
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} __BCAlignedRectTreeTask;
+
+typedef struct {
+    const BCAlignedRectTree *tree;
+    const __BCAlignedRectTreeTask *tasks;
+    BCAlignedRectTreePair *pairs;
+    size_t capacity;
+    size_t found;
+} __BCAlignedRectTreePairs;
+
+//self pushes 3 tasks and descends a level, cross pushes 2 and descends a level of one side, so this is a few times the height
+#define __BC_TREE_TASK_STACK (3 * __BC_TREE_STACK)
+//tasks the top of the traversal is split into, to divide between threads
+#define __BC_TREE_TASKS 1024
+
+//expands a task into up to 3 tasks, returning how many.  A cross of two leaves can't be expanded, and returns -1.
+static inline int __BCAlignedRectTreeExpand(const __BCNode *nodes, __BCAlignedRectTreeTask task, __BCAlignedRectTreeTask *out) {
+    const __BCNode *a = nodes + task.a;
+    if (task.a == task.b) {
+        if (__BCNodeIsLeaf(a)) { return 0; }
+        out[0].a = a->left; out[0].b = a->left;
+        out[1].a = a->right; out[1].b = a->right;
+        out[2].a = a->left; out[2].b = a->right;
+        return 3;
+    }
+    const __BCNode *b = nodes + task.b;
+    if (!__BCAlignedRectOverlaps(a->bounds, b->bounds)) { return 0; }
+    const bool aLeaf = __BCNodeIsLeaf(a);
+    const bool bLeaf = __BCNodeIsLeaf(b);
+    if (aLeaf && bLeaf) { return -1; }
+    if (bLeaf || (!aLeaf && a->height >= b->height)) {
+        out[0].a = a->left; out[0].b = task.b;
+        out[1].a = a->right; out[1].b = task.b;
+    }
+    else {
+        out[0].a = task.a; out[0].b = b->left;
+        out[1].a = task.a; out[1].b = b->right;
+    }
+    return 2;
+}
+
+static void __BCAlignedRectTreePublish(__BCAlignedRectTreePairs *p, const BCAlignedRectTreePair *local, size_t count) {
+    const size_t at = __atomic_fetch_add(&p->found, count, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < count && at + i < p->capacity; i++) {
+        p->pairs[at + i] = local[i];
+    }
+}
+
+static void __BCAlignedRectTreePairsWork(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    __BCAlignedRectTreePairs *p = context;
+    const __BCNode *nodes = p->tree->nodes;
+    BCAlignedRectTreePair local[__BC_TREE_LOCAL_PAIRS];
+    size_t localCount = 0;
+    __BCAlignedRectTreeTask stack[__BC_TREE_TASK_STACK];
+    for (size_t t = begin; t < end; t++) {
+        int top = 0;
+        stack[top++] = p->tasks[t];
+        while (top > 0) {
+            const __BCAlignedRectTreeTask task = stack[--top];
+            __BC_BUGASSERT_CUSTOM(top + 3 <= __BC_TREE_TASK_STACK, return);
+            const int expanded = __BCAlignedRectTreeExpand(nodes, task, stack + top);
+            if (expanded >= 0) {
+                top += expanded;
+                continue;
+            }
+            local[localCount].a = nodes[task.a].data;
+            local[localCount].b = nodes[task.b].data;
+            if (++localCount == __BC_TREE_LOCAL_PAIRS) {
+                __BCAlignedRectTreePublish(p, local, localCount);
+                localCount = 0;
+            }
+        }
+    }
+    if (localCount) { __BCAlignedRectTreePublish(p, local, localCount); }
+}
+
+size_t BCAlignedRectTreeOverlappingPairs(const BCAlignedRectTree *tree, unsigned threads, BCAlignedRectTreePair *pairs, size_t capacity) {
+    __BC_ASSERT(tree != NULL, 0);
+    __BC_ASSERT(pairs != NULL || capacity == 0, 0);
+    if (tree->root == BCAlignedRectTreeNull) { return 0; }
+    __BCAlignedRectTreePairs p;
+    p.tree = tree;
+    p.pairs = pairs;
+    p.capacity = capacity;
+    p.found = 0;
+    //split the top of the traversal breadth-first until there are enough tasks to balance between threads
+    __BCAlignedRectTreeTask tasks[2][__BC_TREE_TASKS];
+    int current = 0;
+    size_t taskCount = 1;
+    tasks[0][0].a = tree->root;
+    tasks[0][0].b = tree->root;
+    const size_t wanted = 16 * (size_t) __BCParallelWorkerCount(threads);
+    bool expandedAny = true;
+    while (taskCount < wanted && expandedAny) {
+        const __BCAlignedRectTreeTask *from = tasks[current];
+        __BCAlignedRectTreeTask *to = tasks[1 - current];
+        size_t next = 0;
+        expandedAny = false;
+        for (size_t t = 0; t < taskCount; t++) {
+            //tasks that can't be expanded, or don't fit, are kept for the workers
+            if (__BC_TREE_TASKS - next < 3 + (taskCount - t - 1)) {
+                to[next++] = from[t];
+                continue;
+            }
+            const int expanded = __BCAlignedRectTreeExpand(tree->nodes, from[t], to + next);
+            if (expanded < 0) { to[next++] = from[t]; }
+            else {
+                next += expanded;
+                expandedAny = true;
+            }
+        }
+        taskCount = next;
+        current = 1 - current;
+    }
+    p.tasks = tasks[current];
+    __BCParallelFor(taskCount, 1, threads, __BCAlignedRectTreePairsWork, &p);
+    return p.found;
+}
+
+static int __BCAlignedRectTreeCheck(const BCAlignedRectTree *tree, uint32_t index, uint32_t parent, uint32_t *leaves) {
+    const __BCNode *n = tree->nodes + index;
+    if (n->parent != parent) { return -1; }
+    if (__BCNodeIsLeaf(n)) {
+        (*leaves)++;
+        return n->height == 0 ? 0 : -1;
+    }
+    const int l = __BCAlignedRectTreeCheck(tree, n->left, index, leaves);
+    const int r = __BCAlignedRectTreeCheck(tree, n->right, index, leaves);
+    if (l < 0 || r < 0) { return -1; }
+    if (n->height != 1 + (l > r ? l : r)) { return -1; }
+    const BCAlignedRect expected = __BCAlignedRectUnion(tree->nodes[n->left].bounds, tree->nodes[n->right].bounds);
+    if (expected.min.x != n->bounds.min.x || expected.min.y != n->bounds.min.y || expected.max.x != n->bounds.max.x || expected.max.y != n->bounds.max.y) { return -1; }
+    return n->height;
+}
+
+bool __BCAlignedRectTreeIsValid(const BCAlignedRectTree *tree) {
+    if (tree->root == BCAlignedRectTreeNull) { return tree->leafCount == 0; }
+    uint32_t leaves = 0;
+    if (__BCAlignedRectTreeCheck(tree, tree->root, BCAlignedRectTreeNull, &leaves) < 0) { return false; }
+    return leaves == tree->leafCount;
+}
+
+int __BCAlignedRectTreeHeight(const BCAlignedRectTree *tree) {
+    if (tree->root == BCAlignedRectTreeNull) { return -1; }
+    return tree->nodes[tree->root].height;
+}
@@ -0,0 +1,247 @@
+//BCArclengthSampler.c: Streaming arclength sampling and dashing along a sequence of cubics
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCArclengthSampler.h"
+#include "BCMetalC.h"
+
+//a single quadrature over the whole cubic is inaccurate for curves that nearly cusp, so we measure panels
+#define __BC_WALK_PANELS 8
+#define __BC_WALK_MAX_ITERATIONS 16
+
+/*
+ Walks a cubic from start to end, finding the bezier parameter for increasing arclengths.
+ Each search starts from the previous result, so a whole walk costs about as much as one parameterization.
+ */
+typedef struct {
+    BCCubic cubic;
+    bc_float_t panels[__BC_WALK_PANELS];
+    bc_float_t length;
+    ///panel containing \c t
+    int panel;
+    ///arclength at the start of \c panel
+    bc_float_t panelStart;
+    bc_float_t t;
+    ///arclength at \c t
+    bc_float_t s;
+} __BCCubicWalk;
+
+static inline void __BCCubicWalkBegin(__BCCubicWalk *w, BCCubic cubic) {
+    w->cubic = cubic;
+    w->length = 0;
+    //panels are long, so they need error control.  Steps within a panel are short, and don't.
+    //1e-6 relative is below float rounding for most lengths, which made quadrature subdivide to its depth limit.
+    const bc_float_t tolerance = BCCubicLength(cubic) * 1e-5f;
+    for (int i = 0; i < __BC_WALK_PANELS; i++) {
+        w->panels[i] = __BCCubicArclengthBetweenWithTolerance(cubic, (bc_float_t) i / __BC_WALK_PANELS, (bc_float_t) (i + 1) / __BC_WALK_PANELS, tolerance);
+        w->length += w->panels[i];
+    }
+    w->panel = 0;
+    w->panelStart = 0;
+    w->t = 0;
+    w->s = 0;
+}
+
+///Finds the bezier parameter at \c arclength, which must be at least the previous arclength and less than \c w->length
+static inline bc_float_t __BCCubicWalkParameter(__BCCubicWalk *w, bc_float_t arclength) {
+    while (w->panel < __BC_WALK_PANELS - 1 && w->panelStart + w->panels[w->panel] <= arclength) {
+        w->panelStart += w->panels[w->panel];
+        w->panel++;
+    }
+    bc_float_t lower = (bc_float_t) w->panel / __BC_WALK_PANELS;
+    bc_float_t upper = (bc_float_t) (w->panel + 1) / __BC_WALK_PANELS;
+    bc_float_t t = w->t;
+    bc_float_t s = w->s;
+    bc_float_t guess = -1;
+    if (t < lower) {
+        //first search in this panel, so assume constant speed within the panel
+        t = lower;
+        s = w->panelStart;
+        if (w->panels[w->panel] > 0) {
+            guess = t + (arclength - s) / w->panels[w->panel] / __BC_WALK_PANELS;
+        }
+    }
+    else {
+        //continue from the previous result.  Estimate the speed at the middle of the step, which is second-order accurate.
+        lower = t;
+        const bc_float_t speed = bc_length(BCCubicEvaluatePrime(w->cubic, t));
+        if (speed > 0) {
+            const bc_float_t middleSpeed = bc_length(BCCubicEvaluatePrime(w->cubic, t + (arclength - s) / speed / 2));
+            if (middleSpeed > 0) {
+                guess = t + (arclength - s) / middleSpeed;
+            }
+        }
+    }
+    if (guess > lower && guess < upper) {
+        s += __BCCubicArclengthBetween(w->cubic, t, guess);
+        t = guess;
+    }
+    const bc_float_t threshold = w->length * 1e-5f;
+    for (int i = 0; i < __BC_WALK_MAX_ITERATIONS; i++) {
+        const bc_float_t error = s - arclength;
+        if (bc_abs(error) <= threshold) { break; }
+        if (error > 0) { upper = t; }
+        else { lower = t; }
+        const bc_float_t speed = bc_length(BCCubicEvaluatePrime(w->cubic, t));
+        bc_float_t next = (lower + upper) / 2;
+        if (speed > 0) {
+            const bc_float_t newton = t - error / speed;
+            if (newton > lower && newton < upper) { next = newton; }
+        }
+        s += __BCCubicArclengthBetween(w->cubic, t, next);
+        t = next;
+    }
+    w->t = t;
+    w->s = s;
+    return t;
+}
+
+BCArclengthSampler BCArclengthSamplerMake(bc_float_t spacing, bc_float_t offset) {
+    BCArclengthSampler sampler;
+    sampler.spacing = 0;
+    sampler.distance = 0;
+    __BC_ASSERT(spacing > 0, sampler);
+    __BC_ASSERT(offset >= 0, sampler);
+    sampler.spacing = spacing;
+    sampler.distance = offset;
+    return sampler;
+}
+
+size_t BCArclengthSamplerSampleCubic(BCArclengthSampler *sampler, BCCubic cubic, BCArclengthSample *output, size_t capacity) {
+    __BC_ASSERT(sampler->spacing > 0, 0);
+    __BCCubicWalk w;
+    __BCCubicWalkBegin(&w, cubic);
+    size_t count = 0;
+    //multiply rather than accumulate, so rounding does not drift over many samples
+    bc_float_t position = sampler->distance;
+    while (position < w.length) {
+        if (count < capacity) {
+            const bc_float_t t = __BCCubicWalkParameter(&w, position);
+            const bc_float2_t prime = BCCubicEvaluatePrime(cubic, t);
+            const bc_float_t speed = bc_length(prime);
+            output[count].position = BCCubicEvaluate(cubic, t);
+            output[count].tangent = speed > 0 ? prime / speed : bc_make_float2(0, 0);
+            output[count].t = t;
+        }
+        count++;
+        position = sampler->distance + count * sampler->spacing;
+    }
+    sampler->distance = position - w.length;
+    return count;
+}
+
+size_t BCArclengthSamplerSampleCubics(BCArclengthSampler *sampler, const BCCubic *cubics, size_t cubicCount, BCArclengthSample *output, size_t *cubicIndices, size_t capacity) {
+    size_t count = 0;
+    for (size_t c = 0; c < cubicCount; c++) {
+        const size_t available = count < capacity ? capacity - count : 0;
+        const size_t written = BCArclengthSamplerSampleCubic(sampler, cubics[c], available ? output + count : output, available);
+        if (cubicIndices) {
+            for (size_t i = count; i < count + written && i < capacity; i++) {
+                cubicIndices[i] = c;
+            }
+        }
+        count += written;
+    }
+    return count;
+}
+
+__attribute__((unused))
+static inline BCDasher __BCDasherErrorMake(void) {
+    BCDasher dasher;
+    dasher.pattern = NULL;
+    dasher.patternCount = 0;
+    dasher.index = 0;
+    dasher.remaining = 0;
+    return dasher;
+}
+
+BCDasher BCDasherMake(const bc_float_t *pattern, size_t patternCount, bc_float_t phase) {
+    __BC_ASSERT(patternCount > 0 && patternCount % 2 == 0, __BCDasherErrorMake());
+    __BC_ASSERT(phase >= 0, __BCDasherErrorMake());
+    bc_float_t sum = 0;
+    for (size_t i = 0; i < patternCount; i++) {
+        __BC_ASSERT(pattern[i] >= 0, __BCDasherErrorMake());
+        sum += pattern[i];
+    }
+    __BC_ASSERT(sum > 0, __BCDasherErrorMake());
+    phase = fmodf(phase, sum);
+    size_t index = 0;
+    while (phase >= pattern[index] && phase > 0) {
+        phase -= pattern[index];
+        index = (index + 1) % patternCount;
+    }
+    BCDasher dasher;
+    dasher.pattern = pattern;
+    dasher.patternCount = patternCount;
+    dasher.index = index;
+    dasher.remaining = pattern[index] - phase;
+    return dasher;
+}
+
+///The part of \c c between two bezier parameters
+static inline BCCubic __BCCubicSubcubic(BCCubic c, bc_float_t t0, bc_float_t t1) {
+    const BCCubic left = BCCubicLeftSplit(c, t1);
+    return t1 > 0 ? BCCubicRightSplit(left, t0 / t1) : left;
+}
+
+size_t BCDasherDashCubic(BCDasher *dasher, BCCubic cubic, BCCubic *output, size_t capacity) {
+    __BC_ASSERT(dasher->patternCount > 0, 0);
+    __BCCubicWalk w;
+    __BCCubicWalkBegin(&w, cubic);
+    size_t count = 0;
+    bc_float_t position = 0;
+    //quadrature rounding, so a dash that ends at the end of the cubic does not leave a sliver for the next
+    const bc_float_t epsilon = w.length * 1e-5f;
+    while (position < w.length) {
+        bc_float_t end;
+        bool finished;
+        if (position + dasher->remaining <= w.length + epsilon) {
+            end = bc_min(position + dasher->remaining, w.length);
+            finished = true;
+        }
+        else {
+            end = w.length;
+            finished = false;
+        }
+        //even entries are on
+        if (dasher->index % 2 == 0 && end - position > epsilon) {
+            if (count < capacity) {
+                const bc_float_t t0 = __BCCubicWalkParameter(&w, position);
+                const bc_float_t t1 = end < w.length ? __BCCubicWalkParameter(&w, end) : 1;
+                output[count] = __BCCubicSubcubic(cubic, t0, t1);
+            }
+            count++;
+        }
+        //a dash no longer than epsilon is a dot, which still draws with round or square caps
+        else if (dasher->index % 2 == 0 && finished && dasher->pattern[dasher->index] <= epsilon) {
+            if (count < capacity) {
+                const bc_float_t t = __BCCubicWalkParameter(&w, position);
+                output[count] = __BCCubicSubcubic(cubic, t, t);
+            }
+            count++;
+        }
+        if (finished) {
+            dasher->index = (dasher->index + 1) % dasher->patternCount;
+            dasher->remaining = dasher->pattern[dasher->index];
+        }
+        else {
+            dasher->remaining -= end - position;
+        }
+        position = end;
+    }
+    return count;
+}
+
+size_t BCDasherDashCubics(BCDasher *dasher, const BCCubic *cubics, size_t cubicCount, BCCubic *output, size_t *cubicIndices, size_t capacity) {
+    size_t count = 0;
+    for (size_t c = 0; c < cubicCount; c++) {
+        const size_t available = count < capacity ? capacity - count : 0;
+        const size_t written = BCDasherDashCubic(dasher, cubics[c], available ? output + count : output, available);
+        if (cubicIndices) {
+            for (size_t i = count; i < count + written && i < capacity; i++) {
+                cubicIndices[i] = c;
+            }
+        }
+        count += written;
+    }
+    return count;
+}
@@ -0,0 +1,91 @@
+//BCArclengthTable.c: Precomputed arclength parameterization
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCArclengthTable.h"
+#include "BCCubic8.h"
+#include "BCMetalC.h"
+
+__attribute__((unused))
+static inline BCArclengthTable __BCArclengthTableErrorMake(void) {
+    BCArclengthTable table;
+    table.lengths = NULL;
+    table.count = 0;
+    return table;
+}
+
+BCArclengthTable BCArclengthTableMake(BCCubic cubic, bc_float_t *storage, size_t count) {
+    __BC_ASSERT(count >= 2, __BCArclengthTableErrorMake());
+    storage[0] = 0;
+    for (size_t i = 1; i < count; i++) {
+        const bc_float_t t = (bc_float_t) i / (count - 1);
+        //the estimate is not quite monotonic for the split, but queries require it to be
+        storage[i] = bc_max(storage[i-1], BCCubicLength(BCCubicLeftSplit(cubic, t)));
+    }
+    BCArclengthTable table;
+    table.lengths = storage;
+    table.count = count;
+    return table;
+}
+
+void BCArclengthTableMakeBatch(const BCCubic *cubics, size_t cubicCount, size_t samples, bc_float_t *storage, BCArclengthTable *output) {
+    __BC_ASSERT_CUSTOM(samples >= 2, for (size_t c = 0; c < cubicCount; c++) { output[c] = __BCArclengthTableErrorMake(); } return);
+    size_t c = 0;
+    for (; c + 8 <= cubicCount; c += 8) {
+        const BCCubic8 wide = BCCubic8Pack(cubics + c);
+        bc_float_t *tableStorage = storage + c * samples;
+        bc_float8_t previous = 0;
+        for (int lane = 0; lane < 8; lane++) {
+            tableStorage[lane * samples] = 0;
+        }
+        for (size_t i = 1; i < samples; i++) {
+            const bc_float8_t t = (bc_float_t) i / (samples - 1);
+            const bc_float8_t length = bc_vmax(previous, BCCubic8Length(BCCubic8LeftSplit(wide, t)));
+            for (int lane = 0; lane < 8; lane++) {
+                tableStorage[lane * samples + i] = length[lane];
+            }
+            previous = length;
+        }
+        for (int lane = 0; lane < 8; lane++) {
+            output[c + lane].lengths = tableStorage + lane * samples;
+            output[c + lane].count = samples;
+        }
+    }
+    for (; c < cubicCount; c++) {
+        output[c] = BCArclengthTableMake(cubics[c], storage + c * samples, samples);
+    }
+}
+
+bc_float_t BCArclengthTableParameterization(BCArclengthTable table, bc_float_t arclength) {
+    __BC_RANGEASSERT(table.count >= 2, (-1-BCErrorArg0));
+    __BC_RANGEASSERT(arclength >= 0, (-1-BCErrorArg1));
+    const bc_float_t *lengths = table.lengths;
+    if (arclength >= lengths[table.count - 1]) {
+        return 1;
+    }
+    //find the first sample whose length exceeds arclength.  lengths[0]==0<=arclength, so this is at least 1.
+    size_t lower = 0;
+    size_t upper = table.count - 1;
+    while (upper - lower > 1) {
+        const size_t middle = lower + (upper - lower) / 2;
+        if (lengths[middle] > arclength) {
+            upper = middle;
+        }
+        else {
+            lower = middle;
+        }
+    }
+    const bc_float_t span = lengths[upper] - lengths[lower];
+    //lengths[upper] > arclength >= lengths[lower], so span is positive
+    const bc_float_t fraction = (arclength - lengths[lower]) / span;
+    return (lower + fraction) / (table.count - 1);
+}
+
+bc_float_t BCArclengthTableArclength(BCArclengthTable table, bc_float_t t) {
+    __BC_RANGEASSERT(table.count >= 2, (-1-BCErrorArg0));
+    __BC_RANGEASSERT(t >= 0 && t <= 1, (-1-BCErrorArg1));
+    const bc_float_t position = t * (table.count - 1);
+    size_t lower = (size_t) position;
+    if (lower > table.count - 2) { lower = table.count - 2; } //t==1
+    const bc_float_t fraction = position - lower;
+    return bc_mix(table.lengths[lower], table.lengths[lower + 1], fraction);
+}
@@ -69,17 +69,22 @@ BCCubic2 BCCubicSplit(BCCubic c, bc_float_t t) {
     return out;
 }
 
-bc_float_t BCCubicArclengthParameterizationWithBounds(BCCubic cubic, bc_float_t arclength, bc_float_t lowerBound, bc_float_t upperBound, bc_float_t threshold) {
-    __BC_RANGEASSERT(arclength >= 0,BCErrorArg1);
+__BCArclengthParameterizationResult __BCCubicArclengthParameterizationBisection(BCCubic cubic, bc_float_t arclength, bc_float_t lowerBound, bc_float_t upperBound, bc_float_t threshold) {
+    __BCArclengthParameterizationResult r;
+    r.iterations = 0;
+    __BC_RANGEASSERT_CUSTOM(arclength >= 0, r.t = BCErrorArg1; return r);
     const float cubicLength = BCCubicLength(cubic);
     if (arclength >= cubicLength) {
-        return upperBound;
+        r.t = upperBound;
+        return r;
     }
     while (true) {
+        r.iterations++;
         bc_float2_t upperEvaluate = BCCubicEvaluate(cubic, upperBound);
         bc_float2_t lowerEvaluate = BCCubicEvaluate(cubic, lowerBound);
         if (bc_distance(upperEvaluate, lowerEvaluate) < threshold) {
-            return lowerBound;
+            r.t = lowerBound;
+            return r;
         }
         bc_float_t partition = (upperBound - lowerBound) / 2 + lowerBound;
         BCCubic d = BCCubicLeftSplit(cubic, partition);
@@ -92,6 +97,168 @@ bc_float_t BCCubicArclengthParameterizationWithBounds(BCCubic cubic, bc_float_t
         }
     }
 }
+
+bc_float_t BCCubicArclengthParameterizationWithBounds(BCCubic cubic, bc_float_t arclength, bc_float_t lowerBound, bc_float_t upperBound, bc_float_t threshold) {
+    return __BCCubicArclengthParameterizationBisection(cubic, arclength, lowerBound, upperBound, threshold).t;
+}
+
+///Speed (\c |BCCubicEvaluatePrime|) at 4 bezier parameters
+static inline bc_float4_t __BCCubicSpeed4(BCCubic c, bc_float4_t t) {
+    const bc_float4_t one_minus_t = 1 - t;
+    const bc_float4_t w0 = 3 * one_minus_t * one_minus_t;
+    const bc_float4_t w1 = 6 * one_minus_t * t;
+    const bc_float4_t w2 = 3 * t * t;
+    const bc_float2_t ca = c.c - c.a;
+    const bc_float2_t dc = c.d - c.c;
+    const bc_float2_t bd = c.b - c.d;
+    const bc_float4_t x = w0 * ca.x + w1 * dc.x + w2 * bd.x;
+    const bc_float4_t y = w0 * ca.y + w1 * dc.y + w2 * bd.y;
+    return bc_vsqrt(x * x + y * y);
+}
+
+///Arclength between two bezier parameters, by 8-point Gauss-Legendre quadrature.  If \c t1<t0 the result is negative.
+static inline bc_float_t __BCCubicSpeedIntegral(BCCubic c, bc_float_t t0, bc_float_t t1) {
+    //nodes are symmetric about 0, so we store the positive half
+    const bc_float4_t nodes = bc_make_float4(0.1834346424956498f, 0.5255324099163290f, 0.7966664774136267f, 0.9602898564975363f);
+    const bc_float4_t weights = bc_make_float4(0.3626837833783620f, 0.3137066458778873f, 0.2223810344533745f, 0.1012285362903763f);
+    const bc_float_t half = (t1 - t0) / 2;
+    const bc_float_t middle = (t0 + t1) / 2;
+    const bc_float4_t speed = __BCCubicSpeed4(c, middle + half * nodes) + __BCCubicSpeed4(c, middle - half * nodes);
+    return half * bc_dot(weights, speed);
+}
+
+bc_float_t __BCCubicArclengthBetween(BCCubic c, bc_float_t t0, bc_float_t t1) {
+    return __BCCubicSpeedIntegral(c, t0, t1);
+}
+
+#define __BC_LENGTH_MAX_DEPTH 16
+
+///Adaptive quadrature for \c BCCubicLengthWithStrategy.  This uses an explicit stack, as Metal does not allow recursion.
+static inline bc_float_t __BCCubicLengthAdaptive(BCCubic c, bc_float_t t0, bc_float_t t1, bc_float_t tolerance) {
+    const bc_float_t width = t1 - t0;
+    if (width == 0) { return 0; }
+    //depth-first, so the stack holds at most one pending interval per level
+    bc_float_t stackT0[__BC_LENGTH_MAX_DEPTH + 1];
+    bc_float_t stackT1[__BC_LENGTH_MAX_DEPTH + 1];
+    bc_float_t stackWhole[__BC_LENGTH_MAX_DEPTH + 1];
+    int stackDepth[__BC_LENGTH_MAX_DEPTH + 1];
+    int top = 0;
+    stackT0[0] = t0;
+    stackT1[0] = t1;
+    stackWhole[0] = __BCCubicSpeedIntegral(c, t0, t1);
+    stackDepth[0] = 0;
+    bc_float_t length = 0;
+    while (top >= 0) {
+        const bc_float_t a = stackT0[top];
+        const bc_float_t b = stackT1[top];
+        const bc_float_t whole = stackWhole[top];
+        const int depth = stackDepth[top];
+        top--;
+        const bc_float_t middle = (a + b) / 2;
+        const bc_float_t left = __BCCubicSpeedIntegral(c, a, middle);
+        const bc_float_t right = __BCCubicSpeedIntegral(c, middle, b);
+        //the halves are far more accurate than the whole, so their difference bounds the error of the whole.
+        //each interval gets a share of the tolerance proportional to its width.
+        if (bc_abs(left + right - whole) <= tolerance * (b - a) / width || depth == __BC_LENGTH_MAX_DEPTH) {
+            length += left + right;
+            continue;
+        }
+        top++;
+        stackT0[top] = middle;
+        stackT1[top] = b;
+        stackWhole[top] = right;
+        stackDepth[top] = depth + 1;
+        top++;
+        stackT0[top] = a;
+        stackT1[top] = middle;
+        stackWhole[top] = left;
+        stackDepth[top] = depth + 1;
+    }
+    return length;
+}
+
+bc_float_t __BCCubicArclengthBetweenWithTolerance(BCCubic c, bc_float_t t0, bc_float_t t1, bc_float_t tolerance) {
+    return __BCCubicLengthAdaptive(c, t0, t1, tolerance);
+}
+
+bc_float_t BCCubicLengthWithStrategy(BCCubic c, bc_float_t tolerance, BCStrategy strategy) {
+    switch (strategy) {
+        case BCStrategyFastest:
+            return BCCubicLength(c);
+        case BCStrategyAccurate:
+            __BC_ASSERT(tolerance > 0, (-1-BCErrorArg2));
+            return __BCCubicLengthAdaptive(c, 0, 1, tolerance);
+        default:
+            __BC_ASSERT(false, (-1-BCErrorArg1));
+            return (-1-BCErrorArg1);
+    }
+}
+
+//Newton's method converges quadratically, so this only happens when stuck at float precision
+#define __BC_NEWTON_MAX_ITERATIONS 32
+#define __BC_NEWTON_PANELS 4
+
+__BCArclengthParameterizationResult __BCCubicArclengthParameterizationNewton(BCCubic cubic, bc_float_t arclength, bc_float_t threshold) {
+    __BCArclengthParameterizationResult r;
+    r.iterations = 0;
+    __BC_RANGEASSERT_CUSTOM(arclength >= 0, r.t = (-1-BCErrorArg1); return r);
+    __BC_ASSERT_CUSTOM(threshold > 0, r.t = (-1-BCErrorArg2); return r);
+    //a single quadrature over [0,1] is inaccurate for curves that nearly cusp, so integrate panels
+    bc_float_t panels[__BC_NEWTON_PANELS];
+    bc_float_t length = 0;
+    for (int i = 0; i < __BC_NEWTON_PANELS; i++) {
+        panels[i] = __BCCubicSpeedIntegral(cubic, (bc_float_t) i / __BC_NEWTON_PANELS, (bc_float_t) (i + 1) / __BC_NEWTON_PANELS);
+        length += panels[i];
+    }
+    if (arclength >= length) {
+        r.t = 1;
+        return r;
+    }
+    //initial guess assumes constant speed within the panel containing arclength
+    int panel = 0;
+    bc_float_t s = 0;
+    while (panel < __BC_NEWTON_PANELS - 1 && s + panels[panel] <= arclength) {
+        s += panels[panel];
+        panel++;
+    }
+    //bracket for the bisection fallback
+    bc_float_t lower = (bc_float_t) panel / __BC_NEWTON_PANELS;
+    bc_float_t upper = (bc_float_t) (panel + 1) / __BC_NEWTON_PANELS;
+    bc_float_t t = lower + (arclength - s) / panels[panel] / __BC_NEWTON_PANELS;
+    s += __BCCubicSpeedIntegral(cubic, lower, t);
+    while (true) {
+        r.iterations++;
+        const bc_float_t error = s - arclength;
+        if (bc_abs(error) < threshold || r.iterations >= __BC_NEWTON_MAX_ITERATIONS) {
+            r.t = t;
+            return r;
+        }
+        if (error > 0) { upper = t; }
+        else { lower = t; }
+        const bc_float_t speed = bc_length(BCCubicEvaluatePrime(cubic, t));
+        bc_float_t next = (lower + upper) / 2;
+        if (speed > 0) {
+            const bc_float_t newton = t - error / speed;
+            if (newton > lower && newton < upper) { next = newton; }
+        }
+        //integrate only the step, which is short and so very accurate
+        s += __BCCubicSpeedIntegral(cubic, t, next);
+        t = next;
+    }
+}
+
+bc_float_t BCCubicArclengthParameterizationWithStrategy(BCCubic cubic, bc_float_t arclength, bc_float_t threshold, BCStrategy strategy) {
+    switch (strategy) {
+        case BCStrategyFastest:
+            return BCCubicArclengthParameterization(cubic, arclength, threshold);
+        case BCStrategyAccurate:
+            return __BCCubicArclengthParameterizationNewton(cubic, arclength, threshold).t;
+        default:
+            //strategy is the fourth argument, which has no BCError
+            __BC_ASSERT(false, (-1-BCErrorUnknown));
+            return (-1-BCErrorUnknown);
+    }
+}
 void BCCubicNormalize(BCCubic __BC_DEVICE *c, bc_float_t approximateDistance) {
     __BC_ASSERT_CUSTOM(approximateDistance > 0, *c = BCErrorCubicMake(BCErrorArg1); return);
     const bc_float_t cDistance = bc_distance(c->c, c->a);
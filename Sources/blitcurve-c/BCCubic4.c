@@ -0,0 +1,18 @@
+//BCCubic4.c: Four BCCubic in a SIMD configuration
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubic4.h"
+#include "BCMetalC.h"
+
+
+extern inline bc_float8_t BCCubic4Evaluate(BCCubic4 c, bc_float4_t t);
+extern inline bc_float8_t BCCubic4EvaluatePrime(BCCubic4 c, bc_float4_t t);
+
+//the functions are shared with BCCubic8.c, see BCCubicWide.h
+#define __BC_WIDE BCCubic4
+#define __BC_WIDE_LANES 4
+#define __BC_WIDE_PARAMETER bc_float4_t
+#define __BC_WIDE_POINTS bc_float8_t
+#define __BC_WIDE_FUNCTION(NAME) BCCubic4##NAME
+#define __BC_WIDE_REPEAT __BCCubic4Parameter
+#include "BCCubicWide.h"
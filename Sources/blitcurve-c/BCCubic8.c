@@ -0,0 +1,18 @@
+//BCCubic8.c: Eight BCCubic in a SIMD configuration
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubic8.h"
+#include "BCMetalC.h"
+
+
+extern inline bc_float16_t BCCubic8Evaluate(BCCubic8 c, bc_float8_t t);
+extern inline bc_float16_t BCCubic8EvaluatePrime(BCCubic8 c, bc_float8_t t);
+
+//the functions are shared with BCCubic4.c, see BCCubicWide.h
+#define __BC_WIDE BCCubic8
+#define __BC_WIDE_LANES 8
+#define __BC_WIDE_PARAMETER bc_float8_t
+#define __BC_WIDE_POINTS bc_float16_t
+#define __BC_WIDE_FUNCTION(NAME) BCCubic8##NAME
+#define __BC_WIDE_REPEAT __BCCubic8Parameter
+#include "BCCubicWide.h"
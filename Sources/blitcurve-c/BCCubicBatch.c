@@ -0,0 +1,362 @@
+//BCCubicBatch.c: Batch evaluation of many BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubicBatch.h"
+#include "BCCubic8.h"
+#include "BCMetalC.h"
+#include "BCLanes8.h"
+#include "BCParallel.h"
+#include "BCTrap.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+static inline __BCCubicLanes8 __BCCubicLanes8LoadPlanes(BCCubicPlanes p, size_t i) {
+    __BCCubicLanes8 l;
+    l.a_x = __bc_load8(p.a_x + i);
+    l.a_y = __bc_load8(p.a_y + i);
+    l.b_x = __bc_load8(p.b_x + i);
+    l.b_y = __bc_load8(p.b_y + i);
+    l.c_x = __bc_load8(p.c_x + i);
+    l.c_y = __bc_load8(p.c_y + i);
+    l.d_x = __bc_load8(p.d_x + i);
+    l.d_y = __bc_load8(p.d_y + i);
+    return l;
+}
+
+static inline bc_float2_t __BCCubicEvaluateScalar(BCCubic c, bc_float_t t, bool prime) {
+    return prime ? BCCubicEvaluatePrime(c, t) : BCCubicEvaluate(c, t);
+}
+
+//a NULL t means use sharedT.  These are always inlined with constant arguments, so the branches fold away.
+static inline void __BCCubicEvaluateBatch(const BCCubic *cubics, const bc_float_t *t, bc_float_t sharedT, bool prime, bc_float2_t *output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(cubics + i);
+        const bc_float8_t t8 = t ? __bc_load8(t + i) : sharedT;
+        bc_float8_t x, y;
+        __BCCubicLanes8Evaluate(l, t8, prime, &x, &y);
+        __bc_store8_interleaved(output + i, x, y);
+    }
+    for (; i < count; i++) {
+        output[i] = __BCCubicEvaluateScalar(cubics[i], t ? t[i] : sharedT, prime);
+    }
+}
+
+static inline void __BCCubicPlanesEvaluateBatch(BCCubicPlanes cubics, const bc_float_t *t, bc_float_t sharedT, bool prime, bc_float_t *output_x, bc_float_t *output_y, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __BCCubicLanes8 l = __BCCubicLanes8LoadPlanes(cubics, i);
+        const bc_float8_t t8 = t ? __bc_load8(t + i) : sharedT;
+        bc_float8_t x, y;
+        __BCCubicLanes8Evaluate(l, t8, prime, &x, &y);
+        __bc_store8(output_x + i, x);
+        __bc_store8(output_y + i, y);
+    }
+    for (; i < count; i++) {
+        BCCubic c;
+        c.a = bc_make_float2(cubics.a_x[i], cubics.a_y[i]);
+        c.b = bc_make_float2(cubics.b_x[i], cubics.b_y[i]);
+        c.c = bc_make_float2(cubics.c_x[i], cubics.c_y[i]);
+        c.d = bc_make_float2(cubics.d_x[i], cubics.d_y[i]);
+        const bc_float2_t r = __BCCubicEvaluateScalar(c, t ? t[i] : sharedT, prime);
+        output_x[i] = r.x;
+        output_y[i] = r.y;
+    }
+}
+
+void BCCubicEvaluateBatch(const BCCubic *cubics, const bc_float_t *t, size_t count, bc_float2_t *output) {
+    __BCCubicEvaluateBatch(cubics, t, 0, false, output, count);
+}
+
+void BCCubicEvaluateBatchSharedParameter(const BCCubic *cubics, size_t count, bc_float_t t, bc_float2_t *output) {
+    __BCCubicEvaluateBatch(cubics, NULL, t, false, output, count);
+}
+
+void BCCubicEvaluatePrimeBatch(const BCCubic *cubics, const bc_float_t *t, size_t count, bc_float2_t *output) {
+    __BCCubicEvaluateBatch(cubics, t, 0, true, output, count);
+}
+
+void BCCubicEvaluatePrimeBatchSharedParameter(const BCCubic *cubics, size_t count, bc_float_t t, bc_float2_t *output) {
+    __BCCubicEvaluateBatch(cubics, NULL, t, true, output, count);
+}
+
+void BCCubicPlanesEvaluateBatch(BCCubicPlanes cubics, const bc_float_t *t, size_t count, bc_float_t *output_x, bc_float_t *output_y) {
+    __BCCubicPlanesEvaluateBatch(cubics, t, 0, false, output_x, output_y, count);
+}
+
+void BCCubicPlanesEvaluateBatchSharedParameter(BCCubicPlanes cubics, size_t count, bc_float_t t, bc_float_t *output_x, bc_float_t *output_y) {
+    __BCCubicPlanesEvaluateBatch(cubics, NULL, t, false, output_x, output_y, count);
+}
+
+void BCCubicPlanesEvaluatePrimeBatch(BCCubicPlanes cubics, const bc_float_t *t, size_t count, bc_float_t *output_x, bc_float_t *output_y) {
+    __BCCubicPlanesEvaluateBatch(cubics, t, 0, true, output_x, output_y, count);
+}
+
+void BCCubicPlanesEvaluatePrimeBatchSharedParameter(BCCubicPlanes cubics, size_t count, bc_float_t t, bc_float_t *output_x, bc_float_t *output_y) {
+    __BCCubicPlanesEvaluateBatch(cubics, NULL, t, true, output_x, output_y, count);
+}
+
+///Like \c __BCCubicSpeedIntegral in BCCubic.c, on 8 lanes
+static inline bc_float8_t __BCCubicLanes8SpeedIntegral(__BCCubicLanes8 l, bc_float_t t0, bc_float_t t1) {
+    const bc_float_t nodes[4] = {0.1834346424956498f, 0.5255324099163290f, 0.7966664774136267f, 0.9602898564975363f};
+    const bc_float_t weights[4] = {0.3626837833783620f, 0.3137066458778873f, 0.2223810344533745f, 0.1012285362903763f};
+    const bc_float_t half = (t1 - t0) / 2;
+    const bc_float_t middle = (t0 + t1) / 2;
+    bc_float8_t sum = 0;
+    for (int i = 0; i < 4; i++) {
+        bc_float8_t x, y;
+        __BCCubicLanes8Evaluate(l, middle + half * nodes[i], true, &x, &y);
+        const bc_float8_t above = bc_vsqrt(x * x + y * y);
+        __BCCubicLanes8Evaluate(l, middle - half * nodes[i], true, &x, &y);
+        const bc_float8_t below = bc_vsqrt(x * x + y * y);
+        sum += weights[i] * (above + below);
+    }
+    return half * sum;
+}
+
+void BCCubicLengthBatch(const BCCubic *cubics, size_t count, bc_float_t tolerance, BCStrategy strategy, bc_float_t *output) {
+    __BC_ASSERT_CUSTOM(strategy == BCStrategyFastest || strategy == BCStrategyAccurate, for (size_t i = 0; i < count; i++) { output[i] = (-1-BCErrorArg1); } return);
+    __BC_ASSERT_CUSTOM(strategy == BCStrategyFastest || tolerance > 0, for (size_t i = 0; i < count; i++) { output[i] = (-1-BCErrorArg2); } return);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        if (strategy == BCStrategyFastest) {
+            __bc_store8(output + i, BCCubic8Length(BCCubic8Pack(cubics + i)));
+            continue;
+        }
+        //the first level of BCCubicLengthWithStrategy's adaptive quadrature
+        const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(cubics + i);
+        const bc_float8_t whole = __BCCubicLanes8SpeedIntegral(l, 0, 1);
+        const bc_float8_t halves = __BCCubicLanes8SpeedIntegral(l, 0, 0.5f) + __BCCubicLanes8SpeedIntegral(l, 0.5f, 1);
+        const bc_float8_t error = bc_abs(halves - whole);
+        for (int lane = 0; lane < 8; lane++) {
+            output[i + lane] = error[lane] <= tolerance ? halves[lane] : BCCubicLengthWithStrategy(cubics[i + lane], tolerance, strategy);
+        }
+    }
+    for (; i < count; i++) {
+        output[i] = BCCubicLengthWithStrategy(cubics[i], tolerance, strategy);
+    }
+}
+
+//One axis of BCCubicLength, before the norm, in the same order so the lanes round the same way
+static inline bc_float8_t __BCLanes8LengthAxis(bc_float8_t a, bc_float8_t b, bc_float8_t c, bc_float8_t d) {
+    const bc_float8_t v0 = bc_abs(c - a);
+    const bc_float8_t v1 = bc_abs(-0.558983582205757f * a + 0.325650248872424f * c + 0.208983582205757f * d + 0.024349751127576f * b);
+    const bc_float8_t v2 = bc_abs(b - a + d - c) * 0.26666666666666666f;
+    const bc_float8_t v3 = bc_abs(-0.024349751127576f * a - 0.208983582205757f * c - 0.325650248872424f * d + 0.558983582205757f * b);
+    const bc_float8_t v4 = bc_abs(b - d);
+    return 0.15f * (v0 + v4) + v1 + v2 + v3;
+}
+
+static inline bc_float8_t __BCCubicLanes8Length(__BCCubicLanes8 l) {
+    const bc_float8_t x = __BCLanes8LengthAxis(l.a_x, l.b_x, l.c_x, l.d_x);
+    const bc_float8_t y = __BCLanes8LengthAxis(l.a_y, l.b_y, l.c_y, l.d_y);
+    return bc_vsqrt(x * x + y * y);
+}
+
+//BCCubicEvaluate, in the same order
+static inline bc_float8_t __BCLanes8EvaluateAxis(bc_float8_t a, bc_float8_t b, bc_float8_t c, bc_float8_t d, bc_float8_t t) {
+    const bc_float8_t mt = 1 - t;
+    return a * (mt * mt * mt) + c * 3 * (mt * mt) * t + d * 3 * mt * (t * t) + b * (t * t * t);
+}
+
+//BCCubicLeftSplit, in the same order
+static inline __BCCubicLanes8 __BCCubicLanes8LeftSplit(__BCCubicLanes8 l, bc_float8_t t) {
+    const bc_float8_t t_minus_1 = t - 1;
+    const bc_float8_t t_minus_1_squared = t_minus_1 * t_minus_1;
+    const bc_float8_t t_cubed = t * t * t;
+    const bc_float8_t t_minus_1_cubed = t_minus_1 * t_minus_1 * t_minus_1;
+    __BCCubicLanes8 out = l;
+#define __BC_LEFT_SPLIT_AXIS(A, B, C, D) { \
+        const bc_float8_t t_squared_d = (t * t) * l.D; \
+        const bc_float8_t t_c = t * l.C; \
+        out.B = t_cubed * l.B - 3 * t_squared_d * t_minus_1 + 3 * t_minus_1_squared * t_c - t_minus_1_cubed * l.A; \
+        out.C = t_c - t_minus_1 * l.A; \
+        out.D = t_squared_d - 2 * t_minus_1 * t_c + t_minus_1_squared * l.A; \
+    }
+    __BC_LEFT_SPLIT_AXIS(a_x, b_x, c_x, d_x)
+    __BC_LEFT_SPLIT_AXIS(a_y, b_y, c_y, d_y)
+#undef __BC_LEFT_SPLIT_AXIS
+    return out;
+}
+
+//__BCCubicArclengthParameterizationBisection on [0,1] for 8 cubics, with each lane stopping where the scalar search would
+static inline bc_float8_t __BCCubicLanes8ArclengthParameterization(__BCCubicLanes8 l, bc_float8_t length, bc_float8_t arclength, bc_float_t threshold) {
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    bc_float8_t lower = zero;
+    bc_float8_t upper = one;
+    //arclengths past the end are the upper bound
+    const __BCMask8 inside = arclength < length;
+    __BCMask8 searching = inside;
+    while (__BCMask8Any(searching)) {
+        const bc_float8_t dx = __BCLanes8EvaluateAxis(l.a_x, l.b_x, l.c_x, l.d_x, upper) - __BCLanes8EvaluateAxis(l.a_x, l.b_x, l.c_x, l.d_x, lower);
+        const bc_float8_t dy = __BCLanes8EvaluateAxis(l.a_y, l.b_y, l.c_y, l.d_y, upper) - __BCLanes8EvaluateAxis(l.a_y, l.b_y, l.c_y, l.d_y, lower);
+        searching &= bc_vsqrt(dx * dx + dy * dy) >= threshold;
+        const bc_float8_t partition = (upper - lower) / 2 + lower;
+        const __BCMask8 left = __BCCubicLanes8Length(__BCCubicLanes8LeftSplit(l, partition)) > arclength;
+        upper = __BCMask8Select(searching & left, partition, upper);
+        lower = __BCMask8Select(searching & ~left, partition, lower);
+    }
+    return __BCMask8Select(inside, lower, one);
+}
+
+void BCCubicParameterRangeMakeClampedParameterizationBatch(const BCCubic *cubics, const bc_float_t *startPositions, const bc_float_t *endPositions, size_t count, bc_float_t threshold, bc_float_t minimumDelta, BCCubicParameterRange *output) {
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(cubics + i);
+        const bc_float8_t length = __BCCubicLanes8Length(l);
+        //same steps as BCCubicParameterRangeMakeClampedParameterization
+        bc_float8_t minT = __BCCubicLanes8ArclengthParameterization(l, length, bc_vmax(zero, __bc_load8(startPositions + i)), threshold);
+        bc_float8_t maxT = __BCCubicLanes8ArclengthParameterization(l, length, bc_vmin(length, __bc_load8(endPositions + i)), threshold);
+        //reversed ranges report their error from the scalar function, which checks before widening
+        const uint32_t reversed = __BCMask8Bits(minT > maxT);
+        const __BCMask8 widen = maxT - minT < minimumDelta;
+        minT = __BCMask8Select(widen, bc_vmax(zero, minT - minimumDelta), minT);
+        maxT = __BCMask8Select(widen, bc_vmin(one, maxT + minimumDelta), maxT);
+        for (int lane = 0; lane < 8; lane++) {
+            if (reversed & (1u << lane)) {
+                output[i + lane] = BCCubicParameterRangeMakeClampedParameterization(cubics[i + lane], startPositions[i + lane], endPositions[i + lane], threshold, minimumDelta);
+            }
+            else {
+                output[i + lane].minT = minT[lane];
+                output[i + lane].maxT = maxT[lane];
+            }
+        }
+    }
+    for (; i < count; i++) {
+        output[i] = BCCubicParameterRangeMakeClampedParameterization(cubics[i], startPositions[i], endPositions[i], threshold, minimumDelta);
+    }
+}
+
+void BCAlignedRectCreateFromCubicBatch(const BCCubic *cubics, size_t count, BCStrategy strategy, BCAlignedRect *output) {
+    BCAlignedRect zero;
+    zero.min = 0;
+    zero.max = 0;
+    __BC_ASSERT_CUSTOM(strategy == BCStrategyFastest || strategy == BCStrategyAccurate, for (size_t i = 0; i < count; i++) { output[i] = zero; } return);
+    __BC_ASSERT_CUSTOM((cubics != NULL && output != NULL) || count == 0, return);
+    size_t i = 0;
+    if (strategy == BCStrategyAccurate) {
+        for (; i + 8 <= count; i += 8) {
+            const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(cubics + i);
+            bc_float8_t minX, maxX, minY, maxY;
+            __BCLanes8AxisRange(l.a_x, l.b_x, l.c_x, l.d_x, &minX, &maxX);
+            __BCLanes8AxisRange(l.a_y, l.b_y, l.c_y, l.d_y, &minY, &maxY);
+            for (int lane = 0; lane < 8; lane++) {
+                output[i + lane].min = bc_make_float2(minX[lane], minY[lane]);
+                output[i + lane].max = bc_make_float2(maxX[lane], maxY[lane]);
+            }
+        }
+    }
+    for (; i < count; i++) {
+        output[i] = BCAlignedRectCreateFromCubic(cubics[i], strategy);
+    }
+}
+
+//cubics per block of BCCubicCullBatch
+#define __BC_CULL_BLOCK 4096
+
+typedef struct {
+    const BCCubic *cubics;
+    size_t count;
+    BCAlignedRect viewport;
+    BCStrategy strategy;
+    uint32_t *output;
+    //visible cubics in each block, whose indexes are at output[block*__BC_CULL_BLOCK]
+    size_t *blockCounts;
+} __BCCubicCull;
+
+static void __BCCubicCullBlocks(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    const __BCCubicCull *c = context;
+    const BCAlignedRect v = c->viewport;
+    for (size_t block = begin; block < end; block++) {
+        const size_t first = block * __BC_CULL_BLOCK;
+        const size_t last = first + __BC_CULL_BLOCK < c->count ? first + __BC_CULL_BLOCK : c->count;
+        uint32_t *out = c->output + first;
+        size_t n = 0;
+        size_t i = first;
+        for (; i + 8 <= last; i += 8) {
+            const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(c->cubics + i);
+            bc_float8_t minX, maxX, minY, maxY;
+            if (c->strategy == BCStrategyAccurate) {
+                __BCLanes8AxisRange(l.a_x, l.b_x, l.c_x, l.d_x, &minX, &maxX);
+                __BCLanes8AxisRange(l.a_y, l.b_y, l.c_y, l.d_y, &minY, &maxY);
+            }
+            else {
+                minX = bc_vmin(bc_vmin(l.a_x, l.b_x), bc_vmin(l.c_x, l.d_x));
+                maxX = bc_vmax(bc_vmax(l.a_x, l.b_x), bc_vmax(l.c_x, l.d_x));
+                minY = bc_vmin(bc_vmin(l.a_y, l.b_y), bc_vmin(l.c_y, l.d_y));
+                maxY = bc_vmax(bc_vmax(l.a_y, l.b_y), bc_vmax(l.c_y, l.d_y));
+            }
+            //the viewport is already grown by the outset
+            const __BCMask8 visible = (maxX >= v.min.x) & (minX <= v.max.x) & (maxY >= v.min.y) & (minY <= v.max.y);
+            //branchless compaction: every lane is written, and only visible ones are kept
+            for (int lane = 0; lane < 8; lane++) {
+                out[n] = (uint32_t) (i + lane);
+                n += visible[lane] & 1;
+            }
+        }
+        for (; i < last; i++) {
+            const BCAlignedRect box = BCAlignedRectCreateFromCubic(c->cubics[i], c->strategy);
+            out[n] = (uint32_t) i;
+            n += box.max.x >= v.min.x && box.min.x <= v.max.x && box.max.y >= v.min.y && box.min.y <= v.max.y;
+        }
+        c->blockCounts[block] = n;
+    }
+}
+
+size_t BCCubicCullBatch(const BCCubic *cubics, size_t count, BCAlignedRect viewport, bc_float_t outset, BCStrategy strategy, unsigned threads, uint32_t *output) {
+    __BC_ASSERT(strategy == BCStrategyFastest || strategy == BCStrategyAccurate, 0);
+    __BC_ASSERT(outset >= 0, 0);
+    __BC_ASSERT((cubics != NULL && output != NULL) || count == 0, 0);
+    __BC_ASSERT(count <= UINT32_MAX, 0);
+    if (count == 0) { return 0; }
+    const size_t blocks = (count + __BC_CULL_BLOCK - 1) / __BC_CULL_BLOCK;
+    size_t *blockCounts = malloc(sizeof(size_t) * blocks);
+    //out of memory isn't a caller error, so it returns at every check level rather than trapping or being assumed away
+    if (blockCounts == NULL) { return 0; }
+    __BCCubicCull c;
+    c.cubics = cubics;
+    c.count = count;
+    //growing the viewport is the same as growing every box
+    c.viewport.min = viewport.min - outset;
+    c.viewport.max = viewport.max + outset;
+    c.strategy = strategy;
+    c.output = output;
+    c.blockCounts = blockCounts;
+    __BCParallelFor(blocks, 1, threads, __BCCubicCullBlocks, &c);
+    //each block's list starts at or after where it belongs, so moving them in order never overwrites one that hasn't moved
+    size_t total = blockCounts[0];
+    for (size_t block = 1; block < blocks; block++) {
+        memmove(output + total, output + block * __BC_CULL_BLOCK, sizeof(uint32_t) * blockCounts[block]);
+        total += blockCounts[block];
+    }
+    free(blockCounts);
+    return total;
+}
+
+uint32_t BCCubicVertexBudgetBatch(const BCCubic *cubics, size_t count, bc_float_t scale, bc_float_t tolerance, uint8_t maximumVertexes, uint8_t vertexesPerSample, uint8_t *vertexCounts, uint32_t *offsets, BCDrawPrimitivesArguments *arguments) {
+    __BC_ASSERT(scale > 0, 0);
+    __BC_ASSERT(tolerance > 0, 0);
+    __BC_ASSERT(maximumVertexes > 1, 0);
+    __BC_ASSERT(vertexesPerSample > 0, 0);
+    __BC_ASSERT(vertexCounts != NULL || count == 0, 0);
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        vertexCounts[i] = BCCubicVertexBudget(cubics[i], scale, tolerance, maximumVertexes);
+        const uint32_t vertexes = (uint32_t) vertexCounts[i] * vertexesPerSample;
+        if (offsets) { offsets[i] = total; }
+        if (arguments) {
+            arguments[i].vertexCount = vertexes;
+            arguments[i].instanceCount = 1;
+            arguments[i].vertexStart = total;
+            arguments[i].baseInstance = (uint32_t) i;
+        }
+        total += vertexes;
+    }
+    if (offsets) { offsets[count] = total; }
+    return total;
+}
@@ -6,6 +6,7 @@
 #include "BCCubicDrawing.h"
 #include "BCMetalC.h"
 #include "BCBezierParameter.h"
+#include "BCCubicFlatness.h"
 __attribute__((overloadable))
 extern inline bc_float3_t BCCubicVertexMake(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, bc_float3x3_t transform);
 
@@ -31,15 +32,55 @@ bc_float2_t BCCubicVertexMake(BCCubic cubic, uint8_t vertexID, uint8_t vertexesP
     return BCCubicVertexMake(cubic, vertexID, vertexesPerCubic, minimum, maximum);
 }
 
-bc_float2_t BCCubicVertexMakeClampedParameterization(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, bc_float_t startPosition, const bc_float_t endPosition, bc_float_t threshold,bc_float_t minimumDelta) {
+__attribute__((unused))
+static inline BCCubicParameterRange __BCCubicParameterRangeErrorMake(BCError e) {
+    BCCubicParameterRange range;
+    range.minT = -1 - (bc_float_t) e;
+    range.maxT = 0;
+    return range;
+}
+
+BCCubicParameterRange BCCubicParameterRangeMakeClampedParameterization(BCCubic cubic, bc_float_t startPosition, bc_float_t endPosition, bc_float_t threshold, bc_float_t minimumDelta) {
+    BCCubicParameterRange range;
     const bc_float_t minLinearPosition = bc_max(0.0,startPosition);
     const bc_float_t maxLinearPosition = bc_min(BCCubicLength(cubic),endPosition);
 
-    const bc_float_t minT = BCCubicArclengthParameterization(cubic, minLinearPosition,threshold);
-    __BC_TRY_IF(minT<0,BCVertex2ErrorMake(BCErrorLogic));
-    const bc_float_t maxT = BCCubicArclengthParameterization(cubic, maxLinearPosition, threshold);
-    __BC_TRY_IF(maxT<0,BCVertex2ErrorMake(BCErrorLogic));
+    range.minT = BCCubicArclengthParameterization(cubic, minLinearPosition,threshold);
+    __BC_TRY_IF(range.minT<0,__BCCubicParameterRangeErrorMake(BCErrorLogic));
+    range.maxT = BCCubicArclengthParameterization(cubic, maxLinearPosition, threshold);
+    __BC_TRY_IF(range.maxT<0,__BCCubicParameterRangeErrorMake(BCErrorLogic));
+    //same adjustment as BCCubicVertexMake with minimumDeltaT
+    __BC_PRECONDITION(range.minT <= range.maxT,__BCCubicParameterRangeErrorMake(BCErrorArgRelationship));
+    if (range.maxT - range.minT < minimumDelta) {
+        range.minT = bc_max(0.0f,range.minT - minimumDelta);
+        range.maxT = bc_min(1.0f,range.maxT + minimumDelta);
+    }
+    return range;
+}
+
+__attribute__((const))
+__attribute__((overloadable))
+bc_float2_t BCCubicVertexMake(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, BCCubicParameterRange range) {
+    __BC_TRY_IF(range.minT<0,BCVertex2ErrorMake((BCError)(-1 * ((int)range.minT + 1))));
+    //rvalue is compatible; passthrough
+    return BCCubicVertexMake(cubic, vertexID, vertexesPerCubic, range.minT, range.maxT);
+}
+
+bc_float2_t BCCubicVertexMakeClampedParameterization(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, bc_float_t startPosition, const bc_float_t endPosition, bc_float_t threshold,bc_float_t minimumDelta) {
     //rvalue is compatible here, so we should be able to passthrough
-    return BCCubicVertexMake(cubic, vertexID, vertexesPerCubic, minT, maxT, minimumDelta);
+    return BCCubicVertexMake(cubic, vertexID, vertexesPerCubic, BCCubicParameterRangeMakeClampedParameterization(cubic, startPosition, endPosition, threshold, minimumDelta));
 }
 
+uint8_t BCCubicVertexBudget(BCCubic cubic, bc_float_t scale, bc_float_t tolerance, uint8_t maximumVertexes) {
+    __BC_ASSERT(scale > 0, 0);
+    __BC_ASSERT(tolerance > 0, 0);
+    __BC_ASSERT(maximumVertexes > 1, 0);
+    //B'' is 6(a-2c+d) at t=0 and 6(c-2d+b) at t=1, and linear in between.  For n segments, 6m/(8n²) <= tolerance.
+    const bc_float_t m = bc_max(bc_length(cubic.a - 2 * cubic.c + cubic.d), bc_length(cubic.c - 2 * cubic.d + cubic.b)) * scale;
+    const bc_float_t segments = bc_ceil(bc_sqrt(0.75f * m / tolerance));
+    //straight, however it's parameterized
+    if (segments <= 1 || __BCCubicIsFlatGeometric(cubic, tolerance / scale)) { return 2; }
+    //compared as floats, which also handles infinity
+    if (!(segments + 1 < maximumVertexes)) { return maximumVertexes; }
+    return (uint8_t) (segments + 1);
+}
@@ -0,0 +1,114 @@
+//BCCubicFlatten.c: Adaptive flattening of BCCubic into polylines
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubicFlatten.h"
+#include "BCMetalC.h"
+#include "BCCubicFlatness.h"
+
+#define __BC_FLATTEN_MAX_DEPTH 16
+
+/*
+ u and v are combinations of the second differences a-2c+d and c-2d+b, with coefficients summing to 3 in magnitude.
+ Each split in half divides the largest second difference by at least 4, so it divides the parametric flatness bound by 16.
+ This gives the depth at which every piece is flat.  Flattening accepts pieces that pass either test, so it never splits deeper.
+ */
+static inline int __BCCubicFlattenDepth(BCCubic c, bc_float_t tolerance) {
+    const bc_float2_t d0 = bc_abs(c.a - 2 * c.c + c.d);
+    const bc_float2_t d1 = bc_abs(c.c - 2 * c.d + c.b);
+    const bc_float2_t m = bc_make_float2(bc_max(d0.x, d1.x), bc_max(d0.y, d1.y));
+    bc_float_t bound = 9 * (m.x * m.x + m.y * m.y);
+    const bc_float_t limit = 16 * tolerance * tolerance;
+    int depth = 0;
+    while (bound > limit && depth < __BC_FLATTEN_MAX_DEPTH) {
+        bound /= 16;
+        depth++;
+    }
+    return depth;
+}
+
+static inline BCCubic __BCCubic2Left(BCCubic2 c) {
+    BCCubic out;
+    out.a = c.a.lo;
+    out.b = c.b.lo;
+    out.c = c.c.lo;
+    out.d = c.d.lo;
+    return out;
+}
+
+static inline BCCubic __BCCubic2Right(BCCubic2 c) {
+    BCCubic out;
+    out.a = c.a.hi;
+    out.b = c.b.hi;
+    out.c = c.c.hi;
+    out.d = c.d.hi;
+    return out;
+}
+
+size_t BCCubicFlattenUpperBound(BCCubic cubic, bc_float_t tolerance) {
+    __BC_ASSERT(tolerance > 0, 0);
+    return ((size_t) 1 << __BCCubicFlattenDepth(cubic, tolerance)) + 1;
+}
+
+size_t BCCubicFlatten(BCCubic cubic, bc_float_t tolerance, bc_float2_t *output, bc_float_t *parameters, size_t capacity) {
+    __BC_ASSERT(tolerance > 0, 0);
+    //depth-first, left first, so the stack holds at most one pending piece per level
+    BCCubic stack[__BC_FLATTEN_MAX_DEPTH + 1];
+    bc_float_t stackT0[__BC_FLATTEN_MAX_DEPTH + 1];
+    int stackDepth[__BC_FLATTEN_MAX_DEPTH + 1];
+    int top = 0;
+    stack[0] = cubic;
+    stackT0[0] = 0;
+    stackDepth[0] = 0;
+    size_t count = 0;
+    if (capacity > 0) {
+        output[0] = cubic.a;
+        if (parameters) { parameters[0] = 0; }
+    }
+    count++;
+    while (top >= 0) {
+        const BCCubic piece = stack[top];
+        const bc_float_t t0 = stackT0[top];
+        const int depth = stackDepth[top];
+        top--;
+        if (depth == __BC_FLATTEN_MAX_DEPTH || __BCCubicIsFlatGeometric(piece, tolerance) || __BCCubicIsFlatParametric(piece, tolerance)) {
+            if (count < capacity) {
+                output[count] = piece.b;
+                if (parameters) { parameters[count] = t0 + 1.0f / (1 << depth); }
+            }
+            count++;
+            continue;
+        }
+        const BCCubic2 halves = BCCubicSplit(piece, 0.5);
+        const bc_float_t width = 1.0f / (2 << depth);
+        top++;
+        stack[top] = __BCCubic2Right(halves);
+        stackT0[top] = t0 + width;
+        stackDepth[top] = depth + 1;
+        top++;
+        stack[top] = __BCCubic2Left(halves);
+        stackT0[top] = t0;
+        stackDepth[top] = depth + 1;
+    }
+    return count;
+}
+
+size_t BCCubicFlattenBatchUpperBound(const BCCubic *cubics, size_t count, bc_float_t tolerance) {
+    __BC_ASSERT(tolerance > 0, 0);
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += BCCubicFlattenUpperBound(cubics[i], tolerance);
+    }
+    return total;
+}
+
+size_t BCCubicFlattenBatch(const BCCubic *cubics, size_t count, bc_float_t tolerance, bc_float2_t *output, bc_float_t *parameters, size_t capacity, size_t *offsets) {
+    __BC_ASSERT(tolerance > 0, 0);
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        offsets[i] = total;
+        const size_t available = total < capacity ? capacity - total : 0;
+        total += BCCubicFlatten(cubics[i], tolerance, available ? output + total : output, (parameters && available) ? parameters + total : parameters, available);
+    }
+    offsets[count] = total;
+    return total;
+}
@@ -0,0 +1,520 @@
+//BCCubicIntersection.c: Intersections with BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubicIntersection.h"
+#include "BCCubic2Inline.h"
+#include "BCCubicBatch.h"
+#include "BCAlignedRect.h"
+#include "BCMetalC.h"
+#include "BCMacros.h"
+#include "BCLanes8.h"
+#include <string.h>
+
+#define __BC_INTERSECT_MAX_DEPTH 24
+//each level leaves at most 3 siblings on the stack, and the deepest level pushes 4
+#define __BC_INTERSECT_STACK_SIZE (3 * __BC_INTERSECT_MAX_DEPTH + 4)
+//intersections remembered for reporting each only once
+#define __BC_INTERSECT_RECENT 16
+//pairs checked together by BCCubicIntersectPairs
+#define __BC_INTERSECT_BATCH 64
+
+///A piece of each cubic, and the parameter range (start, end) of each piece on its original cubic.
+typedef struct {
+    BCCubic a;
+    BCCubic b;
+    bc_float2_t rangeA;
+    bc_float2_t rangeB;
+    int depth;
+} __BCCubicIntersectionTask;
+
+typedef struct {
+    bc_float2_t a;
+    bc_float2_t b;
+} __BCCubicIntersectionPoints;
+
+typedef int32_t __BCMask4 __attribute__((ext_vector_type(4)));
+
+static inline bc_float_t __bc_cross(bc_float2_t a, bc_float2_t b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+//Same test as __BCCubicIsFlatParametric in BCCubicFlatten.c.  Each point on the cubic is within tolerance of the chord point at the same parameter.
+static inline bool __BCCubicIntersectionIsFlat(BCCubic c, bc_float_t tolerance) {
+    const bc_float2_t u = 3 * c.c - 2 * c.a - c.b;
+    const bc_float2_t v = 3 * c.d - 2 * c.b - c.a;
+    const bc_float2_t m = bc_make_float2(bc_max(u.x * u.x, v.x * v.x), bc_max(u.y * u.y, v.y * v.y));
+    return m.x + m.y <= 16 * tolerance * tolerance;
+}
+
+/*
+ Closest points between segments p + s*dp and q + u*dq, for s and u in [0,1].  Returns the squared distance.
+ Segments that cross are 0 apart.  Otherwise, one of the closest points is an endpoint, so projecting each endpoint onto the other segment finds it.
+ */
+static inline bc_float_t __BCSegmentClosest(bc_float2_t p, bc_float2_t dp, bc_float2_t q, bc_float2_t dq, bc_float_t *s, bc_float_t *u) {
+    const bc_float2_t r = q - p;
+    const bc_float_t denominator = __bc_cross(dp, dq);
+    if (denominator != 0) {
+        const bc_float_t crossS = __bc_cross(r, dq) / denominator;
+        const bc_float_t crossU = __bc_cross(r, dp) / denominator;
+        if (crossS >= 0 && crossS <= 1 && crossU >= 0 && crossU <= 1) {
+            *s = crossS;
+            *u = crossU;
+            return 0;
+        }
+    }
+    const bc_float_t dpSquared = bc_dot(dp, dp);
+    const bc_float_t dqSquared = bc_dot(dq, dq);
+    //x/y as x*y/(y*y+epsilon), which is 0 for a 0-length segment
+    const bc_float_t candidateS[4] = {
+        0,
+        1,
+        bc_clamp(bc_dot(r, dp) * dpSquared / (dpSquared * dpSquared + 1e-30f), 0.0f, 1.0f),
+        bc_clamp(bc_dot(r + dq, dp) * dpSquared / (dpSquared * dpSquared + 1e-30f), 0.0f, 1.0f),
+    };
+    const bc_float_t candidateU[4] = {
+        bc_clamp(-bc_dot(r, dq) * dqSquared / (dqSquared * dqSquared + 1e-30f), 0.0f, 1.0f),
+        bc_clamp(bc_dot(dp - r, dq) * dqSquared / (dqSquared * dqSquared + 1e-30f), 0.0f, 1.0f),
+        0,
+        1,
+    };
+    bc_float_t best = BC_FLOAT_LARGE;
+    for (int i = 0; i < 4; i++) {
+        const bc_float_t d = bc_length_squared(p + candidateS[i] * dp - q - candidateU[i] * dq);
+        if (d < best) {
+            best = d;
+            *s = candidateS[i];
+            *u = candidateU[i];
+        }
+    }
+    return best;
+}
+
+/*
+ Newton's method on a(t1) - b(t2) = 0.  The jacobian is [a'(t1), -b'(t2)]; by Cramer's rule the step is
+     t1 -= cross(f, b') / cross(a', b')
+     t2 -= cross(f, a') / cross(a', b')
+ Steps stay within the ranges of the pieces that found the intersection, and are kept only while they bring the points closer.
+ Where the cubics are tangent, the jacobian is singular, and the chord estimate is kept.
+ */
+static inline void __BCCubicIntersectionRefine(BCCubic a, BCCubic b, bc_float2_t rangeA, bc_float2_t rangeB, bc_float_t *t1, bc_float_t *t2) {
+    bc_float2_t f = BCCubicEvaluate(a, *t1) - BCCubicEvaluate(b, *t2);
+    bc_float_t distanceSquared = bc_dot(f, f);
+    for (int i = 0; i < 3 && distanceSquared > 0; i++) {
+        const bc_float2_t primeA = BCCubicEvaluatePrime(a, *t1);
+        const bc_float2_t primeB = BCCubicEvaluatePrime(b, *t2);
+        const bc_float_t determinant = __bc_cross(primeA, primeB);
+        if (bc_abs(determinant) < 1e-12f) { return; }
+        const bc_float_t n1 = bc_clamp(*t1 - __bc_cross(f, primeB) / determinant, rangeA.x, rangeA.y);
+        const bc_float_t n2 = bc_clamp(*t2 - __bc_cross(f, primeA) / determinant, rangeB.x, rangeB.y);
+        const bc_float2_t nf = BCCubicEvaluate(a, n1) - BCCubicEvaluate(b, n2);
+        const bc_float_t nd = bc_dot(nf, nf);
+        if (nd >= distanceSquared) { return; }
+        *t1 = n1;
+        *t2 = n2;
+        f = nf;
+        distanceSquared = nd;
+    }
+}
+
+//bounds of the control points of both halves.  The result is (left.x, left.y, right.x, right.y).
+static inline void __BCCubic2Hulls(BCCubic2 c, bc_float4_t *min, bc_float4_t *max) {
+    *min = bc_vmin(bc_vmin(c.a, c.b), bc_vmin(c.c, c.d));
+    *max = bc_vmax(bc_vmax(c.a, c.b), bc_vmax(c.c, c.d));
+}
+
+//Finds intersections between a and b, whose boxes are already known to be close.
+static size_t __BCCubicIntersectPieces(BCCubic a, BCCubic b, bc_float_t tolerance, BCCubicIntersection *output, size_t capacity) {
+    __BCCubicIntersectionTask stack[__BC_INTERSECT_STACK_SIZE];
+    __BCCubicIntersectionPoints recent[__BC_INTERSECT_RECENT];
+    size_t count = 0;
+    int top = 0;
+    stack[0].a = a;
+    stack[0].b = b;
+    stack[0].rangeA = bc_make_float2(0, 1);
+    stack[0].rangeB = bc_make_float2(0, 1);
+    stack[0].depth = 0;
+    //chord error on both pieces is at most tolerance/4
+    const bc_float_t flatness = tolerance / 8;
+    const bc_float_t toleranceSquared = tolerance * tolerance;
+    while (top >= 0) {
+        const __BCCubicIntersectionTask task = stack[top];
+        top--;
+        if (task.depth == __BC_INTERSECT_MAX_DEPTH || (__BCCubicIntersectionIsFlat(task.a, flatness) && __BCCubicIntersectionIsFlat(task.b, flatness))) {
+            bc_float_t s, u;
+            if (__BCSegmentClosest(task.a.a, task.a.b - task.a.a, task.b.a, task.b.b - task.b.a, &s, &u) > toleranceSquared) {
+                continue;
+            }
+            bc_float_t t1 = task.rangeA.x + s * (task.rangeA.y - task.rangeA.x);
+            bc_float_t t2 = task.rangeB.x + u * (task.rangeB.y - task.rangeB.x);
+            __BCCubicIntersectionRefine(a, b, task.rangeA, task.rangeB, &t1, &t2);
+            __BCCubicIntersectionPoints points;
+            points.a = BCCubicEvaluate(a, t1);
+            points.b = BCCubicEvaluate(b, t2);
+            bool duplicate = false;
+            const size_t recentCount = count < __BC_INTERSECT_RECENT ? count : __BC_INTERSECT_RECENT;
+            for (size_t i = 0; i < recentCount; i++) {
+                if (bc_length_squared(recent[i].a - points.a) <= toleranceSquared && bc_length_squared(recent[i].b - points.b) <= toleranceSquared) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (duplicate) { continue; }
+            recent[count % __BC_INTERSECT_RECENT] = points;
+            if (count < capacity) {
+                output[count].t1 = t1;
+                output[count].t2 = t2;
+            }
+            count++;
+            continue;
+        }
+        const BCCubic2 halvesA = BCCubicSplit(task.a, 0.5);
+        const BCCubic2 halvesB = BCCubicSplit(task.b, 0.5);
+        bc_float4_t minA, maxA, minB, maxB;
+        __BCCubic2Hulls(halvesA, &minA, &maxA);
+        __BCCubic2Hulls(halvesB, &minB, &maxB);
+        //lane i pairs half i/2 of a with half i%2 of b
+        const bc_float4_t slack = tolerance;
+        const __BCMask4 overlaps = (minA.xxzz <= maxB.xzxz + slack) & (minB.xzxz <= maxA.xxzz + slack) & (minA.yyww <= maxB.ywyw + slack) & (minB.ywyw <= maxA.yyww + slack);
+        const BCCubic piecesA[2] = {BCCubic2SeparateLeft(halvesA), BCCubic2SeparateRight(halvesA)};
+        const BCCubic piecesB[2] = {BCCubic2SeparateLeft(halvesB), BCCubic2SeparateRight(halvesB)};
+        const bc_float_t middleA = (task.rangeA.x + task.rangeA.y) / 2;
+        const bc_float_t middleB = (task.rangeB.x + task.rangeB.y) / 2;
+        const bc_float2_t rangesA[2] = {bc_make_float2(task.rangeA.x, middleA), bc_make_float2(middleA, task.rangeA.y)};
+        const bc_float2_t rangesB[2] = {bc_make_float2(task.rangeB.x, middleB), bc_make_float2(middleB, task.rangeB.y)};
+        //push in reverse, so the first half of a is searched first
+        for (int i = 3; i >= 0; i--) {
+            if (!overlaps[i]) { continue; }
+            top++;
+            stack[top].a = piecesA[i >> 1];
+            stack[top].b = piecesB[i & 1];
+            stack[top].rangeA = rangesA[i >> 1];
+            stack[top].rangeB = rangesB[i & 1];
+            stack[top].depth = task.depth + 1;
+        }
+    }
+    return count;
+}
+
+static inline bool __BCAlignedRectsWithinDistance(BCAlignedRect a, BCAlignedRect b, bc_float_t distance) {
+    return a.min.x <= b.max.x + distance && b.min.x <= a.max.x + distance && a.min.y <= b.max.y + distance && b.min.y <= a.max.y + distance;
+}
+
+size_t BCCubicIntersect(BCCubic a, BCCubic b, bc_float_t tolerance, BCCubicIntersection *output, size_t capacity) {
+    __BC_ASSERT(tolerance > 0, 0);
+    if (!__BCAlignedRectsWithinDistance(BCAlignedRectCreateFromCubic(a, BCStrategyAccurate), BCAlignedRectCreateFromCubic(b, BCStrategyAccurate), tolerance)) {
+        return 0;
+    }
+    return __BCCubicIntersectPieces(a, b, tolerance, output, capacity);
+}
+
+size_t BCCubicIntersectPairs(const BCCubic *cubics, const BCRectPair *pairs, size_t count, bc_float_t tolerance, BCCubicIntersection *output, uint32_t *outputPairs, size_t capacity) {
+    __BC_ASSERT(tolerance > 0, 0);
+    BCCubic cubicsA[__BC_INTERSECT_BATCH];
+    BCCubic cubicsB[__BC_INTERSECT_BATCH];
+    BCAlignedRect rectsA[__BC_INTERSECT_BATCH];
+    BCAlignedRect rectsB[__BC_INTERSECT_BATCH];
+    size_t total = 0;
+    for (size_t start = 0; start < count; start += __BC_INTERSECT_BATCH) {
+        const size_t n = count - start < __BC_INTERSECT_BATCH ? count - start : __BC_INTERSECT_BATCH;
+        for (size_t i = 0; i < n; i++) {
+            cubicsA[i] = cubics[pairs[start + i].a];
+            cubicsB[i] = cubics[pairs[start + i].b];
+        }
+        BCAlignedRectCreateFromCubicBatch(cubicsA, n, BCStrategyAccurate, rectsA);
+        BCAlignedRectCreateFromCubicBatch(cubicsB, n, BCStrategyAccurate, rectsB);
+        for (size_t i = 0; i < n; i++) {
+            if (!__BCAlignedRectsWithinDistance(rectsA[i], rectsB[i], tolerance)) { continue; }
+            const size_t available = total < capacity ? capacity - total : 0;
+            const size_t found = __BCCubicIntersectPieces(cubicsA[i], cubicsB[i], tolerance, available ? output + total : output, available);
+            const size_t written = found < available ? found : available;
+            for (size_t j = 0; j < written; j++) {
+                outputPairs[total + j] = (uint32_t) (start + i);
+            }
+            total += found;
+        }
+    }
+    return total;
+}
+
+/*
+ Lines and cubics.  In the line's frame, with d = line.b - line.a, a cubic point p has
+     y = cross(d, p - line.a)          which is 0 on the line
+     x = dot(d, p - line.a) / dot(d,d) which is the line's parameter
+ Both are linear in p, so they are cubics in t whose control values are those of the control points.
+ Roots of y in [0,1] are intersections, and x at each root is where it is on the line.
+ */
+
+//Newton steps per monotonic piece.  Newton converges quadratically within a bracket where the polynomial is monotonic, and each step that leaves the bracket bisects instead.
+#define __BC_LINE_ROOT_ITERATIONS 16
+
+//Power basis coefficients of the cubic with control values p0 (a), p1 (c), p2 (d), p3 (b).  For scalars or lanes.
+#define __BC_POWER_BASIS(P0, P1, P2, P3, A, B, C, D) do { \
+    A = (P3) - (P0) + 3 * ((P1) - (P2)); \
+    B = 3 * ((P0) - 2 * (P1) + (P2)); \
+    C = 3 * ((P1) - (P0)); \
+    D = (P0); \
+} while (0)
+
+/*
+ Splits [0,1] at the roots of the derivative 3a t² + 2b t + c, in increasing order.
+ Like the accurate strategy of BCAlignedRectCreateFromCubic, both quadratic roots and the linear root are found with regularized division, so there are no branches.
+ Whichever of these are not roots are extra splits, which leave every piece monotonic.
+ */
+static inline void __BCCubicPolynomialBreaks(bc_float_t a, bc_float_t b, bc_float_t c, bc_float_t breaks[5]) {
+    const bc_float_t qa = 3 * a;
+    const bc_float_t qb = 2 * b;
+    const bc_float_t root = bc_sqrt(bc_max(qb * qb - 4 * qa * c, 0.0f));
+    const bc_float_t scale = qa / (2 * qa * qa + 1e-30f);
+    const bc_float_t c0 = bc_clamp((-qb + root) * scale, 0.0f, 1.0f);
+    const bc_float_t c1 = bc_clamp((-qb - root) * scale, 0.0f, 1.0f);
+    const bc_float_t c2 = bc_clamp(-c * qb / (qb * qb + 1e-30f), 0.0f, 1.0f);
+    const bc_float_t low = bc_min(c0, c1);
+    const bc_float_t high = bc_max(c0, c1);
+    const bc_float_t middle = bc_max(low, c2);
+    breaks[0] = 0;
+    breaks[1] = bc_min(low, c2);
+    breaks[2] = bc_min(middle, high);
+    breaks[3] = bc_max(middle, high);
+    breaks[4] = 1;
+}
+
+static inline void __BCCubicPolynomialBreaks8(bc_float8_t a, bc_float8_t b, bc_float8_t c, bc_float8_t breaks[5]) {
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    const bc_float8_t qa = 3 * a;
+    const bc_float8_t qb = 2 * b;
+    const bc_float8_t root = bc_vsqrt(bc_vmax(qb * qb - 4 * qa * c, zero));
+    const bc_float8_t scale = qa / (2 * qa * qa + 1e-30f);
+    const bc_float8_t c0 = bc_vmax(bc_vmin((-qb + root) * scale, one), zero);
+    const bc_float8_t c1 = bc_vmax(bc_vmin((-qb - root) * scale, one), zero);
+    const bc_float8_t c2 = bc_vmax(bc_vmin(-c * qb / (qb * qb + 1e-30f), one), zero);
+    const bc_float8_t low = bc_vmin(c0, c1);
+    const bc_float8_t high = bc_vmax(c0, c1);
+    const bc_float8_t middle = bc_vmax(low, c2);
+    breaks[0] = zero;
+    breaks[1] = bc_vmin(low, c2);
+    breaks[2] = bc_vmin(middle, high);
+    breaks[3] = bc_vmax(middle, high);
+    breaks[4] = one;
+}
+
+/*
+ Roots in [0,1] of a*t³ + b*t² + c*t + d, in increasing order.  Returns the number of roots, at most 3.
+ Each monotonic piece has a root if the signs at its ends differ, or one of them is 0.
+ A root on a break is found by both pieces that share it, and reported once.
+ */
+static inline size_t __BCCubicPolynomialRoots(bc_float_t a, bc_float_t b, bc_float_t c, bc_float_t d, bc_float_t roots[3]) {
+    bc_float_t breaks[5];
+    __BCCubicPolynomialBreaks(a, b, c, breaks);
+    size_t count = 0;
+    for (int i = 0; i < 4 && count < 3; i++) {
+        bc_float_t lo = breaks[i];
+        bc_float_t hi = breaks[i + 1];
+        const bc_float_t fLo = __BC_POLYNOMIAL(a, b, c, d, lo);
+        const bc_float_t fHi = __BC_POLYNOMIAL(a, b, c, d, hi);
+        bc_float_t x;
+        if (fLo == 0) { x = lo; }
+        else if (fHi == 0) { x = hi; }
+        else if ((fLo < 0) == (fHi < 0)) { continue; }
+        else {
+            //start from the secant
+            x = lo - fLo * (hi - lo) / (fHi - fLo);
+            for (int k = 0; k < __BC_LINE_ROOT_ITERATIONS; k++) {
+                const bc_float_t fx = __BC_POLYNOMIAL(a, b, c, d, x);
+                if ((fx < 0) == (fLo < 0)) { lo = x; }
+                else { hi = x; }
+                const bc_float_t newton = x - fx / __BC_POLYNOMIAL_PRIME(a, b, c, x);
+                if (fx == 0 || newton == x) { break; }
+                x = (newton > lo && newton < hi) ? newton : (lo + hi) / 2;
+            }
+        }
+        if (count > 0 && roots[count - 1] == x) { continue; }
+        roots[count++] = x;
+    }
+    return count;
+}
+
+/*
+ __BCCubicPolynomialRoots for 8 lanes, with the same arithmetic.  roots[i] is the root in piece i, where found[i] is set.
+ Lanes take every step; a lane that has converged stays put, so the results match the scalar version, which stops early.
+ */
+static inline void __BCCubicPolynomialRoots8(bc_float8_t a, bc_float8_t b, bc_float8_t c, bc_float8_t d, bc_float8_t roots[4], __BCMask8 found[4]) {
+    const bc_float8_t zero = 0;
+    bc_float8_t breaks[5];
+    __BCCubicPolynomialBreaks8(a, b, c, breaks);
+    bc_float8_t last = zero;
+    __BCMask8 hasLast = 0;
+    for (int i = 0; i < 4; i++) {
+        bc_float8_t lo = breaks[i];
+        bc_float8_t hi = breaks[i + 1];
+        const bc_float8_t fLo = __BC_POLYNOMIAL(a, b, c, d, lo);
+        const bc_float8_t fHi = __BC_POLYNOMIAL(a, b, c, d, hi);
+        const __BCMask8 loNegative = fLo < zero;
+        const __BCMask8 zeroLo = fLo == zero;
+        const __BCMask8 zeroHi = fHi == zero;
+        const __BCMask8 crossing = loNegative ^ (fHi < zero);
+        bc_float8_t x = lo - fLo * (hi - lo) / (fHi - fLo);
+        __BCMask8 done = zeroLo | zeroHi | ~crossing;
+        for (int k = 0; k < __BC_LINE_ROOT_ITERATIONS && !__BCMask8All(done); k++) {
+            const bc_float8_t fx = __BC_POLYNOMIAL(a, b, c, d, x);
+            const __BCMask8 sameAsLo = (fx < zero) == loNegative;
+            lo = __BCMask8Select(sameAsLo & ~done, x, lo);
+            hi = __BCMask8Select(~sameAsLo & ~done, x, hi);
+            const bc_float8_t newton = x - fx / __BC_POLYNOMIAL_PRIME(a, b, c, x);
+            done |= (fx == zero) | (newton == x);
+            const bc_float8_t next = __BCMask8Select((newton > lo) & (newton < hi), newton, (lo + hi) / 2);
+            x = __BCMask8Select(done, x, next);
+        }
+        x = __BCMask8Select(zeroHi, breaks[i + 1], x);
+        x = __BCMask8Select(zeroLo, breaks[i], x);
+        const __BCMask8 root = (zeroLo | zeroHi | crossing) & ~(hasLast & (x == last));
+        last = __BCMask8Select(root, x, last);
+        hasLast |= root;
+        roots[i] = x;
+        found[i] = root;
+    }
+}
+
+//Writes the intersections of one line and one cubic, as control values in the line's frame
+static inline size_t __BCLineCubicIntersectionsFromFrame(const bc_float_t y[4], const bc_float_t x[4], BCLineExtent extent, BCLineCubicIntersection output[3]) {
+    //the cubic is in the hull of its control points, so it misses the line when they are all on one side
+    if (bc_min(bc_min(y[0], y[1]), bc_min(y[2], y[3])) > 0 || bc_max(bc_max(y[0], y[1]), bc_max(y[2], y[3])) < 0) { return 0; }
+    bc_float_t a, b, c, d;
+    __BC_POWER_BASIS(y[0], y[1], y[2], y[3], a, b, c, d);
+    bc_float_t xa, xb, xc, xd;
+    __BC_POWER_BASIS(x[0], x[1], x[2], x[3], xa, xb, xc, xd);
+    bc_float_t roots[3];
+    const size_t rootCount = __BCCubicPolynomialRoots(a, b, c, d, roots);
+    size_t count = 0;
+    for (size_t i = 0; i < rootCount; i++) {
+        const bc_float_t s = __BC_POLYNOMIAL(xa, xb, xc, xd, roots[i]);
+        if (s >= 0 && (extent == BCLineExtentRay || s <= 1)) {
+            output[count].lineT = s;
+            output[count].cubicT = roots[i];
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t BCLineIntersectCubic(BCLine line, BCLineExtent extent, BCCubic cubic, BCLineCubicIntersection *output) {
+    const bc_float2_t direction = line.b - line.a;
+    const bc_float_t inverseLengthSquared = 1 / bc_dot(direction, direction);
+    const bc_float2_t points[4] = {cubic.a - line.a, cubic.c - line.a, cubic.d - line.a, cubic.b - line.a};
+    bc_float_t y[4], x[4];
+    for (int i = 0; i < 4; i++) {
+        y[i] = direction.x * points[i].y - direction.y * points[i].x;
+        x[i] = (direction.x * points[i].x + direction.y * points[i].y) * inverseLengthSquared;
+    }
+    return __BCLineCubicIntersectionsFromFrame(y, x, extent, output);
+}
+
+/*
+ Solves 8 lanes, given the control values of each in its line's frame, and appends hits for the first n lanes.
+ Lane i is reported as index first + i.
+ */
+static inline size_t __BCLineCubicIntersections8(const bc_float8_t y[4], const bc_float8_t x[4], BCLineExtent extent, size_t n, uint32_t first, BCLineCubicIntersection *output, uint32_t *outputIndices, size_t total, size_t capacity) {
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    //lanes whose control points are all on one side miss, as in the scalar version
+    const __BCMask8 miss = (bc_vmin(bc_vmin(y[0], y[1]), bc_vmin(y[2], y[3])) > zero) | (bc_vmax(bc_vmax(y[0], y[1]), bc_vmax(y[2], y[3])) < zero);
+    if (__BCMask8All(miss)) { return total; }
+    bc_float8_t a, b, c, d;
+    __BC_POWER_BASIS(y[0], y[1], y[2], y[3], a, b, c, d);
+    bc_float8_t xa, xb, xc, xd;
+    __BC_POWER_BASIS(x[0], x[1], x[2], x[3], xa, xb, xc, xd);
+    bc_float8_t roots[4];
+    __BCMask8 found[4];
+    __BCCubicPolynomialRoots8(a, b, c, d, roots, found);
+    bc_float_t laneRoots[4][8];
+    bc_float_t laneS[4][8];
+    int32_t laneFound[4][8];
+    int32_t laneHits[4][8];
+    for (int i = 0; i < 4; i++) {
+        const bc_float8_t s = __BC_POLYNOMIAL(xa, xb, xc, xd, roots[i]);
+        __BCMask8 hit = found[i] & ~miss & (s >= zero);
+        if (extent != BCLineExtentRay) { hit &= s <= one; }
+        memcpy(laneRoots[i], &roots[i], sizeof(laneRoots[i]));
+        memcpy(laneS[i], &s, sizeof(laneS[i]));
+        memcpy(laneFound[i], &found[i], sizeof(laneFound[i]));
+        memcpy(laneHits[i], &hit, sizeof(laneHits[i]));
+    }
+    for (size_t lane = 0; lane < n; lane++) {
+        //a polynomial that is 0 everywhere has a root on every break; keep 3, as the scalar version does
+        int roots = 0;
+        for (int i = 0; i < 4; i++) {
+            if (!laneFound[i][lane] || roots == 3) { continue; }
+            roots++;
+            if (!laneHits[i][lane]) { continue; }
+            if (total < capacity) {
+                output[total].lineT = laneS[i][lane];
+                output[total].cubicT = laneRoots[i][lane];
+                outputIndices[total] = first + (uint32_t) lane;
+            }
+            total++;
+        }
+    }
+    return total;
+}
+
+size_t BCLineIntersectCubics(BCLine line, BCLineExtent extent, const BCCubic *cubics, size_t count, BCLineCubicIntersection *output, uint32_t *outputCubics, size_t capacity) {
+    const bc_float2_t direction = line.b - line.a;
+    const bc_float_t inverseLengthSquared = 1 / bc_dot(direction, direction);
+    size_t total = 0;
+    for (size_t start = 0; start < count; start += 8) {
+        const size_t n = count - start < 8 ? count - start : 8;
+        //control points a, c, d, b in each lane, relative to line.a.  Unused lanes are 0.
+        bc_float_t px[4][8] = {{0}};
+        bc_float_t py[4][8] = {{0}};
+        for (size_t lane = 0; lane < n; lane++) {
+            const BCCubic cubic = cubics[start + lane];
+            const bc_float2_t points[4] = {cubic.a - line.a, cubic.c - line.a, cubic.d - line.a, cubic.b - line.a};
+            for (int i = 0; i < 4; i++) {
+                px[i][lane] = points[i].x;
+                py[i][lane] = points[i].y;
+            }
+        }
+        bc_float8_t y[4], x[4];
+        for (int i = 0; i < 4; i++) {
+            bc_float8_t laneX, laneY;
+            memcpy(&laneX, px[i], sizeof(laneX));
+            memcpy(&laneY, py[i], sizeof(laneY));
+            y[i] = direction.x * laneY - direction.y * laneX;
+            x[i] = (direction.x * laneX + direction.y * laneY) * inverseLengthSquared;
+        }
+        total = __BCLineCubicIntersections8(y, x, extent, n, (uint32_t) start, output, outputCubics, total, capacity);
+    }
+    return total;
+}
+
+size_t BCLinesIntersectCubic(const BCLine *lines, size_t count, BCLineExtent extent, BCCubic cubic, BCLineCubicIntersection *output, uint32_t *outputLines, size_t capacity) {
+    const bc_float2_t controls[4] = {cubic.a, cubic.c, cubic.d, cubic.b};
+    size_t total = 0;
+    for (size_t start = 0; start < count; start += 8) {
+        const size_t n = count - start < 8 ? count - start : 8;
+        //line.a and direction in each lane.  Unused lanes are 0-length lines, which intersect nothing.
+        bc_float_t ax[8] = {0}, ay[8] = {0}, dx[8] = {0}, dy[8] = {0};
+        for (size_t lane = 0; lane < n; lane++) {
+            const BCLine line = lines[start + lane];
+            ax[lane] = line.a.x;
+            ay[lane] = line.a.y;
+            dx[lane] = line.b.x - line.a.x;
+            dy[lane] = line.b.y - line.a.y;
+        }
+        bc_float8_t originX, originY, directionX, directionY;
+        memcpy(&originX, ax, sizeof(originX));
+        memcpy(&originY, ay, sizeof(originY));
+        memcpy(&directionX, dx, sizeof(directionX));
+        memcpy(&directionY, dy, sizeof(directionY));
+        const bc_float8_t inverseLengthSquared = 1 / (directionX * directionX + directionY * directionY);
+        bc_float8_t y[4], x[4];
+        for (int i = 0; i < 4; i++) {
+            const bc_float8_t pointX = controls[i].x - originX;
+            const bc_float8_t pointY = controls[i].y - originY;
+            y[i] = directionX * pointY - directionY * pointX;
+            x[i] = (directionX * pointX + directionY * pointY) * inverseLengthSquared;
+        }
+        total = __BCLineCubicIntersections8(y, x, extent, n, (uint32_t) start, output, outputLines, total, capacity);
+    }
+    return total;
+}
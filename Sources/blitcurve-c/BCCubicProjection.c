@@ -0,0 +1,256 @@
+//BCCubicProjection.c: Nearest points on BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubicProjection.h"
+#include "BCAlignedRect.h"
+#include "BCMetalC.h"
+#include "BCMacros.h"
+#include "BCLanes8.h"
+#include "BCTrap.h"
+#include <string.h>
+
+#define __BC_PROJECT_SAMPLES 16
+#define __BC_PROJECT_ITERATIONS 4
+
+/*
+ The cubic as a3 t³ + a2 t² + a1 t + a0.  Its derivatives are
+     B'(t)  = 3 a3 t² + 2 a2 t + a1
+     B''(t) = 6 a3 t + 2 a2
+ The same expressions are used for scalars and lanes, so both find the same results.
+ */
+typedef struct {
+    bc_float2_t a3;
+    bc_float2_t a2;
+    bc_float2_t a1;
+    bc_float2_t a0;
+} __BCCubicPowerBasis;
+
+
+static inline __BCCubicPowerBasis __BCCubicPowerBasisMake(BCCubic c) {
+    __BCCubicPowerBasis p;
+    p.a3 = c.b - c.a + 3 * (c.c - c.d);
+    p.a2 = 3 * (c.a - 2 * c.c + c.d);
+    p.a1 = 3 * (c.c - c.a);
+    p.a0 = c.a;
+    return p;
+}
+
+//16 evenly spaced points on the cubic, in one pass per axis
+static inline void __BCCubicProjectionSamples(__BCCubicPowerBasis p, bc_float_t x[__BC_PROJECT_SAMPLES], bc_float_t y[__BC_PROJECT_SAMPLES]) {
+    const bc_float16_t t = (bc_float16_t){0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15} / (__BC_PROJECT_SAMPLES - 1);
+    const bc_float16_t sampleX = __BC_POLYNOMIAL(p.a3.x, p.a2.x, p.a1.x, p.a0.x, t);
+    const bc_float16_t sampleY = __BC_POLYNOMIAL(p.a3.y, p.a2.y, p.a1.y, p.a0.y, t);
+    memcpy(x, &sampleX, sizeof(sampleX));
+    memcpy(y, &sampleY, sizeof(sampleY));
+}
+
+/*
+ Newton's method on g(t) = dot(B(t) - point, B'(t)), which is 0 where the distance has a minimum, with
+     g'(t) = dot(B'(t), B'(t)) + dot(B(t) - point, B''(t))
+ Where g' is not positive, the distance is not convex, and Newton would head for a maximum, so t stays put.
+ */
+static inline BCCubicProjection __BCCubicProjectFromSeed(__BCCubicPowerBasis p, bc_float2_t point, bc_float_t seed, bc_float_t seedDistanceSquared) {
+    const bc_float_t spacing = 1.0f / (__BC_PROJECT_SAMPLES - 1);
+    const bc_float_t lo = bc_max(seed - spacing, 0.0f);
+    const bc_float_t hi = bc_min(seed + spacing, 1.0f);
+    bc_float_t t = seed;
+    for (int i = 0; i < __BC_PROJECT_ITERATIONS; i++) {
+        const bc_float2_t r = __BC_POLYNOMIAL(p.a3, p.a2, p.a1, p.a0, t) - point;
+        const bc_float2_t prime = __BC_POLYNOMIAL_PRIME(p.a3, p.a2, p.a1, t);
+        const bc_float2_t second = __BC_POLYNOMIAL_SECOND(p.a3, p.a2, t);
+        const bc_float_t g = r.x * prime.x + r.y * prime.y;
+        const bc_float_t gPrime = prime.x * prime.x + prime.y * prime.y + r.x * second.x + r.y * second.y;
+        if (gPrime > 0) {
+            t = bc_clamp(t - g / gPrime, lo, hi);
+        }
+    }
+    const bc_float2_t nearest = __BC_POLYNOMIAL(p.a3, p.a2, p.a1, p.a0, t);
+    const bc_float2_t r = nearest - point;
+    const bc_float_t distanceSquared = r.x * r.x + r.y * r.y;
+    BCCubicProjection out;
+    if (distanceSquared <= seedDistanceSquared) {
+        out.t = t;
+        out.point = nearest;
+        out.distance = bc_sqrt(distanceSquared);
+    }
+    else {
+        out.t = seed;
+        out.point = __BC_POLYNOMIAL(p.a3, p.a2, p.a1, p.a0, seed);
+        out.distance = bc_sqrt(seedDistanceSquared);
+    }
+    return out;
+}
+
+static inline BCCubicProjection __BCCubicProjectBasis(__BCCubicPowerBasis p, const bc_float_t sampleX[__BC_PROJECT_SAMPLES], const bc_float_t sampleY[__BC_PROJECT_SAMPLES], bc_float2_t point) {
+    bc_float_t bestDistanceSquared = BC_FLOAT_LARGE;
+    int best = 0;
+    for (int k = 0; k < __BC_PROJECT_SAMPLES; k++) {
+        const bc_float_t dx = sampleX[k] - point.x;
+        const bc_float_t dy = sampleY[k] - point.y;
+        const bc_float_t d = dx * dx + dy * dy;
+        if (d < bestDistanceSquared) {
+            bestDistanceSquared = d;
+            best = k;
+        }
+    }
+    return __BCCubicProjectFromSeed(p, point, (bc_float_t) best / (__BC_PROJECT_SAMPLES - 1), bestDistanceSquared);
+}
+
+BCCubicProjection BCCubicProject(BCCubic cubic, bc_float2_t point) {
+    const __BCCubicPowerBasis p = __BCCubicPowerBasisMake(cubic);
+    bc_float_t sampleX[__BC_PROJECT_SAMPLES];
+    bc_float_t sampleY[__BC_PROJECT_SAMPLES];
+    __BCCubicProjectionSamples(p, sampleX, sampleY);
+    return __BCCubicProjectBasis(p, sampleX, sampleY, point);
+}
+
+
+//the power basis of 8 cubics, one per lane
+typedef struct {
+    bc_float8_t a3x, a3y;
+    bc_float8_t a2x, a2y;
+    bc_float8_t a1x, a1y;
+    bc_float8_t a0x, a0y;
+} __BCCubicPowerBasis8;
+
+//__BCCubicProjectFromSeed for 8 lanes, with the same arithmetic.  Only the first \c n lanes are written.
+static inline void __BCCubicProjectFromSeed8(__BCCubicPowerBasis8 p, bc_float8_t px, bc_float8_t py, bc_float8_t seed, bc_float8_t bestDistanceSquared, size_t n, BCCubicProjection *output) {
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    const bc_float_t spacing = 1.0f / (__BC_PROJECT_SAMPLES - 1);
+    const bc_float8_t lo = bc_vmax(seed - spacing, zero);
+    const bc_float8_t hi = bc_vmin(seed + spacing, one);
+    bc_float8_t t = seed;
+    for (int i = 0; i < __BC_PROJECT_ITERATIONS; i++) {
+        const bc_float8_t rx = __BC_POLYNOMIAL(p.a3x, p.a2x, p.a1x, p.a0x, t) - px;
+        const bc_float8_t ry = __BC_POLYNOMIAL(p.a3y, p.a2y, p.a1y, p.a0y, t) - py;
+        const bc_float8_t primeX = __BC_POLYNOMIAL_PRIME(p.a3x, p.a2x, p.a1x, t);
+        const bc_float8_t primeY = __BC_POLYNOMIAL_PRIME(p.a3y, p.a2y, p.a1y, t);
+        const bc_float8_t secondX = __BC_POLYNOMIAL_SECOND(p.a3x, p.a2x, t);
+        const bc_float8_t secondY = __BC_POLYNOMIAL_SECOND(p.a3y, p.a2y, t);
+        const bc_float8_t g = rx * primeX + ry * primeY;
+        const bc_float8_t gPrime = primeX * primeX + primeY * primeY + rx * secondX + ry * secondY;
+        const bc_float8_t next = bc_vmin(bc_vmax(t - g / gPrime, lo), hi);
+        t = __BCMask8Select(gPrime > zero, next, t);
+    }
+    const bc_float8_t rx = __BC_POLYNOMIAL(p.a3x, p.a2x, p.a1x, p.a0x, t) - px;
+    const bc_float8_t ry = __BC_POLYNOMIAL(p.a3y, p.a2y, p.a1y, p.a0y, t) - py;
+    const bc_float8_t distanceSquared = rx * rx + ry * ry;
+    const __BCMask8 improved = distanceSquared <= bestDistanceSquared;
+    t = __BCMask8Select(improved, t, seed);
+    const bc_float8_t nearestX = __BC_POLYNOMIAL(p.a3x, p.a2x, p.a1x, p.a0x, t);
+    const bc_float8_t nearestY = __BC_POLYNOMIAL(p.a3y, p.a2y, p.a1y, p.a0y, t);
+    const bc_float8_t distance = bc_vsqrt(__BCMask8Select(improved, distanceSquared, bestDistanceSquared));
+    bc_float_t outT[8], outX[8], outY[8], outDistance[8];
+    memcpy(outT, &t, sizeof(outT));
+    memcpy(outX, &nearestX, sizeof(outX));
+    memcpy(outY, &nearestY, sizeof(outY));
+    memcpy(outDistance, &distance, sizeof(outDistance));
+    for (size_t lane = 0; lane < n; lane++) {
+        output[lane].point = bc_make_float2(outX[lane], outY[lane]);
+        output[lane].t = outT[lane];
+        output[lane].distance = outDistance[lane];
+    }
+}
+
+//__BCCubicProjectBasis for 8 points, one per lane, with the same arithmetic
+static inline void __BCCubicProjectBasis8(__BCCubicPowerBasis p, const bc_float_t sampleX[__BC_PROJECT_SAMPLES], const bc_float_t sampleY[__BC_PROJECT_SAMPLES], const bc_float2_t *points, size_t n, BCCubicProjection *output) {
+    bc_float_t laneX[8] = {0}, laneY[8] = {0};
+    for (size_t lane = 0; lane < n; lane++) {
+        laneX[lane] = points[lane].x;
+        laneY[lane] = points[lane].y;
+    }
+    bc_float8_t px, py;
+    memcpy(&px, laneX, sizeof(px));
+    memcpy(&py, laneY, sizeof(py));
+    bc_float8_t bestDistanceSquared = BC_FLOAT_LARGE;
+    bc_float8_t seed = 0;
+    for (int k = 0; k < __BC_PROJECT_SAMPLES; k++) {
+        const bc_float8_t dx = sampleX[k] - px;
+        const bc_float8_t dy = sampleY[k] - py;
+        const bc_float8_t d = dx * dx + dy * dy;
+        const __BCMask8 closer = d < bestDistanceSquared;
+        bestDistanceSquared = __BCMask8Select(closer, d, bestDistanceSquared);
+        seed = __BCMask8Select(closer, (bc_float8_t) ((bc_float_t) k / (__BC_PROJECT_SAMPLES - 1)), seed);
+    }
+    __BCCubicPowerBasis8 p8;
+    p8.a3x = p.a3.x; p8.a3y = p.a3.y;
+    p8.a2x = p.a2.x; p8.a2y = p.a2.y;
+    p8.a1x = p.a1.x; p8.a1y = p.a1.y;
+    p8.a0x = p.a0.x; p8.a0y = p.a0.y;
+    __BCCubicProjectFromSeed8(p8, px, py, seed, bestDistanceSquared, n, output);
+}
+
+//__BCCubicProjectBasis for 8 cubics, one per lane, with the same arithmetic
+static inline void __BCCubicProjectCubics8(const BCCubic *cubics, size_t n, bc_float2_t point, BCCubicProjection *output) {
+    //a partial group repeats its last cubic, so every lane is a real cubic
+    BCCubic group[8];
+    for (size_t lane = 0; lane < 8; lane++) { group[lane] = cubics[lane < n ? lane : n - 1]; }
+    const __BCCubicLanes8 l = __BCCubicLanes8LoadCubics(group);
+    __BCCubicPowerBasis8 p;
+    p.a3x = l.b_x - l.a_x + 3 * (l.c_x - l.d_x);
+    p.a3y = l.b_y - l.a_y + 3 * (l.c_y - l.d_y);
+    p.a2x = 3 * (l.a_x - 2 * l.c_x + l.d_x);
+    p.a2y = 3 * (l.a_y - 2 * l.c_y + l.d_y);
+    p.a1x = 3 * (l.c_x - l.a_x);
+    p.a1y = 3 * (l.c_y - l.a_y);
+    p.a0x = l.a_x;
+    p.a0y = l.a_y;
+    const bc_float8_t px = point.x;
+    const bc_float8_t py = point.y;
+    bc_float8_t bestDistanceSquared = BC_FLOAT_LARGE;
+    bc_float8_t seed = 0;
+    for (int k = 0; k < __BC_PROJECT_SAMPLES; k++) {
+        const bc_float_t t = (bc_float_t) k / (__BC_PROJECT_SAMPLES - 1);
+        const bc_float8_t dx = __BC_POLYNOMIAL(p.a3x, p.a2x, p.a1x, p.a0x, t) - px;
+        const bc_float8_t dy = __BC_POLYNOMIAL(p.a3y, p.a2y, p.a1y, p.a0y, t) - py;
+        const bc_float8_t d = dx * dx + dy * dy;
+        const __BCMask8 closer = d < bestDistanceSquared;
+        bestDistanceSquared = __BCMask8Select(closer, d, bestDistanceSquared);
+        seed = __BCMask8Select(closer, (bc_float8_t) t, seed);
+    }
+    __BCCubicProjectFromSeed8(p, px, py, seed, bestDistanceSquared, n, output);
+}
+
+void BCCubicProjectPoints(BCCubic cubic, const bc_float2_t *points, size_t count, BCCubicProjection *output) {
+    __BC_ASSERT_CUSTOM(points != NULL || count == 0, return);
+    __BC_ASSERT_CUSTOM(output != NULL || count == 0, return);
+    const __BCCubicPowerBasis p = __BCCubicPowerBasisMake(cubic);
+    bc_float_t sampleX[__BC_PROJECT_SAMPLES];
+    bc_float_t sampleY[__BC_PROJECT_SAMPLES];
+    __BCCubicProjectionSamples(p, sampleX, sampleY);
+    for (size_t start = 0; start < count; start += 8) {
+        const size_t n = count - start < 8 ? count - start : 8;
+        __BCCubicProjectBasis8(p, sampleX, sampleY, points + start, n, output + start);
+    }
+}
+
+void BCCubicProjectCubics(const BCCubic *cubics, size_t count, bc_float2_t point, BCCubicProjection *output) {
+    __BC_ASSERT_CUSTOM(cubics != NULL || count == 0, return);
+    __BC_ASSERT_CUSTOM(output != NULL || count == 0, return);
+    for (size_t start = 0; start < count; start += 8) {
+        const size_t n = count - start < 8 ? count - start : 8;
+        __BCCubicProjectCubics8(cubics + start, n, point, output + start);
+    }
+}
+
+size_t BCCubicNearest(const BCCubic *cubics, size_t count, bc_float2_t point, bc_float_t maxDistance, BCCubicProjection *output) {
+    __BC_ASSERT(cubics != NULL || count == 0, count);
+    __BC_ASSERT(output != NULL, count);
+    size_t nearest = count;
+    bc_float_t bound = maxDistance;
+    for (size_t i = 0; i < count; i++) {
+        //the distance to the box is at most the distance to the cubic
+        const BCAlignedRect box = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest);
+        const bc_float_t dx = bc_max(bc_max(box.min.x - point.x, point.x - box.max.x), 0.0f);
+        const bc_float_t dy = bc_max(bc_max(box.min.y - point.y, point.y - box.max.y), 0.0f);
+        if (dx * dx + dy * dy > bound * bound) { continue; }
+        const BCCubicProjection projection = BCCubicProject(cubics[i], point);
+        if (projection.distance <= bound && (nearest == count || projection.distance < output->distance)) {
+            *output = projection;
+            nearest = i;
+            bound = projection.distance;
+        }
+    }
+    return nearest;
+}
@@ -0,0 +1,135 @@
+//BCCubicStroke.c: Stroke tessellation of BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCCubicStroke.h"
+#include "BCMetalC.h"
+#include "BCLanes8.h"
+#include "BCTrap.h"
+#include <string.h>
+
+/*
+ Unit normal, from the derivative, or the second derivative where the derivative vanishes.
+ Where both vanish, the cubic is a point, and the normal is 0.
+ */
+static inline bc_float2_t __BCCubicStrokeNormal(BCCubic c, bc_float_t t) {
+    bc_float2_t direction = BCCubicEvaluatePrime(c, t);
+    if (bc_dot(direction, direction) == 0) {
+        direction = (1 - t) * (c.a - 2 * c.c + c.d) + t * (c.c - 2 * c.d + c.b);
+    }
+    const bc_float_t lengthSquared = bc_dot(direction, direction);
+    if (lengthSquared == 0) { return bc_make_float2(0, 0); }
+    return bc_make_float2(-direction.y, direction.x) / bc_sqrt(lengthSquared);
+}
+
+//Left and right vertexes for samples [first,first+8) of one cubic, in strip order.  Samples past the end are computed, and ignored by the caller.
+static inline void __BCCubicStrokeGroup(BCCubic c, bc_float_t halfWidth, uint32_t first, bc_float_t step, bc_float_t output[32]) {
+    const bc_float8_t lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    const bc_float8_t t = bc_vmin((first + lanes) * step, one);
+    const bc_float8_t one_minus_t = 1 - t;
+    //Same math as BCCubicEvaluate / BCCubicEvaluatePrime, with one cubic and 8 parameters
+    const bc_float8_t wa = one_minus_t * one_minus_t * one_minus_t;
+    const bc_float8_t wc = 3 * one_minus_t * one_minus_t * t;
+    const bc_float8_t wd = 3 * one_minus_t * t * t;
+    const bc_float8_t wb = t * t * t;
+    const bc_float8_t x = c.a.x * wa + c.c.x * wc + c.d.x * wd + c.b.x * wb;
+    const bc_float8_t y = c.a.y * wa + c.c.y * wc + c.d.y * wd + c.b.y * wb;
+    const bc_float8_t w0 = 3 * one_minus_t * one_minus_t;
+    const bc_float8_t w1 = 6 * one_minus_t * t;
+    const bc_float8_t w2 = 3 * t * t;
+    bc_float8_t dx = w0 * (c.c.x - c.a.x) + w1 * (c.d.x - c.c.x) + w2 * (c.b.x - c.d.x);
+    bc_float8_t dy = w0 * (c.c.y - c.a.y) + w1 * (c.d.y - c.c.y) + w2 * (c.b.y - c.d.y);
+    //where the derivative vanishes, the second derivative, as __BCCubicStrokeNormal
+    const __BCMask8 vanishes = (dx * dx + dy * dy) == zero;
+    if (__BCMask8Any(vanishes)) {
+        const bc_float8_t ddx = one_minus_t * (c.a.x - 2 * c.c.x + c.d.x) + t * (c.c.x - 2 * c.d.x + c.b.x);
+        const bc_float8_t ddy = one_minus_t * (c.a.y - 2 * c.c.y + c.d.y) + t * (c.c.y - 2 * c.d.y + c.b.y);
+        dx = __BCMask8Select(vanishes, ddx, dx);
+        dy = __BCMask8Select(vanishes, ddy, dy);
+    }
+    const bc_float8_t lengthSquared = dx * dx + dy * dy;
+    const __BCMask8 point = lengthSquared == zero;
+    //a point has no normal, so its offsets are 0
+    const bc_float8_t scale = (bc_float8_t) ((__BCMask8) (halfWidth / bc_vsqrt(lengthSquared)) & ~point);
+    const bc_float8_t ox = -dy * scale;
+    const bc_float8_t oy = dx * scale;
+    bc_float16_t left, right;
+    left.even = x + ox;
+    left.odd = y + oy;
+    right.even = x - ox;
+    right.odd = y - oy;
+    //alternate left and right vertexes
+    const bc_float16_t lo = __builtin_shufflevector(left, right, 0, 1, 16, 17, 2, 3, 18, 19, 4, 5, 20, 21, 6, 7, 22, 23);
+    const bc_float16_t hi = __builtin_shufflevector(left, right, 8, 9, 24, 25, 10, 11, 26, 27, 12, 13, 28, 29, 14, 15, 30, 31);
+    memcpy(output, &lo, sizeof(lo));
+    memcpy(output + 16, &hi, sizeof(hi));
+}
+
+bool BCCubicStrokeBatch(const BCCubic *cubics, const bc_float_t *widths, size_t count, uint8_t vertexesPerCubic, bc_float_t miterLimit, bc_float2_t *output) {
+    __BC_ASSERT(cubics != NULL || count == 0, false);
+    __BC_ASSERT(widths != NULL || count == 0, false);
+    __BC_ASSERT(vertexesPerCubic > 1, false);
+    __BC_ASSERT(miterLimit >= 1, false);
+    __BC_ASSERT(output != NULL || count == 0, false);
+    const size_t stride = BCCubicStrokeVertexCount(vertexesPerCubic);
+    //same parameters as BCVertexToBezierParameter
+    const bc_float_t step = 1.0f / (vertexesPerCubic - 1);
+    for (size_t i = 0; i < count; i++) {
+        bc_float2_t *out = output + i * stride;
+        const bc_float_t halfWidth = widths[i] / 2;
+        uint32_t first = 0;
+        for (; first + 8 <= vertexesPerCubic; first += 8) {
+            __BCCubicStrokeGroup(cubics[i], halfWidth, first, step, (bc_float_t *) (out + 2 * first));
+        }
+        if (first < vertexesPerCubic) {
+            bc_float_t partial[32];
+            __BCCubicStrokeGroup(cubics[i], halfWidth, first, step, partial);
+            memcpy(out + 2 * first, partial, sizeof(bc_float2_t) * 2 * (vertexesPerCubic - first));
+        }
+        //the last sample is exactly the endpoint, rather than rounding toward it
+        const bc_float2_t normal = __BCCubicStrokeNormal(cubics[i], 1);
+        out[stride - 2] = cubics[i].b + halfWidth * normal;
+        out[stride - 1] = cubics[i].b - halfWidth * normal;
+    }
+    for (size_t i = 0; i + 1 < count; i++) {
+        if (!(cubics[i].b.x == cubics[i + 1].a.x && cubics[i].b.y == cubics[i + 1].a.y)) { continue; }
+        const bc_float2_t before = __BCCubicStrokeNormal(cubics[i], 1);
+        const bc_float2_t after = __BCCubicStrokeNormal(cubics[i + 1], 0);
+        const bc_float2_t bisector = before + after;
+        const bc_float_t bisectorSquared = bc_dot(bisector, bisector);
+        //a point, or a turn all the way back, has no bisector
+        if (bisectorSquared == 0) { continue; }
+        const bc_float2_t miter = bisector / bc_sqrt(bisectorSquared);
+        //the miter is 1/cos of half the turn, and the cos is the dot with either normal
+        const bc_float_t cosine = bc_dot(miter, before);
+        const bc_float_t length = cosine * miterLimit > 1 ? 1 / cosine : miterLimit;
+        const bc_float2_t p = cubics[i].b;
+        const bc_float_t halfBefore = widths[i] / 2;
+        const bc_float_t halfAfter = widths[i + 1] / 2;
+        bc_float2_t *end = output + (i + 1) * stride - 2;
+        bc_float2_t *start = output + (i + 1) * stride;
+        end[0] = p + miter * (length * halfBefore);
+        end[1] = p - miter * (length * halfBefore);
+        start[0] = p + miter * (length * halfAfter);
+        start[1] = p - miter * (length * halfAfter);
+    }
+    return true;
+}
+
+size_t BCCubicStrokeIndexes(uint8_t vertexesPerCubic, uint16_t *output) {
+    __BC_ASSERT(vertexesPerCubic > 1, 0);
+    __BC_ASSERT(output != NULL, 0);
+    //each step along the strip is a quad of left,right,nextLeft,nextRight, as 2 triangles in strip winding
+    for (uint16_t j = 0; j + 1 < vertexesPerCubic; j++) {
+        const uint16_t left = 2 * j;
+        uint16_t *quad = output + 6 * j;
+        quad[0] = left;
+        quad[1] = left + 1;
+        quad[2] = left + 2;
+        quad[3] = left + 2;
+        quad[4] = left + 1;
+        quad[5] = left + 3;
+    }
+    return 6 * ((size_t) vertexesPerCubic - 1);
+}
@@ -0,0 +1,125 @@
+//BCCubicWide.h: Implementation of BCCubic4 and BCCubic8, for one lane width
+// ©2021 DrewCrawfordApps LLC
+
+/*
+ Included once by BCCubic4.c and once by BCCubic8.c, so there is no include guard.  The including file defines:
+ __BC_WIDE              the type, BCCubic4 or BCCubic8
+ __BC_WIDE_LANES        the number of cubics
+ __BC_WIDE_PARAMETER    a vector with a lane per cubic
+ __BC_WIDE_POINTS       a vector with interleaved x,y lanes, 2 per cubic
+ __BC_WIDE_FUNCTION(N)  the public function named N, e.g. BCCubic4##N
+ __BC_WIDE_REPEAT       the function that repeats each lane of a parameter for the interleaved lanes
+ */
+
+#include "BCLanes8.h"
+#include "BCTrap.h"
+
+__BC_WIDE __BC_WIDE_FUNCTION(Pack)(const BCCubic *cubics) {
+    __BC_WIDE out;
+    for (int i = 0; i < __BC_WIDE_LANES; i++) {
+        out.a[2*i] = cubics[i].a.x;
+        out.a[2*i+1] = cubics[i].a.y;
+        out.b[2*i] = cubics[i].b.x;
+        out.b[2*i+1] = cubics[i].b.y;
+        out.c[2*i] = cubics[i].c.x;
+        out.c[2*i+1] = cubics[i].c.y;
+        out.d[2*i] = cubics[i].d.x;
+        out.d[2*i+1] = cubics[i].d.y;
+    }
+    return out;
+}
+
+void __BC_WIDE_FUNCTION(Unpack)(__BC_WIDE c, BCCubic *output) {
+    for (int i = 0; i < __BC_WIDE_LANES; i++) {
+        output[i].a = bc_make_float2(c.a[2*i], c.a[2*i+1]);
+        output[i].b = bc_make_float2(c.b[2*i], c.b[2*i+1]);
+        output[i].c = bc_make_float2(c.c[2*i], c.c[2*i+1]);
+        output[i].d = bc_make_float2(c.d[2*i], c.d[2*i+1]);
+    }
+}
+
+__BC_WIDE_PARAMETER __BC_WIDE_FUNCTION(Length)(__BC_WIDE c) {
+    //see BCCubicLength
+    const __BC_WIDE_POINTS v0 = bc_abs(c.c-c.a);
+    const __BC_WIDE_POINTS v1 = bc_abs(-0.558983582205757f*c.a + 0.325650248872424f*c.c + 0.208983582205757f*c.d + 0.024349751127576f*c.b);
+    const __BC_WIDE_POINTS v2 = bc_abs(c.b-c.a+c.d-c.c)*0.26666666666666666f;
+    const __BC_WIDE_POINTS v3 = bc_abs(-0.024349751127576f*c.a - 0.208983582205757f*c.c - 0.325650248872424f*c.d + 0.558983582205757f*c.b);
+    const __BC_WIDE_POINTS v4 = bc_abs(c.b-c.d);
+
+    const __BC_WIDE_POINTS result = 0.15f*(v0+v4) + v1 + v2 + v3;
+    return bc_vsqrt(result.even * result.even + result.odd * result.odd);
+}
+
+__BC_WIDE __BC_WIDE_FUNCTION(LeftSplit)(__BC_WIDE c, __BC_WIDE_PARAMETER t) {
+    //see BCCubicLeftSplit
+    const __BC_WIDE_POINTS t2 = __BC_WIDE_REPEAT(t);
+    __BC_WIDE out;
+    const __BC_WIDE_POINTS t_minus_1 = t2 - 1;
+    const __BC_WIDE_POINTS t_minus_1_squared = __bc_square(t_minus_1);
+    const __BC_WIDE_POINTS t_squared_d = __bc_square(t2) * c.d;
+    const __BC_WIDE_POINTS t_c = t2 * c.c;
+    out.a = c.a;
+    out.b = t2 * __bc_square(t2) * c.b - 3 * t_squared_d * t_minus_1 + 3 * t_minus_1_squared * t_c - t_minus_1 * t_minus_1_squared * c.a;
+    out.c = t_c - t_minus_1 * c.a;
+    out.d = t_squared_d - 2 * t_minus_1 * t_c + t_minus_1_squared * c.a;
+    return out;
+}
+
+__BC_WIDE __BC_WIDE_FUNCTION(RightSplit)(__BC_WIDE c, __BC_WIDE_PARAMETER t) {
+    //see BCCubicRightSplit
+    const __BC_WIDE_POINTS t2 = __BC_WIDE_REPEAT(t);
+    __BC_WIDE out;
+    const __BC_WIDE_POINTS t_squared = __bc_square(t2);
+    const __BC_WIDE_POINTS t_minus_1 = t2 - 1;
+    const __BC_WIDE_POINTS t_minus_1_d = t_minus_1 * c.d;
+    const __BC_WIDE_POINTS t_minus_1_squared_c = __bc_square(t_minus_1) * c.c;
+    out.a = t2 * t_squared * c.b - 3 * t_squared * t_minus_1_d + 3 * t2 * t_minus_1_squared_c - t_minus_1 * __bc_square(t_minus_1) * c.a;
+    out.b = c.b;
+    out.c = t_squared * c.b - 2 * t2 * t_minus_1_d + t_minus_1_squared_c;
+    out.d = t2 * c.b - t_minus_1_d;
+    return out;
+}
+
+void __BC_WIDE_FUNCTION(AlignedRects)(__BC_WIDE c, BCStrategy strategy, BCAlignedRect *output) {
+    switch (strategy) {
+        case BCStrategyFastest: {
+            const __BC_WIDE_POINTS min = bc_vmin(bc_vmin(c.a, c.b), bc_vmin(c.c, c.d));
+            const __BC_WIDE_POINTS max = bc_vmax(bc_vmax(c.a, c.b), bc_vmax(c.c, c.d));
+            for (int i = 0; i < __BC_WIDE_LANES; i++) {
+                output[i].min = bc_make_float2(min[2*i], min[2*i+1]);
+                output[i].max = bc_make_float2(max[2*i], max[2*i+1]);
+            }
+            return;
+        }
+        case BCStrategyAccurate: {
+            //each group of 8 interleaved lanes is the x,y of 4 cubics, and the axis range treats every lane alike
+            for (int group = 0; group < __BC_WIDE_LANES / 4; group++) {
+                const bc_float8_t a = __bc_load8((const bc_float_t *) &c.a + 8 * group);
+                const bc_float8_t b = __bc_load8((const bc_float_t *) &c.b + 8 * group);
+                const bc_float8_t cc = __bc_load8((const bc_float_t *) &c.c + 8 * group);
+                const bc_float8_t d = __bc_load8((const bc_float_t *) &c.d + 8 * group);
+                bc_float8_t min, max;
+                __BCLanes8AxisRange(a, b, cc, d, &min, &max);
+                for (int i = 0; i < 4; i++) {
+                    output[4 * group + i].min = bc_make_float2(min[2*i], min[2*i+1]);
+                    output[4 * group + i].max = bc_make_float2(max[2*i], max[2*i+1]);
+                }
+            }
+            return;
+        }
+        default: {
+            for (int i = 0; i < __BC_WIDE_LANES; i++) {
+                output[i].min = 0;
+                output[i].max = 0;
+            }
+            __BC_ASSERT_CUSTOM(false, return);
+        }
+    }
+}
+
+#undef __BC_WIDE
+#undef __BC_WIDE_LANES
+#undef __BC_WIDE_PARAMETER
+#undef __BC_WIDE_POINTS
+#undef __BC_WIDE_FUNCTION
+#undef __BC_WIDE_REPEAT
@@ -0,0 +1,398 @@
+//BCDistanceField.c: Distance fields and stroke coverage from BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCDistanceField.h"
+#include "BCCubicBatch.h"
+#include "BCCubicFlatten.h"
+#include "BCParallel.h"
+#include "BCMetalC.h"
+#include "BCTrap.h"
+#include <stdlib.h>
+#include <string.h>
+
+//tiles are square, and a multiple of 8 pixels wide so that each row is whole lane groups
+#define __BC_DISTANCE_TILE 32
+#define __BC_DISTANCE_GROUPS (__BC_DISTANCE_TILE / 8)
+
+typedef struct {
+    const BCCubic *cubics;
+    size_t count;
+    const BCAlignedRect *boxes;
+    //flattened polylines; cubic i is points[offsets[i]] up to points[offsets[i+1]]
+    const bc_float2_t *points;
+    const size_t *offsets;
+    //tile bins; tile t has cubics tileItems[tileStart[t]] up to tileItems[tileStart[t+1]]
+    const size_t *tileStart;
+    const uint32_t *tileItems;
+    uint32_t tileColumns;
+    //per-worker crossing scratch for the sign pass; worker w has crossings[w*crossingCapacity] up to crossings[(w+1)*crossingCapacity]
+    struct __BCDistanceCrossing *crossings;
+    size_t crossingCapacity;
+    //center of pixel (0,0)
+    bc_float2_t origin;
+    bc_float2_t pixelSize;
+    uint32_t width;
+    uint32_t height;
+    bc_float_t maxDistance;
+    bool isSigned;
+    //for distance fields
+    bc_float_t *output;
+    //for stroke coverage, which is written instead of distance when coverage is set
+    bool coverage;
+    BCCoverageFormat format;
+    void *coverageOutput;
+    //coverage is coverageScale * clamp((coverageEdge - distance) * inverseFilterWidth, 0, 1)
+    bc_float_t coverageEdge;
+    bc_float_t coverageScale;
+    bc_float_t inverseFilterWidth;
+} __BCDistanceField;
+
+typedef struct __BCDistanceCrossing {
+    bc_float_t x;
+    int32_t winding;
+} __BCDistanceCrossing;
+
+static int __BCDistanceCrossingCompare(const void *a, const void *b) {
+    const bc_float_t x = ((const __BCDistanceCrossing *) a)->x;
+    const bc_float_t y = ((const __BCDistanceCrossing *) b)->x;
+    return (x > y) - (x < y);
+}
+
+//Splits c at the roots of y' into up to 3 pieces that are monotonic in y.  Writes the piece boundaries to t and returns the number of pieces.
+static inline int __BCDistanceFieldMonotonicPieces(BCCubic c, bc_float_t t[4]) {
+    //y'(t)/3 = qa t² + qb t + qc, as BCAlignedRectCreateFromCubic
+    const bc_float_t p0 = c.c.y - c.a.y;
+    const bc_float_t p1 = c.d.y - c.c.y;
+    const bc_float_t p2 = c.b.y - c.d.y;
+    const bc_float_t qa = p0 - 2 * p1 + p2;
+    const bc_float_t qb = 2 * (p1 - p0);
+    const bc_float_t qc = p0;
+    bc_float_t roots[2];
+    int rootCount = 0;
+    if (qa == 0) {
+        if (qb != 0) { roots[rootCount++] = -qc / qb; }
+    }
+    else {
+        const bc_float_t discriminant = qb * qb - 4 * qa * qc;
+        if (discriminant >= 0) {
+            const bc_float_t root = bc_sqrt(discriminant);
+            roots[rootCount++] = (-qb - root) / (2 * qa);
+            roots[rootCount++] = (-qb + root) / (2 * qa);
+        }
+    }
+    if (rootCount == 2 && roots[0] > roots[1]) {
+        const bc_float_t swap = roots[0];
+        roots[0] = roots[1];
+        roots[1] = swap;
+    }
+    int n = 0;
+    t[n++] = 0;
+    for (int r = 0; r < rootCount; r++) {
+        if (roots[r] > t[n - 1] && roots[r] < 1) { t[n++] = roots[r]; }
+    }
+    t[n++] = 1;
+    return n - 1;
+}
+
+/*
+ Writes -1 inside and 1 outside, for rows [begin,end).
+ A ray from the left crosses each y-monotonic piece of each cubic, upward or downward as its endpoints.
+ A piece is counted when its y range contains the row as [ymin,ymax), so a vertex on the row is counted once by the two pieces that meet there when the contour passes through it, and twice or not at all when the contour turns back at it.
+ Horizontal pieces have an empty range and are never counted.
+ */
+static void __BCDistanceFieldSigns(void *context, size_t begin, size_t end, unsigned worker) {
+    const __BCDistanceField *f = context;
+    __BCDistanceCrossing *crossings = f->crossings + worker * f->crossingCapacity;
+    for (size_t row = begin; row < end; row++) {
+        const bc_float_t y = f->origin.y + row * f->pixelSize.y;
+        size_t n = 0;
+        for (size_t i = 0; i < f->count; i++) {
+            if (!(f->boxes[i].min.y <= y && f->boxes[i].max.y >= y)) { continue; }
+            const BCCubic c = f->cubics[i];
+            bc_float_t t[4];
+            const int pieces = __BCDistanceFieldMonotonicPieces(c, t);
+            //the endpoints are exact, so that a contour's cubics agree on the y of the vertexes they share
+            bc_float_t y0 = c.a.y;
+            for (int p = 0; p < pieces; p++) {
+                const bc_float_t y1 = p + 1 == pieces ? c.b.y : BCCubicEvaluate(c, t[p + 1]).y;
+                const bool upward = y1 > y0;
+                const bc_float_t low = upward ? y0 : y1;
+                const bc_float_t high = upward ? y1 : y0;
+                if (low <= y && y < high) {
+                    //bisect for the crossing, keeping lo on the low side of the row
+                    bc_float_t lo = upward ? t[p] : t[p + 1];
+                    bc_float_t hi = upward ? t[p + 1] : t[p];
+                    for (int k = 0; k < 32; k++) {
+                        const bc_float_t mid = (lo + hi) / 2;
+                        if (mid == lo || mid == hi) { break; }
+                        if (BCCubicEvaluate(c, mid).y <= y) { lo = mid; }
+                        else { hi = mid; }
+                    }
+                    crossings[n].x = BCCubicEvaluate(c, lo).x;
+                    crossings[n].winding = upward ? 1 : -1;
+                    n++;
+                }
+                y0 = y1;
+            }
+        }
+        qsort(crossings, n, sizeof(__BCDistanceCrossing), __BCDistanceCrossingCompare);
+        bc_float_t *out = f->output + row * f->width;
+        int32_t winding = 0;
+        size_t next = 0;
+        for (uint32_t column = 0; column < f->width; column++) {
+            const bc_float_t x = f->origin.x + column * f->pixelSize.x;
+            while (next < n && crossings[next].x <= x) {
+                winding += crossings[next].winding;
+                next++;
+            }
+            out[column] = winding != 0 ? -1 : 1;
+        }
+    }
+}
+
+/*
+ The most cubic boxes that straddle any row, so the sign pass can size its scratch before it starts.
+ Each box is counted on a row more than it reaches on either side, so rounding here can only overestimate.
+ */
+static size_t __BCDistanceFieldMaxStraddling(const __BCDistanceField *f, size_t *rowCounts) {
+    memset(rowCounts, 0, sizeof(size_t) * (f->height + 1));
+    for (size_t i = 0; i < f->count; i++) {
+        const BCAlignedRect box = f->boxes[i];
+        //boxes with NaN never straddle a row
+        if (!(box.min.y <= box.max.y)) { continue; }
+        const bc_float_t first = bc_max(bc_floor((box.min.y - f->origin.y) / f->pixelSize.y) - 1, 0.0f);
+        const bc_float_t last = bc_min(bc_ceil((box.max.y - f->origin.y) / f->pixelSize.y) + 1, (bc_float_t) f->height - 1);
+        if (!(first <= last)) { continue; }
+        rowCounts[(size_t) first]++;
+        rowCounts[(size_t) last + 1]--;
+    }
+    size_t straddling = 0;
+    size_t most = 0;
+    for (uint32_t row = 0; row < f->height; row++) {
+        straddling += rowCounts[row];
+        most = straddling > most ? straddling : most;
+    }
+    return most;
+}
+
+static void __BCDistanceFieldTiles(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    const __BCDistanceField *f = context;
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    const bc_float8_t lanes = {0, 1, 2, 3, 4, 5, 6, 7};
+    for (size_t tile = begin; tile < end; tile++) {
+        const uint32_t column0 = (uint32_t) (tile % f->tileColumns) * __BC_DISTANCE_TILE;
+        const uint32_t row0 = (uint32_t) (tile / f->tileColumns) * __BC_DISTANCE_TILE;
+        const uint32_t rows = f->height - row0 < __BC_DISTANCE_TILE ? f->height - row0 : __BC_DISTANCE_TILE;
+        //squared distances, clamped to maxDistance²
+        bc_float8_t best[__BC_DISTANCE_TILE][__BC_DISTANCE_GROUPS];
+        for (uint32_t r = 0; r < rows; r++) {
+            for (int g = 0; g < __BC_DISTANCE_GROUPS; g++) {
+                best[r][g] = f->maxDistance * f->maxDistance;
+            }
+        }
+        bc_float8_t groupX[__BC_DISTANCE_GROUPS];
+        for (int g = 0; g < __BC_DISTANCE_GROUPS; g++) {
+            groupX[g] = f->origin.x + (column0 + g * 8 + lanes) * f->pixelSize.x;
+        }
+        //pixel centers of the tile, grown by maxDistance
+        const bc_float2_t tileMin = f->origin + bc_make_float2(column0, row0) * f->pixelSize - f->maxDistance;
+        const bc_float2_t tileMax = f->origin + bc_make_float2(column0 + __BC_DISTANCE_TILE - 1, row0 + rows - 1) * f->pixelSize + f->maxDistance;
+        for (size_t item = f->tileStart[tile]; item < f->tileStart[tile + 1]; item++) {
+            const uint32_t cubic = f->tileItems[item];
+            for (size_t p = f->offsets[cubic]; p + 1 < f->offsets[cubic + 1]; p++) {
+                const bc_float2_t a = f->points[p];
+                const bc_float2_t b = f->points[p + 1];
+                if (bc_max(a.x, b.x) < tileMin.x || bc_min(a.x, b.x) > tileMax.x || bc_max(a.y, b.y) < tileMin.y || bc_min(a.y, b.y) > tileMax.y) { continue; }
+                const bc_float2_t ab = b - a;
+                const bc_float_t lengthSquared = bc_dot(ab, ab);
+                //a 0-length segment is its start point
+                const bc_float_t inverseLengthSquared = lengthSquared > 0 ? 1 / lengthSquared : 0;
+                //rows farther than maxDistance from the segment can't get closer
+                const bc_float_t segmentMinY = bc_min(a.y, b.y) - f->maxDistance;
+                const bc_float_t segmentMaxY = bc_max(a.y, b.y) + f->maxDistance;
+                for (uint32_t r = 0; r < rows; r++) {
+                    const bc_float_t y = f->origin.y + (row0 + r) * f->pixelSize.y;
+                    if (y < segmentMinY || y > segmentMaxY) { continue; }
+                    const bc_float_t dy = y - a.y;
+                    for (int g = 0; g < __BC_DISTANCE_GROUPS; g++) {
+                        const bc_float8_t dx = groupX[g] - a.x;
+                        const bc_float8_t h = bc_vmin(bc_vmax((dx * ab.x + dy * ab.y) * inverseLengthSquared, zero), one);
+                        const bc_float8_t ex = dx - h * ab.x;
+                        const bc_float8_t ey = dy - h * ab.y;
+                        best[r][g] = bc_vmin(best[r][g], ex * ex + ey * ey);
+                    }
+                }
+            }
+        }
+        for (uint32_t r = 0; r < rows; r++) {
+            const size_t rowStart = (size_t) (row0 + r) * f->width;
+            for (int g = 0; g < __BC_DISTANCE_GROUPS; g++) {
+                const uint32_t column = column0 + g * 8;
+                if (column >= f->width) { break; }
+                const uint32_t n = f->width - column < 8 ? f->width - column : 8;
+                const bc_float8_t distance = bc_vsqrt(best[r][g]);
+                bc_float_t values[8];
+                if (f->coverage) {
+                    const bc_float8_t coverage = f->coverageScale * bc_vmin(bc_vmax((f->coverageEdge - distance) * f->inverseFilterWidth, zero), one);
+                    memcpy(values, &coverage, sizeof(values));
+                    if (f->format == BCCoverageFormatByte) {
+                        uint8_t *out = (uint8_t *) f->coverageOutput + rowStart + column;
+                        for (uint32_t k = 0; k < n; k++) { out[k] = (uint8_t) (values[k] * 255 + 0.5f); }
+                    }
+                    else {
+                        memcpy((bc_float_t *) f->coverageOutput + rowStart + column, values, sizeof(bc_float_t) * n);
+                    }
+                    continue;
+                }
+                memcpy(values, &distance, sizeof(values));
+                bc_float_t *out = f->output + rowStart + column;
+                for (uint32_t k = 0; k < n; k++) {
+                    out[k] = f->isSigned ? out[k] * values[k] : values[k];
+                }
+            }
+        }
+    }
+}
+
+//tile range covered by [min,max] in one axis, or false if it misses the grid
+static inline bool __BCDistanceFieldTileRange(bc_float_t min, bc_float_t max, bc_float_t origin, bc_float_t pixelSize, uint32_t pixels, uint32_t *first, uint32_t *last) {
+    const bc_float_t lo = (min - origin) / pixelSize;
+    const bc_float_t hi = (max - origin) / pixelSize;
+    if (!(hi >= -1) || !(lo <= pixels)) { return false; }
+    const uint32_t tiles = (pixels + __BC_DISTANCE_TILE - 1) / __BC_DISTANCE_TILE;
+    *first = lo <= 0 ? 0 : (uint32_t) lo / __BC_DISTANCE_TILE;
+    *last = hi >= pixels - 1 ? tiles - 1 : (hi <= 0 ? 0 : (uint32_t) hi / __BC_DISTANCE_TILE);
+    if (*first > tiles - 1) { *first = tiles - 1; }
+    return true;
+}
+
+//Flattens and bins the cubics, then rasterizes every tile.  f has the grid, and what to write, set.
+static bool __BCDistanceFieldRun(__BCDistanceField *f, unsigned threads) {
+    const BCCubic *cubics = f->cubics;
+    const size_t count = f->count;
+    const uint32_t width = f->width;
+    const uint32_t height = f->height;
+    const bc_float_t maxDistance = f->maxDistance;
+    BCAlignedRect *boxes = malloc(sizeof(BCAlignedRect) * (count ? count : 1));
+    //allocation failures return false at every check level, since they aren't the caller's mistake
+    if (boxes == NULL) { return false; }
+    BCAlignedRectCreateFromCubicBatch(cubics, count, BCStrategyAccurate, boxes);
+    f->boxes = boxes;
+
+    const bc_float_t tolerance = bc_min(f->pixelSize.x, f->pixelSize.y) / 16;
+    const size_t pointCapacity = BCCubicFlattenBatchUpperBound(cubics, count, tolerance);
+    bc_float2_t *points = malloc(sizeof(bc_float2_t) * (pointCapacity ? pointCapacity : 1));
+    size_t *offsets = malloc(sizeof(size_t) * (count + 1));
+    if (points == NULL || offsets == NULL) { free(points); free(offsets); free(boxes); return false; }
+    BCCubicFlattenBatch(cubics, count, tolerance, points, NULL, pointCapacity, offsets);
+    f->points = points;
+    f->offsets = offsets;
+
+    //bin each cubic into the tiles its box is within maxDistance of, with a counting sort as in BCRectIntersectingPairs
+    f->tileColumns = (width + __BC_DISTANCE_TILE - 1) / __BC_DISTANCE_TILE;
+    const uint32_t tileRows = (height + __BC_DISTANCE_TILE - 1) / __BC_DISTANCE_TILE;
+    const size_t tiles = (size_t) f->tileColumns * tileRows;
+    size_t *tileStart = calloc(tiles + 1, sizeof(size_t));
+    if (tileStart == NULL) { free(points); free(offsets); free(boxes); return false; }
+    for (int pass = 0; pass < 2; pass++) {
+        uint32_t *items = NULL;
+        if (pass == 1) {
+            for (size_t t = 0; t < tiles; t++) { tileStart[t + 1] += tileStart[t]; }
+            items = malloc(sizeof(uint32_t) * (tileStart[tiles] ? tileStart[tiles] : 1));
+            if (items == NULL) { free(tileStart); free(points); free(offsets); free(boxes); return false; }
+            f->tileItems = items;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t x0, x1, y0, y1;
+            if (!__BCDistanceFieldTileRange(boxes[i].min.x - maxDistance, boxes[i].max.x + maxDistance, f->origin.x, f->pixelSize.x, width, &x0, &x1)) { continue; }
+            if (!__BCDistanceFieldTileRange(boxes[i].min.y - maxDistance, boxes[i].max.y + maxDistance, f->origin.y, f->pixelSize.y, height, &y0, &y1)) { continue; }
+            for (uint32_t y = y0; y <= y1; y++) {
+                for (uint32_t x = x0; x <= x1; x++) {
+                    const size_t t = (size_t) y * f->tileColumns + x;
+                    //first pass counts into tileStart[t+1]; second fills, advancing tileStart[t] as a cursor
+                    if (pass == 0) { tileStart[t + 1]++; }
+                    else { items[tileStart[t]++] = (uint32_t) i; }
+                }
+            }
+        }
+    }
+    memmove(tileStart + 1, tileStart, sizeof(size_t) * tiles);
+    tileStart[0] = 0;
+    f->tileStart = tileStart;
+
+    f->crossings = NULL;
+    if (f->isSigned) {
+        size_t *rowCounts = malloc(sizeof(size_t) * (height + 1));
+        if (rowCounts == NULL) { free((void *) f->tileItems); free(tileStart); free(points); free(offsets); free(boxes); return false; }
+        //at most 3 y-monotonic pieces per cubic
+        f->crossingCapacity = 3 * __BCDistanceFieldMaxStraddling(f, rowCounts);
+        free(rowCounts);
+        const unsigned workers = __BCParallelWorkerCount(threads);
+        f->crossings = malloc(sizeof(__BCDistanceCrossing) * (f->crossingCapacity ? f->crossingCapacity * workers : 1));
+        if (f->crossings == NULL) { free((void *) f->tileItems); free(tileStart); free(points); free(offsets); free(boxes); return false; }
+        __BCParallelFor(height, 4, threads, __BCDistanceFieldSigns, f);
+    }
+    __BCParallelFor(tiles, 1, threads, __BCDistanceFieldTiles, f);
+    free(f->crossings);
+    free((void *) f->tileItems);
+    free(tileStart);
+    free(points);
+    free(offsets);
+    free(boxes);
+    return true;
+}
+
+static inline void __BCDistanceFieldGrid(__BCDistanceField *f, const BCCubic *cubics, size_t count, BCAlignedRect bounds, uint32_t width, uint32_t height) {
+    f->cubics = cubics;
+    f->count = count;
+    f->width = width;
+    f->height = height;
+    f->pixelSize = (bounds.max - bounds.min) / bc_make_float2(width, height);
+    f->origin = bounds.min + f->pixelSize / 2;
+}
+
+bool BCCubicDistanceField(const BCCubic *cubics, size_t count, BCAlignedRect bounds, uint32_t width, uint32_t height, bc_float_t maxDistance, bool isSigned, unsigned threads, bc_float_t *output) {
+    __BC_ASSERT(cubics != NULL || count == 0, false);
+    __BC_ASSERT(count < UINT32_MAX, false);
+    __BC_ASSERT(width > 0 && height > 0, false);
+    __BC_ASSERT(bounds.max.x > bounds.min.x && bounds.max.y > bounds.min.y, false);
+    __BC_ASSERT(maxDistance > 0, false);
+    __BC_ASSERT(output != NULL, false);
+    __BCDistanceField f;
+    __BCDistanceFieldGrid(&f, cubics, count, bounds, width, height);
+    f.maxDistance = maxDistance;
+    f.isSigned = isSigned;
+    f.output = output;
+    f.coverage = false;
+    return __BCDistanceFieldRun(&f, threads);
+}
+
+bool BCCubicStrokeCoverage(const BCCubic *cubics, size_t count, bc_float_t strokeWidth, BCAlignedRect bounds, uint32_t width, uint32_t height, BCCoverageFormat format, unsigned threads, void *output) {
+    __BC_ASSERT(cubics != NULL || count == 0, false);
+    __BC_ASSERT(count < UINT32_MAX, false);
+    __BC_ASSERT(width > 0 && height > 0, false);
+    __BC_ASSERT(bounds.max.x > bounds.min.x && bounds.max.y > bounds.min.y, false);
+    __BC_ASSERT(strokeWidth > 0, false);
+    __BC_ASSERT(format == BCCoverageFormatFloat || format == BCCoverageFormatByte, false);
+    __BC_ASSERT(output != NULL, false);
+    __BCDistanceField f;
+    __BCDistanceFieldGrid(&f, cubics, count, bounds, width, height);
+    /*
+     The filter is a pixel wide, so coverage ramps from 0 to 1 over a pixel centered on the stroke's edge.
+     A stroke thinner than the filter is drawn as wide as the filter, but fainter, in proportion to its width.
+     */
+    const bc_float_t filterWidth = bc_max(f.pixelSize.x, f.pixelSize.y);
+    const bc_float_t halfWidth = bc_max(strokeWidth, filterWidth) / 2;
+    f.coverageEdge = halfWidth + filterWidth / 2;
+    f.inverseFilterWidth = 1 / filterWidth;
+    f.coverageScale = bc_min(strokeWidth / filterWidth, 1.0f);
+    f.maxDistance = f.coverageEdge;
+    f.isSigned = false;
+    f.output = NULL;
+    f.coverage = true;
+    f.format = format;
+    f.coverageOutput = output;
+    return __BCDistanceFieldRun(&f, threads);
+}
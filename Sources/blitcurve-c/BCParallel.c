@@ -0,0 +1,109 @@
+//BCParallel.c: Minimal parallel-for used by CPU batch functions
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCParallel.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define __BC_PARALLEL_MAX_WORKERS 64
+
+typedef struct {
+    size_t count;
+    size_t grain;
+    size_t next;
+    __BCParallelWork work;
+    void *context;
+} __BCParallelJob;
+
+/*
+ Helper threads are started the first time a job wants them, and then wait for jobs for the life of the process.
+ Helper i is worker i; the thread calling __BCParallelFor is worker 0.  One job uses the pool at a time.
+ */
+static pthread_mutex_t __BCParallelSubmit = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t __BCParallelLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t __BCParallelWake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t __BCParallelDone = PTHREAD_COND_INITIALIZER;
+static struct {
+    //guarded by __BCParallelLock
+    unsigned threads;
+    unsigned long generation;
+    __BCParallelJob *job;
+    unsigned helpers;
+    unsigned active;
+} __BCParallelPool;
+
+static void __BCParallelRun(__BCParallelJob *job, unsigned worker) {
+    while (1) {
+        const size_t begin = __atomic_fetch_add(&job->next, job->grain, __ATOMIC_RELAXED);
+        if (begin >= job->count) { break; }
+        const size_t end = job->count - begin < job->grain ? job->count : begin + job->grain;
+        job->work(job->context, begin, end, worker);
+    }
+}
+
+static void *__BCParallelHelper(void *argument) {
+    const unsigned worker = (unsigned) (uintptr_t) argument;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&__BCParallelLock);
+    while (1) {
+        while (__BCParallelPool.generation == seen) {
+            pthread_cond_wait(&__BCParallelWake, &__BCParallelLock);
+        }
+        seen = __BCParallelPool.generation;
+        //jobs with few chunks don't use every helper
+        if (worker > __BCParallelPool.helpers) { continue; }
+        __BCParallelJob *job = __BCParallelPool.job;
+        pthread_mutex_unlock(&__BCParallelLock);
+        __BCParallelRun(job, worker);
+        pthread_mutex_lock(&__BCParallelLock);
+        if (--__BCParallelPool.active == 0) {
+            pthread_cond_signal(&__BCParallelDone);
+        }
+    }
+    return NULL;
+}
+
+unsigned __BCParallelWorkerCount(unsigned threads) {
+    if (threads == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned) cpus : 1;
+    }
+    return threads < __BC_PARALLEL_MAX_WORKERS ? threads : __BC_PARALLEL_MAX_WORKERS;
+}
+
+unsigned __BCParallelFor(size_t count, size_t grain, unsigned threads, __BCParallelWork work, void *context) {
+    const unsigned workers = __BCParallelWorkerCount(threads);
+    if (grain == 0) { grain = 1; }
+    const size_t chunks = (count + grain - 1) / grain;
+    const unsigned used = chunks < workers ? (unsigned) chunks : workers;
+    __BCParallelJob job = {count, grain, 0, work, context};
+    //nested calls, and calls while another thread's job is in the pool, run on the calling thread alone
+    if (used < 2 || pthread_mutex_trylock(&__BCParallelSubmit) != 0) {
+        __BCParallelRun(&job, 0);
+        return workers;
+    }
+    pthread_mutex_lock(&__BCParallelLock);
+    while (__BCParallelPool.threads + 1 < used) {
+        pthread_t handle;
+        const uintptr_t worker = __BCParallelPool.threads + 1;
+        if (pthread_create(&handle, NULL, __BCParallelHelper, (void *) worker) != 0) { break; }
+        pthread_detach(handle);
+        __BCParallelPool.threads++;
+    }
+    __BCParallelPool.helpers = __BCParallelPool.threads < used - 1 ? __BCParallelPool.threads : used - 1;
+    __BCParallelPool.active = __BCParallelPool.helpers;
+    __BCParallelPool.job = &job;
+    __BCParallelPool.generation++;
+    pthread_cond_broadcast(&__BCParallelWake);
+    pthread_mutex_unlock(&__BCParallelLock);
+    __BCParallelRun(&job, 0);
+    pthread_mutex_lock(&__BCParallelLock);
+    while (__BCParallelPool.active > 0) {
+        pthread_cond_wait(&__BCParallelDone, &__BCParallelLock);
+    }
+    pthread_mutex_unlock(&__BCParallelLock);
+    pthread_mutex_unlock(&__BCParallelSubmit);
+    return workers;
+}
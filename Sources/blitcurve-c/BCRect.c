@@ -171,6 +171,36 @@ bool BCRectIntersects(BCRect e, BCRect f) {
     return BCRectHalfIntersects(e, f) && BCRectHalfIntersects(f, e);
 }
 
+BCPreparedRect BCPreparedRectMake(BCRect r) {
+    BCPreparedRect p;
+    p.points = BCRectGet4Points(r);
+    p.center = r.center;
+    p.rotation = bc_make_float2(bc_cos(r.angle), bc_sin(r.angle));
+    const bc_float2_t halflengths = r.lengths / 2;
+    p.halflengths = bc_make_float2(halflengths.y, halflengths.x);
+    return p;
+}
+
+///\abstract implementation detail of \c BCPreparedRectIntersects, like \c BCRectHalfIntersects
+///\return \c false if we know there is no intersection, or \c true for inconclusive
+static bool BCPreparedRectHalfIntersects(const BCPreparedRect fixed, const BCPreparedRect movable) {
+    //rather than transforming movable into the frame of fixed and finding its points, transform its points
+    bc_float4_t xPoints = bc_make_float4(movable.points.a_b.even, movable.points.c_d.even) - fixed.center.x;
+    bc_float4_t yPoints = bc_make_float4(movable.points.a_b.odd, movable.points.c_d.odd) - fixed.center.y;
+    const bc_float4_t x = fixed.rotation.x * xPoints + fixed.rotation.y * yPoints;
+    const bc_float4_t y = fixed.rotation.x * yPoints - fixed.rotation.y * xPoints;
+    const bc_float2_t h = fixed.halflengths;
+    if (x.x <= -h.x && x.y <= -h.x && x.z <= -h.x && x.w <= -h.x) { return false; }
+    if (x.x >= h.x && x.y >= h.x && x.z >= h.x && x.w >= h.x) { return false; }
+    if (y.x <= -h.y && y.y <= -h.y && y.z <= -h.y && y.w <= -h.y) { return false; }
+    if (y.x >= h.y && y.y >= h.y && y.z >= h.y && y.w >= h.y) { return false; }
+    return true;
+}
+
+bool BCPreparedRectIntersects(BCPreparedRect e, BCPreparedRect f) {
+    return BCPreparedRectHalfIntersects(e, f) && BCPreparedRectHalfIntersects(f, e);
+}
+
 char BCRectContainsPoint(BCRect a, bc_float2_t point) {
     //similar to implementation of BCRectHalfIntersects, we assume a is located at .zero and we project point
     //into a space that agrees with this assumption
@@ -0,0 +1,118 @@
+//BCRectBatch.c: Batch intersection of many BCRect
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCRectBatch.h"
+#include "BCMetalC.h"
+#include "BCLanes8.h"
+#include "BCTrap.h"
+#include <string.h>
+
+//corners of 8 prepared rects, one per lane
+typedef struct {
+    //corners a, b, c, d
+    bc_float8_t x[4];
+    bc_float8_t y[4];
+} __BCPreparedRectCorners8;
+
+//frames of 8 prepared rects, one per lane
+typedef struct {
+    bc_float8_t centerX;
+    bc_float8_t centerY;
+    bc_float8_t cos;
+    bc_float8_t sin;
+    bc_float8_t halfX;
+    bc_float8_t halfY;
+} __BCPreparedRectFrames8;
+
+/*
+ Lanes past count repeat the last rect.
+ Fields are transposed through scalar arrays, which compiles to far better code than inserting lanes one at a time.
+ */
+static inline __BCPreparedRectCorners8 __BCPreparedRectCorners8Load(const BCPreparedRect *rects, size_t count) {
+    bc_float_t fields[8][8];
+    for (int lane = 0; lane < 8; lane++) {
+        const BCPreparedRect *r = rects + ((size_t) lane < count ? (size_t) lane : count - 1);
+        fields[0][lane] = r->points.a_b.x;
+        fields[1][lane] = r->points.a_b.z;
+        fields[2][lane] = r->points.c_d.x;
+        fields[3][lane] = r->points.c_d.z;
+        fields[4][lane] = r->points.a_b.y;
+        fields[5][lane] = r->points.a_b.w;
+        fields[6][lane] = r->points.c_d.y;
+        fields[7][lane] = r->points.c_d.w;
+    }
+    __BCPreparedRectCorners8 l;
+    memcpy(&l, fields, sizeof(l));
+    return l;
+}
+
+static inline __BCPreparedRectFrames8 __BCPreparedRectFrames8Load(const BCPreparedRect *rects, size_t count) {
+    bc_float_t fields[6][8];
+    for (int lane = 0; lane < 8; lane++) {
+        const BCPreparedRect *r = rects + ((size_t) lane < count ? (size_t) lane : count - 1);
+        fields[0][lane] = r->center.x;
+        fields[1][lane] = r->center.y;
+        fields[2][lane] = r->rotation.x;
+        fields[3][lane] = r->rotation.y;
+        fields[4][lane] = r->halflengths.x;
+        fields[5][lane] = r->halflengths.y;
+    }
+    __BCPreparedRectFrames8 l;
+    memcpy(&l, fields, sizeof(l));
+    return l;
+}
+
+//lanes where the transformed corners are all on the outside of some edge of a rect centered at 0 with halflengths h
+static inline __BCMask8 __BCRectSeparated8(const bc_float8_t x[4], const bc_float8_t y[4], bc_float8_t halfX, bc_float8_t halfY) {
+    const __BCMask8 left = (x[0] <= -halfX) & (x[1] <= -halfX) & (x[2] <= -halfX) & (x[3] <= -halfX);
+    const __BCMask8 right = (x[0] >= halfX) & (x[1] >= halfX) & (x[2] >= halfX) & (x[3] >= halfX);
+    const __BCMask8 below = (y[0] <= -halfY) & (y[1] <= -halfY) & (y[2] <= -halfY) & (y[3] <= -halfY);
+    const __BCMask8 above = (y[0] >= halfY) & (y[1] >= halfY) & (y[2] >= halfY) & (y[3] >= halfY);
+    return left | right | below | above;
+}
+
+//returns the lanes that intersect rect, for up to 8 others
+static inline uint8_t __BCPreparedRectIntersects8(BCPreparedRect rect, const BCPreparedRect *others, size_t count) {
+    const __BCPreparedRectCorners8 o = __BCPreparedRectCorners8Load(others, count);
+    bc_float8_t x[4];
+    bc_float8_t y[4];
+    //others in the frame of rect
+    for (int i = 0; i < 4; i++) {
+        const bc_float8_t dx = o.x[i] - rect.center.x;
+        const bc_float8_t dy = o.y[i] - rect.center.y;
+        x[i] = rect.rotation.x * dx + rect.rotation.y * dy;
+        y[i] = rect.rotation.x * dy - rect.rotation.y * dx;
+    }
+    uint8_t separated = (uint8_t) __BCMask8Bits(__BCRectSeparated8(x, y, rect.halflengths.x, rect.halflengths.y));
+    //usually most candidates are separated here, and the frames of the others aren't needed
+    if (separated == 0xff) { return 0; }
+    const __BCPreparedRectFrames8 f = __BCPreparedRectFrames8Load(others, count);
+    //rect in the frame of each other
+    const bc_float_t corners[8] = {rect.points.a_b.x, rect.points.a_b.y, rect.points.a_b.z, rect.points.a_b.w, rect.points.c_d.x, rect.points.c_d.y, rect.points.c_d.z, rect.points.c_d.w};
+    for (int i = 0; i < 4; i++) {
+        const bc_float8_t dx = corners[2 * i] - f.centerX;
+        const bc_float8_t dy = corners[2 * i + 1] - f.centerY;
+        x[i] = f.cos * dx + f.sin * dy;
+        y[i] = f.cos * dy - f.sin * dx;
+    }
+    separated |= (uint8_t) __BCMask8Bits(__BCRectSeparated8(x, y, f.halfX, f.halfY));
+    return (uint8_t) ~separated;
+}
+
+void BCPreparedRectMakeBatch(const BCRect *rects, size_t count, BCPreparedRect *output) {
+    __BC_ASSERT_CUSTOM((rects != NULL && output != NULL) || count == 0, return);
+    for (size_t i = 0; i < count; i++) { output[i] = BCPreparedRectMake(rects[i]); }
+}
+
+size_t BCPreparedRectIntersectsBatch(BCPreparedRect rect, const BCPreparedRect *others, size_t count, uint8_t *mask) {
+    __BC_ASSERT((others != NULL && mask != NULL) || count == 0, 0);
+    size_t hits = 0;
+    for (size_t i = 0; i < count; i += 8) {
+        const size_t lanes = count - i < 8 ? count - i : 8;
+        uint8_t bits = __BCPreparedRectIntersects8(rect, others + i, lanes);
+        if (lanes < 8) { bits &= (uint8_t) ((1u << lanes) - 1); }
+        mask[i / 8] = bits;
+        hits += __builtin_popcount(bits);
+    }
+    return hits;
+}
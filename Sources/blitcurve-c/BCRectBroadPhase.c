@@ -0,0 +1,207 @@
+//BCRectBroadPhase.c: Grid broad phase for many BCRect
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCRectBroadPhase.h"
+#include "BCParallel.h"
+#include "BCMetalC.h"
+#include "BCTrap.h"
+#include <string.h>
+
+//pairs found by a worker are published this many at a time
+#define __BC_BROADPHASE_LOCAL_PAIRS 64
+
+typedef struct {
+    const BCRect *rects;
+    //min.x, min.y, max.x, max.y
+    bc_float4_t *bounds;
+    const size_t *cellStart;
+    const uint32_t *items;
+    bc_float2_t origin;
+    bc_float_t inverseCellSize;
+    uint32_t columns;
+    uint32_t rows;
+    //exactly one of these is set
+    BCRectPair *pairs;
+    bool *hits;
+    size_t capacity;
+    size_t found;
+} __BCRectBroadPhase;
+
+static void __BCRectBroadPhaseBounds(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    __BCRectBroadPhase *b = context;
+    for (size_t i = begin; i < end; i++) {
+        const bc_float2_t max = BCRectMax(b->rects[i]);
+        //rects are symmetric about their center
+        const bc_float2_t min = 2 * b->rects[i].center - max;
+        b->bounds[i] = bc_make_float4(min, max);
+    }
+}
+
+static inline uint32_t __BCRectBroadPhaseCoordinate(bc_float_t value, bc_float_t origin, bc_float_t inverseCellSize, uint32_t limit) {
+    const bc_float_t c = (value - origin) * inverseCellSize;
+    if (!(c > 0)) { return 0; }
+    if (c >= limit - 1) { return limit - 1; }
+    return (uint32_t) c;
+}
+
+static void __BCRectBroadPhasePublish(__BCRectBroadPhase *b, const BCRectPair *local, size_t count) {
+    const size_t at = __atomic_fetch_add(&b->found, count, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < count && at + i < b->capacity; i++) {
+        b->pairs[at + i] = local[i];
+    }
+}
+
+static void __BCRectBroadPhaseCells(void *context, size_t begin, size_t end, unsigned worker) {
+    (void)worker;
+    __BCRectBroadPhase *b = context;
+    BCRectPair local[__BC_BROADPHASE_LOCAL_PAIRS];
+    size_t localCount = 0;
+    for (size_t cell = begin; cell < end; cell++) {
+        const uint32_t *items = b->items + b->cellStart[cell];
+        const size_t itemCount = b->cellStart[cell + 1] - b->cellStart[cell];
+        for (size_t m = 0; m < itemCount; m++) {
+            const uint32_t i = items[m];
+            const bc_float4_t bi = b->bounds[i];
+            for (size_t n = m + 1; n < itemCount; n++) {
+                const uint32_t j = items[n];
+                const bc_float4_t bj = b->bounds[j];
+                if (bi.z < bj.x || bj.z < bi.x || bi.w < bj.y || bj.w < bi.y) { continue; }
+                //the pair belongs to the cell with the minimum corner of the bounds' overlap, so other cells they share skip it
+                const uint32_t ownerColumn = __BCRectBroadPhaseCoordinate(bc_max(bi.x, bj.x), b->origin.x, b->inverseCellSize, b->columns);
+                const uint32_t ownerRow = __BCRectBroadPhaseCoordinate(bc_max(bi.y, bj.y), b->origin.y, b->inverseCellSize, b->rows);
+                if ((size_t) ownerRow * b->columns + ownerColumn != cell) { continue; }
+                if (b->hits) {
+                    if (__atomic_load_n(&b->hits[i], __ATOMIC_RELAXED) && __atomic_load_n(&b->hits[j], __ATOMIC_RELAXED)) { continue; }
+                    if (BCRectIntersects(b->rects[i], b->rects[j])) {
+                        __atomic_store_n(&b->hits[i], true, __ATOMIC_RELAXED);
+                        __atomic_store_n(&b->hits[j], true, __ATOMIC_RELAXED);
+                    }
+                }
+                else if (BCRectIntersects(b->rects[i], b->rects[j])) {
+                    local[localCount].a = i;
+                    local[localCount].b = j;
+                    if (++localCount == __BC_BROADPHASE_LOCAL_PAIRS) {
+                        __BCRectBroadPhasePublish(b, local, localCount);
+                        localCount = 0;
+                    }
+                }
+            }
+        }
+    }
+    if (localCount) { __BCRectBroadPhasePublish(b, local, localCount); }
+}
+
+static size_t __BCRectBroadPhaseRun(__BCRectBroadPhase *b, size_t count, bc_float_t cellSize, unsigned threads) {
+    b->bounds = malloc(sizeof(bc_float4_t) * count);
+    //scratch allocation can fail however valid the arguments, so it returns 0 at every check level
+    if (b->bounds == NULL) { return 0; }
+    __BCParallelFor(count, 4096, threads, __BCRectBroadPhaseBounds, b);
+
+    bc_float4_t extent = b->bounds[0];
+    bc_float_t sizeSum = 0;
+    for (size_t i = 0; i < count; i++) {
+        const bc_float4_t r = b->bounds[i];
+        extent = bc_make_float4(bc_min(extent.x, r.x), bc_min(extent.y, r.y), bc_max(extent.z, r.z), bc_max(extent.w, r.w));
+        sizeSum += bc_max(r.z - r.x, r.w - r.y);
+    }
+    //an infinite or NaN extent never fits in maxCells, however large the cells grow
+    __BC_ASSERT_CUSTOM(extent.z - extent.x <= BC_FLOAT_LARGE && extent.w - extent.y <= BC_FLOAT_LARGE, free(b->bounds); return 0);
+    if (cellSize <= 0) { cellSize = sizeSum / count; }
+    if (!(cellSize > 0)) { cellSize = 1; }
+    //a few cells per rect; more cells cost memory and empty work
+    const double maxCells = 2.0 * count + 64;
+    uint32_t columns;
+    uint32_t rows;
+    while (1) {
+        const double c = bc_floor((extent.z - extent.x) / cellSize) + 1;
+        const double r = bc_floor((extent.w - extent.y) / cellSize) + 1;
+        if (c * r <= maxCells) {
+            columns = (uint32_t) c;
+            rows = (uint32_t) r;
+            break;
+        }
+        cellSize *= 1.5f;
+    }
+    b->origin = extent.xy;
+    b->inverseCellSize = 1 / cellSize;
+    b->columns = columns;
+    b->rows = rows;
+    const size_t cells = (size_t) columns * rows;
+
+    size_t *cellStart = calloc(cells + 1, sizeof(size_t));
+    if (cellStart == NULL) { free(b->bounds); return 0; }
+    //count into cellStart[cell+1], so the prefix sum gives each cell's start
+    for (size_t i = 0; i < count; i++) {
+        const bc_float4_t r = b->bounds[i];
+        const uint32_t x0 = __BCRectBroadPhaseCoordinate(r.x, b->origin.x, b->inverseCellSize, columns);
+        const uint32_t x1 = __BCRectBroadPhaseCoordinate(r.z, b->origin.x, b->inverseCellSize, columns);
+        const uint32_t y0 = __BCRectBroadPhaseCoordinate(r.y, b->origin.y, b->inverseCellSize, rows);
+        const uint32_t y1 = __BCRectBroadPhaseCoordinate(r.w, b->origin.y, b->inverseCellSize, rows);
+        for (uint32_t y = y0; y <= y1; y++) {
+            for (uint32_t x = x0; x <= x1; x++) {
+                cellStart[(size_t) y * columns + x + 1]++;
+            }
+        }
+    }
+    for (size_t c = 0; c < cells; c++) { cellStart[c + 1] += cellStart[c]; }
+    uint32_t *items = malloc(sizeof(uint32_t) * (cellStart[cells] ? cellStart[cells] : 1));
+    if (items == NULL) { free(cellStart); free(b->bounds); return 0; }
+    //fill in index order, advancing cellStart[cell] as a cursor; afterwards cellStart[cell] is the old cellStart[cell+1]
+    for (size_t i = 0; i < count; i++) {
+        const bc_float4_t r = b->bounds[i];
+        const uint32_t x0 = __BCRectBroadPhaseCoordinate(r.x, b->origin.x, b->inverseCellSize, columns);
+        const uint32_t x1 = __BCRectBroadPhaseCoordinate(r.z, b->origin.x, b->inverseCellSize, columns);
+        const uint32_t y0 = __BCRectBroadPhaseCoordinate(r.y, b->origin.y, b->inverseCellSize, rows);
+        const uint32_t y1 = __BCRectBroadPhaseCoordinate(r.w, b->origin.y, b->inverseCellSize, rows);
+        for (uint32_t y = y0; y <= y1; y++) {
+            for (uint32_t x = x0; x <= x1; x++) {
+                items[cellStart[(size_t) y * columns + x]++] = (uint32_t) i;
+            }
+        }
+    }
+    memmove(cellStart + 1, cellStart, sizeof(size_t) * cells);
+    cellStart[0] = 0;
+    b->cellStart = cellStart;
+    b->items = items;
+
+    b->found = 0;
+    __BCParallelFor(cells, 64, threads, __BCRectBroadPhaseCells, b);
+    free(items);
+    free(cellStart);
+    free(b->bounds);
+    return b->found;
+}
+
+size_t BCRectIntersectingPairs(const BCRect *rects, size_t count, bc_float_t cellSize, unsigned threads, BCRectPair *pairs, size_t capacity) {
+    __BC_ASSERT(rects != NULL || count == 0, 0);
+    __BC_ASSERT(count < UINT32_MAX, 0);
+    __BC_ASSERT(pairs != NULL || capacity == 0, 0);
+    if (count < 2) { return 0; }
+    __BCRectBroadPhase b;
+    b.rects = rects;
+    b.pairs = pairs;
+    b.hits = NULL;
+    b.capacity = capacity;
+    return __BCRectBroadPhaseRun(&b, count, cellSize, threads);
+}
+
+size_t BCRectIntersectingFlags(const BCRect *rects, size_t count, bc_float_t cellSize, unsigned threads, bool *hits) {
+    __BC_ASSERT(rects != NULL || count == 0, 0);
+    __BC_ASSERT(count < UINT32_MAX, 0);
+    __BC_ASSERT(hits != NULL || count == 0, 0);
+    if (count < 2) {
+        if (count) { hits[0] = false; }
+        return 0;
+    }
+    memset(hits, 0, sizeof(bool) * count);
+    __BCRectBroadPhase b;
+    b.rects = rects;
+    b.pairs = NULL;
+    b.hits = hits;
+    b.capacity = 0;
+    __BCRectBroadPhaseRun(&b, count, cellSize, threads);
+    size_t hitCount = 0;
+    for (size_t i = 0; i < count; i++) { hitCount += hits[i]; }
+    return hitCount;
+}
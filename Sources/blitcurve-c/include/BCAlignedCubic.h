@@ -60,16 +60,16 @@ bc_float_t BCAlignedCubicKappa(BCAlignedCubic c, bc_float_t t);
 __attribute__((const))
 __attribute__((swift_name("AlignedCubic.__kappaPrime(self:t:)")))
 /**
- Private function.
- @discussion uses \c BUGASSERT to check arguments, rvalue is \c BC_FLOAT_LARGE.
+ Private function.  The derivative of kappa at 4 bezier parameters at once.
+ @discussion lanes where the derivative of the cubic vanishes are \c BC_FLOAT_LARGE.
  */
-bc_float_t __BCAlignedCubicKappaPrime(BCAlignedCubic c, bc_float_t t);
+bc_float4_t __BCAlignedCubicKappaPrime4(BCAlignedCubic c, bc_float4_t t);
 #endif
 
 /**This returns the bezier parameter \c (t) at which the maximum kappa can be found.
  @param c the cubic
  @param accuracy The maximum error allowed on \c t
- @performance This implements a binary search.
+ @performance This is \c BCAlignedCubicMaxKappaParameterWithBrackets with 5 brackets.
  @warning This function is UB if the curve has 0-length or the cubic not technically normalized (see \c BCCubicIsTechnicallyNormalized)`  In addition, "good behavior" requires a higher-than-normal normalization distance, see \c BCAlignedCubicIsNormalizedForCurvature for details.
  @throws rvalue is \c (-1-BCError)
  */
@@ -77,6 +77,30 @@ __attribute__((const))
 __attribute__((swift_name("AlignedCubic.maxKappaParameter(self:accuracy:)")))
 bc_float_t BCAlignedCubicMaxKappaParameter(BCAlignedCubic c, bc_float_t accuracy);
 
+/**This returns the bezier parameter \c (t) at which the maximum kappa can be found, searching a given number of brackets.
+ @discussion The interval [0,1] is divided into \c brackets equal brackets, and each bracket where the derivative of kappa changes sign is searched for its extremum.  More brackets find extrema that are close together, at the cost of more evaluations.
+ @param c the cubic
+ @param accuracy The maximum error allowed on \c t
+ @param brackets Number of brackets.  Must be positive.
+ @performance A binary search on all brackets at once, 4 brackets per SIMD lane group.  Each step evaluates the derivative of kappa only at the new midpoints.  Multiples of 4 use all lanes.
+ @warning This function is UB if the curve has 0-length or the cubic not technically normalized (see \c BCCubicIsTechnicallyNormalized)`  In addition, "good behavior" requires a higher-than-normal normalization distance, see \c BCAlignedCubicIsNormalizedForCurvature for details.
+ @throws rvalue is \c (-1-BCError)
+ */
+__attribute__((const))
+__attribute__((swift_name("AlignedCubic.maxKappaParameter(self:accuracy:brackets:)")))
+bc_float_t BCAlignedCubicMaxKappaParameterWithBrackets(BCAlignedCubic c, bc_float_t accuracy, uint8_t brackets);
+
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+/**Finds \c BCAlignedCubicMaxKappaParameterWithBrackets for many cubics.
+ @param cubics \c count cubics
+ @param output storage for \c count parameters.  Each is as \c BCAlignedCubicMaxKappaParameterWithBrackets, including its rvalue.
+ @performance Cubics are searched 8 at a time, one per SIMD lane, so every lane searches the same bracket and the bisection has no per-cubic branches.  Cubics whose search hits an error are searched again one at a time, to get the same rvalue.
+ */
+__attribute__((swift_name("AlignedCubic.maxKappaParameterBatch(_:count:accuracy:brackets:output:)")))
+void BCAlignedCubicMaxKappaParameterBatch(const BCAlignedCubic *cubics, size_t count, bc_float_t accuracy, uint8_t brackets, bc_float_t *output);
+#endif
+
 /** This returns the curvature radius at a given bezier parameter.
  @see This is the inverse of BCAlignedCubicKappa.
  @param t The bezier parameter on interval [0,1] at which to measure the curvature.
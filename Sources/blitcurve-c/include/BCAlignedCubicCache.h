@@ -0,0 +1,102 @@
+//BCAlignedCubicCache.h: Shape-keyed cache of BCAlignedCubic results
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCAlignedCubicCache_h
+#define BCAlignedCubicCache_h
+//the cache lives in caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCAlignedCubic.h"
+
+/**
+ \abstract Results cached for one aligned shape.
+ \discussion Each field is the result of the corresponding function on the shape's representative cubic, including its rvalue.
+ */
+__attribute__((swift_name("AlignedCubicCacheValue")))
+typedef struct {
+    ///\c BCAlignedCubicMaxKappaParameter.  \c BC_FLOAT_LARGE if the representative has a 0-length \c b_x, \c c or \c d arm, where kappa is undefined.
+    bc_float_t maxKappaParameter;
+    ///\c BCAlignedCubicKappa at \c maxKappaParameter, or \c BC_FLOAT_LARGE as above.
+    bc_float_t maxKappa;
+    ///\c BCCubicLengthWithStrategy, accurate to the cache's quantum
+    bc_float_t length;
+    ///\c BCAlignedCubicIsNormalizedForCurvature.  \c false if \c b_x is 0.
+    char isNormalizedForCurvature;
+} BCAlignedCubicCacheValue;
+
+struct __BCAlignedCubicCacheEntry;
+
+/**
+ \abstract Interns aligned cubics by shape, and remembers results that depend only on shape.
+ \discussion Many cubics align to the same shape (see \c BCAlignedCubic), for example a glyph drawn many times at different positions and angles.  The cache quantizes \c c, \c d and \c b_x to a grid of \c quantum, and computes results once per grid cell, on the cell's representative cubic.  So all cubics in a cell get the same results, and those differ from the exact results by about what a \c quantum change in the shape would cause.
+ 
+ The cache holds at most \c capacity shapes.  When it is full, the least recently used shape is evicted.
+ 
+ Create with \c BCAlignedCubicCacheMake.  The cache is not thread-safe; use one cache per thread, or synchronize externally.
+ */
+__attribute__((swift_name("AlignedCubicCache")))
+typedef struct {
+    struct __BCAlignedCubicCacheEntry *entries;
+    uint32_t *buckets;
+    uint32_t capacity;
+    uint32_t bucketMask;
+    uint32_t count;
+    //least and most recently used entries
+    uint32_t lruHead;
+    uint32_t lruTail;
+    bc_float_t quantum;
+    bc_float_t kappaAccuracy;
+    bc_float_t straightAngle;
+    bc_float_t curvatureError;
+    ///Number of lookups that found their shape
+    size_t hits;
+    ///Number of lookups that computed their shape
+    size_t misses;
+} BCAlignedCubicCache;
+
+/**
+ \abstract Returns the number of bytes of storage \c BCAlignedCubicCacheMake needs for \c capacity shapes.
+ \discussion This is about 64 bytes per shape.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((const))
+__attribute__((swift_name("AlignedCubicCache.storageSize(capacity:)")))
+size_t BCAlignedCubicCacheStorageSize(size_t capacity);
+
+/**
+ \abstract Creates an empty cache.
+ @param storage \c BCAlignedCubicCacheStorageSize(capacity) bytes, aligned as for \c malloc.  The cache uses it until the caller stops using the cache; it need not be initialized.
+ @param capacity maximum number of shapes.  Must be positive, and less than \c UINT32_MAX/2.
+ @param quantum grid spacing for the shape key.  Must be positive.  Results are computed to about this accuracy as well.
+ @param kappaAccuracy accuracy for \c BCAlignedCubicMaxKappaParameter
+ @param straightAngle \c straightAngle for \c BCAlignedCubicIsNormalizedForCurvature
+ @param curvatureError \c curvatureError for \c BCAlignedCubicIsNormalizedForCurvature
+ \throws Checks arguments with assert.  rvalue has a \c capacity of 0.
+ */
+__attribute__((swift_name("AlignedCubicCache.init(storage:capacity:quantum:kappaAccuracy:straightAngle:curvatureError:)")))
+BCAlignedCubicCache BCAlignedCubicCacheMake(void *storage, size_t capacity, bc_float_t quantum, bc_float_t kappaAccuracy, bc_float_t straightAngle, bc_float_t curvatureError);
+
+/**
+ \abstract Finds the results for the shape of \c cubic, computing them if the shape is not in the cache.
+ \discussion The shape becomes the most recently used.  If it was not in the cache and the cache is full, the least recently used shape is evicted.
+ 
+ A shape with a coordinate larger than \c quantum*2^24 can't be keyed at \c quantum resolution.  Its results are computed on \c cubic itself, counted as a miss, and not stored.
+ \performance A hit is a hash of the quantized shape and a short chain walk.  A miss also computes every result, which is dominated by the accurate length.
+ \throws Checks arguments with assert.  rvalue has every field \c (-1-BCError).
+ */
+__attribute__((swift_name("AlignedCubicCache.lookup(self:_:)")))
+BCAlignedCubicCacheValue BCAlignedCubicCacheLookup(BCAlignedCubicCache *cache, BCAlignedCubic cubic);
+
+/**
+ \abstract Aligns many cubics with \c BCAlignedCubicMake and looks up each one.
+ @param cubics \c count cubics
+ @param aligned If not \c NULL, storage for \c count aligned cubics.
+ @param output storage for \c count values, as \c BCAlignedCubicCacheLookup.
+ \throws Checks arguments with assert.
+ */
+__attribute__((swift_name("AlignedCubicCache.lookupBatch(self:_:count:aligned:output:)")))
+void BCAlignedCubicCacheLookupBatch(BCAlignedCubicCache *cache, const BCCubic *cubics, size_t count, BCAlignedCubic *aligned, BCAlignedCubicCacheValue *output);
+
+#endif //__METAL_VERSION__
+#endif //BCAlignedCubicCache_h
@@ -10,7 +10,9 @@
 #include "BCMacros.h"
 
 #ifndef __METAL_VERSION__
+#ifndef BC_PORTABLE_SIMD
 #include <simd/simd.h>
+#endif
 #include <stdbool.h>
 #endif
 
@@ -27,9 +29,18 @@ typedef struct {
     
 } BCAlignedRect;
 
+//implementation detail of BCAlignedRectCreateFromCubic.  Evaluates the cubic with a separate parameter per axis, t.x for x and t.y for y.
+__attribute__((const))
+static inline bc_float2_t __BCAlignedRectCubicEvaluateAxes(BCCubic c, bc_float2_t t) {
+    const bc_float2_t mt = 1 - t;
+    return mt * mt * mt * c.a + 3 * mt * mt * t * c.c + 3 * mt * t * t * c.d + t * t * t * c.b;
+}
+
 /**
  \abstract Calculates a bounding box for a cubic.
-\param strategy The only value supported currently is \c fastest, which is O(1) and ~4 SIMD instructions
+\param strategy \c fastest bounds the control points, which is O(1) and ~4 SIMD instructions.  For curvy cubics this can be much larger than the curve.
+
+ \c accurate is the tightest box: it bounds the endpoints and the points where the derivative is 0 on each axis.  This is a quadratic solve and a few evaluations, without branches.
  \throws Checks the arguments with assert.  \c rvalue for the error case is a 0-sized rect.
  */
 __attribute__((swift_name("AlignedRect.init(cubic:strategy:)")))
@@ -44,6 +55,38 @@ static inline BCAlignedRect BCAlignedRectCreateFromCubic(BCCubic c, BCStrategy s
             b.max = bc_make_float2(bc_reduce_max(x),bc_reduce_max(y));
             return b;
         }
+        case BCStrategyAccurate: {
+            /*
+             B'(t)/3 = (1-t)²(c-a) + 2t(1-t)(d-c) + t²(b-d) = At² + Bt + C per axis.
+             Evaluating at any t in [0,1] gives a point on the curve, so candidates that are not roots are clamped into range and do no harm.
+             That avoids branches: the quadratic roots are found with a regularized division, and the linear root covers A==0, where those fail.
+             The extremum value is insensitive to error in its parameter, since the derivative is 0 there, so the simple quadratic formula is enough.
+             */
+            const bc_float2_t p0 = c.c - c.a;
+            const bc_float2_t p1 = c.d - c.c;
+            const bc_float2_t p2 = c.b - c.d;
+            const bc_float2_t qa = p0 - 2 * p1 + p2;
+            const bc_float2_t qb = 2 * (p1 - p0);
+            const bc_float2_t qc = p0;
+            const bc_float2_t discriminant = qb * qb - 4 * qa * qc;
+            const bc_float2_t root = bc_make_float2(bc_sqrt(bc_max(discriminant.x, 0.0f)), bc_sqrt(bc_max(discriminant.y, 0.0f)));
+            //x/y computed as x*y/(y*y+epsilon), which is finite for y==0
+            const bc_float2_t quadraticScale = qa / (2 * qa * qa + 1e-30f);
+            const bc_float2_t candidates[3] = {
+                (-qb + root) * quadraticScale,
+                (-qb - root) * quadraticScale,
+                -qc * qb / (qb * qb + 1e-30f),
+            };
+            b.min = bc_make_float2(bc_min(c.a.x, c.b.x), bc_min(c.a.y, c.b.y));
+            b.max = bc_make_float2(bc_max(c.a.x, c.b.x), bc_max(c.a.y, c.b.y));
+            for (int i = 0; i < 3; i++) {
+                const bc_float2_t t = bc_make_float2(bc_max(0.0f, bc_min(1.0f, candidates[i].x)), bc_max(0.0f, bc_min(1.0f, candidates[i].y)));
+                const bc_float2_t p = __BCAlignedRectCubicEvaluateAxes(c, t);
+                b.min = bc_make_float2(bc_min(b.min.x, p.x), bc_min(b.min.y, p.y));
+                b.max = bc_make_float2(bc_max(b.max.x, p.x), bc_max(b.max.y, p.y));
+            }
+            return b;
+        }
             
         default: {
             b.min = 0;
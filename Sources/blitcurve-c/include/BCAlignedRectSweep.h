@@ -0,0 +1,77 @@
+//BCAlignedRectSweep.h: Sweep-and-prune broad phase over BCAlignedRect
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCAlignedRectSweep_h
+#define BCAlignedRectSweep_h
+//the sweep lives in caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCAlignedRect.h"
+#include "BCRectBroadPhase.h"
+
+struct __BCAlignedRectSweepEntry;
+
+/**
+ \abstract A sort-based broad phase that keeps its sort between frames.
+ \discussion Rects are kept sorted by \c min.x.  Sweeping in that order, each rect is only compared with the following rects whose \c min.x is at most its \c max.x, and those are tested for overlap on y 8 at a time.
+ 
+ When rects move coherently, their order changes little between frames, so \c BCAlignedRectSweepUpdate restores it with an insertion sort that is about linear.  This is much cheaper than sorting or binning from scratch.
+ 
+ The sweep has a fixed number of rects, identified by their index in the arrays passed to \c BCAlignedRectSweepMake and \c BCAlignedRectSweepUpdate.  Create with \c BCAlignedRectSweepMake.
+ */
+__attribute__((swift_name("AlignedRectSweep")))
+typedef struct {
+    ///sorted by min.x
+    struct __BCAlignedRectSweepEntry *entries;
+    //bounds in sorted order, each padded with 8 elements that overlap nothing
+    bc_float_t *minX;
+    bc_float_t *maxX;
+    bc_float_t *minY;
+    bc_float_t *maxY;
+    ///Number of rects
+    uint32_t count;
+} BCAlignedRectSweep;
+
+/**
+ \abstract Returns the number of bytes of storage \c BCAlignedRectSweepMake needs for \c count rects.
+ \discussion This is about 24 bytes per rect.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((const))
+__attribute__((swift_name("AlignedRectSweep.storageSize(count:)")))
+size_t BCAlignedRectSweepStorageSize(size_t count);
+
+/**
+ \abstract Creates a sweep over \c count rects, sorting them.
+ @param storage \c BCAlignedRectSweepStorageSize(count) bytes, aligned as for \c malloc.  It need not be initialized.
+ @param rects \c count rects.  \c count must be positive and less than \c UINT32_MAX.
+ \performance O(n log n)
+ \throws Checks arguments with assert.  rvalue has a \c count of 0.
+ */
+__attribute__((swift_name("AlignedRectSweep.init(storage:rects:count:)")))
+BCAlignedRectSweep BCAlignedRectSweepMake(void *storage, const BCAlignedRect *rects, size_t count);
+
+/**
+ \abstract Moves the rects to new bounds, and restores the sort.
+ @param rects \c count rects, in the same order as passed to \c BCAlignedRectSweepMake.
+ @return the number of positions rects moved in the sort.  This is a measure of coherence; when it is large compared to \c count, the sort is doing more work than sorting from scratch would.
+ \performance O(n + k) for k moved positions.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("AlignedRectSweep.update(self:rects:)")))
+size_t BCAlignedRectSweepUpdate(BCAlignedRectSweep *sweep, const BCAlignedRect *rects);
+
+/**
+ \abstract Finds every pair of overlapping rects.
+ \discussion Rects that touch overlap.  These are candidates; refine them with \c BCRectIntersects, \c BCAlignedRectsCornerWithinDistance or similar.
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.  The sweep is divided between the threads.
+ @param pairs storage for \c capacity pairs.  Pairs are in no particular order.
+ @return the number of pairs.  If this is more than \c capacity, only \c capacity pairs are written.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("AlignedRectSweep.overlappingPairs(self:threads:pairs:capacity:)")))
+size_t BCAlignedRectSweepOverlappingPairs(const BCAlignedRectSweep *sweep, unsigned threads, BCRectPair *pairs, size_t capacity);
+
+#endif //__METAL_VERSION__
+#endif //BCAlignedRectSweep_h
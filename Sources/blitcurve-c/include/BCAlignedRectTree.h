@@ -0,0 +1,145 @@
+//BCAlignedRectTree.h: Dynamic bounding volume tree over BCAlignedRect
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCAlignedRectTree_h
+#define BCAlignedRectTree_h
+//the tree lives in caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCAlignedRect.h"
+
+///A leaf that is not in the tree
+#define BCAlignedRectTreeNull UINT32_MAX
+
+///Data of two leaves whose bounds overlap
+__attribute__((swift_name("AlignedRectTreePair")))
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} BCAlignedRectTreePair;
+
+struct __BCAlignedRectTreeNode;
+
+/**
+ \abstract A bounding volume tree that can be changed incrementally, for things that move a little at a time.
+ \discussion Each leaf stores a "fat" \c BCAlignedRect: its rect grown by \c margin on each side.  Moving a leaf is free while its rect stays inside its fat rect, so small per-frame motion rarely changes the tree.  When it does leave, the leaf is removed and inserted again.  Inserting walks down to the sibling that grows the tree's bounds least, and the tree is rebalanced with rotations on the way up, so its height stays logarithmic.
+ 
+ Leaves are identified by the value \c BCAlignedRectTreeInsert returns, which stays the same until the leaf is removed.  Each leaf also carries a \c data value of the caller's choosing, such as a cubic index, which queries report.
+ 
+ Create with \c BCAlignedRectTreeMake.  The tree is not thread-safe for changes; queries may run concurrently with each other.
+ */
+__attribute__((swift_name("AlignedRectTree")))
+typedef struct {
+    struct __BCAlignedRectTreeNode *nodes;
+    uint32_t nodeCapacity;
+    uint32_t root;
+    uint32_t freeList;
+    ///Number of leaves in the tree
+    uint32_t leafCount;
+    bc_float_t margin;
+} BCAlignedRectTree;
+
+/**
+ \abstract Returns the number of bytes of storage \c BCAlignedRectTreeMake needs for \c leafCapacity leaves.
+ \discussion This is 80 bytes per leaf.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((const))
+__attribute__((swift_name("AlignedRectTree.storageSize(leafCapacity:)")))
+size_t BCAlignedRectTreeStorageSize(size_t leafCapacity);
+
+/**
+ \abstract Creates an empty tree.
+ @param storage \c BCAlignedRectTreeStorageSize(leafCapacity) bytes, aligned as for \c malloc.  It need not be initialized.
+ @param leafCapacity maximum number of leaves.  Must be positive, and less than \c UINT32_MAX/2.
+ @param margin distance to grow each leaf's rect on each side.  Larger margins restructure less often, but make queries report more false positives.  Must not be negative.
+ \throws Checks arguments with assert.  rvalue has a \c nodeCapacity of 0.
+ */
+__attribute__((swift_name("AlignedRectTree.init(storage:leafCapacity:margin:)")))
+BCAlignedRectTree BCAlignedRectTreeMake(void *storage, size_t leafCapacity, bc_float_t margin);
+
+/**
+ \abstract Inserts a leaf.
+ @param rect the leaf's bounds.  The tree stores it grown by the margin.
+ @param data a value reported by queries for this leaf
+ @return the leaf.
+ \performance O(log n)
+ \throws Checks arguments with assert.  If the tree is full, traps as a precondition.  rvalue is \c BCAlignedRectTreeNull.
+ */
+__attribute__((swift_name("AlignedRectTree.insert(self:_:data:)")))
+uint32_t BCAlignedRectTreeInsert(BCAlignedRectTree *tree, BCAlignedRect rect, uint32_t data);
+
+/**
+ \abstract Inserts a leaf for a cubic, bounded with \c BCAlignedRectCreateFromCubic.
+ \throws As \c BCAlignedRectTreeInsert.
+ */
+__attribute__((swift_name("AlignedRectTree.insert(self:cubic:data:)")))
+uint32_t BCAlignedRectTreeInsertCubic(BCAlignedRectTree *tree, BCCubic cubic, uint32_t data);
+
+/**
+ \abstract Removes a leaf.
+ \performance O(log n)
+ \throws Checks arguments with assert.
+ */
+__attribute__((swift_name("AlignedRectTree.remove(self:_:)")))
+void BCAlignedRectTreeRemove(BCAlignedRectTree *tree, uint32_t leaf);
+
+/**
+ \abstract Moves a leaf to new bounds.
+ \discussion If \c rect is inside the leaf's fat rect, nothing changes.  Otherwise the leaf is reinserted with a new fat rect.
+ @return whether the tree was restructured.
+ \performance O(1) if \c rect is inside the fat rect, otherwise O(log n)
+ \throws Checks arguments with assert.  rvalue is \c false.
+ */
+__attribute__((swift_name("AlignedRectTree.update(self:_:rect:)")))
+bool BCAlignedRectTreeUpdate(BCAlignedRectTree *tree, uint32_t leaf, BCAlignedRect rect);
+
+/**
+ \abstract Moves many leaves to the bounds of their cubics, as \c BCAlignedRectTreeUpdate.
+ @param leaves \c count leaves
+ @param cubics \c count cubics.  Each is bounded with \c BCAlignedRectCreateFromCubic.
+ @return the number of leaves that were reinserted.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("AlignedRectTree.updateCubics(self:_:cubics:count:)")))
+size_t BCAlignedRectTreeUpdateCubics(BCAlignedRectTree *tree, const uint32_t *leaves, const BCCubic *cubics, size_t count);
+
+/**
+ \abstract Returns a leaf's fat rect.
+ \throws Checks arguments with assert.  rvalue is a 0-sized rect.
+ */
+__attribute__((swift_name("AlignedRectTree.fatRect(self:_:)")))
+BCAlignedRect BCAlignedRectTreeFatRect(const BCAlignedRectTree *tree, uint32_t leaf);
+
+/**
+ \abstract Finds the leaves whose fat rects overlap a region.
+ \discussion Rects that touch overlap.
+ @param output storage for \c capacity data values.
+ @return the number of leaves found.  If this is more than \c capacity, only \c capacity values are written.
+ \performance O(log n + k) for k results, with a fixed-size stack and no allocation.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("AlignedRectTree.query(self:_:output:capacity:)")))
+size_t BCAlignedRectTreeQuery(const BCAlignedRectTree *tree, BCAlignedRect region, uint32_t *output, size_t capacity);
+
+/**
+ \abstract Finds every pair of leaves whose fat rects overlap.
+ \discussion Each pair is reported once.  Since fat rects are conservative, these are candidates for a narrow phase test.
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.  Leaves are divided between the threads.
+ @param pairs storage for \c capacity pairs.  Pairs are in no particular order.
+ @return the number of pairs.  If this is more than \c capacity, only \c capacity pairs are written.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("AlignedRectTree.overlappingPairs(self:threads:pairs:capacity:)")))
+size_t BCAlignedRectTreeOverlappingPairs(const BCAlignedRectTree *tree, unsigned threads, BCAlignedRectTreePair *pairs, size_t capacity);
+
+///Checks the tree's structure, bounds and heights.  For testing.
+__attribute__((swift_private))
+bool __BCAlignedRectTreeIsValid(const BCAlignedRectTree *tree);
+///Returns the height of the tree, where a single leaf is 0.  For testing.
+__attribute__((swift_private))
+int __BCAlignedRectTreeHeight(const BCAlignedRectTree *tree);
+
+#endif //__METAL_VERSION__
+#endif //BCAlignedRectTree_h
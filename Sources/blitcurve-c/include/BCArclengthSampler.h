@@ -0,0 +1,112 @@
+//BCArclengthSampler.h: Streaming arclength sampling and dashing along a sequence of cubics
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCArclengthSampler_h
+#define BCArclengthSampler_h
+//samplers write to caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include "BCCubic.h"
+
+/**
+ \abstract A point sampled at a given arclength.
+ */
+__attribute__((swift_name("ArclengthSample")))
+typedef struct {
+    ///Point on the cubic
+    bc_float2_t position;
+    ///Unit tangent at \c position.  This is 0 where the derivative vanishes (a cusp or a degenerate cubic).
+    bc_float2_t tangent;
+    ///Bezier parameter of \c position
+    bc_float_t t;
+} BCArclengthSample;
+
+/**
+ \abstract Places samples at a fixed arclength spacing along a sequence of cubics.
+ \discussion Compared to calling \c BCCubicArclengthParameterization once per sample, the sampler walks each cubic once, and each sample starts its search from the previous one.
+ The sampler carries the distance to its next sample from one cubic to the next, so the spacing is uniform across a path made of several cubics.
+ */
+__attribute__((swift_name("ArclengthSampler")))
+typedef struct {
+    ///Arclength between samples.
+    bc_float_t spacing;
+    ///Arclength from the start of the next cubic to the next sample.
+    bc_float_t distance;
+} BCArclengthSampler;
+
+/**
+ \abstract Creates a sampler.
+ @param spacing arclength between samples.  Must be positive.
+ @param offset arclength from the start of the first cubic to the first sample.  Must not be negative.
+ \throws Checks arguments with assert.  rvalue is a sampler with \c spacing 0, which produces no samples.
+ */
+__attribute__((swift_name("ArclengthSampler.init(spacing:offset:)")))
+BCArclengthSampler BCArclengthSamplerMake(bc_float_t spacing, bc_float_t offset);
+
+/**
+ \abstract Samples the next cubic in the sequence, and advances the sampler past it.
+ \discussion Arclength is measured with Gauss-Legendre quadrature, like \c BCCubicLengthWithStrategy with \c BCStrategyAccurate.  A sample that falls exactly on the end of the cubic is emitted at the start of the next cubic instead.
+ @param output storage for \c capacity samples
+ @return The number of samples in this cubic.  If this is more than \c capacity, only the first \c capacity samples are written, but the sampler still advances past the whole cubic.  The number of samples is at most <tt>floor((length - distance) / spacing) + 1</tt>.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("ArclengthSampler.sample(self:cubic:output:capacity:)")))
+size_t BCArclengthSamplerSampleCubic(BCArclengthSampler *sampler, BCCubic cubic, BCArclengthSample *output, size_t capacity);
+
+/**
+ \abstract Samples a sequence of cubics.
+ \discussion Equivalent to calling \c BCArclengthSamplerSampleCubic on each cubic in turn, with the output of each following the last.
+ @param cubicIndices If not \c NULL, storage for \c capacity indices.  Each is the index of the cubic that its sample lies on.
+ @return The number of samples.  As with \c BCArclengthSamplerSampleCubic, at most \c capacity are written.
+ */
+__attribute__((swift_name("ArclengthSampler.sample(self:cubics:cubicCount:output:cubicIndices:capacity:)")))
+size_t BCArclengthSamplerSampleCubics(BCArclengthSampler *sampler, const BCCubic *cubics, size_t cubicCount, BCArclengthSample *output, size_t *cubicIndices, size_t capacity);
+
+/**
+ \abstract Cuts a sequence of cubics into dashes.
+ \discussion The dash pattern alternates "on" and "off" arclengths, starting with "on".  The dasher carries its place in the pattern from one cubic to the next.
+ A dash that crosses the end of a cubic is emitted as one piece per cubic.  The end of one piece is the start of the next.
+ */
+__attribute__((swift_name("Dasher")))
+typedef struct {
+    ///Pattern of arclengths, alternating on and off.  The dasher does not own this storage.
+    const bc_float_t *pattern;
+    ///Number of entries in \c pattern.  This is even, or 0 for an error.
+    size_t patternCount;
+    ///Current entry in \c pattern
+    size_t index;
+    ///Arclength remaining in the current entry
+    bc_float_t remaining;
+} BCDasher;
+
+/**
+ \abstract Creates a dasher.
+ @param pattern \c patternCount arclengths, alternating on and off.  None may be negative, and the sum must be positive.  This must outlive the dasher.
+ @param patternCount Must be even and nonzero.
+ @param phase arclength into the pattern at which the first cubic starts.  Must not be negative.
+ \throws Checks arguments with assert.  rvalue is a dasher with \c patternCount 0, which produces no dashes.
+ */
+__attribute__((swift_name("Dasher.init(pattern:patternCount:phase:)")))
+BCDasher BCDasherMake(const bc_float_t *pattern, size_t patternCount, bc_float_t phase);
+
+/**
+ \abstract Dashes the next cubic in the sequence, and advances the dasher past it.
+ \discussion An on entry of length \c 0, or no longer than \c 1e-5 of the cubic's length, produces a degenerate piece whose control points are all the same point.  So the pattern \c {0,10} draws dots, when the stroke has round or square caps.
+ @param output storage for \c capacity cubics.  Each is the part of \c cubic covered by one dash.
+ @return The number of dash pieces in this cubic.  If this is more than \c capacity, only the first \c capacity pieces are written, but the dasher still advances past the whole cubic.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Dasher.dash(self:cubic:output:capacity:)")))
+size_t BCDasherDashCubic(BCDasher *dasher, BCCubic cubic, BCCubic *output, size_t capacity);
+
+/**
+ \abstract Dashes a sequence of cubics.
+ \discussion Equivalent to calling \c BCDasherDashCubic on each cubic in turn, with the output of each following the last.
+ @param cubicIndices If not \c NULL, storage for \c capacity indices.  Each is the index of the cubic that its piece was cut from.
+ @return The number of dash pieces.  As with \c BCDasherDashCubic, at most \c capacity are written.
+ */
+__attribute__((swift_name("Dasher.dash(self:cubics:cubicCount:output:cubicIndices:capacity:)")))
+size_t BCDasherDashCubics(BCDasher *dasher, const BCCubic *cubics, size_t cubicCount, BCCubic *output, size_t *cubicIndices, size_t capacity);
+
+#endif //__METAL_VERSION__
+#endif //BCArclengthSampler_h
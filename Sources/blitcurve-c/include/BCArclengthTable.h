@@ -0,0 +1,82 @@
+//BCArclengthTable.h: Precomputed arclength parameterization
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCArclengthTable_h
+#define BCArclengthTable_h
+//tables use caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include "BCCubic.h"
+
+/**
+ \abstract A table of arclengths for one cubic, for answering many arclength parameterization queries.
+ \discussion \c BCCubicArclengthParameterization does an iterative search on every call.  When parameterizing the same cubic many times, build a table once with \c BCArclengthTableMake and query it instead.
+
+ The table samples the cubic at \c count evenly-spaced bezier parameters.  \c lengths[i] is the arclength from \c a to the bezier parameter \c i/(count-1), using the same estimate as \c BCCubicArclengthParameterization (\c BCCubicLength of the left split).  Lengths are non-decreasing.
+
+ Queries interpolate linearly between samples, so accuracy improves with \c count.  For random cubics, the mean error is about 0.04% of the length with 32 samples, and 0.001% with 256.  Cubics with cusps have larger error near the cusp, up to a few percent with 32 samples and about 0.2% with 256.
+ \note The table does not own its storage.  Queries read it, so they see any change the caller makes to it.
+ */
+__attribute__((swift_name("ArclengthTable")))
+typedef struct {
+    ///\c count arclengths.
+    const bc_float_t *lengths;
+    ///Number of samples in the table.  This is at least 2, or 0 for an error.
+    size_t count;
+} BCArclengthTable;
+
+/**
+ \abstract Builds an arclength table for a cubic.
+ @param cubic cubic to sample
+ @param storage storage for \c count floats.  This must outlive the table.
+ @param count number of samples.  Must be at least 2.
+ \throws Checks arguments with assert.  rvalue is a table with \c count 0.
+ */
+__attribute__((swift_name("ArclengthTable.init(cubic:storage:count:)")))
+BCArclengthTable BCArclengthTableMake(BCCubic cubic, bc_float_t *storage, size_t count);
+
+/**
+ \abstract Builds arclength tables for many cubics.
+ \discussion Equivalent to calling \c BCArclengthTableMake for each cubic, with table \c i using \c storage+i*samples.
+ @param cubics \c cubicCount cubics
+ @param samples number of samples per table.  Must be at least 2.
+ @param storage storage for \c cubicCount*samples floats
+ @param output storage for \c cubicCount tables
+ \performance Builds 8 tables at a time with \c BCCubic8, with a scalar tail.
+ \throws Checks arguments with assert.  rvalue is that all output tables have \c count 0.
+ */
+__attribute__((swift_name("ArclengthTable.makeBatch(cubics:cubicCount:samples:storage:output:)")))
+void BCArclengthTableMakeBatch(const BCCubic *cubics, size_t cubicCount, size_t samples, bc_float_t *storage, BCArclengthTable *output);
+
+/**
+ \abstract The arclength of the entire cubic.
+ \throws Checks arguments with rangeassert.  rvalue is \c (-1-BCError).
+ */
+__attribute__((pure))
+__attribute__((swift_name("getter:ArclengthTable.length(self:)")))
+static inline bc_float_t BCArclengthTableLength(BCArclengthTable table) {
+    __BC_RANGEASSERT(table.count >= 2, (-1-BCErrorArg0));
+    return table.lengths[table.count - 1];
+}
+
+/**
+ \abstract Finds the bezier parameter at a given arclength from \c cubic.a (distance to \c t).
+ \discussion Like \c BCCubicArclengthParameterization, arclengths at or beyond the length of the cubic return 1.
+ \performance A binary search over the table, plus an interpolation.
+ \throws Checks arguments with rangeassert.  rvalue is \c (-1-BCError).
+ */
+__attribute__((pure))
+__attribute__((swift_name("ArclengthTable.parameterization(self:arclength:)")))
+bc_float_t BCArclengthTableParameterization(BCArclengthTable table, bc_float_t arclength);
+
+/**
+ \abstract Finds the arclength from \c cubic.a to a given bezier parameter (\c t to distance).
+ \performance O(1), an interpolation between two samples.
+ \throws Checks arguments with rangeassert.  rvalue is \c (-1-BCError).
+ */
+__attribute__((pure))
+__attribute__((swift_name("ArclengthTable.arclength(self:t:)")))
+bc_float_t BCArclengthTableArclength(BCArclengthTable table, bc_float_t t);
+
+#endif //__METAL_VERSION__
+#endif //BCArclengthTable_h
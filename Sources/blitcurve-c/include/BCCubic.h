@@ -11,13 +11,16 @@
 #include "BCLine2.h"
 #include "BCCubic2.h"
 #include "BCTrap.h"
+#include "BCStrategy.h"
 
 #ifndef __METAL_VERSION__
 #include <stdbool.h>
 #include <float.h>
 #endif
 
+#ifndef BC_PORTABLE_SIMD
 #include <simd/simd.h>
+#endif
 ///\abstract BCCubic is a cubic bezier curve defined on 4 points.
 ///\discussion Unlike some other notation, we use \c a and \c b consistently for start and end points, reserving other values for control points.
 __attribute__((swift_name("Cubic")))
@@ -417,6 +420,19 @@ __attribute__((const))
 __attribute__((swift_name("getter:Cubic.length(self:)")))
 bc_float_t BCCubicLength(BCCubic c);
 
+/**
+ \abstract Calculates the arclength, with a choice of algorithm.
+ @param tolerance maximum error, in distance units.  Must be positive.
+ @param strategy
+ * \c fastest is \c BCCubicLength, and ignores \c tolerance.  This has no error control, and is off by several percent for highly curved cubics.
+ * \c accurate integrates the speed \c |BCCubicEvaluatePrime| by 8-point Gauss-Legendre quadrature, subdividing until the estimated error is within \c tolerance.
+ \performance \c accurate evaluates all 8 quadrature nodes of an interval together in SIMD.  Smooth cubics need only a few splits; cubics that nearly cusp subdivide further, up to a depth of 16.  This is much slower than \c fastest, about 30x for random cubics at a tolerance of 0.01.
+ \throws Checks arguments with assert.  rvalue is \c (-1-BCError).
+ */
+__attribute__((const))
+__attribute__((swift_name("Cubic.length(self:tolerance:strategy:)")))
+bc_float_t BCCubicLengthWithStrategy(BCCubic c, bc_float_t tolerance, BCStrategy strategy);
+
 
 ///Splits the curve at a given bezier parameter
 ///\performance O(1)
@@ -456,6 +472,45 @@ static inline bc_float_t BCCubicArclengthParameterization(BCCubic cubic, bc_floa
     return BCCubicArclengthParameterizationWithBounds(cubic, length, 0, 1, threshold);
 }
 
+/**
+ \abstract Performs an arclength parameterization, with a choice of algorithm.  This finds a bezier parameter \c t (in range 0,1) that is a length specified from \c cubic.a.
+ \param threshold Accuracy, in distance units
+ \param strategy
+ * \c fastest is \c BCCubicArclengthParameterization: a bisection on the \c BCCubicLength estimate.  Each iteration gains one bit of \c t and costs a split and a length estimate, so small thresholds take 20 or more iterations.
+ * \c accurate measures arclength by Gauss-Legendre quadrature of the speed \c |BCCubicEvaluatePrime|, and solves for \c t with Newton-Raphson steps, falling back to bisection when a step leaves the bracket.  Stops when the arclength at \c t is within \c threshold.  This usually takes 2-3 iterations, and is about 3 times faster than \c fastest at the same threshold.
+ Because the two strategies measure arclength differently, they return slightly different values.  Arclengths at or beyond the length of the cubic return 1 for either strategy.
+ \throws Checks arguments with assert.  rvalue is \c (-1-BCError).
+ */
+__attribute__((const))
+__attribute__((swift_name("Cubic.parameterization(self:arclength:threshold:strategy:)")))
+bc_float_t BCCubicArclengthParameterizationWithStrategy(BCCubic cubic, bc_float_t arclength, bc_float_t threshold, BCStrategy strategy);
+
+///Arclength between two bezier parameters, by 8-point Gauss-Legendre quadrature of \c |BCCubicEvaluatePrime|.  This is accurate for short intervals, and is the building block of the \c accurate strategies.  If \c t1<t0 the result is negative.
+__attribute__((const))
+__attribute__((swift_private))
+bc_float_t __BCCubicArclengthBetween(BCCubic c, bc_float_t t0, bc_float_t t1);
+
+///Like \c __BCCubicArclengthBetween, but subdivides until the estimated error is within \c tolerance, like \c BCCubicLengthWithStrategy.
+__attribute__((const))
+__attribute__((swift_private))
+bc_float_t __BCCubicArclengthBetweenWithTolerance(BCCubic c, bc_float_t t0, bc_float_t t1, bc_float_t tolerance);
+
+///Result of an iterative arclength parameterization, with the iteration count for benchmarks.
+typedef struct {
+    bc_float_t t;
+    uint16_t iterations;
+} __BCArclengthParameterizationResult;
+
+///Implements \c BCCubicArclengthParameterizationWithBounds.  \see \c __BCArclengthParameterizationResult
+__attribute__((const))
+__attribute__((swift_private))
+__BCArclengthParameterizationResult __BCCubicArclengthParameterizationBisection(BCCubic cubic, bc_float_t arclength, bc_float_t lowerBound, bc_float_t upperBound, bc_float_t threshold);
+
+///Implements the \c accurate strategy of \c BCCubicArclengthParameterizationWithStrategy.  \see \c __BCArclengthParameterizationResult
+__attribute__((const))
+__attribute__((swift_private))
+__BCArclengthParameterizationResult __BCCubicArclengthParameterizationNewton(BCCubic cubic, bc_float_t arclength, bc_float_t threshold);
+
 /**Determines if the given cubic is normalized with a method appropriate for curvature calculations.
  \discussion See the documentation for \c BCCubicNormalize and \c BCNormalizationDistanceForCubicCurvatureError
  \seealso see \c BCAlignedCubicIsNormalizedForCurvature, a variant for the BCAlignedCubic case.
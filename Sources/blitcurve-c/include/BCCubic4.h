@@ -0,0 +1,93 @@
+//BCCubic4.h: Four BCCubic in a SIMD configuration
+// ©2021 DrewCrawfordApps LLC
+#ifndef BCCubic4_h
+#define BCCubic4_h
+#include "BCCubic.h"
+#include "BCAlignedRect.h"
+#include "BCMetalC.h"
+#include "BCMath.h"
+//requires 8-wide vectors
+#ifndef BC_NO_VEC8
+
+/**
+ \abstract Four \c BCCubic in a SIMD configuration.
+ \discussion Like \c BCCubic2, points are interleaved: \c a holds \c a.x,a.y of cubic 0, then \c a.x,a.y of cubic 1, and so on.
+ Functions that take or return a \c bc_float4_t use lane \c i for cubic \c i.
+ \seealso \c BCCubic4Pack and \c BCCubic4Unpack to convert from/to arrays of \c BCCubic
+ */
+__attribute__((swift_name("Cubic4")))
+typedef struct {
+    bc_float8_t a;
+    bc_float8_t b;
+    bc_float8_t c;
+    bc_float8_t d;
+} BCCubic4;
+
+///\abstract Repeats each lane of \c t, so it can be multiplied against interleaved points.
+__attribute__((const))
+static inline bc_float8_t __BCCubic4Parameter(bc_float4_t t) {
+    return t.s00112233;
+}
+
+///\abstract Packs 4 cubics into a \c BCCubic4
+///\param cubics An array of at least 4 cubics
+__attribute__((swift_name("Cubic4.init(packing:)")))
+BCCubic4 BCCubic4Pack(const BCCubic *cubics);
+
+///\abstract Unpacks a \c BCCubic4 into 4 cubics
+///\param output storage for 4 cubics
+__attribute__((swift_name("Cubic4.unpack(self:into:)")))
+void BCCubic4Unpack(BCCubic4 c, BCCubic *output);
+
+///\abstract Evaluate each cubic for the bezier parameter in its lane
+///\return Points on each cubic, interleaved as \c x,y pairs
+__attribute__((const))
+__attribute__((swift_name("Cubic4.evaluate(self:t:)")))
+inline bc_float8_t BCCubic4Evaluate(BCCubic4 c, bc_float4_t t) {
+    const bc_float8_t t2 = __BCCubic4Parameter(t);
+    const bc_float8_t one_minus_t = 1 - t2;
+    return c.a * one_minus_t * __bc_square(one_minus_t) + c.c * 3 * __bc_square(one_minus_t) * t2 + c.d * 3 * one_minus_t * __bc_square(t2) + c.b * t2 * __bc_square(t2);
+}
+
+///\abstract Evaluate the derivative of each cubic for the bezier parameter in its lane
+///\return Points on each derivative, interleaved as \c x,y pairs
+__attribute__((const))
+__attribute__((swift_name("Cubic4.evaluatePrime(self:t:)")))
+inline bc_float8_t BCCubic4EvaluatePrime(BCCubic4 c, bc_float4_t t) {
+    const bc_float8_t t2 = __BCCubic4Parameter(t);
+    const bc_float8_t one_minus_t = 1 - t2;
+    const bc_float8_t three_by_one_minus_t_squared = 3 * __bc_square(one_minus_t);
+    const bc_float8_t three_by_t_squared = 3 * __bc_square(t2);
+    const bc_float8_t six_by_1_minus_t_t = 6 * one_minus_t * t2;
+    return three_by_one_minus_t_squared * (c.c - c.a) + six_by_1_minus_t_t * (c.d - c.c) + three_by_t_squared * (c.b - c.d);
+}
+
+///\abstract Estimates the length of each cubic.
+///\discussion Uses the same estimate as \c BCCubicLength, on all lanes at once.
+__attribute__((const))
+__attribute__((swift_name("getter:Cubic4.length(self:)")))
+bc_float4_t BCCubic4Length(BCCubic4 c);
+
+///\abstract Splits each cubic at the bezier parameter in its lane, returning the left parts.
+///\seealso \c BCCubicLeftSplit
+__attribute__((const))
+__attribute__((swift_name("Cubic4.leftSplit(self:t:)")))
+BCCubic4 BCCubic4LeftSplit(BCCubic4 c, bc_float4_t t);
+
+///\abstract Splits each cubic at the bezier parameter in its lane, returning the right parts.
+///\seealso \c BCCubicRightSplit
+__attribute__((const))
+__attribute__((swift_name("Cubic4.rightSplit(self:t:)")))
+BCCubic4 BCCubic4RightSplit(BCCubic4 c, bc_float4_t t);
+
+/**
+ \abstract Calculates a bounding box for each cubic.
+ \param strategy As \c BCAlignedRectCreateFromCubic.  \c fastest bounds the control points; \c accurate bounds the curve, solving for the extrema of every cubic on all lanes at once.
+ \param output storage for 4 rects
+ \throws Checks the arguments with assert.  \c rvalue for the error case is 0-sized rects.
+ */
+__attribute__((swift_name("Cubic4.alignedRects(self:strategy:into:)")))
+void BCCubic4AlignedRects(BCCubic4 c, BCStrategy strategy, BCAlignedRect *output);
+
+#endif //BC_NO_VEC8
+#endif //BCCubic4_h
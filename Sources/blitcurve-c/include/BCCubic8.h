@@ -0,0 +1,93 @@
+//BCCubic8.h: Eight BCCubic in a SIMD configuration
+// ©2021 DrewCrawfordApps LLC
+#ifndef BCCubic8_h
+#define BCCubic8_h
+#include "BCCubic.h"
+#include "BCAlignedRect.h"
+#include "BCMetalC.h"
+#include "BCMath.h"
+//requires 16-wide vectors
+#ifndef BC_NO_VEC8
+
+/**
+ \abstract Eight \c BCCubic in a SIMD configuration.
+ \discussion Like \c BCCubic2, points are interleaved: \c a holds \c a.x,a.y of cubic 0, then \c a.x,a.y of cubic 1, and so on.
+ Functions that take or return a \c bc_float8_t use lane \c i for cubic \c i.
+ \seealso \c BCCubic8Pack and \c BCCubic8Unpack to convert from/to arrays of \c BCCubic
+ */
+__attribute__((swift_name("Cubic8")))
+typedef struct {
+    bc_float16_t a;
+    bc_float16_t b;
+    bc_float16_t c;
+    bc_float16_t d;
+} BCCubic8;
+
+///\abstract Repeats each lane of \c t, so it can be multiplied against interleaved points.
+__attribute__((const))
+static inline bc_float16_t __BCCubic8Parameter(bc_float8_t t) {
+    return t.s0011223344556677;
+}
+
+///\abstract Packs 8 cubics into a \c BCCubic8
+///\param cubics An array of at least 8 cubics
+__attribute__((swift_name("Cubic8.init(packing:)")))
+BCCubic8 BCCubic8Pack(const BCCubic *cubics);
+
+///\abstract Unpacks a \c BCCubic8 into 8 cubics
+///\param output storage for 8 cubics
+__attribute__((swift_name("Cubic8.unpack(self:into:)")))
+void BCCubic8Unpack(BCCubic8 c, BCCubic *output);
+
+///\abstract Evaluate each cubic for the bezier parameter in its lane
+///\return Points on each cubic, interleaved as \c x,y pairs
+__attribute__((const))
+__attribute__((swift_name("Cubic8.evaluate(self:t:)")))
+inline bc_float16_t BCCubic8Evaluate(BCCubic8 c, bc_float8_t t) {
+    const bc_float16_t t2 = __BCCubic8Parameter(t);
+    const bc_float16_t one_minus_t = 1 - t2;
+    return c.a * one_minus_t * __bc_square(one_minus_t) + c.c * 3 * __bc_square(one_minus_t) * t2 + c.d * 3 * one_minus_t * __bc_square(t2) + c.b * t2 * __bc_square(t2);
+}
+
+///\abstract Evaluate the derivative of each cubic for the bezier parameter in its lane
+///\return Points on each derivative, interleaved as \c x,y pairs
+__attribute__((const))
+__attribute__((swift_name("Cubic8.evaluatePrime(self:t:)")))
+inline bc_float16_t BCCubic8EvaluatePrime(BCCubic8 c, bc_float8_t t) {
+    const bc_float16_t t2 = __BCCubic8Parameter(t);
+    const bc_float16_t one_minus_t = 1 - t2;
+    const bc_float16_t three_by_one_minus_t_squared = 3 * __bc_square(one_minus_t);
+    const bc_float16_t three_by_t_squared = 3 * __bc_square(t2);
+    const bc_float16_t six_by_1_minus_t_t = 6 * one_minus_t * t2;
+    return three_by_one_minus_t_squared * (c.c - c.a) + six_by_1_minus_t_t * (c.d - c.c) + three_by_t_squared * (c.b - c.d);
+}
+
+///\abstract Estimates the length of each cubic.
+///\discussion Uses the same estimate as \c BCCubicLength, on all lanes at once.
+__attribute__((const))
+__attribute__((swift_name("getter:Cubic8.length(self:)")))
+bc_float8_t BCCubic8Length(BCCubic8 c);
+
+///\abstract Splits each cubic at the bezier parameter in its lane, returning the left parts.
+///\seealso \c BCCubicLeftSplit
+__attribute__((const))
+__attribute__((swift_name("Cubic8.leftSplit(self:t:)")))
+BCCubic8 BCCubic8LeftSplit(BCCubic8 c, bc_float8_t t);
+
+///\abstract Splits each cubic at the bezier parameter in its lane, returning the right parts.
+///\seealso \c BCCubicRightSplit
+__attribute__((const))
+__attribute__((swift_name("Cubic8.rightSplit(self:t:)")))
+BCCubic8 BCCubic8RightSplit(BCCubic8 c, bc_float8_t t);
+
+/**
+ \abstract Calculates a bounding box for each cubic.
+ \param strategy As \c BCAlignedRectCreateFromCubic.  \c fastest bounds the control points; \c accurate bounds the curve, solving for the extrema of every cubic on all lanes at once.
+ \param output storage for 8 rects
+ \throws Checks the arguments with assert.  \c rvalue for the error case is 0-sized rects.
+ */
+__attribute__((swift_name("Cubic8.alignedRects(self:strategy:into:)")))
+void BCCubic8AlignedRects(BCCubic8 c, BCStrategy strategy, BCAlignedRect *output);
+
+#endif //BC_NO_VEC8
+#endif //BCCubic8_h
@@ -0,0 +1,168 @@
+//BCCubicBatch.h: Batch evaluation of many BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicBatch_h
+#define BCCubicBatch_h
+//batch kernels are CPU-only
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCCubic.h"
+#include "BCCubicDrawing.h"
+#include "BCAlignedRect.h"
+
+/**
+ \abstract Many cubics in a structure-of-arrays layout.
+ \discussion Each field points to a plane of floats, one per cubic.  For example, \c a_x[i] is \c a.x for cubic \c i.  Compared to an array of \c BCCubic, this layout lets batch kernels load full SIMD registers without any shuffling.
+ */
+__attribute__((swift_name("CubicPlanes")))
+typedef struct {
+    const bc_float_t *a_x;
+    const bc_float_t *a_y;
+    const bc_float_t *b_x;
+    const bc_float_t *b_y;
+    const bc_float_t *c_x;
+    const bc_float_t *c_y;
+    const bc_float_t *d_x;
+    const bc_float_t *d_y;
+} BCCubicPlanes;
+
+/**
+ \abstract Evaluates many cubics, each at its own bezier parameter.
+ \discussion Equivalent to \c output[i]=BCCubicEvaluate(cubics[i],t[i]) for each \c i.
+ @param cubics \c count cubics
+ @param t \c count bezier parameters
+ @param output storage for \c count points
+ \performance Cubics are processed 8 at a time, with a scalar tail.  Results may differ from \c BCCubicEvaluate in the last bit due to contraction.
+ */
+__attribute__((swift_name("Cubic.evaluateBatch(_:t:count:output:)")))
+void BCCubicEvaluateBatch(const BCCubic *cubics, const bc_float_t *t, size_t count, bc_float2_t *output);
+
+/**
+ \abstract Evaluates many cubics at the same bezier parameter.
+ \discussion Equivalent to \c output[i]=BCCubicEvaluate(cubics[i],t) for each \c i.
+ \performance Cubics are processed 8 at a time, with a scalar tail.
+ */
+__attribute__((swift_name("Cubic.evaluateBatch(_:count:sharedT:output:)")))
+void BCCubicEvaluateBatchSharedParameter(const BCCubic *cubics, size_t count, bc_float_t t, bc_float2_t *output);
+
+/**
+ \abstract Evaluates the derivative of many cubics, each at its own bezier parameter.
+ \discussion Equivalent to \c output[i]=BCCubicEvaluatePrime(cubics[i],t[i]) for each \c i.
+ \performance Cubics are processed 8 at a time, with a scalar tail.
+ */
+__attribute__((swift_name("Cubic.evaluatePrimeBatch(_:t:count:output:)")))
+void BCCubicEvaluatePrimeBatch(const BCCubic *cubics, const bc_float_t *t, size_t count, bc_float2_t *output);
+
+/**
+ \abstract Evaluates the derivative of many cubics at the same bezier parameter.
+ \discussion Equivalent to \c output[i]=BCCubicEvaluatePrime(cubics[i],t) for each \c i.
+ \performance Cubics are processed 8 at a time, with a scalar tail.
+ */
+__attribute__((swift_name("Cubic.evaluatePrimeBatch(_:count:sharedT:output:)")))
+void BCCubicEvaluatePrimeBatchSharedParameter(const BCCubic *cubics, size_t count, bc_float_t t, bc_float2_t *output);
+
+/**
+ \abstract Evaluates many cubics in planar layout, each at its own bezier parameter.
+ @param cubics \c count cubics
+ @param t \c count bezier parameters
+ @param output_x storage for \c count x coordinates
+ @param output_y storage for \c count y coordinates
+ \performance Cubics are processed 8 at a time, with a scalar tail.  This is the fastest layout.
+ */
+__attribute__((swift_name("CubicPlanes.evaluateBatch(self:t:count:outputX:outputY:)")))
+void BCCubicPlanesEvaluateBatch(BCCubicPlanes cubics, const bc_float_t *t, size_t count, bc_float_t *output_x, bc_float_t *output_y);
+
+///\abstract Like \c BCCubicPlanesEvaluateBatch, but evaluates all cubics at the same bezier parameter.
+__attribute__((swift_name("CubicPlanes.evaluateBatch(self:count:sharedT:outputX:outputY:)")))
+void BCCubicPlanesEvaluateBatchSharedParameter(BCCubicPlanes cubics, size_t count, bc_float_t t, bc_float_t *output_x, bc_float_t *output_y);
+
+///\abstract Like \c BCCubicPlanesEvaluateBatch, but evaluates the derivative.
+__attribute__((swift_name("CubicPlanes.evaluatePrimeBatch(self:t:count:outputX:outputY:)")))
+void BCCubicPlanesEvaluatePrimeBatch(BCCubicPlanes cubics, const bc_float_t *t, size_t count, bc_float_t *output_x, bc_float_t *output_y);
+
+///\abstract Like \c BCCubicPlanesEvaluatePrimeBatch, but evaluates all cubics at the same bezier parameter.
+__attribute__((swift_name("CubicPlanes.evaluatePrimeBatch(self:count:sharedT:outputX:outputY:)")))
+void BCCubicPlanesEvaluatePrimeBatchSharedParameter(BCCubicPlanes cubics, size_t count, bc_float_t t, bc_float_t *output_x, bc_float_t *output_y);
+
+/**
+ \abstract Calculates the arclength of many cubics.
+ \discussion Equivalent to \c output[i]=BCCubicLengthWithStrategy(cubics[i],tolerance,strategy) for each \c i.
+ @param cubics \c count cubics
+ @param output storage for \c count lengths
+ \performance Cubics are processed 8 at a time, with a scalar tail.  For \c accurate, the first split of all 8 cubics is integrated in SIMD lanes, and only cubics that need more subdivision fall back to \c BCCubicLengthWithStrategy.
+ \throws Checks arguments with assert.  rvalue is that all outputs are \c (-1-BCError).
+ */
+__attribute__((swift_name("Cubic.lengthBatch(_:count:tolerance:strategy:output:)")))
+void BCCubicLengthBatch(const BCCubic *cubics, size_t count, bc_float_t tolerance, BCStrategy strategy, bc_float_t *output);
+
+/**
+ \abstract Resolves the drawing range of many cubics.
+ \discussion Equivalent to \c output[i]=BCCubicParameterRangeMakeClampedParameterization(cubics[i],startPositions[i],endPositions[i],threshold,minimumDelta) for each \c i.  Upload the output as per-instance data, and use the \c BCCubicParameterRange overload of \c BCCubicVertexMake per vertex.
+ @param cubics \c count cubics
+ @param startPositions \c count start positions
+ @param endPositions \c count end positions
+ @param output storage for \c count ranges
+ \performance Two arclength searches per cubic, rather than two per vertex.  Cubics are searched 8 at a time, with each lane stopping where the single-cubic search would, so the ranges are the same.  A partial group at the end, and any cubic whose range fails its checks, use the single-cubic function.
+ \throws Checks arguments.  rvalue is that the output for the failing cubic has \c minT of \c (-1-BCError).
+ */
+__attribute__((swift_name("CubicParameterRange.makeBatch(clampedParameterization:startPositions:endPositions:count:threshold:minimumDelta:output:)")))
+void BCCubicParameterRangeMakeClampedParameterizationBatch(const BCCubic *cubics, const bc_float_t *startPositions, const bc_float_t *endPositions, size_t count, bc_float_t threshold, bc_float_t minimumDelta, BCCubicParameterRange *output);
+
+/**
+ \abstract Calculates bounding boxes for many cubics.
+ \discussion Equivalent to \c output[i]=BCAlignedRectCreateFromCubic(cubics[i],strategy) for each \c i.
+ @param cubics \c count cubics
+ @param output storage for \c count rects
+ \performance The \c accurate strategy solves 8 cubics at a time, one per lane.
+ \throws Checks arguments with assert.  rvalue is that every output is a 0-sized rect.
+ */
+__attribute__((swift_name("AlignedRect.createBatch(cubics:count:strategy:output:)")))
+void BCAlignedRectCreateFromCubicBatch(const BCCubic *cubics, size_t count, BCStrategy strategy, BCAlignedRect *output);
+
+/**
+ \abstract Finds the cubics that may be visible in a viewport, as a compacted list of indexes.
+ \discussion A cubic is visible when its \c BCAlignedRectCreateFromCubic box, grown by \c outset, overlaps \c viewport, including touching.  Its index is written to \c output, in increasing order, so the list can be used directly as instance IDs for the vertex stage.
+ @param cubics \c count cubics
+ @param viewport the visible area, in the cubics' coordinates
+ @param outset distance to grow each box, for example half a stroke width.  Must not be negative.
+ @param strategy \c fastest culls by the control points' box, and \c accurate by the extrema, which culls more cubics near the edges.
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.
+ @param output storage for \c count indexes.  Only the first \c rvalue are meaningful.
+ @return the number of visible cubics.
+ \performance Boxes are computed and tested 8 cubics at a time, with no allocation beyond a count per block of 4096 cubics.  Blocks are culled in parallel, each into its own part of \c output, and then moved together.
+ \throws Checks arguments with assert.  rvalue is \c 0.  If the block counts can't be allocated, returns \c 0 at every check level.
+ */
+__attribute__((swift_name("Cubic.cullBatch(_:count:viewport:outset:strategy:threads:output:)")))
+size_t BCCubicCullBatch(const BCCubic *cubics, size_t count, BCAlignedRect viewport, bc_float_t outset, BCStrategy strategy, unsigned threads, uint32_t *output);
+
+/**
+ \abstract Arguments for drawing one cubic with an indirect draw.
+ \discussion This has the layout of \c MTLDrawPrimitivesIndirectArguments, so an array of these can be a Metal indirect buffer.
+ */
+__attribute__((swift_name("DrawPrimitivesArguments")))
+typedef struct {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t vertexStart;
+    uint32_t baseInstance;
+} BCDrawPrimitivesArguments;
+
+/**
+ \abstract Finds \c BCCubicVertexBudget for many cubics, and lays their vertexes out in one buffer.
+ \discussion Cubic \c i is \c vertexCounts[i] samples, each of \c vertexesPerSample vertexes: 1 for a line strip from \c BCCubicVertexMake, or 2 for \c BCCubicStrokeBatch.  Its vertexes are \c offsets[i] up to \c offsets[i+1].
+
+ \c arguments[i] draws cubic \c i alone: its vertex count and start, with \c baseInstance of \c i so the shader can find the cubic from its instance ID.
+ @param cubics \c count cubics
+ @param vertexesPerSample vertexes written for each sample.  Must be positive.
+ @param vertexCounts storage for \c count sample counts
+ @param offsets if not \c NULL, storage for \c count+1 prefix-summed vertex offsets.
+ @param arguments if not \c NULL, storage for \c count draw records.
+ @return the total number of vertexes, which is \c offsets[count].
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.vertexBudgetBatch(_:count:scale:tolerance:maximumVertexes:vertexesPerSample:vertexCounts:offsets:arguments:)")))
+uint32_t BCCubicVertexBudgetBatch(const BCCubic *cubics, size_t count, bc_float_t scale, bc_float_t tolerance, uint8_t maximumVertexes, uint8_t vertexesPerSample, uint8_t *vertexCounts, uint32_t *offsets, BCDrawPrimitivesArguments *arguments);
+
+#endif //__METAL_VERSION__
+#endif //BCCubicBatch_h
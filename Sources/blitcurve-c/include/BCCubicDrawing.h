@@ -82,9 +82,57 @@ inline bc_float2_t BCCubicVertexMake(BCCubic cubic, uint8_t vertexID, uint8_t ve
  \param endPosition End position to draw in linear coordinates.  This ought to be <= to the start coordinates.  If this exceeds the length of the cubic, it will be clamped.
  \param threshold The threshold to use for calculating the arclength parameterization.
  \param minimumDeltaT the minimum range to be drawn, in \c t coordinates.  If \c maximum-minimum is less than this, the range will be adjusted.
+ \performance Each call performs two arclength parameterizations.  When drawing many vertexes of the same cubic, resolve the range once with \c BCCubicParameterRangeMakeClampedParameterization and use the \c BCCubicParameterRange overload of \c BCCubicVertexMake.
  \throws Checks arguments, \c rvalue.xyz is \c BCVertex3ErrorMake.  \c w is not defined.
  */
 __attribute__((const))
 bc_float2_t BCCubicVertexMakeClampedParameterization(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, bc_float_t startPosition, bc_float_t endPosition, bc_float_t threshold,bc_float_t minimumDelta);
 
+/**
+ \abstract A range of bezier parameters to draw, resolved once per cubic.
+ \discussion This is a compact per-instance record.  Compute it on the CPU (or once per instance on the GPU), then pass it to every vertex of the instance.
+ */
+__attribute__((swift_name("CubicParameterRange")))
+typedef struct {
+    ///The minimum \c t to be generated.  On error, this is \c (-1-BCError).
+    bc_float_t minT;
+    ///The maximum \c t to be generated.
+    bc_float_t maxT;
+} BCCubicParameterRange;
+
+/**
+ \abstract Resolves the parameter range of \c BCCubicVertexMakeClampedParameterization.
+ \discussion Arguments have the same meaning as for \c BCCubicVertexMakeClampedParameterization.  The range includes the \c minimumDelta adjustment.
+ \throws Checks arguments.  rvalue has \c minT of \c (-1-BCError).
+ */
+__attribute__((const))
+__attribute__((swift_name("CubicParameterRange.init(clampedParameterization:startPosition:endPosition:threshold:minimumDelta:)")))
+BCCubicParameterRange BCCubicParameterRangeMakeClampedParameterization(BCCubic cubic, bc_float_t startPosition, bc_float_t endPosition, bc_float_t threshold, bc_float_t minimumDelta);
+
+/**
+ \abstract Creates a 2D vertex suitable for drawing a portion of a cubic, using a range from \c BCCubicParameterRangeMakeClampedParameterization.
+ \seealso See all overloads for this function.
+ \performance This only evaluates the cubic, with no arclength parameterization.
+ \throws Checks arguments.  rvalue is \c BCVertex2ErrorMake
+ */
+__attribute__((const))
+__attribute__((overloadable))
+bc_float2_t BCCubicVertexMake(BCCubic cubic, uint8_t vertexID, uint8_t vertexesPerCubic, BCCubicParameterRange range);
+
+/**
+ \abstract Returns how many evenly-spaced vertexes draw a cubic within a tolerance on screen.
+ \discussion This is a budget for the fixed-step drawing functions, such as \c BCCubicVertexMake and \c BCCubicStrokeBatch, which place vertex \c i of \c n at \c t=i/(n-1).
+
+ With \c n-1 even steps, the cubic is within \c max|B''|/(8(n-1)²) of the polyline, and \c |B''| is largest at an endpoint.  This bound grows with both the size of the cubic and how sharply it turns, so long or curvy cubics get more vertexes.  A cubic that is a line, within \c tolerance, gets 2 vertexes however it is parameterized.
+ @param scale screen units per cubic unit, for example from a projection.  Must be positive.
+ @param tolerance maximum distance between the cubic and the polyline, in screen units.  Must be positive.
+ @param maximumVertexes the most vertexes to return.  If the cubic needs more, it is drawn with this many, beyond the tolerance.  Must be \c >1.
+ @return a count on the range \c 2...maximumVertexes
+ \performance O(1).  This is a few multiplies and a square root, with no trig.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((const))
+__attribute__((swift_name("Cubic.vertexBudget(self:scale:tolerance:maximumVertexes:)")))
+uint8_t BCCubicVertexBudget(BCCubic cubic, bc_float_t scale, bc_float_t tolerance, uint8_t maximumVertexes);
+
 #endif
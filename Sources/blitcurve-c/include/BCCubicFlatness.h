@@ -0,0 +1,51 @@
+//BCCubicFlatness.h: Flatness tests shared by flattening and vertex budgets
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicFlatness_h
+#define BCCubicFlatness_h
+#include "BCCubic.h"
+#include "BCMetalC.h"
+
+/*
+ Flatness test from Roger Willcocks.  With
+     u = 3c - 2a - b
+     v = 3d - 2b - a
+ the distance between the cubic and its chord is at most sqrt(max(u.x²,v.x²) + max(u.y²,v.y²)) / 4.
+ This compares points at the same parameter, so it fails for pieces that are straight but not uniformly parameterized.
+ */
+static inline bool __BCCubicIsFlatParametric(BCCubic c, bc_float_t tolerance) {
+    const bc_float2_t u = 3 * c.c - 2 * c.a - c.b;
+    const bc_float2_t v = 3 * c.d - 2 * c.b - c.a;
+    const bc_float2_t m = bc_make_float2(bc_max(u.x * u.x, v.x * v.x), bc_max(u.y * u.y, v.y * v.y));
+    return m.x + m.y <= 16 * tolerance * tolerance;
+}
+
+/*
+ Geometric flatness test.  When the control points project inside the chord, the cubic does too, and its distance from the chord is
+     3t(1-t)((1-t)*dc + t*dd)
+ where dc and dd are the signed distances of the control points from the chord's line.  This is at most 3/4 of the larger.
+ Otherwise, the cubic is in the convex hull of its control points, so its distance from the chord is at most the distance of c or d.
+ */
+static inline bool __BCCubicIsFlatGeometric(BCCubic c, bc_float_t tolerance) {
+    const bc_float2_t chord = c.b - c.a;
+    const bc_float_t chordSquared = bc_dot(chord, chord);
+    if (chordSquared == 0) {
+        return bc_max(bc_distance(c.c, c.a), bc_distance(c.d, c.a)) <= tolerance;
+    }
+    const bc_float2_t ac = c.c - c.a;
+    const bc_float2_t ad = c.d - c.a;
+    const bc_float_t pc = bc_dot(ac, chord) / chordSquared;
+    const bc_float_t pd = bc_dot(ad, chord) / chordSquared;
+    if (pc >= 0 && pc <= 1 && pd >= 0 && pd <= 1) {
+        //cross products are distance times chord length
+        const bc_float_t dc = ac.x * chord.y - ac.y * chord.x;
+        const bc_float_t dd = ad.x * chord.y - ad.y * chord.x;
+        const bc_float_t d = bc_max(bc_abs(dc), bc_abs(dd)) * 0.75f;
+        return d * d <= tolerance * tolerance * chordSquared;
+    }
+    const bc_float_t distanceC = bc_distance(c.c, c.a + bc_clamp(pc, 0.0f, 1.0f) * chord);
+    const bc_float_t distanceD = bc_distance(c.d, c.a + bc_clamp(pd, 0.0f, 1.0f) * chord);
+    return bc_max(distanceC, distanceD) <= tolerance;
+}
+
+#endif //BCCubicFlatness_h
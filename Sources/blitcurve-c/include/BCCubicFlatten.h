@@ -0,0 +1,59 @@
+//BCCubicFlatten.h: Adaptive flattening of BCCubic into polylines
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicFlatten_h
+#define BCCubicFlatten_h
+//flattening writes to caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCCubic.h"
+
+/**
+ \abstract Returns an upper bound on the number of points \c BCCubicFlatten produces.
+ \discussion This is exact for the worst case, and cheap to compute, so it is suitable for sizing buffers.
+ @param tolerance maximum distance between the cubic and the polyline.  Must be positive.
+ \performance O(1)
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((const))
+__attribute__((swift_name("Cubic.flattenUpperBound(self:tolerance:)")))
+size_t BCCubicFlattenUpperBound(BCCubic cubic, bc_float_t tolerance);
+
+/**
+ \abstract Converts a cubic to a polyline within a given tolerance.
+ \discussion Recursively splits the cubic in half until each piece is flat: its control points are close enough to its chord that the piece is within \c tolerance of the chord.  Flat parts of the cubic use few points, and tight turns use many.
+
+ The polyline starts at \c cubic.a and ends at \c cubic.b.  Pieces stop splitting at a depth of 16, so a very small tolerance may not be met.
+ @param tolerance maximum distance between the cubic and the polyline.  Must be positive.
+ @param output storage for \c capacity points.  \c BCCubicFlattenUpperBound is a sufficient capacity.
+ @param parameters If not \c NULL, storage for \c capacity bezier parameters.  Each is the \c t of the corresponding point.
+ @return The number of points in the polyline.  If this is more than \c capacity, only the first \c capacity points are written.
+ \performance No allocation.  The flatness test is a few multiplies per piece, and splitting is a de Casteljau step.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.flatten(self:tolerance:output:parameters:capacity:)")))
+size_t BCCubicFlatten(BCCubic cubic, bc_float_t tolerance, bc_float2_t *output, bc_float_t *parameters, size_t capacity);
+
+/**
+ \abstract Returns the sum of \c BCCubicFlattenUpperBound for many cubics.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.flattenBatchUpperBound(_:count:tolerance:)")))
+size_t BCCubicFlattenBatchUpperBound(const BCCubic *cubics, size_t count, bc_float_t tolerance);
+
+/**
+ \abstract Flattens many cubics into one buffer.
+ \discussion Each cubic gets its own polyline, starting at its \c a.  Polyline \c i is \c output[offsets[i]] up to (excluding) \c output[offsets[i+1]].
+ @param cubics \c count cubics
+ @param output storage for \c capacity points.  \c BCCubicFlattenBatchUpperBound is a sufficient capacity.
+ @param parameters If not \c NULL, storage for \c capacity bezier parameters.
+ @param offsets storage for \c count+1 offsets.  If the output is truncated, offsets are still those of the full output.
+ @return The total number of points.  If this is more than \c capacity, only the first \c capacity points are written.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.flattenBatch(_:count:tolerance:output:parameters:capacity:offsets:)")))
+size_t BCCubicFlattenBatch(const BCCubic *cubics, size_t count, bc_float_t tolerance, bc_float2_t *output, bc_float_t *parameters, size_t capacity, size_t *offsets);
+
+#endif //__METAL_VERSION__
+#endif //BCCubicFlatten_h
@@ -0,0 +1,104 @@
+//BCCubicIntersection.h: Intersections with BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicIntersection_h
+#define BCCubicIntersection_h
+//intersection writes to caller-provided CPU storage
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCCubic.h"
+#include "BCLine.h"
+#include "BCRectBroadPhase.h"
+
+///An intersection between two cubics, as the bezier parameter on each.
+__attribute__((swift_name("CubicIntersection")))
+typedef struct {
+    ///bezier parameter on the first cubic
+    bc_float_t t1;
+    ///bezier parameter on the second cubic
+    bc_float_t t2;
+} BCCubicIntersection;
+
+/**
+ \abstract Finds the points where two cubics intersect.
+ \discussion Both cubics are split in half, recursively, and pairs of pieces whose bounding boxes are more than \c tolerance apart are discarded.  The boxes for both halves of both cubics are found and compared together, with SIMD.
+ Once both pieces of a pair are nearly straight, their chords are intersected directly, and the result is refined with Newton's method on the original cubics.
+
+ Each intersection is a pair of parameters where the cubics are within about \c tolerance of each other.  Intersections whose points are within \c tolerance of one found recently are reported only once, so a crossing near a split is not reported twice.  Curves that overlap for a distance, rather than crossing, report several points along the overlap.
+ Cubics that share an endpoint intersect there.  Intersections are reported in no particular order.
+ @param tolerance maximum distance between the cubics at an intersection.  Must be positive.
+ @param output storage for \c capacity intersections.  Two cubics that cross have at most 9 intersections.
+ @return The number of intersections.  If this is more than \c capacity, only the first \c capacity intersections are written.
+ \performance No allocation; pieces are kept on a fixed-size stack.  Cubics whose \c BCAlignedRectCreateFromCubic boxes are apart are rejected after that test.  Splitting stops at a depth of 24.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.intersections(self:_:tolerance:output:capacity:)")))
+size_t BCCubicIntersect(BCCubic a, BCCubic b, bc_float_t tolerance, BCCubicIntersection *output, size_t capacity);
+
+/**
+ \abstract Finds the intersections of many pairs of cubics.
+ \discussion Like \c BCCubicIntersect for each pair, in order.  Pairs usually come from a broad phase, such as \c BCAlignedRectSweepOverlappingPairs over the cubics' boxes.
+ Pairs are first checked 8 at a time, with \c BCAlignedRectCreateFromCubicBatch, so pairs whose cubics are apart cost little.
+ @param cubics cubics indexed by \c pairs
+ @param pairs \c count pairs of indices into \c cubics.  \c a need not be less than \c b.
+ @param output storage for \c capacity intersections.  \c t1 is on \c cubics[pair.a], and \c t2 on \c cubics[pair.b].
+ @param outputPairs storage for \c capacity indices into \c pairs, one for each intersection.
+ @return The total number of intersections.  If this is more than \c capacity, only the first \c capacity are written.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("Cubic.intersectionsBatch(_:pairs:count:tolerance:output:outputPairs:capacity:)")))
+size_t BCCubicIntersectPairs(const BCCubic *cubics, const BCRectPair *pairs, size_t count, bc_float_t tolerance, BCCubicIntersection *output, uint32_t *outputPairs, size_t capacity);
+
+///How far a \c BCLine extends, for intersection.
+typedef enum {
+    ///From \c a to \c b
+    BCLineExtentSegment __attribute__((swift_name("segment"))),
+    ///From \c a through \c b, without end
+    BCLineExtentRay __attribute__((swift_name("ray"))),
+} __attribute__((enum_extensibility(closed))) BCLineExtent;
+
+///An intersection between a line and a cubic.
+__attribute__((swift_name("LineCubicIntersection")))
+typedef struct {
+    ///parameter on the line, 0 at \c a and 1 at \c b
+    bc_float_t lineT;
+    ///bezier parameter on the cubic
+    bc_float_t cubicT;
+} BCLineCubicIntersection;
+
+/**
+ \abstract Finds the points where a line crosses a cubic.
+ \discussion The cubic is moved into the line's frame, as \c BCAlignedCubicMake does, but with the line's direction instead of an angle, so no trig is needed.  There, the cubic's distance from the line is a cubic polynomial in \c t.
+ The polynomial's turning points split [0,1] into pieces where it is monotonic, and each piece with a sign change has one root, found by Newton's method kept inside the bracket.
+
+ Intersections are in order of \c cubicT.  A cubic that touches the line without crossing may or may not intersect it.  A cubic that lies along the line reports a few points, and a 0-length line intersects nothing.
+ @param output storage for 3 intersections, which is the most possible
+ @return The number of intersections.
+ \performance No allocation.  No trig or cube roots; the most expensive step is one square root.
+ */
+__attribute__((swift_name("Line.intersections(self:extent:cubic:output:)")))
+size_t BCLineIntersectCubic(BCLine line, BCLineExtent extent, BCCubic cubic, BCLineCubicIntersection *output);
+
+/**
+ \abstract Intersects one line with many cubics.
+ \discussion Like \c BCLineIntersectCubic for each cubic, in order.  8 cubics are solved at a time, one per lane, which suits a ray cast against a scene.
+ @param output storage for \c capacity intersections
+ @param outputCubics storage for \c capacity indices into \c cubics, one for each intersection.
+ @return The total number of intersections.  If this is more than \c capacity, only the first \c capacity are written.
+ */
+__attribute__((swift_name("Line.intersectionsBatch(self:extent:cubics:count:output:outputCubics:capacity:)")))
+size_t BCLineIntersectCubics(BCLine line, BCLineExtent extent, const BCCubic *cubics, size_t count, BCLineCubicIntersection *output, uint32_t *outputCubics, size_t capacity);
+
+/**
+ \abstract Intersects many lines with one cubic.
+ \discussion Like \c BCLineIntersectCubic for each line, in order.  8 lines are solved at a time, one per lane, which suits picking many points against a curve.
+ @param output storage for \c capacity intersections
+ @param outputLines storage for \c capacity indices into \c lines, one for each intersection.
+ @return The total number of intersections.  If this is more than \c capacity, only the first \c capacity are written.
+ */
+__attribute__((swift_name("Line.intersectionsBatch(_:count:extent:cubic:output:outputLines:capacity:)")))
+size_t BCLinesIntersectCubic(const BCLine *lines, size_t count, BCLineExtent extent, BCCubic cubic, BCLineCubicIntersection *output, uint32_t *outputLines, size_t capacity);
+
+#endif //__METAL_VERSION__
+#endif //BCCubicIntersection_h
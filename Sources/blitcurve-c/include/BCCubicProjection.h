@@ -0,0 +1,68 @@
+//BCCubicProjection.h: Nearest points on BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicProjection_h
+#define BCCubicProjection_h
+//batch projection works on CPU arrays
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include "BCCubic.h"
+
+///The point on a cubic nearest to some query point.
+__attribute__((swift_name("CubicProjection")))
+typedef struct {
+    ///the nearest point on the cubic
+    bc_float2_t point;
+    ///bezier parameter of \c point
+    bc_float_t t;
+    ///distance from the query point to \c point
+    bc_float_t distance;
+} BCCubicProjection;
+
+/**
+ \abstract Finds the point on a cubic nearest to a query point.
+ \discussion The cubic is sampled at 16 evenly spaced parameters at once, with SIMD, and the nearest sample seeds Newton's method on the derivative of the squared distance.  Newton evaluates the cubic and its first and second derivatives in power basis, so results may differ from \c BCCubicEvaluate and \c BCCubicEvaluatePrime in the last bits.
+ Newton stays between the seed's neighboring samples, and is only kept when it improves on the seed.  Endpoints are samples, so a query beyond the end of the cubic finds the end.
+
+ When two parts of the cubic are nearly the same distance away, the seed may pick the one that is slightly farther.  The distance is then still close to the nearest.
+ \performance No allocation.  4 Newton steps.
+ */
+__attribute__((const))
+__attribute__((swift_name("Cubic.project(self:_:)")))
+BCCubicProjection BCCubicProject(BCCubic cubic, bc_float2_t point);
+
+/**
+ \abstract Projects many points onto one cubic.
+ \discussion Like \c BCCubicProject for each point.  The cubic's samples are found once, and 8 points are refined at a time, one per lane.
+ @param points \c count query points
+ @param output storage for \c count projections
+ \throws Checks arguments with assert.
+ */
+__attribute__((swift_name("Cubic.projectBatch(self:_:count:output:)")))
+void BCCubicProjectPoints(BCCubic cubic, const bc_float2_t *points, size_t count, BCCubicProjection *output);
+
+/**
+ \abstract Projects one point onto many cubics.
+ \discussion Like \c BCCubicProject for each cubic.  8 cubics are sampled and refined at a time, one per lane.
+ @param cubics \c count cubics
+ @param output storage for \c count projections, one per cubic
+ \performance Unlike \c BCCubicNearest, every cubic is projected, so use this when all the distances are wanted.
+ \throws Checks arguments with assert.
+ */
+__attribute__((swift_name("Cubic.projectBatch(_:count:point:output:)")))
+void BCCubicProjectCubics(const BCCubic *cubics, size_t count, bc_float2_t point, BCCubicProjection *output);
+
+/**
+ \abstract Finds the cubic nearest to a point, such as for snapping or hit testing.
+ \discussion Each cubic's \c BCAlignedRectCreateFromCubic box bounds how close it can be.  A cubic whose box is farther than the nearest cubic so far, or than \c maxDistance, is skipped without projecting it.
+ @param cubics \c count cubics
+ @param maxDistance cubics farther than this are not found.  Pass \c BC_FLOAT_LARGE for no limit.
+ @param output If a cubic is found, its \c BCCubicProjection.
+ @return The index of the nearest cubic, or \c count if no cubic is within \c maxDistance.  Ties go to the lower index.
+ \throws Checks arguments with assert.  rvalue is \c count.
+ */
+__attribute__((swift_name("Cubic.nearest(_:count:to:maxDistance:output:)")))
+size_t BCCubicNearest(const BCCubic *cubics, size_t count, bc_float2_t point, bc_float_t maxDistance, BCCubicProjection *output);
+
+#endif //__METAL_VERSION__
+#endif //BCCubicProjection_h
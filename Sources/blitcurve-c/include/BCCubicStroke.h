@@ -0,0 +1,55 @@
+//BCCubicStroke.h: Stroke tessellation of BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCCubicStroke_h
+#define BCCubicStroke_h
+//stroke tessellation is a CPU batch kernel
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "BCCubic.h"
+
+/**
+ \abstract Number of vertexes \c BCCubicStrokeBatch writes for each cubic.
+ */
+__attribute__((const))
+__attribute__((swift_name("CubicStrokeVertexCount(vertexesPerCubic:)")))
+static inline size_t BCCubicStrokeVertexCount(uint8_t vertexesPerCubic) {
+    return 2 * (size_t) vertexesPerCubic;
+}
+
+/**
+ \abstract Tessellates many cubics into wide strokes, as triangle strips.
+ \discussion Each cubic is sampled at \c vertexesPerCubic evenly-spaced bezier parameters, as \c BCCubicVertexMake.  Each sample writes 2 vertexes, offset to its left and then its right by half of the cubic's width.  So cubic \c i is \c output[i*2*vertexesPerCubic] up to \c output[(i+1)*2*vertexesPerCubic], in triangle strip order.  Draw each cubic as a strip, or as triangles with \c BCCubicStrokeIndexes.
+
+ Offsets are along the normal, which is the derivative rotated a quarter turn and scaled by its reciprocal length, so no trig is needed.  Where the derivative vanishes, as at an endpoint whose control point is on it, the second derivative is used instead.
+
+ When a cubic ends exactly where the next one starts, the two are joined with a miter: both strips end on the same line, along the bisector of their normals.  The miter is clipped to \c miterLimit times the half width, measured as SVG does, so sharp corners don't spike.  There's no join from the last cubic to the first.
+ @param cubics \c count cubics
+ @param widths \c count stroke widths, one per cubic
+ @param vertexesPerCubic samples per cubic.  Must be \c >1.
+ @param miterLimit limit on the length of a miter, as a multiple of the half width.  Must be \c >=1.
+ @param output storage for \c count*BCCubicStrokeVertexCount(vertexesPerCubic) vertexes
+ @return \c true if the strokes were tessellated.
+ \performance Samples are processed 8 at a time, with a partial group at the end of each cubic.  This is a few multiplies and one square root per sample, instead of \c BCCubicTangent 's \c atan2 and the \c sin/cos to turn the angle back into an offset.
+ \throws Checks arguments with assert.  rvalue is \c false.
+ */
+__attribute__((swift_name("Cubic.strokeBatch(_:widths:count:vertexesPerCubic:miterLimit:output:)")))
+bool BCCubicStrokeBatch(const BCCubic *cubics, const bc_float_t *widths, size_t count, uint8_t vertexesPerCubic, bc_float_t miterLimit, bc_float2_t *output);
+
+/**
+ \abstract Writes triangle indexes for one cubic stroked by \c BCCubicStrokeBatch.
+ \discussion Indexes are relative to the cubic's first vertex, and every cubic with the same \c vertexesPerCubic uses the same indexes.  So write them once, into one index buffer, and draw each cubic from it with a base vertex of \c i*BCCubicStrokeVertexCount(vertexesPerCubic), for example with instancing.
+
+ Triangles are wound the same way as the strip, so they have the same facing.
+ @param vertexesPerCubic samples per cubic.  Must be \c >1.
+ @param output storage for \c 6*(vertexesPerCubic-1) indexes
+ @return the number of indexes written, \c 6*(vertexesPerCubic-1).
+ \throws Checks arguments with assert.  rvalue is \c 0.
+ */
+__attribute__((swift_name("Cubic.strokeIndexes(vertexesPerCubic:output:)")))
+size_t BCCubicStrokeIndexes(uint8_t vertexesPerCubic, uint16_t *output);
+
+#endif //__METAL_VERSION__
+#endif //BCCubicStroke_h
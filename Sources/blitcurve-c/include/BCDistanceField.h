@@ -0,0 +1,63 @@
+//BCDistanceField.h: Distance fields and stroke coverage from BCCubic
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCDistanceField_h
+#define BCDistanceField_h
+//distance fields and coverage are rasterized by CPU threads
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "BCCubic.h"
+#include "BCAlignedRect.h"
+
+/**
+ \abstract Rasterizes the distance to a set of cubics into a grid.
+ \discussion Pixel \c (x,y) is \c output[y*width+x], and its center is \c bounds.min + ((x,y)+0.5) * (bounds.max-bounds.min)/(width,height).  So row 0 is at \c bounds.min.y.
+
+ Each pixel is the distance from its center to the nearest cubic, up to \c maxDistance.  Cubics are flattened to within 1/16 of a pixel with \c BCCubicFlatten, and distances are to the flattened polylines.
+ If \c isSigned, the cubics are closed contours, and pixels inside them, by the nonzero winding rule, are negative.  Insideness is found for each row from where each y-monotonic piece of each cubic crosses it, and in which direction.  A piece counts when the row is in its half-open y range \c [ymin,ymax), so a vertex on a pixel center is counted once where the contour passes through it, and not at all or twice where it turns back.
+
+ The grid is split into 32x32 tiles, and each cubic is binned to the tiles its \c BCAlignedRectCreateFromCubic box is within \c maxDistance of.  Tiles are then rasterized in parallel: each candidate segment is tested against 8 pixels at a time, one per lane, and segments farther than \c maxDistance from the tile are skipped.
+ @param cubics \c count cubics
+ @param bounds the area covered by the grid
+ @param maxDistance distance at which the field is clamped.  Smaller values cull more.  Must be positive.
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.
+ @param output storage for \c width*height distances
+ @return \c true if the field was rasterized.
+ \performance Allocates scratch, proportional to the flattened cubics.  Work is about the number of pixels within \c maxDistance of each segment.
+ \throws Checks arguments with assert.  rvalue is \c false.  If scratch can't be allocated, returns \c false at every check level.
+ */
+__attribute__((swift_name("Cubic.distanceField(_:count:bounds:width:height:maxDistance:isSigned:threads:output:)")))
+bool BCCubicDistanceField(const BCCubic *cubics, size_t count, BCAlignedRect bounds, uint32_t width, uint32_t height, bc_float_t maxDistance, bool isSigned, unsigned threads, bc_float_t *output);
+
+/**
+ \abstract Storage for each pixel of \c BCCubicStrokeCoverage.
+ */
+typedef enum {
+    ///\c bc_float_t from 0 to 1
+    BCCoverageFormatFloat,
+    ///\c uint8_t from 0 to 255
+    BCCoverageFormatByte,
+} BCCoverageFormat;
+
+/**
+ \abstract Rasterizes anti-aliased coverage of a set of stroked cubics into a grid.
+ \discussion The grid is laid out as in \c BCCubicDistanceField, and rasterized the same way: cubics are binned into 32x32 tiles by their boxes, and tiles are rasterized in parallel, 8 pixels of a row at a time.  Strokes have round joins and caps: a pixel is inside when its center is within \c strokeWidth/2 of a cubic.  Where strokes overlap, coverage is the union rather than the sum.
+
+ Coverage ramps from 0 to 1 over a filter as wide as the larger side of a pixel, centered on the edge of the stroke.  A stroke thinner than the filter is drawn as wide as the filter, with coverage scaled by its width, so hairlines fade rather than drop out.
+ @param cubics \c count cubics
+ @param strokeWidth width of the stroke, in the units of \c bounds.  Must be positive.
+ @param bounds the area covered by the grid
+ @param format storage for each pixel
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.
+ @param output storage for \c width*height pixels, in \c format
+ @return \c true if the coverage was rasterized.
+ \performance Allocates scratch, proportional to the flattened cubics.  Work is about the number of pixels the strokes touch, times the segments that touch them.
+ \throws Checks arguments with assert.  rvalue is \c false.  If scratch can't be allocated, returns \c false at every check level.
+ */
+__attribute__((swift_name("Cubic.strokeCoverage(_:count:strokeWidth:bounds:width:height:format:threads:output:)")))
+bool BCCubicStrokeCoverage(const BCCubic *cubics, size_t count, bc_float_t strokeWidth, BCAlignedRect bounds, uint32_t width, uint32_t height, BCCoverageFormat format, unsigned threads, void *output);
+
+#endif //__METAL_VERSION__
+#endif //BCDistanceField_h
@@ -0,0 +1,154 @@
+//BCLanes8.h: 8-lane SIMD helpers shared by CPU batch functions
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCLanes8_h
+#define BCLanes8_h
+#ifndef __METAL_VERSION__
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "BCCubic.h"
+#include "BCMetalC.h"
+
+///A mask for 8 lanes, as comparing two \c bc_float8_t gives: every bit of a lane is set, or none are.
+typedef int32_t __BCMask8 __attribute__((ext_vector_type(8)));
+
+///Lanes of \c a where \c mask is set, and of \c b elsewhere
+static inline bc_float8_t __BCMask8Select(__BCMask8 mask, bc_float8_t a, bc_float8_t b) {
+    return (bc_float8_t) (((__BCMask8) a & mask) | ((__BCMask8) b & ~mask));
+}
+
+///Bit \c i is set when lane \c i of \c mask is
+static inline uint32_t __BCMask8Bits(__BCMask8 mask) {
+    uint32_t bits = 0;
+    for (int lane = 0; lane < 8; lane++) { bits |= (uint32_t) (mask[lane] != 0) << lane; }
+    return bits;
+}
+
+static inline bool __BCMask8Any(__BCMask8 mask) {
+    uint64_t words[4];
+    memcpy(words, &mask, sizeof(words));
+    return (words[0] | words[1] | words[2] | words[3]) != 0;
+}
+
+static inline bool __BCMask8All(__BCMask8 mask) {
+    uint64_t words[4];
+    memcpy(words, &mask, sizeof(words));
+    return (words[0] & words[1] & words[2] & words[3]) == UINT64_MAX;
+}
+
+///8 cubics, transposed so that each lane holds one cubic
+typedef struct {
+    bc_float8_t a_x;
+    bc_float8_t a_y;
+    bc_float8_t b_x;
+    bc_float8_t b_y;
+    bc_float8_t c_x;
+    bc_float8_t c_y;
+    bc_float8_t d_x;
+    bc_float8_t d_y;
+} __BCCubicLanes8;
+
+//unaligned loads and stores; the compiler lowers these to single vector instructions
+static inline bc_float8_t __bc_load8(const bc_float_t *p) {
+    bc_float8_t r;
+    memcpy(&r, p, sizeof(r));
+    return r;
+}
+static inline void __bc_store8(bc_float_t *p, bc_float8_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+static inline bc_float16_t __bc_concat8(bc_float8_t lo, bc_float8_t hi) {
+    bc_float16_t r;
+    r.lo = lo;
+    r.hi = hi;
+    return r;
+}
+
+/*
+ Transposes 8 BCCubic into lanes.
+ Each BCCubic is a.x,a.y,b.x,b.y,c.x,c.y,d.x,d.y, so 2 cubics fill a float16.  Separating even/odd elements twice
+ takes x from y, then a,c from b,d, and a third time gives each control point.
+ */
+static inline __BCCubicLanes8 __BCCubicLanes8LoadCubics(const BCCubic *cubics) {
+    bc_float16_t v[4];
+    memcpy(v, cubics, sizeof(v));
+    //a.x b.x c.x d.x for cubics 0...3
+    const bc_float16_t x01 = __bc_concat8(v[0].even, v[1].even);
+    const bc_float16_t y01 = __bc_concat8(v[0].odd, v[1].odd);
+    const bc_float16_t x23 = __bc_concat8(v[2].even, v[3].even);
+    const bc_float16_t y23 = __bc_concat8(v[2].odd, v[3].odd);
+    //a.x c.x, interleaved, for cubics 0...7
+    const bc_float16_t x_ac = __bc_concat8(x01.even, x23.even);
+    const bc_float16_t x_bd = __bc_concat8(x01.odd, x23.odd);
+    const bc_float16_t y_ac = __bc_concat8(y01.even, y23.even);
+    const bc_float16_t y_bd = __bc_concat8(y01.odd, y23.odd);
+    __BCCubicLanes8 l;
+    l.a_x = x_ac.even;
+    l.c_x = x_ac.odd;
+    l.b_x = x_bd.even;
+    l.d_x = x_bd.odd;
+    l.a_y = y_ac.even;
+    l.c_y = y_ac.odd;
+    l.b_y = y_bd.even;
+    l.d_y = y_bd.odd;
+    return l;
+}
+
+static inline void __bc_store8_interleaved(bc_float2_t *output, bc_float8_t x, bc_float8_t y) {
+    bc_float16_t v;
+    v.even = x;
+    v.odd = y;
+    memcpy(output, &v, sizeof(v));
+}
+
+//Same math as BCCubicEvaluate / BCCubicEvaluatePrime, on 8 lanes.
+static inline void __BCCubicLanes8Evaluate(__BCCubicLanes8 l, bc_float8_t t, bool prime, bc_float8_t *x, bc_float8_t *y) {
+    const bc_float8_t one_minus_t = 1 - t;
+    if (prime) {
+        const bc_float8_t w0 = 3 * one_minus_t * one_minus_t;
+        const bc_float8_t w1 = 6 * one_minus_t * t;
+        const bc_float8_t w2 = 3 * t * t;
+        *x = w0 * (l.c_x - l.a_x) + w1 * (l.d_x - l.c_x) + w2 * (l.b_x - l.d_x);
+        *y = w0 * (l.c_y - l.a_y) + w1 * (l.d_y - l.c_y) + w2 * (l.b_y - l.d_y);
+    }
+    else {
+        const bc_float8_t wa = one_minus_t * one_minus_t * one_minus_t;
+        const bc_float8_t wc = 3 * one_minus_t * one_minus_t * t;
+        const bc_float8_t wd = 3 * one_minus_t * t * t;
+        const bc_float8_t wb = t * t * t;
+        *x = l.a_x * wa + l.c_x * wc + l.d_x * wd + l.b_x * wb;
+        *y = l.a_y * wa + l.c_y * wc + l.d_y * wd + l.b_y * wb;
+    }
+}
+
+//One axis of the accurate strategy of BCAlignedRectCreateFromCubic, for 8 cubics.  Lanes are independent, so they can also be the interleaved x,y of 4 cubics.
+static inline void __BCLanes8AxisRange(bc_float8_t a, bc_float8_t b, bc_float8_t c, bc_float8_t d, bc_float8_t *min, bc_float8_t *max) {
+    const bc_float8_t p0 = c - a;
+    const bc_float8_t p1 = d - c;
+    const bc_float8_t p2 = b - d;
+    const bc_float8_t qa = p0 - 2 * p1 + p2;
+    const bc_float8_t qb = 2 * (p1 - p0);
+    const bc_float8_t zero = 0;
+    const bc_float8_t one = 1;
+    const bc_float8_t discriminant = qb * qb - 4 * qa * p0;
+    const bc_float8_t root = bc_vsqrt(bc_vmax(discriminant, zero));
+    const bc_float8_t quadraticScale = qa / (2 * qa * qa + 1e-30f);
+    const bc_float8_t candidates[3] = {
+        (-qb + root) * quadraticScale,
+        (-qb - root) * quadraticScale,
+        -p0 * qb / (qb * qb + 1e-30f),
+    };
+    *min = bc_vmin(a, b);
+    *max = bc_vmax(a, b);
+    for (int i = 0; i < 3; i++) {
+        const bc_float8_t t = bc_vmax(bc_vmin(candidates[i], one), zero);
+        const bc_float8_t mt = 1 - t;
+        const bc_float8_t v = mt * mt * mt * a + 3 * mt * mt * t * c + 3 * mt * t * t * d + t * t * t * b;
+        *min = bc_vmin(*min, v);
+        *max = bc_vmax(*max, v);
+    }
+}
+
+#endif //__METAL_VERSION__
+#endif //BCLanes8_h
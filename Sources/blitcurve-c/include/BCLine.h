@@ -11,8 +11,10 @@
 #ifndef __METAL_VERSION__
 #include <math.h>
 #include <assert.h>
+#ifndef BC_PORTABLE_SIMD
 #include <simd/simd.h>
 #endif
+#endif
 ///\abstract BCLine is a linesegment defined on 2 points
 ///\discussion Unlike some other notation, we use \c a and  \c b consistently for start and end points, reserving other values for control points.
 __attribute__((swift_name("Line")))
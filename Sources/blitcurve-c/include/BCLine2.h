@@ -6,8 +6,10 @@
 #include "BCTypes.h"
 
 #ifndef __METAL_VERSION__
+#ifndef BC_PORTABLE_SIMD
 #include <simd/simd.h>
 #endif
+#endif
 
 #include "BCMetalC.h"
 ///\abstract BCLine is logically 2 BCLine.  In certain cases we can perform operations faster via vectorization.
@@ -12,4 +12,10 @@
 #define __BC_MAYBESTATIC
 #endif
 
+//__BC_POLYNOMIAL is the power-basis cubic A t³ + B t² + C t + D by Horner's rule, for scalars or any vector type.
+//__BC_POLYNOMIAL_PRIME and __BC_POLYNOMIAL_SECOND are its derivatives.
+#define __BC_POLYNOMIAL(A, B, C, D, T) ((((A) * (T) + (B)) * (T) + (C)) * (T) + (D))
+#define __BC_POLYNOMIAL_PRIME(A, B, C, T) ((3 * (A) * (T) + 2 * (B)) * (T) + (C))
+#define __BC_POLYNOMIAL_SECOND(A, B, T) (6 * (A) * (T) + 2 * (B))
+
 #endif //BCMacros_h
@@ -41,4 +41,14 @@ static inline bc_float2_t __bc_square(bc_float2_t a) {
     //metal::pow ought to be avoided, FB8904929
     return a * a;
 }
+#ifndef BC_NO_VEC8
+__attribute__((overloadable))
+static inline bc_float8_t __bc_square(bc_float8_t a) {
+    return a * a;
+}
+__attribute__((overloadable))
+static inline bc_float16_t __bc_square(bc_float16_t a) {
+    return a * a;
+}
+#endif
 #endif
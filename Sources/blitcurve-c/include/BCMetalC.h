@@ -86,6 +86,9 @@ inline float bc_reduce_add(simd_float2 v) {
 #define bc_min simd::min
 #define bc_sign simd::sign
 #define bc_clamp simd::clamp
+#define bc_vmin simd::min
+#define bc_vmax simd::max
+#define bc_vsqrt metal::sqrt
 
 
 #define __BC_DEVICE device
@@ -95,53 +98,67 @@ inline float bc_reduce_add(simd_float2 v) {
 
 #else //defines we need in C
 
-
-#define bc_make_4x2 simd_matrix
-#define bc_make_2x4 simd_matrix
-#define bc_make_4x4 simd_matrix
-#define bc_make_2x2 simd_matrix
-
 #define BC_M_PI_F M_PI
 
 
 
 __attribute__((overloadable))
 inline bc_float_t bc_pow(float a, float b) { return powf(a,b); }
-static inline bc_float2_t bc_pow(bc_float2_t a, bc_float2_t b) { return pow(a,b); }
 __attribute__((overloadable))
 inline bc_float_t bc_cos(float a) { return cosf(a); }
-static inline bc_float2_t bc_cos(bc_float2_t a) { return cos(a); }
 __attribute__((overloadable))
 inline bc_float_t bc_sin(float a) { return sinf(a); }
-static inline bc_float2_t bc_sin(bc_float2_t a) { return sin(a); }
 __attribute__((overloadable))
 inline bc_float_t bc_abs(float a) { return fabsf(a);}
+
+#define bc_max fmax
+#define bc_min fmin
+#define bc_atan2 atan2f
+#define bc_round roundf
+#define bc_ceil ceilf
+#define bc_floor floorf
+#define bc_sqrt sqrtf
+#define bc_atan atan
+#define bc_signbit signbit
+
+#ifdef BC_PORTABLE_SIMD
+//vector functions are implemented on ext_vector_type
+#include "BCPortableC.h"
+#else
+
+#define bc_make_4x2 simd_matrix
+#define bc_make_2x4 simd_matrix
+#define bc_make_4x4 simd_matrix
+#define bc_make_2x2 simd_matrix
+
+static inline bc_float2_t bc_pow(bc_float2_t a, bc_float2_t b) { return pow(a,b); }
+static inline bc_float2_t bc_cos(bc_float2_t a) { return cos(a); }
+static inline bc_float2_t bc_sin(bc_float2_t a) { return sin(a); }
 __attribute__((overloadable))
 static inline bc_float2_t bc_abs(bc_float2_t a) { return simd_abs(a);}
 
 #define bc_reduce_max simd_reduce_max
-#define bc_max fmax
-#define bc_min fmin
 #define bc_dot simd_dot
 #define bc_norm_inf simd_norm_inf
 #define bc_fast_length simd_fast_length
-#define bc_atan2 atan2f
 #define bc_mix simd_mix
 #define bc_distance simd_distance
 #define bc_length simd_length
 #define bc_precise_length simd_precise_length
-#define bc_round roundf
-#define bc_ceil ceilf
-#define bc_floor floorf
 #define bc_mul simd_mul
 #define bc_sub simd_sub
 #define bc_reduce_add simd_reduce_add
 #define bc_reduce_min simd_reduce_min
 #define bc_length_squared simd_length_squared
-#define bc_sqrt sqrtf
-#define bc_atan atan
-#define bc_signbit signbit
 #define bc_clamp simd_clamp
+//elementwise operations on wide vectors.  bc_min/bc_max/bc_sqrt are scalar in C.
+#define bc_vmin simd_min
+#define bc_vmax simd_max
+#define bc_vsqrt simd_sqrt
+__attribute__((overloadable))
+static inline bc_float8_t bc_abs(bc_float8_t a) { return simd_abs(a);}
+__attribute__((overloadable))
+static inline bc_float16_t bc_abs(bc_float16_t a) { return simd_abs(a);}
 
 
 
@@ -155,6 +172,7 @@ static inline bc_float4_t bc_make_float4(bc_float2_t a, bc_float2_t b) {
 }
 #define bc_make_float2 simd_make_float2
 #define bc_make_float3 simd_make_float3
+#endif //BC_PORTABLE_SIMD
 
 //address space qualifier
 #define __BC_DEVICE
@@ -0,0 +1,35 @@
+//BCParallel.h: Minimal parallel-for used by CPU batch functions
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCParallel_h
+#define BCParallel_h
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+
+/**
+ \abstract Work function for \c __BCParallelFor.
+ @param context the context passed to \c __BCParallelFor
+ @param begin first index of the chunk
+ @param end index after the last of the chunk
+ @param worker index of the calling worker, less than the worker count \c __BCParallelFor returns.  Use it to index per-worker scratch.
+ */
+typedef void (*__BCParallelWork)(void *context, size_t begin, size_t end, unsigned worker);
+
+/**
+ \abstract Returns the number of workers \c __BCParallelFor uses for a given \c threads argument.
+ \discussion \c 0 is the number of online CPUs.
+ */
+unsigned __BCParallelWorkerCount(unsigned threads);
+
+/**
+ \abstract Calls \c work on chunks of \c [0,count) from several threads.
+ \discussion Chunks are \c grain indices (the last may be shorter) and are handed out dynamically, so uneven work balances.  The calling thread is worker 0.  Returns once every chunk is done.
+
+ Other workers are a pool of threads, started the first time a call wants them and then kept waiting for work, so per-frame calls don't pay for thread creation.  One call uses the pool at a time: a call made from a work function, or while another thread's call is running, does all its chunks on the calling thread.  If a thread can't be created, its share is done by the others.
+ @param threads maximum number of workers, or \c 0 for the number of online CPUs
+ @return the number of workers that could have been used, as \c __BCParallelWorkerCount.
+ */
+unsigned __BCParallelFor(size_t count, size_t grain, unsigned threads, __BCParallelWork work, void *context);
+
+#endif //__METAL_VERSION__
+#endif //BCParallel_h
@@ -0,0 +1,213 @@
+// BCPortableC.h: Portable C backend for BCMetalC.h
+// ©2021 DrewCrawfordApps LLC
+
+/*
+ Implements the vector half of BCMetalC.h on clang's ext_vector_type, for platforms without <simd/simd.h> (e.g. Linux).
+ 
+ Only the subset of simd/simd.h that blitcurve uses is implemented here.  Semantics follow the simd/simd.h function of the same name (e.g. \c bc_mix is \c simd_mix).
+ The vector arithmetic is lowered by clang to SSE/AVX/NEON as available for the target, so pass the usual flags (e.g. \c -mavx2) to get wider instructions.
+ 
+ Don't include this directly; it is included by BCMetalC.h when \c BC_PORTABLE_SIMD is defined.
+ */
+#ifndef BCPortableC_h
+#define BCPortableC_h
+#include "BCTypes.h"
+//module maps may pull in this header on Apple platforms, where it doesn't apply
+#ifdef BC_PORTABLE_SIMD
+
+#define __BC_PORTABLE_INLINE static inline __attribute__((overloadable)) __attribute__((const))
+
+//unsigned types used for bit manipulation, e.g. abs.  Same size as the corresponding float type.
+typedef uint32_t __bc_uint2_t __attribute__((ext_vector_type(2)));
+typedef uint32_t __bc_uint4_t __attribute__((ext_vector_type(4)));
+typedef uint32_t __bc_uint8_t __attribute__((ext_vector_type(8)));
+typedef uint32_t __bc_uint16_t __attribute__((ext_vector_type(16)));
+
+//matrix types we construct, but which don't have a bc_ name.  Same layout as simd_float4x2/simd_float2x4.
+typedef struct { bc_float2_t columns[4]; } __bc_float4x2_t;
+typedef struct { bc_float4_t columns[2]; } __bc_float2x4_t;
+
+//MARK: construction
+__BC_PORTABLE_INLINE bc_float2_t bc_make_float2(float x, float y) {
+    return (bc_float2_t){x, y};
+}
+__BC_PORTABLE_INLINE bc_float3_t bc_make_float3(float x, float y, float z) {
+    return (bc_float3_t){x, y, z};
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_make_float4(float x, float y, float z, float w) {
+    return (bc_float4_t){x, y, z, w};
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_make_float4(bc_float2_t a, bc_float2_t b) {
+    return (bc_float4_t){a.x, a.y, b.x, b.y};
+}
+
+//matrices are specified by columns, as simd_matrix
+__BC_PORTABLE_INLINE bc_float2x2_t bc_make_2x2(bc_float2_t c0, bc_float2_t c1) {
+    bc_float2x2_t m = {{c0, c1}};
+    return m;
+}
+__BC_PORTABLE_INLINE bc_float4x4_t bc_make_4x4(bc_float4_t c0, bc_float4_t c1, bc_float4_t c2, bc_float4_t c3) {
+    bc_float4x4_t m = {{c0, c1, c2, c3}};
+    return m;
+}
+__BC_PORTABLE_INLINE __bc_float4x2_t bc_make_4x2(bc_float2_t c0, bc_float2_t c1, bc_float2_t c2, bc_float2_t c3) {
+    __bc_float4x2_t m = {{c0, c1, c2, c3}};
+    return m;
+}
+__BC_PORTABLE_INLINE __bc_float2x4_t bc_make_2x4(bc_float4_t c0, bc_float4_t c1) {
+    __bc_float2x4_t m = {{c0, c1}};
+    return m;
+}
+
+//MARK: matrix arithmetic
+__BC_PORTABLE_INLINE bc_float2_t bc_mul(bc_float2x2_t m, bc_float2_t v) {
+    return m.columns[0] * v.x + m.columns[1] * v.y;
+}
+__BC_PORTABLE_INLINE bc_float3_t bc_mul(bc_float3x3_t m, bc_float3_t v) {
+    return m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z;
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_mul(bc_float4x4_t m, bc_float4_t v) {
+    return m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z + m.columns[3] * v.w;
+}
+__BC_PORTABLE_INLINE bc_float2x2_t bc_sub(bc_float2x2_t a, bc_float2x2_t b) {
+    return bc_make_2x2(a.columns[0] - b.columns[0], a.columns[1] - b.columns[1]);
+}
+__BC_PORTABLE_INLINE bc_float4x4_t bc_sub(bc_float4x4_t a, bc_float4x4_t b) {
+    return bc_make_4x4(a.columns[0] - b.columns[0], a.columns[1] - b.columns[1], a.columns[2] - b.columns[2], a.columns[3] - b.columns[3]);
+}
+
+//MARK: elementwise math
+__BC_PORTABLE_INLINE bc_float2_t bc_abs(bc_float2_t a) {
+    //clear the sign bit, which vectorizes better than calling fabsf per lane
+    return (bc_float2_t)((__bc_uint2_t)a & 0x7fffffff);
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_abs(bc_float4_t a) {
+    return (bc_float4_t)((__bc_uint4_t)a & 0x7fffffff);
+}
+__BC_PORTABLE_INLINE bc_float2_t bc_pow(bc_float2_t a, bc_float2_t b) {
+    return bc_make_float2(powf(a.x, b.x), powf(a.y, b.y));
+}
+__BC_PORTABLE_INLINE bc_float2_t bc_cos(bc_float2_t a) {
+    return bc_make_float2(cosf(a.x), cosf(a.y));
+}
+__BC_PORTABLE_INLINE bc_float2_t bc_sin(bc_float2_t a) {
+    return bc_make_float2(sinf(a.x), sinf(a.y));
+}
+__BC_PORTABLE_INLINE float bc_mix(float x, float y, float t) {
+    return x + t * (y - x);
+}
+__BC_PORTABLE_INLINE bc_float2_t bc_mix(bc_float2_t x, bc_float2_t y, bc_float2_t t) {
+    return x + t * (y - x);
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_mix(bc_float4_t x, bc_float4_t y, bc_float4_t t) {
+    return x + t * (y - x);
+}
+__BC_PORTABLE_INLINE float bc_clamp(float x, float min, float max) {
+    return fminf(fmaxf(x, min), max);
+}
+__BC_PORTABLE_INLINE bc_float2_t bc_clamp(bc_float2_t x, bc_float2_t min, bc_float2_t max) {
+    return bc_make_float2(bc_clamp(x.x, min.x, max.x), bc_clamp(x.y, min.y, max.y));
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_clamp(bc_float4_t x, bc_float4_t min, bc_float4_t max) {
+    return bc_make_float4(bc_clamp(x.lo, min.lo, max.lo), bc_clamp(x.hi, min.hi, max.hi));
+}
+
+//MARK: reductions
+__BC_PORTABLE_INLINE float bc_reduce_add(bc_float2_t a) {
+    return a.x + a.y;
+}
+__BC_PORTABLE_INLINE float bc_reduce_add(bc_float4_t a) {
+    return bc_reduce_add(a.lo + a.hi);
+}
+__BC_PORTABLE_INLINE float bc_reduce_min(bc_float2_t a) {
+    return fminf(a.x, a.y);
+}
+__BC_PORTABLE_INLINE float bc_reduce_min(bc_float4_t a) {
+    return bc_reduce_min(bc_make_float2(fminf(a.x, a.z), fminf(a.y, a.w)));
+}
+__BC_PORTABLE_INLINE float bc_reduce_max(bc_float2_t a) {
+    return fmaxf(a.x, a.y);
+}
+__BC_PORTABLE_INLINE float bc_reduce_max(bc_float4_t a) {
+    return bc_reduce_max(bc_make_float2(fmaxf(a.x, a.z), fmaxf(a.y, a.w)));
+}
+
+//MARK: geometry
+__BC_PORTABLE_INLINE float bc_dot(bc_float2_t a, bc_float2_t b) {
+    return bc_reduce_add(a * b);
+}
+__BC_PORTABLE_INLINE float bc_dot(bc_float3_t a, bc_float3_t b) {
+    const bc_float3_t m = a * b;
+    return m.x + m.y + m.z;
+}
+__BC_PORTABLE_INLINE float bc_dot(bc_float4_t a, bc_float4_t b) {
+    return bc_reduce_add(a * b);
+}
+__BC_PORTABLE_INLINE float bc_length_squared(bc_float2_t a) {
+    return bc_dot(a, a);
+}
+__BC_PORTABLE_INLINE float bc_length_squared(bc_float4_t a) {
+    return bc_dot(a, a);
+}
+__BC_PORTABLE_INLINE float bc_length(bc_float2_t a) {
+    return sqrtf(bc_length_squared(a));
+}
+__BC_PORTABLE_INLINE float bc_length(bc_float4_t a) {
+    return sqrtf(bc_length_squared(a));
+}
+//on Apple, these are distinguished by precision.  Here, all lengths are computed the same way.
+#define bc_fast_length bc_length
+#define bc_precise_length bc_length
+__BC_PORTABLE_INLINE float bc_distance(bc_float2_t a, bc_float2_t b) {
+    return bc_length(a - b);
+}
+__BC_PORTABLE_INLINE float bc_distance(bc_float4_t a, bc_float4_t b) {
+    return bc_length(a - b);
+}
+__BC_PORTABLE_INLINE float bc_norm_inf(bc_float2_t a) {
+    return bc_reduce_max(bc_abs(a));
+}
+__BC_PORTABLE_INLINE float bc_norm_inf(bc_float4_t a) {
+    return bc_reduce_max(bc_abs(a));
+}
+
+//MARK: lane operations, for wide types
+__BC_PORTABLE_INLINE bc_float8_t bc_abs(bc_float8_t a) {
+    return (bc_float8_t)((__bc_uint8_t)a & 0x7fffffff);
+}
+__BC_PORTABLE_INLINE bc_float16_t bc_abs(bc_float16_t a) {
+    return (bc_float16_t)((__bc_uint16_t)a & 0x7fffffff);
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_vmin(bc_float4_t a, bc_float4_t b) {
+    return a < b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float8_t bc_vmin(bc_float8_t a, bc_float8_t b) {
+    return a < b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float16_t bc_vmin(bc_float16_t a, bc_float16_t b) {
+    return a < b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_vmax(bc_float4_t a, bc_float4_t b) {
+    return a > b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float8_t bc_vmax(bc_float8_t a, bc_float8_t b) {
+    return a > b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float16_t bc_vmax(bc_float16_t a, bc_float16_t b) {
+    return a > b ? a : b;
+}
+__BC_PORTABLE_INLINE bc_float4_t bc_vsqrt(bc_float4_t a) {
+    for (int i = 0; i < 4; i++) { a[i] = __builtin_sqrtf(a[i]); }
+    return a;
+}
+__BC_PORTABLE_INLINE bc_float8_t bc_vsqrt(bc_float8_t a) {
+    for (int i = 0; i < 8; i++) { a[i] = __builtin_sqrtf(a[i]); }
+    return a;
+}
+__BC_PORTABLE_INLINE bc_float16_t bc_vsqrt(bc_float16_t a) {
+    for (int i = 0; i < 16; i++) { a[i] = __builtin_sqrtf(a[i]); }
+    return a;
+}
+
+#endif //BC_PORTABLE_SIMD
+#endif //BCPortableC_h
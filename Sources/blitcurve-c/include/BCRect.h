@@ -88,6 +88,31 @@ __attribute__((swift_name("BCRect.intersects(self:_:)")))
 ///\abstract Calculates whether 2 \c BCRect intersect
 bool BCRectIntersects(BCRect e, BCRect f);
 
+/**\abstract A \c BCRect with its rotation and corners calculated ahead of time.
+\discussion \c BCRectIntersects finds the rotation and corners of both rects, for each call.  When a rect is tested many times, prepare it once with \c BCPreparedRectMake and use \c BCPreparedRectIntersects instead, which does no trig.
+ */
+__attribute__((swift_name("PreparedRect")))
+typedef struct {
+    ///The corners, as \c BCRectGet4Points
+    BC4Points points;
+    bc_float2_t center;
+    ///\c cos and \c sin of the angle
+    bc_float2_t rotation;
+    ///Half the extent along the rect's own x and y axes.  Note that this is \c lengths/2 with x and y swapped, see \c BCRectGet4Points.
+    bc_float2_t halflengths;
+} BCPreparedRect;
+
+__attribute__((const))
+__attribute__((swift_name("PreparedRect.init(_:)")))
+///\abstract Prepares a rect for repeated intersection tests.
+BCPreparedRect BCPreparedRectMake(BCRect r);
+
+__attribute__((const))
+__attribute__((swift_name("PreparedRect.intersects(self:_:)")))
+///\abstract Calculates whether 2 \c BCPreparedRect intersect, like \c BCRectIntersects.
+///\performance 16 multiplies per direction, and no trig.
+bool BCPreparedRectIntersects(BCPreparedRect e, BCPreparedRect f);
+
 __attribute__((const))
 __attribute__((swift_private)) //use overlay instead
 /**
@@ -0,0 +1,34 @@
+//BCRectBatch.h: Batch intersection of many BCRect
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCRectBatch_h
+#define BCRectBatch_h
+//batch kernels are CPU-only
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include "BCRect.h"
+
+/**
+ \abstract Prepares many rects, as \c BCPreparedRectMake.
+ @param rects \c count rects
+ @param output storage for \c count prepared rects
+ \throws Checks arguments with assert.
+ */
+__attribute__((swift_name("PreparedRect.makeBatch(_:count:output:)")))
+void BCPreparedRectMakeBatch(const BCRect *rects, size_t count, BCPreparedRect *output);
+
+/**
+ \abstract Tests one prepared rect against many, as \c BCPreparedRectIntersects.
+ @param rect the rect to test
+ @param others \c count prepared rects
+ @param mask storage for \c (count+7)/8 bytes.  Bit \c i%8 of byte \c i/8 is set if \c rect intersects \c others[i].  Unused bits of the last byte are cleared.
+ @return the number of rects in \c others that intersect \c rect.
+ \performance 8 rects at a time, one per SIMD lane.
+ \throws Checks arguments with assert.  rvalue is 0.
+ */
+__attribute__((swift_name("PreparedRect.intersectsBatch(self:_:count:mask:)")))
+size_t BCPreparedRectIntersectsBatch(BCPreparedRect rect, const BCPreparedRect *others, size_t count, uint8_t *mask);
+
+#endif //__METAL_VERSION__
+#endif //BCRectBatch_h
@@ -0,0 +1,45 @@
+//BCRectBroadPhase.h: Grid broad phase for many BCRect
+// ©2021 DrewCrawfordApps LLC
+
+#ifndef BCRectBroadPhase_h
+#define BCRectBroadPhase_h
+//the broad phase runs on CPU threads
+#ifndef __METAL_VERSION__
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "BCRect.h"
+
+///Two rects, by index.  \c a is less than \c b.
+__attribute__((swift_name("RectPair")))
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} BCRectPair;
+
+/**
+ \abstract Finds every pair of intersecting rects.
+ \discussion Each rect's axis-aligned bounds (\c BCRectMax, mirrored through the center for the minimum) are binned into a uniform grid.  \c BCRectIntersects is only called for rects that share a cell and whose bounds overlap, and each pair is tested in exactly one cell.  So this is about linear in \c count when rects are spread out, rather than quadratic.
+ @param rects \c count rects.  \c count must be less than \c UINT32_MAX, and the rects' bounds must be finite.
+ @param cellSize width and height of a grid cell.  Pass \c 0 to use the average bounds size, which suits rects of similar size.  The cell size may be increased to keep the grid to a few cells per rect.
+ @param threads maximum number of threads, or \c 0 for the number of online CPUs.  Cells are divided between the threads.
+ @param pairs storage for \c capacity pairs.  Pairs are in no particular order.
+ @return the number of intersecting pairs.  If this is more than \c capacity, only \c capacity pairs are written.
+ \performance Allocates scratch of about 16 bytes per rect and per cell.
+ \throws Checks arguments with assert.  rvalue is 0.  If scratch can't be allocated, returns 0 at every check level.
+ */
+__attribute__((swift_name("Rect.intersectingPairs(_:count:cellSize:threads:pairs:capacity:)")))
+size_t BCRectIntersectingPairs(const BCRect *rects, size_t count, bc_float_t cellSize, unsigned threads, BCRectPair *pairs, size_t capacity);
+
+/**
+ \abstract Finds every rect that intersects some other rect.
+ \discussion Like \c BCRectIntersectingPairs, but rather than listing pairs, sets a flag for each rect.
+ @param hits storage for \c count flags.  Each is set to whether the rect intersects any other rect.
+ @return the number of rects that intersect another rect.
+ \throws Checks arguments with assert.  rvalue is 0.  If scratch can't be allocated, returns 0 at every check level.
+ */
+__attribute__((swift_name("Rect.intersectingFlags(_:count:cellSize:threads:hits:)")))
+size_t BCRectIntersectingFlags(const BCRect *rects, size_t count, bc_float_t cellSize, unsigned threads, bool *hits);
+
+#endif //__METAL_VERSION__
+#endif //BCRectBroadPhase_h
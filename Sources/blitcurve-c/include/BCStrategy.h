@@ -7,6 +7,8 @@
 ///Indicates which of several strategies to use in a function call or algorithm
 typedef enum {
     ///Use the fastest method, regardless of its accuracy
-    BCStrategyFastest __attribute__((swift_name("fastest")))
+    BCStrategyFastest __attribute__((swift_name("fastest"))),
+    ///Use a more accurate method.  Depending on the function this may or may not be slower than \c fastest, see the function documentation.
+    BCStrategyAccurate __attribute__((swift_name("accurate")))
 }  __attribute__((enum_extensibility(closed))) BCStrategy;
 #endif
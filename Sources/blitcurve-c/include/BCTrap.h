@@ -17,7 +17,7 @@
  
  * The platform might trap, if supported / convenient.  On Metal we have tried a variety of trap systems, not all of which work well.  At the time of this writing, we trap on CPU platforms, but this may change.
  * If not trapping, the rvalue may be returned.
- * We may in the future allow a mode for UB for errors, to allow faster performance.  Unclear to me if this will be in the form of calling special UB functions, or through a preprocessor define.
+ * Or the check may be assumed, so a failure is UB, for faster performance.  This is a preprocessor define, see "Check levels" below.
  
  Assertion types.  These generally draw a distinction between "variant" and "constant" values.  Constant values are parameters that the developer probably used a compile-time constant for (e.g. a strategy, max size, accuracy, etc.)  Variant values are those that really reflect the runtime situation (geometry, etc.)  In this way we can check assertions for the former case during development and then disable them, knowing that the same constants are in use in production and they were fine.
  
@@ -42,10 +42,62 @@
 #define __BC_CPU_TRAP {printf("BC_CPU_TRAP %s:%d\n",__FILE__,__LINE__); exit(137);}
 #endif
 
+/*
+ Check levels.  Each assertion type has its own level, chosen at compile time, so checks meant for development can be compiled out of production builds that have validated their inputs.
+
+ * BC_CHECK_TRAP traps, as described above.  On GPU, where trap is a no-op, this is the same as BC_CHECK_RETURN.
+ * BC_CHECK_RETURN returns the rvalue (or runs the custom code) without trapping.
+ * BC_CHECK_ASSUME tells the compiler the condition is true.  The branch and rvalue are compiled out, and the compiler may optimize further on the condition.  A false condition is UB.  Helpers that only build rvalues, such as __BCDasherErrorMake, are then unused, so mark them __attribute__((unused)).
+
+ Define BC_BUGASSERT_LEVEL, BC_ASSERT_LEVEL, BC_RANGEASSERT_LEVEL or BC_PRECONDITION_LEVEL to choose a level per type, or BC_CHECK_LEVEL for all of them.  The default is BC_CHECK_TRAP.
+ BC_TRY_LEVEL covers __BC_TRY_IF and __BC_ASSERT_CONVERT, which pass along errors that a callee already reported.  It defaults to BC_CHECK_ASSUME when every type is assumed, since then there are no errors to pass along, to BC_CHECK_RETURN when no type traps, and to BC_CHECK_TRAP otherwise.
+
+ Levels must be defined the same way for blitcurve and for code that includes its headers, since inline functions are checked at the level of the file that includes them.
+ */
+#define BC_CHECK_TRAP 0
+#define BC_CHECK_RETURN 1
+#define BC_CHECK_ASSUME 2
+
+#ifndef BC_CHECK_LEVEL
+#define BC_CHECK_LEVEL BC_CHECK_TRAP
+#endif
+#ifndef BC_BUGASSERT_LEVEL
+#define BC_BUGASSERT_LEVEL BC_CHECK_LEVEL
+#endif
+#ifndef BC_ASSERT_LEVEL
+#define BC_ASSERT_LEVEL BC_CHECK_LEVEL
+#endif
+#ifndef BC_RANGEASSERT_LEVEL
+#define BC_RANGEASSERT_LEVEL BC_CHECK_LEVEL
+#endif
+#ifndef BC_PRECONDITION_LEVEL
+#define BC_PRECONDITION_LEVEL BC_CHECK_LEVEL
+#endif
+#ifndef BC_TRY_LEVEL
+#if BC_BUGASSERT_LEVEL == BC_CHECK_ASSUME && BC_ASSERT_LEVEL == BC_CHECK_ASSUME && BC_RANGEASSERT_LEVEL == BC_CHECK_ASSUME && BC_PRECONDITION_LEVEL == BC_CHECK_ASSUME
+#define BC_TRY_LEVEL BC_CHECK_ASSUME
+#elif BC_BUGASSERT_LEVEL != BC_CHECK_TRAP && BC_ASSERT_LEVEL != BC_CHECK_TRAP && BC_RANGEASSERT_LEVEL != BC_CHECK_TRAP && BC_PRECONDITION_LEVEL != BC_CHECK_TRAP
+#define BC_TRY_LEVEL BC_CHECK_RETURN
+#else
+#define BC_TRY_LEVEL BC_CHECK_TRAP
+#endif
+#endif
+
+//One check at each level.  CUSTOM runs when CONDITION is false.
+#define __BC_CHECK_TRAP(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {__BC_CPU_TRAP CUSTOM;}
+#define __BC_CHECK_RETURN(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {CUSTOM;}
+#define __BC_CHECK_ASSUME(CONDITION,CUSTOM) if (!(CONDITION)) {__builtin_unreachable();}
+
 //ASSERT priority
 
 //Like __BC_ASSERT, but allows custom code to run after the trap rather than using an rvalue.
-#define __BC_ASSERT_CUSTOM(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {__BC_CPU_TRAP CUSTOM;}
+#if BC_ASSERT_LEVEL == BC_CHECK_ASSUME
+#define __BC_ASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_ASSUME(CONDITION,CUSTOM)
+#elif BC_ASSERT_LEVEL == BC_CHECK_RETURN
+#define __BC_ASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_RETURN(CONDITION,CUSTOM)
+#else
+#define __BC_ASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_TRAP(CONDITION,CUSTOM)
+#endif
 
 /*__BC_ASSERT traps incorrect application usage of blitcurve.  This is typically cases like invalid arguments and similar obvious misuse.
  This does not include "subtle" bugs that might only turn up in production.  For example, issues that occur only on large problem sizes.
@@ -56,22 +108,52 @@
 /*
  Converts some rvalue to another rvalue, for assertion-type.
  */
-#define __BC_ASSERT_CONVERT(LHS,RVALUE,NEWRVALUE) if (__builtin_expect(LHS==RVALUE,0)) { __BC_CPU_TRAP return NEWRVALUE; }
+#if BC_TRY_LEVEL == BC_CHECK_ASSUME
+#define __BC_ASSERT_CONVERT(LHS,RVALUE,NEWRVALUE) __BC_CHECK_ASSUME(!(LHS==RVALUE),return NEWRVALUE)
+#elif BC_TRY_LEVEL == BC_CHECK_RETURN
+#define __BC_ASSERT_CONVERT(LHS,RVALUE,NEWRVALUE) __BC_CHECK_RETURN(!(LHS==RVALUE),return NEWRVALUE)
+#else
+#define __BC_ASSERT_CONVERT(LHS,RVALUE,NEWRVALUE) __BC_CHECK_TRAP(!(LHS==RVALUE),return NEWRVALUE)
+#endif
 
 //The BUG priority deals with conditions that we think are blitcurve bugs if they occur
-#define __BC_BUGASSERT_CUSTOM(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {__BC_CPU_TRAP CUSTOM;}
+#if BC_BUGASSERT_LEVEL == BC_CHECK_ASSUME
+#define __BC_BUGASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_ASSUME(CONDITION,CUSTOM)
+#elif BC_BUGASSERT_LEVEL == BC_CHECK_RETURN
+#define __BC_BUGASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_RETURN(CONDITION,CUSTOM)
+#else
+#define __BC_BUGASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_TRAP(CONDITION,CUSTOM)
+#endif
 #define __BC_BUGASSERT(CONDITION,RVALUE) __BC_BUGASSERT_CUSTOM(CONDITION,return RVALUE)
 
 //The RANGEASSSERT priority deals with values outside a constant range
-#define __BC_RANGEASSERT_CUSTOM(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {__BC_CPU_TRAP CUSTOM;}
+#if BC_RANGEASSERT_LEVEL == BC_CHECK_ASSUME
+#define __BC_RANGEASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_ASSUME(CONDITION,CUSTOM)
+#elif BC_RANGEASSERT_LEVEL == BC_CHECK_RETURN
+#define __BC_RANGEASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_RETURN(CONDITION,CUSTOM)
+#else
+#define __BC_RANGEASSERT_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_TRAP(CONDITION,CUSTOM)
+#endif
 #define __BC_RANGEASSERT(CONDITION,RVALUE) __BC_RANGEASSERT_CUSTOM(CONDITION,return RVALUE)
 
 //The PRECONDITION priority deals with variant errors
-#define __BC_PRECONDITION_CUSTOM(CONDITION,CUSTOM) if (!__builtin_expect(CONDITION,1)) {__BC_CPU_TRAP CUSTOM;}
+#if BC_PRECONDITION_LEVEL == BC_CHECK_ASSUME
+#define __BC_PRECONDITION_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_ASSUME(CONDITION,CUSTOM)
+#elif BC_PRECONDITION_LEVEL == BC_CHECK_RETURN
+#define __BC_PRECONDITION_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_RETURN(CONDITION,CUSTOM)
+#else
+#define __BC_PRECONDITION_CUSTOM(CONDITION,CUSTOM) __BC_CHECK_TRAP(CONDITION,CUSTOM)
+#endif
 #define __BC_PRECONDITION(CONDITION,RVALUE) __BC_PRECONDITION_CUSTOM(CONDITION,return RVALUE)
 
 
-#define __BC_TRY_IF(CONDITION,RVALUE) if (__builtin_expect(CONDITION,0)) { __BC_CPU_TRAP return RVALUE; }
+#if BC_TRY_LEVEL == BC_CHECK_ASSUME
+#define __BC_TRY_IF(CONDITION,RVALUE) __BC_CHECK_ASSUME(!(CONDITION),return RVALUE)
+#elif BC_TRY_LEVEL == BC_CHECK_RETURN
+#define __BC_TRY_IF(CONDITION,RVALUE) __BC_CHECK_RETURN(!(CONDITION),return RVALUE)
+#else
+#define __BC_TRY_IF(CONDITION,RVALUE) __BC_CHECK_TRAP(!(CONDITION),return RVALUE)
+#endif
 /**
  This defines various error situations that might occur.  Note that in practice, functions often transform these errors in some way to fit them into values outside the function domain.
  For example, they  might be cast to floats or negated.
@@ -4,8 +4,25 @@
 #ifndef Types_h
 #define Types_h
 
+/*
+ blitcurve supports three backends for its vector types:
+ 1.  Metal, when \c __METAL_VERSION__ is defined.
+ 2.  Apple C, using \c <simd/simd.h>.
+ 3.  Portable C, using clang's \c ext_vector_type directly.  This is selected automatically when \c <simd/simd.h> is unavailable (e.g. on Linux), or you may force it by defining \c BC_PORTABLE_SIMD.  This backend requires clang, as the library relies on \c overloadable and vector swizzles (\c .xy, \c .lo, \c .even etc.)
+ 
+ The Apple \c simd types are themselves \c ext_vector_type, so the portable types have identical size and alignment, and structs like \c BCCubic and \c BCRect are byte-identical across backends.
+ */
 #ifndef __METAL_VERSION__
+#if !defined(BC_PORTABLE_SIMD) && !__has_include(<simd/simd.h>)
+#define BC_PORTABLE_SIMD
+#endif
+#ifndef BC_PORTABLE_SIMD
 #include <simd/simd.h>
+#else
+//these are otherwise provided by simd/simd.h
+#include <stdint.h>
+#include <math.h>
+#endif
 #include <float.h> //needed for FLT_MAX
 #else
 #include <metal_stdlib>
@@ -25,48 +42,82 @@ typedef float bc_float_t;
 
 __attribute__((swift_name("BCFloat2")))
 ///@typedef BlitCurve's internal float2 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef simd::float2 bc_float2_t;
+#elif defined(BC_PORTABLE_SIMD)
+typedef float bc_float2_t __attribute__((ext_vector_type(2)));
 #else
 typedef simd_float2 bc_float2_t;
 #endif
 
 __attribute__((swift_name("BCFloat3")))
 ///@typedef BlitCurve's internal float3 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef simd::float3 bc_float3_t;
+#elif defined(BC_PORTABLE_SIMD)
+typedef float bc_float3_t __attribute__((ext_vector_type(3)));
 #else
 typedef simd_float3 bc_float3_t;
 #endif
 
 __attribute__((swift_name("BCFloat4")))
 ///@typedef BlitCurve's internal float4 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef simd::float4 bc_float4_t;
+#elif defined(BC_PORTABLE_SIMD)
+typedef float bc_float4_t __attribute__((ext_vector_type(4)));
 #else
 typedef simd_float4 bc_float4_t;
 #endif
 
+//8- and 16-wide types are used by CPU batch kernels.  These are not available on Metal, see BC_NO_VEC8
+#ifndef __METAL_VERSION__
+__attribute__((swift_name("BCFloat8")))
+///@typedef BlitCurve's internal float8 type.
+#if defined(BC_PORTABLE_SIMD)
+typedef float bc_float8_t __attribute__((ext_vector_type(8)));
+#else
+typedef simd_float8 bc_float8_t;
+#endif
+
+__attribute__((swift_name("BCFloat16")))
+///@typedef BlitCurve's internal float16 type.
+#if defined(BC_PORTABLE_SIMD)
+typedef float bc_float16_t __attribute__((ext_vector_type(16)));
+#else
+typedef simd_float16 bc_float16_t;
+#endif
+#endif
+
 __attribute__((swift_name("BCFloat2x2")))
 ///@typedef BlitCurve's internal float2 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef metal::float2x2 bc_float2x2_t;
+#elif defined(BC_PORTABLE_SIMD)
+//same layout as simd_float2x2
+typedef struct { bc_float2_t columns[2]; } bc_float2x2_t;
 #else
 typedef simd_float2x2 bc_float2x2_t;
 #endif
 
 __attribute__((swift_name("BCFloat3x3")))
 ///@typedef BlitCurve's internal float2 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef metal::float3x3 bc_float3x3_t;
+#elif defined(BC_PORTABLE_SIMD)
+//same layout as simd_float3x3
+typedef struct { bc_float3_t columns[3]; } bc_float3x3_t;
 #else
 typedef simd_float3x3 bc_float3x3_t;
 #endif
 
 __attribute__((swift_name("BCFloat4x4")))
 ///@typedef BlitCurve's internal float2 type.
-#ifdef __METAL_VERSION__
+#if defined(__METAL_VERSION__)
 typedef metal::float4x4 bc_float4x4_t;
+#elif defined(BC_PORTABLE_SIMD)
+//same layout as simd_float4x4
+typedef struct { bc_float4_t columns[4]; } bc_float4x4_t;
 #else
 typedef simd_float4x4 bc_float4x4_t;
 #endif
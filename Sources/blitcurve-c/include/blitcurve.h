@@ -14,6 +14,21 @@
 #include "BCStrategy.h"
 #include "BCTypes.h"
 #include "BCCubic2.h"
+#include "BCCubic4.h"
+#include "BCCubic8.h"
 #include "BCAlignedCubic.h"
 #include "BCCubicDrawing.h"
+#include "BCCubicBatch.h"
+#include "BCArclengthTable.h"
+#include "BCArclengthSampler.h"
+#include "BCCubicFlatten.h"
+#include "BCAlignedCubicCache.h"
+#include "BCRectBroadPhase.h"
+#include "BCAlignedRectTree.h"
+#include "BCAlignedRectSweep.h"
+#include "BCRectBatch.h"
+#include "BCCubicIntersection.h"
+#include "BCCubicProjection.h"
+#include "BCDistanceField.h"
+#include "BCCubicStroke.h"
 #endif
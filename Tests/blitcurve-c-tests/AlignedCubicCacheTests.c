@@ -0,0 +1,172 @@
+// AlignedCubicCacheTests.c: BCAlignedCubicCache tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static BCCubic transformCubic(BCCubic c, float angle, bc_float2_t offset) {
+    const bc_float2x2_t rotation = bc_make_2x2(bc_make_float2(cosf(angle), sinf(angle)), bc_make_float2(-sinf(angle), cosf(angle)));
+    return CubicMake(bc_mul(rotation, c.a) + offset, bc_mul(rotation, c.b) + offset, bc_mul(rotation, c.c) + offset, bc_mul(rotation, c.d) + offset);
+}
+
+static void testLookup(void) {
+    const size_t capacity = 16;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    const BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(20,40), bc_make_float2(80,40));
+    const BCAlignedCubic aligned = BCAlignedCubicMake(cubic);
+    const BCAlignedCubicCacheValue v = BCAlignedCubicCacheLookup(&cache, aligned);
+    XCTAssertEqual(cache.misses, 1);
+    XCTAssertEqual(cache.hits, 0);
+    XCTAssertEqualWithAccuracy(v.maxKappaParameter, BCAlignedCubicMaxKappaParameter(aligned, 0.001), 0.01);
+    XCTAssertEqualWithAccuracy(v.maxKappa, BCAlignedCubicKappa(aligned, BCAlignedCubicMaxKappaParameter(aligned, 0.001)), 0.001);
+    XCTAssertEqualWithAccuracy(v.length, BCCubicLengthWithStrategy(cubic, 0.001, BCStrategyAccurate), 0.05);
+    XCTAssertEqual(v.isNormalizedForCurvature, BCAlignedCubicIsNormalizedForCurvature(aligned, 2 * M_PI / 360, 0.001));
+
+    //the same shape elsewhere hits
+    const BCAlignedCubicCacheValue moved = BCAlignedCubicCacheLookup(&cache, BCAlignedCubicMake(transformCubic(cubic, 0.7, bc_make_float2(300, -20))));
+    XCTAssertEqual(cache.misses, 1);
+    XCTAssertEqual(cache.hits, 1);
+    XCTAssertEqual(moved.length, v.length);
+    XCTAssertEqual(moved.maxKappaParameter, v.maxKappaParameter);
+
+    //a different shape misses
+    BCAlignedCubicCacheLookup(&cache, BCAlignedCubicMake(CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(20,60), bc_make_float2(80,40))));
+    XCTAssertEqual(cache.misses, 2);
+    XCTAssertEqual(cache.count, 2);
+    free(storage);
+}
+
+static void testDegenerate(void) {
+    const size_t capacity = 4;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    //c is on a, so kappa is undefined
+    const BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(0,0), bc_make_float2(80,40));
+    const BCAlignedCubicCacheValue v = BCAlignedCubicCacheLookup(&cache, BCAlignedCubicMake(cubic));
+    XCTAssertEqual(v.maxKappaParameter, BC_FLOAT_LARGE);
+    XCTAssertEqual(v.maxKappa, BC_FLOAT_LARGE);
+    XCTAssertFalse(v.isNormalizedForCurvature);
+    XCTAssertEqualWithAccuracy(v.length, BCCubicLengthWithStrategy(cubic, 0.001, BCStrategyAccurate), 0.05);
+    free(storage);
+}
+
+static void testLargeCoordinates(void) {
+    const size_t capacity = 4;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    //b_x is past quantum*2^24, so the shape can't be keyed
+    const BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(1e6,0), bc_make_float2(2e5,4e5), bc_make_float2(8e5,4e5));
+    const BCAlignedCubic aligned = BCAlignedCubicMake(cubic);
+    const BCAlignedCubicCacheValue v = BCAlignedCubicCacheLookup(&cache, aligned);
+    BCAlignedCubicCacheLookup(&cache, aligned);
+    XCTAssertEqual(cache.misses, 2);
+    XCTAssertEqual(cache.hits, 0);
+    XCTAssertEqual(cache.count, 0);
+    XCTAssertEqualWithAccuracy(v.length, BCCubicLengthWithStrategy(cubic, 0.01, BCStrategyAccurate), 1);
+    free(storage);
+}
+
+static void testEviction(void) {
+    const size_t capacity = 3;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    BCAlignedCubic shapes[4];
+    for (int i = 0; i < 4; i++) {
+        shapes[i] = BCAlignedCubicMake(CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(20,10 + 10 * i), bc_make_float2(80,40)));
+    }
+    BCAlignedCubicCacheLookup(&cache, shapes[0]);
+    BCAlignedCubicCacheLookup(&cache, shapes[1]);
+    BCAlignedCubicCacheLookup(&cache, shapes[2]);
+    //0 becomes most recently used, so 1 is evicted
+    BCAlignedCubicCacheLookup(&cache, shapes[0]);
+    BCAlignedCubicCacheLookup(&cache, shapes[3]);
+    XCTAssertEqual(cache.count, 3);
+    XCTAssertEqual(cache.misses, 4);
+    BCAlignedCubicCacheLookup(&cache, shapes[0]);
+    BCAlignedCubicCacheLookup(&cache, shapes[2]);
+    BCAlignedCubicCacheLookup(&cache, shapes[3]);
+    XCTAssertEqual(cache.misses, 4);
+    BCAlignedCubicCacheLookup(&cache, shapes[1]);
+    XCTAssertEqual(cache.misses, 5);
+
+    //churning many shapes through a small cache stays consistent
+    for (int i = 0; i < 1000; i++) {
+        const BCAlignedCubic a = BCAlignedCubicMake(BCTestRandomCubic(bc_make_float2(0, 0), 100));
+        const BCAlignedCubicCacheValue v = BCAlignedCubicCacheLookup(&cache, a);
+        const BCAlignedCubicCacheValue again = BCAlignedCubicCacheLookup(&cache, a);
+        XCTAssertEqual(v.length, again.length);
+    }
+    XCTAssertEqual(cache.count, 3);
+    XCTAssertEqual(cache.hits + cache.misses, 2009);
+    free(storage);
+}
+
+static void testBatch(void) {
+    const size_t capacity = 8;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    BCCubic glyph[4];
+    for (int i = 0; i < 4; i++) { glyph[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100); }
+    //the glyph drawn 25 times
+    BCCubic cubics[100];
+    for (int i = 0; i < 100; i++) {
+        cubics[i] = transformCubic(glyph[i % 4], (i / 4) * 0.25, bc_make_float2(i * 3, i * 7));
+    }
+    BCAlignedCubic aligned[100];
+    BCAlignedCubicCacheValue output[100];
+    BCAlignedCubicCacheLookupBatch(&cache, cubics, 100, aligned, output);
+    for (int i = 0; i < 100; i++) {
+        const BCAlignedCubic expected = BCAlignedCubicMake(cubics[i]);
+        XCTAssertEqualFloat2(aligned[i].c, expected.c);
+        XCTAssertEqual(aligned[i].b_x, expected.b_x);
+        XCTAssertEqualWithAccuracy(output[i].length, output[i % 4].length, 0.05);
+    }
+    //transforming moves the aligned shape by rounding error, so a few may land in a neighboring cell
+    XCTAssertLessThan(cache.misses, 20);
+    free(storage);
+}
+
+static void testCacheBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const int glyphCount = 64;
+    const int cubicCount = 100000;
+    BCCubic glyph[64];
+    for (int i = 0; i < glyphCount; i++) { glyph[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100); }
+    BCCubic *cubics = malloc(sizeof(BCCubic) * cubicCount);
+    for (int i = 0; i < cubicCount; i++) {
+        cubics[i] = transformCubic(glyph[i % glyphCount], BCTestRandom(0, 6), bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000)));
+    }
+    BCAlignedCubicCacheValue *output = malloc(sizeof(BCAlignedCubicCacheValue) * cubicCount);
+    const size_t capacity = 1024;
+    void *storage = malloc(BCAlignedCubicCacheStorageSize(capacity));
+    BCAlignedCubicCache cache = BCAlignedCubicCacheMake(storage, capacity, 0.01, 0.001, 2 * M_PI / 360, 0.001);
+    double start = BCTestNow();
+    BCAlignedCubicCacheLookupBatch(&cache, cubics, cubicCount, NULL, output);
+    const double cached = BCTestNow() - start;
+    float sink = 0;
+    start = BCTestNow();
+    for (int i = 0; i < cubicCount; i++) {
+        const BCAlignedCubic a = BCAlignedCubicMake(cubics[i]);
+        sink += BCAlignedCubicMaxKappaParameter(a, 0.001) + BCCubicLengthWithStrategy(cubics[i], 0.01, BCStrategyAccurate);
+    }
+    const double direct = BCTestNow() - start;
+    printf("    aligned cubic cache: %.2f ns/cubic cached (%zu misses), %.2f ns/cubic direct (%f)\n", cached / cubicCount * 1e9, cache.misses, direct / cubicCount * 1e9, sink + output[0].length);
+    free(storage);
+    free(output);
+    free(cubics);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLookup", testLookup},
+    {"testDegenerate", testDegenerate},
+    {"testEviction", testEviction},
+    {"testLargeCoordinates", testLargeCoordinates},
+    {"testBatch", testBatch},
+    {"testCacheBench", testCacheBench},
+};
+BC_TEST_SUITE(AlignedCubicCacheTests, tests);
@@ -0,0 +1,187 @@
+//AlignedCubicTests.c: Aligned cubic tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include "BCTestSupport.h"
+
+static void testMake(void) {
+    BCCubic c = CubicMake(bc_make_float2(120,160), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    BCAlignedCubic alignedCubic = BCAlignedCubicMake(c);
+    XCTAssertEqualWithAccuracy(alignedCubic.b_x, 156, 1);
+    XCTAssertLessThan(bc_distance(alignedCubic.c, bc_make_float2(-85,-40)), 2);
+    XCTAssertLessThan(bc_distance(alignedCubic.d, bc_make_float2(-12,140)), 2);
+}
+
+static void testKappa(void) {
+    //basically a line
+    BCCubic basicallyALine = BCCubicMakeWithLine(LineMake(bc_make_float2(0,0), bc_make_float2(100,100)));
+    BCAlignedCubic alignedLine = BCAlignedCubicMake(basicallyALine);
+    XCTAssertEqualWithAccuracy(BCAlignedCubicKappa(alignedLine, 0.5), 0, 0.01);
+
+    //fromQuad
+    BCCubic fromQuad = CubicMake(bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(66.66667, 0), bc_make_float2(100,33.3333));
+    BCAlignedCubic alignedFromQuad = BCAlignedCubicMake(fromQuad);
+    XCTAssertEqualWithAccuracy(BCAlignedCubicKappa(alignedFromQuad, 0.5), 0.0147, 0.001);
+
+    BCCubic small = CubicMake(bc_make_float2(619.19244,913.3555), bc_make_float2(888.6296,1392.5944), bc_make_float2(709.89105,1074.6781), bc_make_float2(799.70337,1234.4243));
+    BCAlignedCubic alignedSmall = BCAlignedCubicMake(small);
+    XCTAssertLessThan(BCAlignedCubicKappa(alignedSmall, 0.07617), 0.00001);
+
+    BCAlignedCubic t = AlignedCubicMake(bc_make_float2(32.121765, -14.771326), bc_make_float2(26.025661, -70.33964), 106.62551);
+    XCTAssertEqualWithAccuracy(BCAlignedCubicKappa(t, 0.560689), 0.0449, 0.01);
+}
+
+static void testKappaBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    BCCubic small = CubicMake(bc_make_float2(619.19244,913.3555), bc_make_float2(888.6296,1392.5944), bc_make_float2(709.89105,1074.6781), bc_make_float2(799.70337,1234.4243));
+    BCAlignedCubic alignedSmall = BCAlignedCubicMake(small);
+    const size_t count = 10000000;
+    float *floats = malloc(sizeof(float) * count);
+    for (size_t i = 0; i < count; i++) {
+        floats[i] = BCTestRandom(0, 1);
+    }
+    union { float f; uint32_t u; } i = {0};
+    uint32_t x = 0;
+    const double start = BCTestNow();
+    for (size_t f = 0; f < count; f++) {
+        i.f = BCAlignedCubicKappa(alignedSmall, floats[f]);
+        x ^= i.u;
+    }
+    const double elapsed = BCTestNow() - start;
+    printf("    kappa: %.2f ns/call (%u)\n", elapsed / count * 1e9, x);
+    free(floats);
+#endif
+}
+
+static void testKappaPrime(void) {
+    //this test only works in debug mode
+#ifndef NDEBUG
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(1000,1000), bc_make_float2(0,250), bc_make_float2(750, 0));
+    BCAlignedCubic a = BCAlignedCubicMake(c);
+    const bc_float4_t prime = __BCAlignedCubicKappaPrime4(a, bc_make_float4(0, 0.5, 1, 0));
+    XCTAssertEqualWithAccuracy(prime.x, -0.0826, 0.1);
+    XCTAssertEqualWithAccuracy(prime.y, 0.003304, 0.01);
+    XCTAssertEqualWithAccuracy(prime.z, -0.00211, 0.01);
+    // {ax->0,ay->0,by->0,cx->32.121765,cy->-14.771326, dx->26.025661, dy-> -70.33964, bx->106.62551, t->0.56989586}
+    BCAlignedCubic a2 = AlignedCubicMake(bc_make_float2(32.121765, -14.771326), bc_make_float2(26.025661, -70.33964), 106.62551);
+    const bc_float4_t prime2 = __BCAlignedCubicKappaPrime4(a2, bc_make_float4(0.56989586, 0.56064975, 0, 1));
+    XCTAssertEqualWithAccuracy(prime2.x, -0.0296569, 0.00001);
+    XCTAssertEqualWithAccuracy(prime2.y, 0.000101445, 0.00001);
+#else
+    XCTSkip("kappaPrime is not supported in release builds");
+#endif
+}
+
+static void testMaxKappa(void) {
+    BCCubic c2 = CubicMake(bc_make_float2(0,0), bc_make_float2(37,100), bc_make_float2(25,25), bc_make_float2(75,0));
+    BCAlignedCubic a2 = BCAlignedCubicMake(c2);
+    const float libmax = BCAlignedCubicMaxKappaParameter(a2, 0.0001);
+    float t = -1;
+    float f = 0;
+    for (float i = 0; i < 1; i += 0.0001) {
+        const float a = bc_abs(BCAlignedCubicKappa(a2, i));
+        if (a > f) { f = a; t = i; }
+    }
+    XCTAssertEqualWithAccuracy(libmax, t, 0.0001);
+
+    //try a line
+    BCCubic linear = CubicMake(bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(25,25), bc_make_float2(75,75));
+    BCAlignedCubic alignedLine = BCAlignedCubicMake(linear);
+    const float kappaT = BCAlignedCubicMaxKappaParameter(alignedLine, 0.01);
+    XCTAssert(kappaT >= 0 && kappaT <= 1);
+}
+
+static BCAlignedCubic randomAlignedCubic(void) {
+    return BCAlignedCubicMake(BCTestRandomCubic(bc_make_float2(0, 0), 100));
+}
+
+static void testMaxKappaBrackets(void) {
+    for (int c = 0; c < 100; c++) {
+        BCAlignedCubic a = randomAlignedCubic();
+        const float t5 = BCAlignedCubicMaxKappaParameterWithBrackets(a, 0.0001, 5);
+        XCTAssertEqual(t5, BCAlignedCubicMaxKappaParameter(a, 0.0001));
+        XCTAssert(t5 >= 0 && t5 <= 1);
+        //the result is an extremum of kappa
+        if (t5 > 0.01 && t5 < 0.99) {
+            const float k = BCAlignedCubicKappa(a, t5);
+            const float left = BCAlignedCubicKappa(a, t5 - 0.01);
+            const float right = BCAlignedCubicKappa(a, t5 + 0.01);
+            XCTAssert((left <= k && right <= k) || (left >= k && right >= k));
+        }
+        //more brackets can only find more extrema, so the maximum does not decrease
+        const float t16 = BCAlignedCubicMaxKappaParameterWithBrackets(a, 0.0001, 16);
+        XCTAssertGreaterThan(bc_abs(BCAlignedCubicKappa(a, t16)) * 1.001, bc_abs(BCAlignedCubicKappa(a, t5)));
+    }
+}
+
+static void testMaxKappaBatch(void) {
+    //2 whole lane groups and a partial one
+    enum { count = 19 };
+    BCAlignedCubic cubics[count];
+    for (int c = 0; c < count; c++) {
+        cubics[c] = randomAlignedCubic();
+    }
+    bc_float_t output[count];
+    //brackets wider than the accuracy, and brackets already within it
+    const uint8_t brackets[3] = {8, 5, 1};
+    const bc_float_t accuracies[3] = {0.001, 0.0001, 0.3};
+    for (int b = 0; b < 3; b++) {
+        for (int a = 0; a < 3; a++) {
+            BCAlignedCubicMaxKappaParameterBatch(cubics, count, accuracies[a], brackets[b], output);
+            for (int c = 0; c < count; c++) {
+                XCTAssertEqual(output[c], BCAlignedCubicMaxKappaParameterWithBrackets(cubics[c], accuracies[a], brackets[b]));
+            }
+        }
+    }
+}
+
+static void testMaxKappaBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    enum { count = 1000 };
+    BCAlignedCubic cubics[count];
+    for (int c = 0; c < count; c++) {
+        cubics[c] = randomAlignedCubic();
+    }
+    const int iterations = 100;
+    float r = 0;
+    const double start = BCTestNow();
+    for (int i = 0; i < iterations; i++) {
+        for (int c = 0; c < count; c++) {
+            r += BCAlignedCubicMaxKappaParameter(cubics[c], 0.0001);
+        }
+    }
+    const double elapsed = BCTestNow() - start;
+    printf("    maxKappaParameter: %.2f ns/call (%f)\n", elapsed / (iterations * count) * 1e9, r);
+    bc_float_t output[count];
+    double batchStart = BCTestNow();
+    for (int i = 0; i < iterations; i++) {
+        BCAlignedCubicMaxKappaParameterBatch(cubics, count, 0.0001, 8, output);
+        r += output[i];
+    }
+    const double batchElapsed = BCTestNow() - batchStart;
+    const double singleStart = BCTestNow();
+    for (int i = 0; i < iterations; i++) {
+        for (int c = 0; c < count; c++) {
+            r += BCAlignedCubicMaxKappaParameterWithBrackets(cubics[c], 0.0001, 8);
+        }
+    }
+    const double singleElapsed = BCTestNow() - singleStart;
+    printf("    maxKappaParameter, 8 brackets: %.2f ns/call, %.2f ns/cubic batch (%f)\n", singleElapsed / (iterations * count) * 1e9, batchElapsed / (iterations * count) * 1e9, r);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testMake", testMake},
+    {"testKappa", testKappa},
+    {"testKappaBench", testKappaBench},
+    {"testKappaPrime", testKappaPrime},
+    {"testMaxKappa", testMaxKappa},
+    {"testMaxKappaBrackets", testMaxKappaBrackets},
+    {"testMaxKappaBatch", testMaxKappaBatch},
+    {"testMaxKappaBench", testMaxKappaBench},
+};
+BC_TEST_SUITE(AlignedCubicTests, tests);
@@ -0,0 +1,156 @@
+// AlignedRectSweepTests.c: BCAlignedRectSweep tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static BCAlignedRect randomRect(float world, float size) {
+    const bc_float2_t min = bc_make_float2(BCTestRandom(0, world), BCTestRandom(0, world));
+    return AlignedRectMake(min, min + bc_make_float2(BCTestRandom(0, size), BCTestRandom(0, size)));
+}
+
+static bool overlaps(BCAlignedRect a, BCAlignedRect b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+static int comparePairs(const void *l, const void *r) {
+    const BCRectPair *a = l;
+    const BCRectPair *b = r;
+    if (a->a != b->a) { return a->a < b->a ? -1 : 1; }
+    if (a->b != b->b) { return a->b < b->b ? -1 : 1; }
+    return 0;
+}
+
+//checks the sweep's pairs against every pair of rects
+static void checkPairs(const BCAlignedRectSweep *sweep, const BCAlignedRect *rects, size_t count, unsigned threads) {
+    size_t capacity = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) { capacity += overlaps(rects[i], rects[j]); }
+    }
+    BCRectPair *expected = malloc(sizeof(BCRectPair) * (capacity + 1));
+    BCRectPair *pairs = malloc(sizeof(BCRectPair) * (capacity + 1));
+    size_t expectedCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = i + 1; j < count; j++) {
+            if (overlaps(rects[i], rects[j])) {
+                expected[expectedCount].a = i;
+                expected[expectedCount].b = j;
+                expectedCount++;
+            }
+        }
+    }
+    const size_t found = BCAlignedRectSweepOverlappingPairs(sweep, threads, pairs, capacity);
+    XCTAssertEqual(found, expectedCount);
+    if (found == expectedCount) {
+        qsort(pairs, found, sizeof(BCRectPair), comparePairs);
+        for (size_t i = 0; i < found; i++) {
+            XCTAssertEqual(pairs[i].a, expected[i].a);
+            XCTAssertEqual(pairs[i].b, expected[i].b);
+        }
+    }
+    free(pairs);
+    free(expected);
+}
+
+static void testPairs(void) {
+    const size_t count = 1500;
+    BCAlignedRect rects[1500];
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(1000, i % 50 == 0 ? 400 : 30); }
+    void *storage = malloc(BCAlignedRectSweepStorageSize(count));
+    BCAlignedRectSweep sweep = BCAlignedRectSweepMake(storage, rects, count);
+    XCTAssertEqual(sweep.count, count);
+    checkPairs(&sweep, rects, count, 1);
+    checkPairs(&sweep, rects, count, 4);
+    XCTAssertGreaterThan(BCAlignedRectSweepOverlappingPairs(&sweep, 0, NULL, 0), 0);
+    free(storage);
+
+    //rects sharing min.x, and fewer rects than a SIMD group
+    BCAlignedRect column[5];
+    for (int i = 0; i < 5; i++) { column[i] = AlignedRectMake(bc_make_float2(0, i * 10), bc_make_float2(1, i * 10 + 10)); }
+    storage = malloc(BCAlignedRectSweepStorageSize(5));
+    sweep = BCAlignedRectSweepMake(storage, column, 5);
+    //touching rects overlap
+    XCTAssertEqual(BCAlignedRectSweepOverlappingPairs(&sweep, 1, NULL, 0), 4);
+    checkPairs(&sweep, column, 5, 1);
+    free(storage);
+}
+
+static void testUpdate(void) {
+    const size_t count = 1000;
+    BCAlignedRect rects[1000];
+    bc_float2_t velocity[1000];
+    for (size_t i = 0; i < count; i++) {
+        rects[i] = randomRect(500, 10);
+        velocity[i] = bc_make_float2(BCTestRandom(-1, 1), BCTestRandom(-1, 1));
+    }
+    void *storage = malloc(BCAlignedRectSweepStorageSize(count));
+    BCAlignedRectSweep sweep = BCAlignedRectSweepMake(storage, rects, count);
+    XCTAssertEqual(BCAlignedRectSweepUpdate(&sweep, rects), 0);
+    size_t moved = 0;
+    for (int frame = 0; frame < 20; frame++) {
+        for (size_t i = 0; i < count; i++) {
+            rects[i].min += velocity[i];
+            rects[i].max += velocity[i];
+        }
+        moved += BCAlignedRectSweepUpdate(&sweep, rects);
+        checkPairs(&sweep, rects, count, frame % 3);
+    }
+    XCTAssertGreaterThan(moved, 0);
+    //coherent motion moves rects a few positions each
+    XCTAssertLessThan(moved, count * 20 * 10);
+    //an incoherent update still sorts correctly
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(500, 10); }
+    BCAlignedRectSweepUpdate(&sweep, rects);
+    checkPairs(&sweep, rects, count, 2);
+    free(storage);
+}
+
+static void testSweepBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    //traffic: lanes of cars moving mostly along x
+    const size_t count = 200000;
+    BCAlignedRect *rects = malloc(sizeof(BCAlignedRect) * count);
+    float *speed = malloc(sizeof(float) * count);
+    for (size_t i = 0; i < count; i++) {
+        const float lane = (float) (i % 2000) * 6;
+        const bc_float2_t min = bc_make_float2(BCTestRandom(0, 50000), lane);
+        rects[i] = AlignedRectMake(min, min + bc_make_float2(4.5, 2));
+        speed[i] = BCTestRandom(0.5, 1.5);
+    }
+    void *storage = malloc(BCAlignedRectSweepStorageSize(count));
+    double start = BCTestNow();
+    BCAlignedRectSweep sweep = BCAlignedRectSweepMake(storage, rects, count);
+    const double makeTime = BCTestNow() - start;
+    const int frames = 20;
+    size_t moved = 0;
+    size_t pairCount = 0;
+    double updateTime = 0;
+    double pairTime = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        for (size_t i = 0; i < count; i++) {
+            rects[i].min.x += speed[i];
+            rects[i].max.x += speed[i];
+        }
+        start = BCTestNow();
+        moved += BCAlignedRectSweepUpdate(&sweep, rects);
+        updateTime += BCTestNow() - start;
+        start = BCTestNow();
+        pairCount += BCAlignedRectSweepOverlappingPairs(&sweep, 0, NULL, 0);
+        pairTime += BCTestNow() - start;
+    }
+    printf("    aligned rect sweep: %zu rects, make %.2f ms, update %.2f ms/frame (%.2f moves/rect), pairs %.2f ms/frame (%zu)\n", count, makeTime * 1e3, updateTime / frames * 1e3, (double) moved / (count * frames), pairTime / frames * 1e3, pairCount / frames);
+    free(storage);
+    free(speed);
+    free(rects);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testPairs", testPairs},
+    {"testUpdate", testUpdate},
+    {"testSweepBench", testSweepBench},
+};
+BC_TEST_SUITE(AlignedRectSweepTests, tests);
@@ -0,0 +1,90 @@
+// AlignedRectTests.c: AlignedRect tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <math.h>
+#include "BCTestSupport.h"
+
+static void testApartCorners(void) {
+    BCAlignedRect a = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(0,0));
+    BCAlignedRect b = AlignedRectMake(bc_make_float2(1,1), bc_make_float2(1,1));
+    XCTAssert(!BCAlignedRectsCornerWithinDistance(a, b, 0.5));
+    XCTAssert(BCAlignedRectsCornerWithinDistance(a, b, sqrtf(2)+0.01));
+}
+
+static void testFarCorners(void) {
+    BCAlignedRect a = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(0,0));
+    BCAlignedRect b = AlignedRectMake(bc_make_float2(1,1), bc_make_float2(1,1));
+    XCTAssert(!BCAlignedRectsCornerWithinDistance(a, b, 0.5));
+    XCTAssert(BCAlignedRectsCornerWithinDistance(a, b, sqrtf(2)+0.01));
+}
+
+static void testCenterPoint(void) {
+    BCAlignedRect a = AlignedRectMake(bc_make_float2(1,1), bc_make_float2(2,2));
+    XCTAssertEqualFloat2(BCAlignedRectCenterPoint(a), bc_make_float2(1.5,1.5));
+}
+
+static void testIsPointOnOrInside(void) {
+    BCAlignedRect a = AlignedRectMake(bc_make_float2(1,1), bc_make_float2(2,2));
+    XCTAssert(BCAlignedRectIsPointOnOrInside(a, bc_make_float2(1.5,1.5)));
+    XCTAssert(BCAlignedRectIsPointOnOrInside(a, a.min));
+    XCTAssert(BCAlignedRectIsPointOnOrInside(a, a.max));
+    XCTAssert(!BCAlignedRectIsPointOnOrInside(a, bc_make_float2(2.01,2)));
+    XCTAssert(!BCAlignedRectIsPointOnOrInside(a, bc_make_float2(2,2.01)));
+    XCTAssert(!BCAlignedRectIsPointOnOrInside(a, bc_make_float2(0.99,0.99)));
+    XCTAssert(!BCAlignedRectIsPointOnOrInside(a, bc_make_float2(0.99,1.5)));
+}
+
+static void testCreateFromCubicAccurate(void) {
+    {
+        const BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(1,0), bc_make_float2(0,1), bc_make_float2(1,1));
+        const BCAlignedRect r = BCAlignedRectCreateFromCubic(c, BCStrategyAccurate);
+        XCTAssertEqualFloat2WithAccuracy(r.min, bc_make_float2(0,0), 1e-6);
+        XCTAssertEqualFloat2WithAccuracy(r.max, bc_make_float2(1,0.75), 1e-6);
+        //the control points are well outside the curve
+        XCTAssertEqualFloat2(BCAlignedRectCreateFromCubic(c, BCStrategyFastest).max, bc_make_float2(1,1));
+    }
+    {
+        //y is a degree-elevated quadratic, so its derivative is linear
+        const BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(3,0), bc_make_float2(1,2), bc_make_float2(2,2));
+        const BCAlignedRect r = BCAlignedRectCreateFromCubic(c, BCStrategyAccurate);
+        XCTAssertEqualFloat2WithAccuracy(r.max, bc_make_float2(3,1.5), 1e-6);
+    }
+    {
+        //a point
+        const BCCubic c = CubicMake(bc_make_float2(2,2), bc_make_float2(2,2), bc_make_float2(2,2), bc_make_float2(2,2));
+        const BCAlignedRect r = BCAlignedRectCreateFromCubic(c, BCStrategyAccurate);
+        XCTAssertEqualFloat2(r.min, bc_make_float2(2,2));
+        XCTAssertEqualFloat2(r.max, bc_make_float2(2,2));
+    }
+    for (int i = 0; i < 1000; i++) {
+        const BCCubic c = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        const BCAlignedRect r = BCAlignedRectCreateFromCubic(c, BCStrategyAccurate);
+        const BCAlignedRect fast = BCAlignedRectCreateFromCubic(c, BCStrategyFastest);
+        bc_float2_t sampledMin = c.a;
+        bc_float2_t sampledMax = c.a;
+        for (int s = 0; s <= 1000; s++) {
+            const bc_float2_t p = BCCubicEvaluate(c, s / 1000.0f);
+            sampledMin = bc_make_float2(fminf(sampledMin.x, p.x), fminf(sampledMin.y, p.y));
+            sampledMax = bc_make_float2(fmaxf(sampledMax.x, p.x), fmaxf(sampledMax.y, p.y));
+        }
+        //the box contains the curve, and is no larger than the samples show
+        XCTAssertEqualFloat2WithAccuracy(r.min, sampledMin, 1e-3);
+        XCTAssertEqualFloat2WithAccuracy(r.max, sampledMax, 1e-3);
+        XCTAssertLessThanOrEqual(r.min.x, sampledMin.x + 1e-4);
+        XCTAssertLessThanOrEqual(r.min.y, sampledMin.y + 1e-4);
+        XCTAssertLessThanOrEqual(sampledMax.x, r.max.x + 1e-4);
+        XCTAssertLessThanOrEqual(sampledMax.y, r.max.y + 1e-4);
+        //and inside the control point box
+        XCTAssertLessThanOrEqual(fast.min.x, r.min.x);
+        XCTAssertLessThanOrEqual(r.max.y, fast.max.y);
+    }
+}
+
+static const BCTestCase tests[] = {
+    {"testApartCorners", testApartCorners},
+    {"testFarCorners", testFarCorners},
+    {"testCenterPoint", testCenterPoint},
+    {"testIsPointOnOrInside", testIsPointOnOrInside},
+    {"testCreateFromCubicAccurate", testCreateFromCubicAccurate},
+};
+BC_TEST_SUITE(AlignedRectTests, tests);
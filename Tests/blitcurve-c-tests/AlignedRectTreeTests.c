@@ -0,0 +1,204 @@
+// AlignedRectTreeTests.c: BCAlignedRectTree tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static BCCubic moveCubic(BCCubic c, bc_float2_t offset) {
+    return CubicMake(c.a + offset, c.b + offset, c.c + offset, c.d + offset);
+}
+
+static bool overlaps(BCAlignedRect a, BCAlignedRect b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+static int compareData(const void *l, const void *r) {
+    const uint32_t a = *(const uint32_t *) l;
+    const uint32_t b = *(const uint32_t *) r;
+    return a < b ? -1 : a > b;
+}
+
+//checks a region query against every live leaf's fat rect
+static void checkQuery(const BCAlignedRectTree *tree, const uint32_t *leaves, const bool *live, size_t count, BCAlignedRect region) {
+    uint32_t *output = malloc(sizeof(uint32_t) * count);
+    const size_t found = BCAlignedRectTreeQuery(tree, region, output, count);
+    size_t expected = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (live[i] && overlaps(BCAlignedRectTreeFatRect(tree, leaves[i]), region)) { expected++; }
+    }
+    XCTAssertEqual(found, expected);
+    qsort(output, found < count ? found : count, sizeof(uint32_t), compareData);
+    for (size_t i = 0; i + 1 < found && i + 1 < count; i++) {
+        XCTAssertLessThan(output[i], output[i + 1]);
+    }
+    for (size_t i = 0; i < found && i < count; i++) {
+        XCTAssert(live[output[i]]);
+        XCTAssert(overlaps(BCAlignedRectTreeFatRect(tree, leaves[output[i]]), region));
+    }
+    free(output);
+}
+
+static void testInsertQueryRemove(void) {
+    const size_t count = 1000;
+    //room for one extra
+    void *storage = malloc(BCAlignedRectTreeStorageSize(count + 1));
+    BCAlignedRectTree tree = BCAlignedRectTreeMake(storage, count + 1, 1);
+    uint32_t leaves[1000];
+    bool live[1000];
+    for (uint32_t i = 0; i < count; i++) {
+        leaves[i] = BCAlignedRectTreeInsertCubic(&tree, BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000)), 20), i);
+        live[i] = true;
+    }
+    XCTAssertEqual(tree.leafCount, count);
+    XCTAssert(__BCAlignedRectTreeIsValid(&tree));
+    //balanced, so about log2(1000) = 10
+    XCTAssertLessThan(__BCAlignedRectTreeHeight(&tree), 20);
+    for (int q = 0; q < 50; q++) {
+        const bc_float2_t min = bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000));
+        checkQuery(&tree, leaves, live, count, AlignedRectMake(min, min + BCTestRandom(0, 200)));
+    }
+    //the fat rect contains the cubic's bounds, grown by the margin
+    const BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(10,0), bc_make_float2(2,5), bc_make_float2(8,-5));
+    const uint32_t extra = BCAlignedRectTreeInsertCubic(&tree, c, 5000);
+    const BCAlignedRect fat = BCAlignedRectTreeFatRect(&tree, extra);
+    XCTAssertEqualFloat2(fat.min, bc_make_float2(-1, -6));
+    XCTAssertEqualFloat2(fat.max, bc_make_float2(11, 6));
+    BCAlignedRectTreeRemove(&tree, extra);
+
+    for (uint32_t i = 0; i < count; i += 2) {
+        BCAlignedRectTreeRemove(&tree, leaves[i]);
+        live[i] = false;
+    }
+    XCTAssertEqual(tree.leafCount, count / 2);
+    XCTAssert(__BCAlignedRectTreeIsValid(&tree));
+    XCTAssertLessThan(__BCAlignedRectTreeHeight(&tree), 20);
+    for (int q = 0; q < 50; q++) {
+        const bc_float2_t min = bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000));
+        checkQuery(&tree, leaves, live, count, AlignedRectMake(min, min + BCTestRandom(0, 200)));
+    }
+    for (uint32_t i = 1; i < count; i += 2) { BCAlignedRectTreeRemove(&tree, leaves[i]); }
+    XCTAssertEqual(tree.leafCount, 0);
+    XCTAssert(__BCAlignedRectTreeIsValid(&tree));
+    XCTAssertEqual(BCAlignedRectTreeQuery(&tree, AlignedRectMake(bc_make_float2(0,0), bc_make_float2(1000,1000)), NULL, 0), 0);
+    //storage is reused after removing
+    for (uint32_t i = 0; i < count; i++) {
+        leaves[i] = BCAlignedRectTreeInsertCubic(&tree, BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000)), 20), i);
+    }
+    XCTAssertEqual(tree.leafCount, count);
+    XCTAssert(__BCAlignedRectTreeIsValid(&tree));
+    free(storage);
+}
+
+static void testUpdate(void) {
+    const size_t count = 500;
+    void *storage = malloc(BCAlignedRectTreeStorageSize(count));
+    BCAlignedRectTree tree = BCAlignedRectTreeMake(storage, count, 2);
+    BCCubic cubics[500];
+    uint32_t leaves[500];
+    bool live[500];
+    for (uint32_t i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 500), BCTestRandom(0, 500)), 10);
+        leaves[i] = BCAlignedRectTreeInsertCubic(&tree, cubics[i], i);
+        live[i] = true;
+    }
+    //a move within the margin doesn't restructure
+    XCTAssertFalse(BCAlignedRectTreeUpdate(&tree, leaves[0], BCAlignedRectCreateFromCubic(moveCubic(cubics[0], bc_make_float2(1, -1)), BCStrategyFastest)));
+    XCTAssert(BCAlignedRectTreeUpdate(&tree, leaves[0], BCAlignedRectCreateFromCubic(moveCubic(cubics[0], bc_make_float2(3, 0)), BCStrategyFastest)));
+    cubics[0] = moveCubic(cubics[0], bc_make_float2(3, 0));
+    size_t moved = 0;
+    for (int tick = 0; tick < 50; tick++) {
+        for (size_t i = 0; i < count; i++) {
+            cubics[i] = moveCubic(cubics[i], bc_make_float2(BCTestRandom(-0.5, 0.5), BCTestRandom(-0.5, 0.5)));
+        }
+        moved += BCAlignedRectTreeUpdateCubics(&tree, leaves, cubics, count);
+        //every cubic is within its fat rect
+        for (size_t i = 0; i < count; i++) {
+            const BCAlignedRect tight = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest);
+            const BCAlignedRect fat = BCAlignedRectTreeFatRect(&tree, leaves[i]);
+            XCTAssert(fat.min.x <= tight.min.x && fat.min.y <= tight.min.y && tight.max.x <= fat.max.x && tight.max.y <= fat.max.y);
+        }
+    }
+    //small steps rarely leave a margin of 2
+    XCTAssertGreaterThan(moved, 0);
+    XCTAssertLessThan(moved, count * 50 / 4);
+    XCTAssert(__BCAlignedRectTreeIsValid(&tree));
+    for (int q = 0; q < 20; q++) {
+        const bc_float2_t min = bc_make_float2(BCTestRandom(0, 500), BCTestRandom(0, 500));
+        checkQuery(&tree, leaves, live, count, AlignedRectMake(min, min + BCTestRandom(0, 100)));
+    }
+    free(storage);
+}
+
+static void testOverlappingPairs(void) {
+    const size_t count = 800;
+    void *storage = malloc(BCAlignedRectTreeStorageSize(count));
+    BCAlignedRectTree tree = BCAlignedRectTreeMake(storage, count, 0.5);
+    uint32_t leaves[800];
+    for (uint32_t i = 0; i < count; i++) {
+        leaves[i] = BCAlignedRectTreeInsertCubic(&tree, BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 800), BCTestRandom(0, 800)), 25), i);
+    }
+    size_t expected = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            expected += overlaps(BCAlignedRectTreeFatRect(&tree, leaves[i]), BCAlignedRectTreeFatRect(&tree, leaves[j]));
+        }
+    }
+    XCTAssertGreaterThan(expected, 0);
+    BCAlignedRectTreePair *pairs = malloc(sizeof(BCAlignedRectTreePair) * expected);
+    const unsigned threads[] = {1, 3};
+    for (int t = 0; t < 2; t++) {
+        const size_t found = BCAlignedRectTreeOverlappingPairs(&tree, threads[t], pairs, expected);
+        XCTAssertEqual(found, expected);
+        for (size_t p = 0; p < found && p < expected; p++) {
+            XCTAssertNotEqual(pairs[p].a, pairs[p].b);
+            XCTAssert(overlaps(BCAlignedRectTreeFatRect(&tree, leaves[pairs[p].a]), BCAlignedRectTreeFatRect(&tree, leaves[pairs[p].b])));
+        }
+    }
+    XCTAssertEqual(BCAlignedRectTreeOverlappingPairs(&tree, 0, NULL, 0), expected);
+    free(pairs);
+    free(storage);
+}
+
+static void testTreeBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const size_t count = 1000000;
+    void *storage = malloc(BCAlignedRectTreeStorageSize(count));
+    BCAlignedRectTree tree = BCAlignedRectTreeMake(storage, count, 1);
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    uint32_t *leaves = malloc(sizeof(uint32_t) * count);
+    double start = BCTestNow();
+    for (uint32_t i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 20000), BCTestRandom(0, 20000)), 10);
+        leaves[i] = BCAlignedRectTreeInsertCubic(&tree, cubics[i], i);
+    }
+    const double insertTime = BCTestNow() - start;
+    const int ticks = 10;
+    size_t moved = 0;
+    start = BCTestNow();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (size_t i = 0; i < count; i++) {
+            cubics[i] = moveCubic(cubics[i], bc_make_float2(0.2f, ((i & 1) ? 0.1f : -0.1f)));
+        }
+        moved += BCAlignedRectTreeUpdateCubics(&tree, leaves, cubics, count);
+    }
+    const double updateTime = (BCTestNow() - start) / ticks;
+    start = BCTestNow();
+    const size_t pairCount = BCAlignedRectTreeOverlappingPairs(&tree, 0, NULL, 0);
+    const double pairTime = BCTestNow() - start;
+    printf("    aligned rect tree: %zu cubics, insert %.2f ms, update %.2f ms/tick (%.1f%% reinserted), pairs %.2f ms (%zu), height %d\n", count, insertTime * 1e3, updateTime * 1e3, 100.0 * moved / (count * ticks), pairTime * 1e3, pairCount, __BCAlignedRectTreeHeight(&tree));
+    free(leaves);
+    free(cubics);
+    free(storage);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testInsertQueryRemove", testInsertQueryRemove},
+    {"testUpdate", testUpdate},
+    {"testOverlappingPairs", testOverlappingPairs},
+    {"testTreeBench", testTreeBench},
+};
+BC_TEST_SUITE(AlignedRectTreeTests, tests);
@@ -0,0 +1,113 @@
+// ArclengthParameterizationTests.c: BCCubicArclengthParameterizationWithStrategy tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include "BCTestSupport.h"
+
+//reference arclength from a fine polyline
+static float polylineLength(BCCubic cubic, float t) {
+    const int segments = 2000;
+    float length = 0;
+    bc_float2_t previous = cubic.a;
+    for (int i = 1; i <= segments; i++) {
+        const bc_float2_t next = BCCubicEvaluate(cubic, t * i / segments);
+        length += bc_distance(previous, next);
+        previous = next;
+    }
+    return length;
+}
+
+static void testLine(void) {
+    //same cubic as CubicTests.testParametrization
+    BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(66.6667,0), bc_make_float2(100,0));
+    XCTAssertEqualWithAccuracy(BCCubicArclengthParameterizationWithStrategy(cubic, 50, 0.01, BCStrategyAccurate), 0.289, 0.01);
+    XCTAssertEqual(BCCubicArclengthParameterizationWithStrategy(cubic, 50, 0.01, BCStrategyFastest), BCCubicArclengthParameterization(cubic, 50, 0.01));
+    XCTAssertEqual(BCCubicArclengthParameterizationWithStrategy(cubic, 0, 0.01, BCStrategyAccurate), 0);
+    XCTAssertEqual(BCCubicArclengthParameterizationWithStrategy(cubic, 100.5, 0.01, BCStrategyAccurate), 1);
+}
+
+static void testAccuracy(void) {
+    for (int c = 0; c < 50; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        const float length = polylineLength(cubic, 1);
+        for (int i = 0; i < 10; i++) {
+            const float arclength = BCTestRandom(0, 0.99) * length;
+            const float t = BCCubicArclengthParameterizationWithStrategy(cubic, arclength, 0.01, BCStrategyAccurate);
+            //threshold, plus some error for the polyline and quadrature
+            XCTAssertEqualWithAccuracy(polylineLength(cubic, t), arclength, 0.01 + length * 0.001);
+        }
+    }
+}
+
+static void testCusp(void) {
+    //the speed is 0 at t=0.5, so Newton steps near there fall back to bisection
+    BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(-100,100));
+    const float length = polylineLength(cubic, 1);
+    for (int i = 1; i < 20; i++) {
+        const float arclength = length * i / 20;
+        const float t = BCCubicArclengthParameterizationWithStrategy(cubic, arclength, 0.01, BCStrategyAccurate);
+        XCTAssertEqualWithAccuracy(polylineLength(cubic, t), arclength, 0.01 + length * 0.001);
+    }
+}
+
+static void testIterations(void) {
+    int newton = 0;
+    int bisection = 0;
+    for (int c = 0; c < 100; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        const float length = BCCubicLength(cubic);
+        for (int i = 0; i < 10; i++) {
+            const float arclength = BCTestRandom(0, 0.99) * length;
+            newton += __BCCubicArclengthParameterizationNewton(cubic, arclength, 0.01).iterations;
+            bisection += __BCCubicArclengthParameterizationBisection(cubic, arclength, 0, 1, 0.01).iterations;
+        }
+    }
+    XCTAssertLessThan(newton, bisection);
+}
+
+static void testParameterizationBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    enum { cubicCount = 100, count = 1000 };
+    BCCubic cubics[cubicCount];
+    for (int c = 0; c < cubicCount; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    float r = 0;
+    long iterations = 0;
+    double start = BCTestNow();
+    for (int c = 0; c < cubicCount; c++) {
+        const float length = BCCubicLength(cubics[c]);
+        for (int i = 0; i < count; i++) {
+            __BCArclengthParameterizationResult result = __BCCubicArclengthParameterizationBisection(cubics[c], length * i / count, 0, 1, 0.01);
+            r += result.t;
+            iterations += result.iterations;
+        }
+    }
+    const double bisection = BCTestNow() - start;
+    const double bisectionIterations = (double) iterations / (cubicCount * count);
+    iterations = 0;
+    start = BCTestNow();
+    for (int c = 0; c < cubicCount; c++) {
+        const float length = BCCubicLength(cubics[c]);
+        for (int i = 0; i < count; i++) {
+            __BCArclengthParameterizationResult result = __BCCubicArclengthParameterizationNewton(cubics[c], length * i / count, 0.01);
+            r += result.t;
+            iterations += result.iterations;
+        }
+    }
+    const double newton = BCTestNow() - start;
+    const double newtonIterations = (double) iterations / (cubicCount * count);
+    printf("    parameterization: bisection %.2f iterations %.2f ns/query, newton %.2f iterations %.2f ns/query (%f)\n", bisectionIterations, bisection / (cubicCount * count) * 1e9, newtonIterations, newton / (cubicCount * count) * 1e9, r);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testAccuracy", testAccuracy},
+    {"testCusp", testCusp},
+    {"testIterations", testIterations},
+    {"testParameterizationBench", testParameterizationBench},
+};
+BC_TEST_SUITE(ArclengthParameterizationTests, tests);
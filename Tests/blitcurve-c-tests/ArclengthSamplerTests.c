@@ -0,0 +1,209 @@
+// ArclengthSamplerTests.c: BCArclengthSampler and BCDasher tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+//a straight cubic of length 100 along x, with nonuniform speed
+static BCCubic line(float x) {
+    return CubicMake(bc_make_float2(x,0), bc_make_float2(x+100,0), bc_make_float2(x+66.6667,0), bc_make_float2(x+100,0));
+}
+
+//reference arclength from a fine polyline in double precision
+static double polylineLength(BCCubic cubic, double t) {
+    const int segments = 4000;
+    double length = 0;
+    double px = cubic.a.x, py = cubic.a.y;
+    for (int i = 1; i <= segments; i++) {
+        const double s = t * i / segments;
+        const double u = 1 - s;
+        const double x = u*u*u*cubic.a.x + 3*u*u*s*cubic.c.x + 3*u*s*s*cubic.d.x + s*s*s*cubic.b.x;
+        const double y = u*u*u*cubic.a.y + 3*u*u*s*cubic.c.y + 3*u*s*s*cubic.d.y + s*s*s*cubic.b.y;
+        length += sqrt((x-px)*(x-px) + (y-py)*(y-py));
+        px = x;
+        py = y;
+    }
+    return length;
+}
+
+static void testSampleLine(void) {
+    BCArclengthSampler sampler = BCArclengthSamplerMake(10, 0);
+    BCArclengthSample samples[16];
+    XCTAssertEqual(BCArclengthSamplerSampleCubic(&sampler, line(0), samples, 16), 10);
+    for (int i = 0; i < 10; i++) {
+        XCTAssertEqualFloat2WithAccuracy(samples[i].position, bc_make_float2(i * 10, 0), 0.01);
+        XCTAssertEqualFloat2WithAccuracy(samples[i].tangent, bc_make_float2(1, 0), 0.001);
+    }
+    //the sample at 100 is carried to the next cubic
+    XCTAssertEqualWithAccuracy(sampler.distance, 0, 0.01);
+}
+
+static void testSampleCarry(void) {
+    BCArclengthSampler sampler = BCArclengthSamplerMake(30, 5);
+    BCArclengthSample samples[16];
+    XCTAssertEqual(BCArclengthSamplerSampleCubic(&sampler, line(0), samples, 16), 4);
+    XCTAssertEqualFloat2WithAccuracy(samples[3].position, bc_make_float2(95, 0), 0.01);
+    XCTAssertEqual(BCArclengthSamplerSampleCubic(&sampler, line(100), samples, 16), 3);
+    XCTAssertEqualFloat2WithAccuracy(samples[0].position, bc_make_float2(125, 0), 0.01);
+    XCTAssertEqualFloat2WithAccuracy(samples[2].position, bc_make_float2(185, 0), 0.01);
+}
+
+static void testSampleAccuracy(void) {
+    BCArclengthSample samples[256];
+    for (int c = 0; c < 20; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        BCArclengthSampler sampler = BCArclengthSamplerMake(1, 0.5);
+        const size_t count = BCArclengthSamplerSampleCubic(&sampler, cubic, samples, 256);
+        const double length = polylineLength(cubic, 1);
+        //unless the length is within rounding of a sample
+        XCTAssertEqualWithAccuracy(count, (size_t) (length - 0.5) + 1, 1);
+        for (size_t i = 0; i < count && i < 256; i++) {
+            XCTAssertEqualWithAccuracy(polylineLength(cubic, samples[i].t), 0.5 + i, 0.01);
+            XCTAssertEqualFloat2(samples[i].position, BCCubicEvaluate(cubic, samples[i].t));
+        }
+    }
+}
+
+static void testSampleCapacity(void) {
+    BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    BCArclengthSample samples[64];
+    BCArclengthSampler full = BCArclengthSamplerMake(3, 0);
+    const size_t count = BCArclengthSamplerSampleCubic(&full, cubic, samples, 64);
+    BCArclengthSample partial[4];
+    BCArclengthSampler limited = BCArclengthSamplerMake(3, 0);
+    XCTAssertEqual(BCArclengthSamplerSampleCubic(&limited, cubic, partial, 4), count);
+    XCTAssertEqual(limited.distance, full.distance);
+    for (int i = 0; i < 4; i++) {
+        XCTAssertEqual(partial[i].t, samples[i].t);
+    }
+}
+
+static void testSampleBatch(void) {
+    BCCubic cubics[5];
+    for (int c = 0; c < 5; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    BCArclengthSample batch[256];
+    size_t indices[256];
+    BCArclengthSampler sampler = BCArclengthSamplerMake(7, 2);
+    const size_t count = BCArclengthSamplerSampleCubics(&sampler, cubics, 5, batch, indices, 256);
+    BCArclengthSampler scalar = BCArclengthSamplerMake(7, 2);
+    size_t offset = 0;
+    for (int c = 0; c < 5; c++) {
+        BCArclengthSample samples[64];
+        const size_t n = BCArclengthSamplerSampleCubic(&scalar, cubics[c], samples, 64);
+        for (size_t i = 0; i < n; i++) {
+            XCTAssertEqual(batch[offset + i].t, samples[i].t);
+            XCTAssertEqual(indices[offset + i], (size_t) c);
+        }
+        offset += n;
+    }
+    XCTAssertEqual(count, offset);
+    XCTAssertEqual(sampler.distance, scalar.distance);
+}
+
+static void testDashLine(void) {
+    const bc_float_t pattern[2] = {10, 5};
+    BCDasher dasher = BCDasherMake(pattern, 2, 0);
+    BCCubic dashes[16];
+    XCTAssertEqual(BCDasherDashCubic(&dasher, line(0), dashes, 16), 7);
+    for (int i = 0; i < 7; i++) {
+        XCTAssertEqualFloat2WithAccuracy(dashes[i].a, bc_make_float2(i * 15, 0), 0.01);
+        XCTAssertEqualFloat2WithAccuracy(dashes[i].b, bc_make_float2(bc_min(i * 15 + 10, 100), 0), 0.01);
+    }
+}
+
+static void testDashCarry(void) {
+    const bc_float_t pattern[2] = {30, 10};
+    BCCubic cubics[2] = {line(0), line(100)};
+    BCCubic dashes[16];
+    size_t indices[16];
+    BCDasher dasher = BCDasherMake(pattern, 2, 0);
+    XCTAssertEqual(BCDasherDashCubics(&dasher, cubics, 2, dashes, indices, 16), 6);
+    //the dash from 80 to 110 is split across the cubics
+    XCTAssertEqualFloat2WithAccuracy(dashes[2].a, bc_make_float2(80, 0), 0.01);
+    XCTAssertEqualFloat2(dashes[2].b, cubics[0].b);
+    XCTAssertEqual(indices[2], 0);
+    XCTAssertEqualFloat2(dashes[3].a, cubics[1].a);
+    XCTAssertEqualFloat2WithAccuracy(dashes[3].b, bc_make_float2(110, 0), 0.01);
+    XCTAssertEqual(indices[3], 1);
+    XCTAssertEqualFloat2WithAccuracy(dashes[5].a, bc_make_float2(160, 0), 0.01);
+    XCTAssertEqualFloat2WithAccuracy(dashes[5].b, bc_make_float2(190, 0), 0.01);
+}
+
+static void testDashPhase(void) {
+    const bc_float_t pattern[2] = {30, 10};
+    //starts in the gap, 5 before the next dash
+    BCDasher dasher = BCDasherMake(pattern, 2, 75);
+    XCTAssertEqual(dasher.index, 1);
+    XCTAssertEqualWithAccuracy(dasher.remaining, 5, 0.001);
+    BCCubic dashes[16];
+    XCTAssertEqual(BCDasherDashCubic(&dasher, line(0), dashes, 16), 3);
+    XCTAssertEqualFloat2WithAccuracy(dashes[0].a, bc_make_float2(5, 0), 0.01);
+}
+
+static void testDashDots(void) {
+    const bc_float_t pattern[2] = {0, 10};
+    BCDasher dasher = BCDasherMake(pattern, 2, 0);
+    BCCubic dashes[16];
+    //the dot at 100 is drawn at the start of the next cubic
+    XCTAssertEqual(BCDasherDashCubic(&dasher, line(0), dashes, 16), 10);
+    for (int i = 0; i < 10; i++) {
+        XCTAssertEqualFloat2WithAccuracy(dashes[i].a, bc_make_float2(i * 10, 0), 0.01);
+        XCTAssertEqualFloat2(dashes[i].a, dashes[i].b);
+        XCTAssertEqualFloat2(dashes[i].a, dashes[i].c);
+        XCTAssertEqualFloat2(dashes[i].a, dashes[i].d);
+    }
+    XCTAssertEqual(BCDasherDashCubic(&dasher, line(100), dashes, 16), 10);
+    XCTAssertEqualFloat2WithAccuracy(dashes[0].a, bc_make_float2(100, 0), 0.01);
+}
+
+static void testSampleBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    enum { cubicCount = 1000 };
+    BCCubic cubics[cubicCount];
+    for (int c = 0; c < cubicCount; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    const float spacing = 2;
+    float r = 0;
+    size_t count = 0;
+    double start = BCTestNow();
+    for (int c = 0; c < cubicCount; c++) {
+        const float length = BCCubicLengthWithStrategy(cubics[c], 0.01, BCStrategyAccurate);
+        for (float position = 0; position < length; position += spacing) {
+            r += BCCubicArclengthParameterizationWithStrategy(cubics[c], position, 0.01, BCStrategyAccurate);
+            count++;
+        }
+    }
+    const double repeated = BCTestNow() - start;
+    BCArclengthSample samples[256];
+    BCArclengthSampler sampler = BCArclengthSamplerMake(spacing, 0);
+    start = BCTestNow();
+    size_t sampled = 0;
+    for (int c = 0; c < cubicCount; c++) {
+        const size_t n = BCArclengthSamplerSampleCubic(&sampler, cubics[c], samples, 256);
+        r += samples[0].t;
+        sampled += n;
+    }
+    const double streaming = BCTestNow() - start;
+    printf("    sample: repeated parameterization %.2f ns/sample, sampler %.2f ns/sample (%f)\n", repeated / count * 1e9, streaming / sampled * 1e9, r);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testSampleLine", testSampleLine},
+    {"testSampleCarry", testSampleCarry},
+    {"testSampleAccuracy", testSampleAccuracy},
+    {"testSampleCapacity", testSampleCapacity},
+    {"testSampleBatch", testSampleBatch},
+    {"testDashLine", testDashLine},
+    {"testDashCarry", testDashCarry},
+    {"testDashPhase", testDashPhase},
+    {"testDashDots", testDashDots},
+    {"testSampleBench", testSampleBench},
+};
+BC_TEST_SUITE(ArclengthSamplerTests, tests);
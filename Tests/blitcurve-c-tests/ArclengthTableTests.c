@@ -0,0 +1,124 @@
+// ArclengthTableTests.c: BCArclengthTable tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include "BCTestSupport.h"
+
+static void testLine(void) {
+    //same cubic as CubicTests.testParametrization
+    BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(66.6667,0), bc_make_float2(100,0));
+    bc_float_t storage[64];
+    BCArclengthTable table = BCArclengthTableMake(cubic, storage, 64);
+    XCTAssertEqual(table.count, 64);
+    XCTAssertEqualWithAccuracy(BCArclengthTableParameterization(table, 50), 0.289, 0.01);
+    XCTAssertEqual(BCArclengthTableLength(table), BCCubicLength(cubic));
+    XCTAssertEqual(BCArclengthTableParameterization(table, 0), 0);
+    //like BCCubicArclengthParameterization, we may parameterize slightly out of range
+    XCTAssertEqual(BCArclengthTableParameterization(table, BCCubicLength(cubic) + 0.5), 1);
+    XCTAssertEqual(BCArclengthTableArclength(table, 0), 0);
+    XCTAssertEqual(BCArclengthTableArclength(table, 1), BCCubicLength(cubic));
+}
+
+//queries read the caller's storage, so they must not be reused after it changes
+static void testStorageChange(void) {
+    BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    bc_float_t storage[32];
+    BCArclengthTable table = BCArclengthTableMake(cubic, storage, 32);
+    const float length = BCArclengthTableLength(table);
+    const float half = BCArclengthTableArclength(table, 0.5);
+    const float t = BCArclengthTableParameterization(table, length / 2);
+    for (int i = 0; i < 32; i++) { storage[i] *= 2; }
+    XCTAssertEqual(BCArclengthTableLength(table), 2 * length);
+    XCTAssertEqualWithAccuracy(BCArclengthTableArclength(table, 0.5), 2 * half, 1e-4);
+    XCTAssertEqualWithAccuracy(BCArclengthTableParameterization(table, length), t, 1e-5);
+    XCTAssertLessThan(BCArclengthTableParameterization(table, length / 2), t);
+}
+
+//compare against the iterative BCCubicArclengthParameterization
+static void testAccuracy(void) {
+    bc_float_t storage[256];
+    float worst = 0;
+    for (int c = 0; c < 100; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        BCArclengthTable table = BCArclengthTableMake(cubic, storage, 256);
+        const float length = BCCubicLength(cubic);
+        for (int i = 0; i < 20; i++) {
+            const float arclength = BCTestRandom(0, 1) * length;
+            const float t = BCArclengthTableParameterization(table, arclength);
+            const float expected = BCCubicArclengthParameterization(cubic, arclength, 0.0001);
+            XCTAssertEqualWithAccuracy(t, expected, 0.01);
+            //the point we find is at the requested arclength
+            const float error = bc_abs(BCCubicLength(BCCubicLeftSplit(cubic, t)) - arclength) / length;
+            worst = bc_max(worst, error);
+        }
+    }
+    XCTAssertLessThan(worst, 0.005);
+}
+
+static void testRoundTrip(void) {
+    bc_float_t storage[32];
+    for (int c = 0; c < 100; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        BCArclengthTable table = BCArclengthTableMake(cubic, storage, 32);
+        for (int i = 0; i < 20; i++) {
+            const float t = BCTestRandom(0, 1);
+            const float arclength = BCArclengthTableArclength(table, t);
+            XCTAssertEqualWithAccuracy(BCArclengthTableArclength(table, BCArclengthTableParameterization(table, arclength)), arclength, 0.01);
+        }
+    }
+}
+
+static void testBatch(void) {
+    //not a multiple of 8, so we exercise the scalar tail
+    enum { count = 19, samples = 33 };
+    BCCubic cubics[count];
+    for (int c = 0; c < count; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    bc_float_t storage[count * samples];
+    BCArclengthTable tables[count];
+    BCArclengthTableMakeBatch(cubics, count, samples, storage, tables);
+    bc_float_t scalarStorage[samples];
+    for (int c = 0; c < count; c++) {
+        BCArclengthTable scalar = BCArclengthTableMake(cubics[c], scalarStorage, samples);
+        XCTAssertEqual(tables[c].count, samples);
+        XCTAssert(tables[c].lengths == storage + c * samples);
+        for (int i = 0; i < samples; i++) {
+            XCTAssertEqualWithAccuracy(tables[c].lengths[i], scalar.lengths[i], 0.001);
+        }
+    }
+}
+
+static void testParameterizationBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    const float length = BCCubicLength(cubic);
+    const int count = 100000;
+    float r = 0;
+    double start = BCTestNow();
+    for (int i = 0; i < count; i++) {
+        r += BCCubicArclengthParameterization(cubic, length * i / count, 0.01);
+    }
+    const double iterative = BCTestNow() - start;
+    start = BCTestNow();
+    bc_float_t storage[64];
+    BCArclengthTable table = BCArclengthTableMake(cubic, storage, 64);
+    for (int i = 0; i < count; i++) {
+        r += BCArclengthTableParameterization(table, length * i / count);
+    }
+    const double tabled = BCTestNow() - start;
+    printf("    parameterization: iterative %.2f ns/query, table %.2f ns/query including build (%f)\n", iterative / count * 1e9, tabled / count * 1e9, r);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testStorageChange", testStorageChange},
+    {"testAccuracy", testAccuracy},
+    {"testRoundTrip", testRoundTrip},
+    {"testBatch", testBatch},
+    {"testParameterizationBench", testParameterizationBench},
+};
+BC_TEST_SUITE(ArclengthTableTests, tests);
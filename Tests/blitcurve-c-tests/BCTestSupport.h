@@ -0,0 +1,160 @@
+// BCTestSupport.h: Minimal XCTest-style assertions for the C test runner
+// ©2021 DrewCrawfordApps LLC
+
+/*
+ These tests mirror the Swift tests in blitcurveTests, for platforms where XCTest isn't available.
+ Assertion names follow the XCTest (Objective-C) macros, so that tests can be ported line-for-line.
+ */
+#ifndef BCTestSupport_h
+#define BCTestSupport_h
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "blitcurve.h"
+
+typedef void (*BCTestFunction)(void);
+
+typedef struct {
+    const char *name;
+    BCTestFunction function;
+} BCTestCase;
+
+typedef struct {
+    const char *name;
+    const BCTestCase *tests;
+    size_t count;
+} BCTestSuite;
+
+#define BC_TEST_SUITE(NAME, TESTS) const BCTestSuite NAME = {#NAME, TESTS, sizeof(TESTS) / sizeof(BCTestCase)}
+
+///Number of failed assertions so far
+extern unsigned long __bc_test_failures;
+
+static inline void __BCTestFail(const char *file, int line, const char *message) {
+    printf("%s:%d: error: %s\n", file, line, message);
+    __bc_test_failures++;
+}
+
+static inline void __BCTestFailFloat(const char *file, int line, const char *expression, double a, double b, double accuracy) {
+    printf("%s:%d: error: %s (%g is not equal to %g within %g)\n", file, line, expression, a, b, accuracy);
+    __bc_test_failures++;
+}
+
+static inline void __BCTestFailFloat2(const char *file, int line, const char *expression, bc_float2_t a, bc_float2_t b, double accuracy) {
+    printf("%s:%d: error: %s ((%g,%g) is not equal to (%g,%g) within %g)\n", file, line, expression, a.x, a.y, b.x, b.y, accuracy);
+    __bc_test_failures++;
+}
+
+#define XCTAssert(CONDITION) do { if (!(CONDITION)) { __BCTestFail(__FILE__, __LINE__, "XCTAssert(" #CONDITION ")"); } } while (0)
+#define XCTAssertTrue(CONDITION) XCTAssert(CONDITION)
+#define XCTAssertFalse(CONDITION) do { if ((CONDITION)) { __BCTestFail(__FILE__, __LINE__, "XCTAssertFalse(" #CONDITION ")"); } } while (0)
+
+#define XCTAssertEqualWithAccuracy(A, B, ACCURACY) do { \
+    const double __a = (A); const double __b = (B); const double __acc = (ACCURACY); \
+    if (!(__a - __b <= __acc && __b - __a <= __acc)) { __BCTestFailFloat(__FILE__, __LINE__, "XCTAssertEqualWithAccuracy(" #A ", " #B ")", __a, __b, __acc); } \
+} while (0)
+
+#define XCTAssertEqual(A, B) XCTAssertEqualWithAccuracy(A, B, 0)
+
+#define XCTAssertNotEqual(A, B) do { \
+    const double __a = (A); const double __b = (B); \
+    if (__a == __b) { __BCTestFailFloat(__FILE__, __LINE__, "XCTAssertNotEqual(" #A ", " #B ")", __a, __b, 0); } \
+} while (0)
+
+#define XCTAssertLessThan(A, B) do { \
+    const double __a = (A); const double __b = (B); \
+    if (!(__a < __b)) { __BCTestFailFloat(__FILE__, __LINE__, "XCTAssertLessThan(" #A ", " #B ")", __a, __b, 0); } \
+} while (0)
+
+#define XCTAssertGreaterThan(A, B) XCTAssertLessThan(B, A)
+
+#define XCTAssertLessThanOrEqual(A, B) do { \
+    const double __a = (A); const double __b = (B); \
+    if (!(__a <= __b)) { __BCTestFailFloat(__FILE__, __LINE__, "XCTAssertLessThanOrEqual(" #A ", " #B ")", __a, __b, 0); } \
+} while (0)
+
+///Compares 2 \c bc_float2_t.  Each component must be within \c ACCURACY.
+#define XCTAssertEqualFloat2WithAccuracy(A, B, ACCURACY) do { \
+    const bc_float2_t __a = (A); const bc_float2_t __b = (B); const double __acc = (ACCURACY); \
+    if (!(bc_norm_inf(__a - __b) <= __acc)) { __BCTestFailFloat2(__FILE__, __LINE__, "XCTAssertEqualFloat2(" #A ", " #B ")", __a, __b, __acc); } \
+} while (0)
+
+#define XCTAssertEqualFloat2(A, B) XCTAssertEqualFloat2WithAccuracy(A, B, 0)
+
+///Compares 2 \c bc_float4_t, componentwise.
+#define XCTAssertEqualFloat4WithAccuracy(A, B, ACCURACY) do { \
+    const bc_float4_t __a4 = (A); const bc_float4_t __b4 = (B); \
+    XCTAssertEqualFloat2WithAccuracy(__a4.lo, __b4.lo, ACCURACY); \
+    XCTAssertEqualFloat2WithAccuracy(__a4.hi, __b4.hi, ACCURACY); \
+} while (0)
+
+//MARK: memberwise initializers, as imported into Swift
+static inline BCCubic CubicMake(bc_float2_t a, bc_float2_t b, bc_float2_t c, bc_float2_t d) {
+    BCCubic r;
+    r.a = a;
+    r.b = b;
+    r.c = c;
+    r.d = d;
+    return r;
+}
+
+static inline BCAlignedCubic AlignedCubicMake(bc_float2_t c, bc_float2_t d, bc_float_t b_x) {
+    BCAlignedCubic r;
+    r.c = c;
+    r.d = d;
+    r.b_x = b_x;
+    return r;
+}
+
+static inline BCLine LineMake(bc_float2_t a, bc_float2_t b) {
+    BCLine r;
+    r.a = a;
+    r.b = b;
+    return r;
+}
+
+static inline BCRect RectMake(bc_float2_t center, bc_float2_t lengths, bc_float_t angle) {
+    BCRect r;
+    r.center = center;
+    r.lengths = lengths;
+    r.angle = angle;
+    return r;
+}
+
+static inline BCAlignedRect AlignedRectMake(bc_float2_t min, bc_float2_t max) {
+    BCAlignedRect r;
+    r.min = min;
+    r.max = max;
+    return r;
+}
+
+///Skips the remainder of the test.
+#define XCTSkip(MESSAGE) do { printf("    skipped: %s\n", MESSAGE); return; } while (0)
+
+///Returns a monotonic time in seconds, for benchmarks.
+static inline double BCTestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+///Returns a float in [lower, upper), from a deterministic generator so runs are repeatable.
+static inline float BCTestRandom(float lower, float upper) {
+    static unsigned long long state = 0x2545F4914F6CDD1DULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return lower + (upper - lower) * (float)((state >> 40) / 16777216.0);
+}
+
+///Returns a cubic whose points are each in [origin, origin+size) on both axes, from \c BCTestRandom.
+static inline BCCubic BCTestRandomCubic(bc_float2_t origin, float size) {
+    bc_float2_t p[4];
+    for (int i = 0; i < 4; i++) {
+        p[i] = origin + bc_make_float2(BCTestRandom(0, size), BCTestRandom(0, size));
+    }
+    return CubicMake(p[0], p[1], p[2], p[3]);
+}
+
+#endif
@@ -0,0 +1,93 @@
+// CheckLevelTests.c: BCTrap.h check level tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+//checked at this file's level, as blitcurve's inline functions are
+static int checkedSquareRoot(int x) {
+    __BC_ASSERT(x >= 0, -1);
+    return (int) sqrtf(x);
+}
+
+static void testLevels(void) {
+    const int levels[5] = {BC_BUGASSERT_LEVEL, BC_ASSERT_LEVEL, BC_RANGEASSERT_LEVEL, BC_PRECONDITION_LEVEL, BC_TRY_LEVEL};
+    for (int i = 0; i < 5; i++) {
+        XCTAssertTrue(levels[i] == BC_CHECK_TRAP || levels[i] == BC_CHECK_RETURN || levels[i] == BC_CHECK_ASSUME);
+    }
+    //valid arguments behave the same at every level
+    XCTAssertEqual(checkedSquareRoot(16), 4);
+}
+
+static void testReturnLevel(void) {
+#if BC_CHECK_LEVEL != BC_CHECK_RETURN
+    XCTSkip("Requires BC_CHECK_LEVEL of BC_CHECK_RETURN");
+#else
+    //volatile, so the arguments aren't diagnosed at compile time
+    volatile int negative = -1;
+    XCTAssertEqual(checkedSquareRoot(negative), -1);
+    volatile uint16_t vertexID = 5;
+    XCTAssertEqual(BCVertexToBezierParameter(vertexID, 4), -1 - BCErrorArgRelationship);
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(10,10), bc_make_float2(3,6), bc_make_float2(7,2));
+    XCTAssertEqual(BCAlignedCubicKappa(BCAlignedCubicMake(c), 2), BC_FLOAT_LARGE);
+    XCTAssertEqual(BCCubicFlattenUpperBound(c, -1), 0);
+    uint32_t output[1];
+    XCTAssertEqual(BCCubicCullBatch(&c, 1, AlignedRectMake(bc_make_float2(0,0), bc_make_float2(1,1)), -1, BCStrategyFastest, 1, output), 0);
+#endif
+}
+
+static void testCheckLevelBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    enum { count = 1000 };
+    BCCubic cubics[count];
+    BCAlignedCubic aligned[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        aligned[i] = BCAlignedCubicMake(cubics[i]);
+    }
+    //best of several runs, since each level is a separate build and can't be compared in one process
+    double vertexTime = INFINITY, parameterTime = INFINITY, kappaTime = INFINITY, lengthTime = INFINITY;
+    bc_float2_t vertexSum = 0;
+    float parameterSum = 0, kappaSum = 0, lengthSum = 0;
+    for (int run = 0; run < 10; run++) {
+        //BCVertexToBezierParameter and BCCubicVertexMake, as a vertex shader calls them
+        double start = BCTestNow();
+        for (int i = 0; i < count; i++) {
+            for (uint8_t v = 0; v < 64; v++) {
+                vertexSum += BCCubicVertexMake(cubics[i], v, 64, 0.25, 0.75);
+            }
+        }
+        vertexTime = fmin(vertexTime, (BCTestNow() - start) / count / 64);
+        start = BCTestNow();
+        for (int i = 0; i < count; i++) {
+            for (uint16_t v = 0; v < 64; v++) {
+                parameterSum += BCVertexToBezierParameter(v, 64, 0.25f, 0.75f);
+            }
+        }
+        parameterTime = fmin(parameterTime, (BCTestNow() - start) / count / 64);
+        start = BCTestNow();
+        for (int i = 0; i < count; i++) {
+            for (int k = 0; k < 64; k++) {
+                kappaSum += BCAlignedCubicKappa(aligned[i], k / 63.0f);
+            }
+        }
+        kappaTime = fmin(kappaTime, (BCTestNow() - start) / count / 64);
+        start = BCTestNow();
+        for (int i = 0; i < count; i++) {
+            lengthSum += BCCubicLength(cubics[i]);
+        }
+        lengthTime = fmin(lengthTime, (BCTestNow() - start) / count);
+    }
+    printf("    check level %d (bug %d, assert %d, range %d, precondition %d, try %d): %.2f ns vertex, %.2f ns parameter, %.2f ns kappa, %.2f ns length (%f %f %f %f)\n", BC_CHECK_LEVEL, BC_BUGASSERT_LEVEL, BC_ASSERT_LEVEL, BC_RANGEASSERT_LEVEL, BC_PRECONDITION_LEVEL, BC_TRY_LEVEL, vertexTime * 1e9, parameterTime * 1e9, kappaTime * 1e9, lengthTime * 1e9, vertexSum.x, parameterSum, kappaSum, lengthSum);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLevels", testLevels},
+    {"testReturnLevel", testReturnLevel},
+    {"testCheckLevelBench", testCheckLevelBench},
+};
+BC_TEST_SUITE(CheckLevelTests, tests);
@@ -0,0 +1,325 @@
+// CubicBatchTests.c: Batch evaluation tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <string.h>
+#include "BCTestSupport.h"
+
+//not a multiple of the lane width, so we exercise the scalar tail
+#define COUNT 37
+
+static void testEvaluateBatch(void) {
+    BCCubic cubics[COUNT];
+    bc_float_t t[COUNT];
+    for (int i = 0; i < COUNT; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        t[i] = BCTestRandom(0, 1);
+    }
+    bc_float2_t output[COUNT];
+    BCCubicEvaluateBatch(cubics, t, COUNT, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(output[i], BCCubicEvaluate(cubics[i], t[i]), 0.001);
+    }
+    BCCubicEvaluatePrimeBatch(cubics, t, COUNT, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(output[i], BCCubicEvaluatePrime(cubics[i], t[i]), 0.001);
+    }
+    BCCubicEvaluateBatchSharedParameter(cubics, COUNT, 0.3, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(output[i], BCCubicEvaluate(cubics[i], 0.3), 0.001);
+    }
+    BCCubicEvaluatePrimeBatchSharedParameter(cubics, COUNT, 0.3, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(output[i], BCCubicEvaluatePrime(cubics[i], 0.3), 0.001);
+    }
+    //endpoints are exact
+    BCCubicEvaluateBatchSharedParameter(cubics, COUNT, 1, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2(output[i], cubics[i].b);
+    }
+}
+
+static void testPlanesEvaluateBatch(void) {
+    bc_float_t planes[8][COUNT];
+    bc_float_t t[COUNT];
+    BCCubic cubics[COUNT];
+    for (int i = 0; i < COUNT; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        t[i] = BCTestRandom(0, 1);
+        planes[0][i] = cubics[i].a.x;
+        planes[1][i] = cubics[i].a.y;
+        planes[2][i] = cubics[i].b.x;
+        planes[3][i] = cubics[i].b.y;
+        planes[4][i] = cubics[i].c.x;
+        planes[5][i] = cubics[i].c.y;
+        planes[6][i] = cubics[i].d.x;
+        planes[7][i] = cubics[i].d.y;
+    }
+    BCCubicPlanes p = {planes[0], planes[1], planes[2], planes[3], planes[4], planes[5], planes[6], planes[7]};
+    bc_float_t x[COUNT];
+    bc_float_t y[COUNT];
+    BCCubicPlanesEvaluateBatch(p, t, COUNT, x, y);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(x[i], y[i]), BCCubicEvaluate(cubics[i], t[i]), 0.001);
+    }
+    BCCubicPlanesEvaluatePrimeBatch(p, t, COUNT, x, y);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(x[i], y[i]), BCCubicEvaluatePrime(cubics[i], t[i]), 0.001);
+    }
+    BCCubicPlanesEvaluateBatchSharedParameter(p, COUNT, 0.7, x, y);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(x[i], y[i]), BCCubicEvaluate(cubics[i], 0.7), 0.001);
+    }
+    BCCubicPlanesEvaluatePrimeBatchSharedParameter(p, COUNT, 0.7, x, y);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(x[i], y[i]), BCCubicEvaluatePrime(cubics[i], 0.7), 0.001);
+    }
+}
+
+static void testLengthBatch(void) {
+    BCCubic cubics[COUNT];
+    for (int i = 0; i < COUNT; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    //a cusp, which needs more subdivision than the first split
+    cubics[3] = CubicMake(bc_make_float2(0,0), bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(-100,100));
+    bc_float_t output[COUNT];
+    BCCubicLengthBatch(cubics, COUNT, 0.01, BCStrategyFastest, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualWithAccuracy(output[i], BCCubicLength(cubics[i]), 0.001);
+    }
+    BCCubicLengthBatch(cubics, COUNT, 0.01, BCStrategyAccurate, output);
+    for (int i = 0; i < COUNT; i++) {
+        XCTAssertEqualWithAccuracy(output[i], BCCubicLengthWithStrategy(cubics[i], 0.01, BCStrategyAccurate), 0.01);
+    }
+}
+
+static void testAlignedRectBatch(void) {
+    BCCubic cubics[COUNT];
+    for (int i = 0; i < COUNT; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    BCAlignedRect output[COUNT];
+    const BCStrategy strategies[] = {BCStrategyFastest, BCStrategyAccurate};
+    for (int s = 0; s < 2; s++) {
+        BCAlignedRectCreateFromCubicBatch(cubics, COUNT, strategies[s], output);
+        for (int i = 0; i < COUNT; i++) {
+            const BCAlignedRect expected = BCAlignedRectCreateFromCubic(cubics[i], strategies[s]);
+            XCTAssertEqualFloat2WithAccuracy(output[i].min, expected.min, 1e-4);
+            XCTAssertEqualFloat2WithAccuracy(output[i].max, expected.max, 1e-4);
+        }
+    }
+}
+
+static void testAlignedRectBatchBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    const size_t count = 1000000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    BCAlignedRect *output = malloc(sizeof(BCAlignedRect) * count);
+    for (size_t i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    double start = BCTestNow();
+    BCAlignedRectCreateFromCubicBatch(cubics, count, BCStrategyFastest, output);
+    const double fastest = BCTestNow() - start;
+    double fastestArea = 0;
+    for (size_t i = 0; i < count; i++) { fastestArea += (output[i].max.x - output[i].min.x) * (output[i].max.y - output[i].min.y); }
+    start = BCTestNow();
+    for (size_t i = 0; i < count; i++) {
+        output[i] = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyAccurate);
+    }
+    const double scalar = BCTestNow() - start;
+    start = BCTestNow();
+    BCAlignedRectCreateFromCubicBatch(cubics, count, BCStrategyAccurate, output);
+    const double batch = BCTestNow() - start;
+    double accurateArea = 0;
+    for (size_t i = 0; i < count; i++) { accurateArea += (output[i].max.x - output[i].min.x) * (output[i].max.y - output[i].min.y); }
+    printf("    aligned rect: fastest %.2f ns/cubic, accurate %.2f ns/cubic scalar, %.2f ns/cubic batch, accurate area is %.0f%% of fastest\n", fastest / count * 1e9, scalar / count * 1e9, batch / count * 1e9, 100 * accurateArea / fastestArea);
+    free(cubics);
+    free(output);
+#endif
+}
+
+static void testEvaluateBatchBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    const size_t count = 1000000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    bc_float_t *t = malloc(sizeof(bc_float_t) * count);
+    bc_float2_t *output = malloc(sizeof(bc_float2_t) * count);
+    bc_float_t *planes = malloc(sizeof(bc_float_t) * count * 10);
+    for (size_t i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        t[i] = BCTestRandom(0, 1);
+        for (int p = 0; p < 8; p++) {
+            planes[p * count + i] = ((const bc_float_t *) &cubics[i])[p];
+        }
+    }
+    //touch the output planes so page faults are not measured
+    memset(planes + 8 * count, 0, sizeof(bc_float_t) * count * 2);
+    BCCubicPlanes p = {planes, planes + count, planes + 2 * count, planes + 3 * count, planes + 4 * count, planes + 5 * count, planes + 6 * count, planes + 7 * count};
+
+    double start = BCTestNow();
+    for (size_t i = 0; i < count; i++) {
+        output[i] = BCCubicEvaluate(cubics[i], t[i]);
+    }
+    const double scalar = BCTestNow() - start;
+    start = BCTestNow();
+    BCCubicEvaluateBatch(cubics, t, count, output);
+    const double batch = BCTestNow() - start;
+    start = BCTestNow();
+    BCCubicPlanesEvaluateBatch(p, t, count, planes + 8 * count, planes + 9 * count);
+    const double planar = BCTestNow() - start;
+    printf("    evaluate: scalar %.2f ns/point, batch %.2f ns/point, planes %.2f ns/point\n", scalar / count * 1e9, batch / count * 1e9, planar / count * 1e9);
+    free(cubics);
+    free(t);
+    free(output);
+    free(planes);
+#endif
+}
+
+static void testCullBatch(void) {
+    //more than one block, and a partial group of 8 at the end
+    const size_t count = 10003;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    for (size_t i = 0; i < count; i++) {
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000));
+        cubics[i] = CubicMake(origin, origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)), origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)), origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)));
+    }
+    const BCAlignedRect viewport = AlignedRectMake(bc_make_float2(300,200), bc_make_float2(500,350));
+    uint32_t *output = malloc(sizeof(uint32_t) * count);
+    uint32_t *threaded = malloc(sizeof(uint32_t) * count);
+    const BCStrategy strategies[2] = {BCStrategyFastest, BCStrategyAccurate};
+    size_t visible[2];
+    for (int s = 0; s < 2; s++) {
+        visible[s] = BCCubicCullBatch(cubics, count, viewport, 2, strategies[s], 1, output);
+        size_t expected = 0;
+        for (size_t i = 0; i < count; i++) {
+            const BCAlignedRect box = BCAlignedRectCreateFromCubic(cubics[i], strategies[s]);
+            if (box.max.x + 2 >= viewport.min.x && box.min.x - 2 <= viewport.max.x && box.max.y + 2 >= viewport.min.y && box.min.y - 2 <= viewport.max.y) {
+                XCTAssertLessThan(expected, visible[s]);
+                XCTAssertEqual(output[expected], i);
+                expected++;
+            }
+        }
+        XCTAssertEqual(visible[s], expected);
+        XCTAssertEqual(BCCubicCullBatch(cubics, count, viewport, 2, strategies[s], 4, threaded), visible[s]);
+        XCTAssertTrue(memcmp(output, threaded, sizeof(uint32_t) * visible[s]) == 0);
+    }
+    //the accurate box is inside the fast one, so it culls at least as much
+    XCTAssertLessThanOrEqual(visible[1], visible[0]);
+    XCTAssertEqual(BCCubicCullBatch(cubics, 0, viewport, 0, BCStrategyFastest, 1, output), 0);
+    free(cubics);
+    free(output);
+    free(threaded);
+}
+
+static void testCullBatchBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    //a map zoomed in to 1% of its area
+    const size_t count = 1000000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    for (size_t i = 0; i < count; i++) {
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(0, 10000), BCTestRandom(0, 10000));
+        cubics[i] = CubicMake(origin, origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)), origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)), origin + bc_make_float2(BCTestRandom(-20,20),BCTestRandom(-20,20)));
+    }
+    const BCAlignedRect viewport = AlignedRectMake(bc_make_float2(4000,4000), bc_make_float2(5000,5000));
+    uint32_t *output = malloc(sizeof(uint32_t) * count);
+    //a scalar loop over BCAlignedRectCreateFromCubic
+    double start = BCTestNow();
+    size_t scalar = 0;
+    for (size_t i = 0; i < count; i++) {
+        const BCAlignedRect box = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest);
+        if (box.max.x >= viewport.min.x && box.min.x <= viewport.max.x && box.max.y >= viewport.min.y && box.min.y <= viewport.max.y) {
+            output[scalar++] = (uint32_t) i;
+        }
+    }
+    const double scalarTime = (BCTestNow() - start) / count;
+    start = BCTestNow();
+    const size_t fastest = BCCubicCullBatch(cubics, count, viewport, 0, BCStrategyFastest, 1, output);
+    const double fastestTime = (BCTestNow() - start) / count;
+    start = BCTestNow();
+    const size_t accurate = BCCubicCullBatch(cubics, count, viewport, 0, BCStrategyAccurate, 1, output);
+    const double accurateTime = (BCTestNow() - start) / count;
+    printf("    cull: %.2f ns/cubic scalar, %.2f ns/cubic fastest, %.2f ns/cubic accurate, %zu/%zu/%zu of %zu visible\n", scalarTime * 1e9, fastestTime * 1e9, accurateTime * 1e9, scalar, fastest, accurate, count);
+    free(cubics);
+    free(output);
+#endif
+}
+
+static void testVertexBudgetBatch(void) {
+    enum { cubicCount = 37 };
+    BCCubic cubics[cubicCount];
+    for (int c = 0; c < cubicCount; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    uint8_t counts[cubicCount];
+    uint32_t offsets[cubicCount + 1];
+    BCDrawPrimitivesArguments arguments[cubicCount];
+    const uint32_t total = BCCubicVertexBudgetBatch(cubics, cubicCount, 2, 0.1, 64, 2, counts, offsets, arguments);
+    uint32_t expected = 0;
+    for (int c = 0; c < cubicCount; c++) {
+        XCTAssertEqual(counts[c], BCCubicVertexBudget(cubics[c], 2, 0.1, 64));
+        XCTAssertEqual(offsets[c], expected);
+        XCTAssertEqual(arguments[c].vertexStart, expected);
+        XCTAssertEqual(arguments[c].vertexCount, 2 * counts[c]);
+        XCTAssertEqual(arguments[c].instanceCount, 1);
+        XCTAssertEqual(arguments[c].baseInstance, c);
+        expected += 2 * counts[c];
+    }
+    XCTAssertEqual(offsets[cubicCount], expected);
+    XCTAssertEqual(total, expected);
+    //counts alone
+    XCTAssertEqual(BCCubicVertexBudgetBatch(cubics, cubicCount, 2, 0.1, 64, 2, counts, NULL, NULL), total);
+}
+
+static void testVertexBudgetBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    //a scene of short and long cubics, some nearly straight, at a quarter pixel
+    enum { cubicCount = 100000 };
+    BCCubic *cubics = malloc(sizeof(BCCubic) * cubicCount);
+    for (int c = 0; c < cubicCount; c++) {
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000));
+        const float size = BCTestRandom(1, 200);
+        const float bend = c % 2 ? 0.05 : 1;
+        const bc_float2_t direction = bc_make_float2(BCTestRandom(-1, 1), BCTestRandom(-1, 1)) * size;
+        const bc_float2_t side = bc_make_float2(-direction.y, direction.x) * bend;
+        cubics[c] = CubicMake(origin, origin + direction, origin + direction / 3 + side * BCTestRandom(-0.5, 0.5), origin + direction * 2 / 3 + side * BCTestRandom(-0.5, 0.5));
+    }
+    uint8_t *counts = malloc(cubicCount);
+    uint32_t *offsets = malloc(sizeof(uint32_t) * (cubicCount + 1));
+    BCDrawPrimitivesArguments *arguments = malloc(sizeof(BCDrawPrimitivesArguments) * cubicCount);
+    const double start = BCTestNow();
+    const uint32_t total = BCCubicVertexBudgetBatch(cubics, cubicCount, 1, 0.25, 255, 1, counts, offsets, arguments);
+    const double elapsed = (BCTestNow() - start) / cubicCount;
+    //a fixed count has to be the largest budget to draw every cubic as well
+    uint8_t fixed = 2;
+    for (int c = 0; c < cubicCount; c++) { fixed = counts[c] > fixed ? counts[c] : fixed; }
+    printf("    vertex budget: %.2f vertexes/cubic adaptive, %d fixed for the same tolerance, %.1f ns/cubic (%u)\n", (double) total / cubicCount, fixed, elapsed * 1e9, arguments[cubicCount - 1].vertexStart);
+    free(cubics);
+    free(counts);
+    free(offsets);
+    free(arguments);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testEvaluateBatch", testEvaluateBatch},
+    {"testPlanesEvaluateBatch", testPlanesEvaluateBatch},
+    {"testLengthBatch", testLengthBatch},
+    {"testAlignedRectBatch", testAlignedRectBatch},
+    {"testAlignedRectBatchBench", testAlignedRectBatchBench},
+    {"testEvaluateBatchBench", testEvaluateBatchBench},
+    {"testCullBatch", testCullBatch},
+    {"testCullBatchBench", testCullBatchBench},
+    {"testVertexBudgetBatch", testVertexBudgetBatch},
+    {"testVertexBudgetBench", testVertexBudgetBench},
+};
+BC_TEST_SUITE(CubicBatchTests, tests);
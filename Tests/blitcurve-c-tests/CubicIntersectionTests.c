@@ -0,0 +1,311 @@
+// CubicIntersectionTests.c: BCCubicIntersect tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static void testLines(void) {
+    BCCubic a = CubicMake(bc_make_float2(0,0), bc_make_float2(10,10), bc_make_float2(2,2), bc_make_float2(8,8));
+    BCCubic b = CubicMake(bc_make_float2(0,10), bc_make_float2(10,0), bc_make_float2(3,7), bc_make_float2(7,3));
+    BCCubicIntersection output[4];
+    XCTAssertEqual(BCCubicIntersect(a, b, 0.001, output, 4), 1);
+    XCTAssertEqualFloat2WithAccuracy(BCCubicEvaluate(a, output[0].t1), bc_make_float2(5,5), 0.001);
+    XCTAssertEqualFloat2WithAccuracy(BCCubicEvaluate(b, output[0].t2), bc_make_float2(5,5), 0.001);
+}
+
+static void testThreeCrossings(void) {
+    //x is t, and y is 3t(1-t)(1-2t), which is 0 at 0, 1/2 and 1
+    BCCubic s = CubicMake(bc_make_float2(0,0), bc_make_float2(1,0), bc_make_float2(1.0/3,1), bc_make_float2(2.0/3,-1));
+    BCCubic line = CubicMake(bc_make_float2(-1,0), bc_make_float2(2,0), bc_make_float2(0,0), bc_make_float2(1,0));
+    BCCubicIntersection output[9];
+    const size_t count = BCCubicIntersect(s, line, 0.0001, output, 9);
+    XCTAssertEqual(count, 3);
+    bool found[3] = {false, false, false};
+    for (size_t i = 0; i < count; i++) {
+        const int k = (int) roundf(output[i].t1 * 2);
+        XCTAssertEqualWithAccuracy(output[i].t1, k / 2.0f, 0.001);
+        XCTAssertEqualWithAccuracy(BCCubicEvaluate(line, output[i].t2).x, k / 2.0f, 0.001);
+        found[k] = true;
+    }
+    XCTAssertTrue(found[0] && found[1] && found[2]);
+
+    //capacity only limits what is written
+    output[1].t1 = -1;
+    XCTAssertEqual(BCCubicIntersect(s, line, 0.0001, output, 1), 3);
+    XCTAssertEqual(output[1].t1, -1);
+}
+
+static void testApart(void) {
+    BCCubic a = BCTestRandomCubic(bc_make_float2(0,0), 10);
+    BCCubic b = BCTestRandomCubic(bc_make_float2(20,0), 10);
+    BCCubicIntersection output[9];
+    XCTAssertEqual(BCCubicIntersect(a, b, 0.01, output, 9), 0);
+    //parallel lines closer than the tolerance touch
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(10,0), bc_make_float2(3,0), bc_make_float2(7,0));
+    BCCubic d = CubicMake(bc_make_float2(0,1), bc_make_float2(10,1), bc_make_float2(3,1), bc_make_float2(7,1));
+    XCTAssertEqual(BCCubicIntersect(c, d, 0.5, output, 9), 0);
+    XCTAssertLessThanOrEqual(1, BCCubicIntersect(c, d, 1.5, output, 9));
+}
+
+static bool segmentsCross(bc_float2_t p0, bc_float2_t p1, bc_float2_t q0, bc_float2_t q1, bc_float2_t *point) {
+    const bc_float2_t dp = p1 - p0;
+    const bc_float2_t dq = q1 - q0;
+    const bc_float2_t r = q0 - p0;
+    const float denominator = dp.x * dq.y - dp.y * dq.x;
+    if (denominator == 0) { return false; }
+    const float s = (r.x * dq.y - r.y * dq.x) / denominator;
+    const float u = (r.x * dp.y - r.y * dp.x) / denominator;
+    if (s < 0 || s > 1 || u < 0 || u > 1) { return false; }
+    *point = p0 + s * dp;
+    return true;
+}
+
+//every reported intersection is within tolerance, and every crossing of fine polylines is near a reported one
+static void testRandom(void) {
+    const float tolerance = 0.01;
+    bc_float2_t polylineA[2048];
+    bc_float2_t polylineB[2048];
+    BCCubicIntersection output[64];
+    for (int trial = 0; trial < 200; trial++) {
+        BCCubic a = BCTestRandomCubic(bc_make_float2(0,0), 100);
+        BCCubic b = BCTestRandomCubic(bc_make_float2(0,0), 100);
+        const size_t count = BCCubicIntersect(a, b, tolerance, output, 64);
+        XCTAssertLessThanOrEqual(count, 64);
+        for (size_t i = 0; i < count; i++) {
+            XCTAssertLessThanOrEqual(bc_distance(BCCubicEvaluate(a, output[i].t1), BCCubicEvaluate(b, output[i].t2)), tolerance);
+        }
+        const size_t countA = BCCubicFlatten(a, 0.001, polylineA, NULL, 2048);
+        const size_t countB = BCCubicFlatten(b, 0.001, polylineB, NULL, 2048);
+        XCTAssertLessThanOrEqual(countA, 2048);
+        XCTAssertLessThanOrEqual(countB, 2048);
+        for (size_t i = 0; i + 1 < countA; i++) {
+            for (size_t j = 0; j + 1 < countB; j++) {
+                bc_float2_t crossing;
+                if (!segmentsCross(polylineA[i], polylineA[i+1], polylineB[j], polylineB[j+1], &crossing)) { continue; }
+                float nearest = INFINITY;
+                for (size_t k = 0; k < count; k++) {
+                    nearest = fminf(nearest, bc_distance(BCCubicEvaluate(a, output[k].t1), crossing));
+                }
+                XCTAssertLessThanOrEqual(nearest, 3 * tolerance);
+            }
+        }
+    }
+}
+
+static void testPairs(void) {
+    const int cubicCount = 200;
+    BCCubic cubics[cubicCount];
+    for (int i = 0; i < cubicCount; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 40), BCTestRandom(0, 40)), 20);
+    }
+    const int pairCount = 500;
+    BCRectPair pairs[pairCount];
+    for (int i = 0; i < pairCount; i++) {
+        pairs[i].a = arc4random_uniform(cubicCount);
+        //a cubic overlaps itself everywhere
+        pairs[i].b = (pairs[i].a + 1 + arc4random_uniform(cubicCount - 1)) % cubicCount;
+    }
+    const size_t capacity = pairCount * 9;
+    BCCubicIntersection *output = malloc(sizeof(BCCubicIntersection) * capacity);
+    uint32_t *outputPairs = malloc(sizeof(uint32_t) * capacity);
+    const size_t total = BCCubicIntersectPairs(cubics, pairs, pairCount, 0.01, output, outputPairs, capacity);
+    XCTAssertLessThanOrEqual(total, capacity);
+    size_t expected = 0;
+    BCCubicIntersection single[64];
+    for (int i = 0; i < pairCount; i++) {
+        const size_t count = BCCubicIntersect(cubics[pairs[i].a], cubics[pairs[i].b], 0.01, single, 64);
+        XCTAssertLessThanOrEqual(count, 64);
+        for (size_t j = 0; j < count; j++) {
+            XCTAssertEqual(outputPairs[expected + j], i);
+            XCTAssertEqual(output[expected + j].t1, single[j].t1);
+            XCTAssertEqual(output[expected + j].t2, single[j].t2);
+        }
+        expected += count;
+    }
+    XCTAssertEqual(total, expected);
+    //truncated output still counts everything
+    XCTAssertEqual(BCCubicIntersectPairs(cubics, pairs, pairCount, 0.01, output, outputPairs, total / 2), total);
+    free(output);
+    free(outputPairs);
+}
+
+static void testIntersectionBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    //short segments scattered over a large map, in pairs that are close, as from a broad phase
+    const int pairCount = 200000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * pairCount * 2);
+    BCRectPair *pairs = malloc(sizeof(BCRectPair) * pairCount);
+    for (int i = 0; i < pairCount; i++) {
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(0, 10000), BCTestRandom(0, 10000));
+        cubics[2 * i] = BCTestRandomCubic(origin, 10);
+        cubics[2 * i + 1] = BCTestRandomCubic(origin + bc_make_float2(BCTestRandom(-5, 5), BCTestRandom(-5, 5)), 10);
+        pairs[i].a = 2 * i;
+        pairs[i].b = 2 * i + 1;
+    }
+    const size_t capacity = (size_t) pairCount * 9;
+    BCCubicIntersection *output = malloc(sizeof(BCCubicIntersection) * capacity);
+    uint32_t *outputPairs = malloc(sizeof(uint32_t) * capacity);
+    double start = BCTestNow();
+    size_t single = 0;
+    for (int i = 0; i < pairCount; i++) {
+        single += BCCubicIntersect(cubics[2 * i], cubics[2 * i + 1], 0.01, output, 9);
+    }
+    const double singleTime = BCTestNow() - start;
+    start = BCTestNow();
+    const size_t batch = BCCubicIntersectPairs(cubics, pairs, pairCount, 0.01, output, outputPairs, capacity);
+    const double batchTime = BCTestNow() - start;
+    XCTAssertEqual(single, batch);
+    printf("    intersect: %.2f intersections/pair, %.0f ns/pair single, %.0f ns/pair batch\n", (double) batch / pairCount, singleTime / pairCount * 1e9, batchTime / pairCount * 1e9);
+    free(cubics);
+    free(pairs);
+    free(output);
+    free(outputPairs);
+#endif
+}
+
+static void testLineCrossings(void) {
+    //the same s curve, crossing y=0 at x = 0, 1/2 and 1
+    BCCubic s = CubicMake(bc_make_float2(0,0), bc_make_float2(1,0), bc_make_float2(1.0/3,1), bc_make_float2(2.0/3,-1));
+    BCLineCubicIntersection output[3];
+    BCLine line = {bc_make_float2(-1,0), bc_make_float2(2,0)};
+    XCTAssertEqual(BCLineIntersectCubic(line, BCLineExtentSegment, s, output), 3);
+    for (int i = 0; i < 3; i++) {
+        XCTAssertEqualWithAccuracy(output[i].cubicT, i / 2.0f, 1e-5);
+        XCTAssertEqualWithAccuracy(output[i].lineT, (1 + i / 2.0f) / 3, 1e-5);
+    }
+    //a shorter segment misses the first
+    BCLine shorter = {bc_make_float2(0.25,0), bc_make_float2(2,0)};
+    XCTAssertEqual(BCLineIntersectCubic(shorter, BCLineExtentSegment, s, output), 2);
+    XCTAssertEqualWithAccuracy(output[0].cubicT, 0.5, 1e-5);
+    //a ray keeps going
+    BCLine ray = {bc_make_float2(0.25,0), bc_make_float2(0.3,0)};
+    XCTAssertEqual(BCLineIntersectCubic(ray, BCLineExtentSegment, s, output), 0);
+    XCTAssertEqual(BCLineIntersectCubic(ray, BCLineExtentRay, s, output), 2);
+    XCTAssertEqualWithAccuracy(output[0].lineT, 5, 1e-3);
+    XCTAssertEqualWithAccuracy(output[1].lineT, 15, 1e-3);
+    //vertical, through the middle
+    BCLine vertical = {bc_make_float2(0.5,-1), bc_make_float2(0.5,1)};
+    XCTAssertEqual(BCLineIntersectCubic(vertical, BCLineExtentSegment, s, output), 1);
+    XCTAssertEqualWithAccuracy(output[0].cubicT, 0.5, 1e-5);
+    XCTAssertEqualWithAccuracy(output[0].lineT, 0.5, 1e-5);
+    //0-length
+    BCLine point = {bc_make_float2(0.5,0), bc_make_float2(0.5,0)};
+    XCTAssertEqual(BCLineIntersectCubic(point, BCLineExtentRay, s, output), 0);
+}
+
+static void testLineRandom(void) {
+    bc_float2_t polyline[2048];
+    BCLineCubicIntersection output[3];
+    for (int trial = 0; trial < 500; trial++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0,0), 100);
+        BCLine line = {bc_make_float2(BCTestRandom(0,100),BCTestRandom(0,100)), bc_make_float2(BCTestRandom(0,100),BCTestRandom(0,100))};
+        const size_t count = BCLineIntersectCubic(line, BCLineExtentSegment, cubic, output);
+        XCTAssertLessThanOrEqual(count, 3);
+        for (size_t i = 0; i < count; i++) {
+            XCTAssertEqualFloat2WithAccuracy(BCCubicEvaluate(cubic, output[i].cubicT), line.a + output[i].lineT * (line.b - line.a), 0.01);
+            if (i > 0) { XCTAssertLessThanOrEqual(output[i - 1].cubicT, output[i].cubicT); }
+        }
+        const size_t points = BCCubicFlatten(cubic, 0.001, polyline, NULL, 2048);
+        for (size_t i = 0; i + 1 < points; i++) {
+            bc_float2_t crossing;
+            if (!segmentsCross(polyline[i], polyline[i+1], line.a, line.b, &crossing)) { continue; }
+            float nearest = INFINITY;
+            for (size_t k = 0; k < count; k++) {
+                nearest = fminf(nearest, bc_distance(BCCubicEvaluate(cubic, output[k].cubicT), crossing));
+            }
+            XCTAssertLessThanOrEqual(nearest, 0.1);
+        }
+    }
+}
+
+static void testLineBatch(void) {
+    const int count = 301;
+    BCCubic cubics[count];
+    BCLine lines[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0,0), 100);
+        lines[i].a = bc_make_float2(BCTestRandom(0,100),BCTestRandom(0,100));
+        lines[i].b = bc_make_float2(BCTestRandom(0,100),BCTestRandom(0,100));
+    }
+    BCLineCubicIntersection output[3 * count];
+    uint32_t indices[3 * count];
+    BCLineCubicIntersection single[3];
+    for (int extent = 0; extent < 2; extent++) {
+        //one line, many cubics
+        size_t total = BCLineIntersectCubics(lines[0], (BCLineExtent) extent, cubics, count, output, indices, 3 * count);
+        size_t expected = 0;
+        for (int i = 0; i < count; i++) {
+            const size_t n = BCLineIntersectCubic(lines[0], (BCLineExtent) extent, cubics[i], single);
+            for (size_t j = 0; j < n && expected + j < total; j++) {
+                XCTAssertEqual(indices[expected + j], i);
+                XCTAssertEqualWithAccuracy(output[expected + j].cubicT, single[j].cubicT, 1e-6);
+                XCTAssertEqualWithAccuracy(output[expected + j].lineT, single[j].lineT, 1e-4);
+            }
+            expected += n;
+        }
+        XCTAssertEqual(total, expected);
+        //many lines, one cubic
+        total = BCLinesIntersectCubic(lines, count, (BCLineExtent) extent, cubics[0], output, indices, 3 * count);
+        expected = 0;
+        for (int i = 0; i < count; i++) {
+            const size_t n = BCLineIntersectCubic(lines[i], (BCLineExtent) extent, cubics[0], single);
+            for (size_t j = 0; j < n && expected + j < total; j++) {
+                XCTAssertEqual(indices[expected + j], i);
+                XCTAssertEqualWithAccuracy(output[expected + j].cubicT, single[j].cubicT, 1e-6);
+                XCTAssertEqualWithAccuracy(output[expected + j].lineT, single[j].lineT, 1e-4);
+            }
+            expected += n;
+        }
+        XCTAssertEqual(total, expected);
+        //capacity only limits what is written
+        XCTAssertEqual(BCLinesIntersectCubic(lines, count, (BCLineExtent) extent, cubics[0], output, indices, 1), total);
+    }
+}
+
+static void testLineBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const int count = 1000000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000)), 10);
+    }
+    BCLineCubicIntersection *output = malloc(sizeof(BCLineCubicIntersection) * 3 * count);
+    uint32_t *indices = malloc(sizeof(uint32_t) * 3 * count);
+    //a ray across the whole scene crosses most cubics' lines, so every cubic is solved
+    const BCLine ray = {bc_make_float2(0, 500), bc_make_float2(1, 501)};
+    BCLineCubicIntersection single[3];
+    double start = BCTestNow();
+    size_t scalar = 0;
+    for (int i = 0; i < count; i++) {
+        scalar += BCLineIntersectCubic(ray, BCLineExtentRay, cubics[i], single);
+    }
+    const double scalarTime = BCTestNow() - start;
+    start = BCTestNow();
+    const size_t batch = BCLineIntersectCubics(ray, BCLineExtentRay, cubics, count, output, indices, 3 * count);
+    const double batchTime = BCTestNow() - start;
+    XCTAssertEqual(scalar, batch);
+    printf("    line-cubic: %.0f hits, %.2f ns/cubic scalar, %.2f ns/cubic batch\n", (double) batch, scalarTime / count * 1e9, batchTime / count * 1e9);
+    free(cubics);
+    free(output);
+    free(indices);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLines", testLines},
+    {"testThreeCrossings", testThreeCrossings},
+    {"testApart", testApart},
+    {"testRandom", testRandom},
+    {"testPairs", testPairs},
+    {"testIntersectionBench", testIntersectionBench},
+    {"testLineCrossings", testLineCrossings},
+    {"testLineRandom", testLineRandom},
+    {"testLineBatch", testLineBatch},
+    {"testLineBench", testLineBench},
+};
+BC_TEST_SUITE(CubicIntersectionTests, tests);
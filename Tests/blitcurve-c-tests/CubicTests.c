@@ -0,0 +1,287 @@
+// CubicTests.c: Cubic tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <math.h>
+#include "BCTestSupport.h"
+
+static void testTangents(void) {
+    //mostly want to make sure we can access these symbols
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(1,1), bc_make_float2(2,2), bc_make_float2(3,3));
+    (void) BCCubicInitialTangentLine(c);
+    (void) BCCubicFinalTangentLine(c);
+    (void) BCCubicInitialTangentAngle(c);
+    (void) BCCubicFinalTangentAngle(c);
+}
+
+static void testEvaluate(void) {
+    BCCubic curve = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    bc_float2_t shouldBeA = BCCubicEvaluate(curve, 0);
+    XCTAssertEqual(shouldBeA.x, curve.a.x);
+    XCTAssertEqual(shouldBeA.y, curve.a.y);
+
+    bc_float2_t shouldBeB = BCCubicEvaluate(curve, 1);
+    XCTAssertEqual(shouldBeB.x, curve.b.x);
+    XCTAssertEqual(shouldBeB.y, curve.b.y);
+}
+
+static void testNormalize(void) {
+    BCCubic curve = CubicMake(bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(0,0), bc_make_float2(100,100));
+    BCCubicNormalize(&curve, 0.001);
+    XCTAssert(bc_distance(curve.a, curve.c) != 0);
+    XCTAssert(bc_distance(curve.b, curve.d) != 0);
+
+    BCCubic curve2 = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(10,0), bc_make_float2(90,0));
+    BCCubicNormalize(&curve2, 15);
+    XCTAssertEqualFloat2(curve2.c, bc_make_float2(15,0));
+    XCTAssertEqualFloat2WithAccuracy(curve2.d, bc_make_float2(85,0), 0.01);
+}
+
+static void testConnectingTangents(void) {
+    BCLine railLine = LineMake(bc_make_float2(510.37002139454205, 343.83395079162915), bc_make_float2(1712.387147298103, 298.4828489580134));
+    const float finalTangent = BCLineTangent(LineMake(bc_make_float2(1712.387147298103, 298.4828489580134), bc_make_float2(1808.2719716869988, 244.57458936905402)));
+    const float initialTangent = BCLineTangent(LineMake(bc_make_float2(376.872572406239, 106.38648819110057), bc_make_float2(510.37002139454205, 343.83395079162915)));
+    BCCubic cube = BCCubicMakeConnectingTangents(railLine, bc_make_float2(initialTangent, finalTangent), bc_make_float2(1,1));
+    XCTAssertEqualWithAccuracy(BCCubicInitialTangentAngle(cube), initialTangent, 0.1);
+    XCTAssertEqualWithAccuracy(BCCubicFinalTangentAngle(cube), finalTangent, 0.1);
+}
+
+static void testConnectingCubics(void) {
+    BCCubic aRail = CubicMake(bc_make_float2(2.6605175, 9.86255), bc_make_float2(0.21252254, 5.5065603), bc_make_float2(1.8522768, 8.424357), bc_make_float2(1.0362785, 6.9723616));
+    BCCubic nextRail = CubicMake(bc_make_float2(4.6373005, 3.1232715), bc_make_float2(7.0850296, 7.478789), bc_make_float2(5.4609714, 4.5889215), bc_make_float2(6.276881, 6.04076));
+    BCCubic c = BCCubicMakeConnectingCubicsWithTangentRule(aRail, nextRail, BCTangentMagnitudeRuleCopied);
+
+    XCTAssertEqualFloat2(aRail.b, c.a);
+    XCTAssertEqualFloat2(nextRail.a, c.b);
+    XCTAssertEqual(BCCubicInitialTangentAngle(c), BCCubicFinalTangentAngle(aRail));
+    //final tangent is reversed nextRail.initialTangent
+    XCTAssertEqualWithAccuracy(BCCubicFinalTangentAngle(c), BCCubicInitialTangentAngle(nextRail), 0.1);
+}
+
+static void testConnectingLines(void) {
+    BCLine a = LineMake(bc_make_float2(0,0), bc_make_float2(10,10));
+    BCLine b = LineMake(bc_make_float2(20,20), bc_make_float2(30,30));
+    BCCubic c = BCCubicMakeConnectingLines(a, b);
+    XCTAssertEqualFloat2(c.a, a.b);
+    XCTAssertEqualFloat2(c.b, b.a);
+    XCTAssertEqual(BCCubicInitialTangentAngle(c), BCLineTangent(a));
+    XCTAssertEqual(BCCubicFinalTangentAngle(c), BCLineTangent(b));
+    XCTAssertEqual(BCCubicInitialTangentMagnitude(c), BCCubicFinalTangentMagnitude(c));
+    XCTAssertEqualWithAccuracy(BCCubicInitialTangentMagnitude(c), 7.07, 0.01);
+}
+
+static void testConnectingCubicToPoint(void) {
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(10,10), bc_make_float2(0,3), bc_make_float2(0,7));
+    BCCubic c2 = BCCubicMakeConnectingCubicToPoint(c, bc_make_float2(10,15), 0, BCTangentMagnitudeRuleCopied);
+    XCTAssertEqualFloat2(c2.a, c.b);
+    XCTAssertEqualFloat2(c2.b, bc_make_float2(10,15));
+    XCTAssertEqual(BCCubicInitialTangentAngle(c2), BCCubicFinalTangentAngle(c));
+    XCTAssertEqual(BCCubicInitialTangentMagnitude(c2), BCCubicFinalTangentMagnitude(c));
+    XCTAssertEqual(BCCubicFinalTangentAngle(c2), 0);
+    XCTAssertEqual(BCCubicFinalTangentMagnitude(c2), 2.5);
+}
+
+static void testLength(void) {
+    BCCubic curve = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    XCTAssertEqualWithAccuracy(BCCubicLength(curve), 272.87, 20);
+}
+
+//reference arclength from a fine polyline in double precision
+static double polylineLength(BCCubic cubic) {
+    const int segments = 20000;
+    double length = 0;
+    double px = cubic.a.x, py = cubic.a.y;
+    for (int i = 1; i <= segments; i++) {
+        const double t = (double) i / segments;
+        const double u = 1 - t;
+        const double x = u*u*u*cubic.a.x + 3*u*u*t*cubic.c.x + 3*u*t*t*cubic.d.x + t*t*t*cubic.b.x;
+        const double y = u*u*u*cubic.a.y + 3*u*u*t*cubic.c.y + 3*u*t*t*cubic.d.y + t*t*t*cubic.b.y;
+        length += sqrt((x-px)*(x-px) + (y-py)*(y-py));
+        px = x;
+        py = y;
+    }
+    return length;
+}
+
+static void testLengthWithStrategy(void) {
+    BCCubic curve = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    XCTAssertEqual(BCCubicLengthWithStrategy(curve, 0.01, BCStrategyFastest), BCCubicLength(curve));
+    XCTAssertEqualWithAccuracy(BCCubicLengthWithStrategy(curve, 0.01, BCStrategyAccurate), polylineLength(curve), 0.02);
+    //straight line
+    BCCubic line = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(66.6667,0), bc_make_float2(100,0));
+    XCTAssertEqualWithAccuracy(BCCubicLengthWithStrategy(line, 0.01, BCStrategyAccurate), 100, 0.02);
+    //cusp at t=0.5, where the fixed estimate does poorly
+    BCCubic cusp = CubicMake(bc_make_float2(0,0), bc_make_float2(0,0), bc_make_float2(100,100), bc_make_float2(-100,100));
+    XCTAssertEqualWithAccuracy(BCCubicLengthWithStrategy(cusp, 0.01, BCStrategyAccurate), polylineLength(cusp), 0.02);
+    for (int i = 0; i < 100; i++) {
+        BCCubic c = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        //plus a little float rounding on the polyline side
+        XCTAssertEqualWithAccuracy(BCCubicLengthWithStrategy(c, 0.01, BCStrategyAccurate), polylineLength(c), 0.02);
+    }
+}
+
+static void testAlignedRect(void) {
+    BCCubic curve = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    BCAlignedRect box = BCAlignedRectCreateFromCubic(curve, BCStrategyFastest);
+    XCTAssertEqualFloat2(box.min, bc_make_float2(35,40));
+    XCTAssertEqualFloat2(box.max, bc_make_float2(220,260));
+}
+
+static void testSplit(void) {
+    BCCubic curve = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    BCCubic2 curves = BCCubicSplit(curve, 0.5);
+    //left is in the low half, right in the high half
+    BCCubic left = CubicMake(curves.a.lo, curves.b.lo, curves.c.lo, curves.d.lo);
+    BCCubic right = CubicMake(curves.a.hi, curves.b.hi, curves.c.hi, curves.d.hi);
+
+    //endpoints
+    XCTAssertEqualFloat2(left.a, curve.a);
+    XCTAssertEqualFloat2(right.b, curve.b);
+
+    XCTAssertEqualFloat2(left.b, bc_make_float2(138.125, 185.0));
+    XCTAssertEqualFloat2(left.c, bc_make_float2(77.5, 130.0));
+    XCTAssertEqualFloat2(left.d, bc_make_float2(102.5, 180.0));
+
+    XCTAssertEqualFloat2(right.a, bc_make_float2(138.125, 185.0));
+    XCTAssertEqualFloat2(right.c, bc_make_float2(173.75, 190.0));
+    XCTAssertEqualFloat2(right.d, bc_make_float2(220.0, 150.0));
+
+    BCCubic leftSplit = BCCubicLeftSplit(curve, 0.5);
+    XCTAssertEqualFloat2(leftSplit.a, left.a);
+    XCTAssertEqualFloat2(leftSplit.b, left.b);
+    XCTAssertEqualFloat2(leftSplit.c, left.c);
+    XCTAssertEqualFloat2(leftSplit.d, left.d);
+
+    BCCubic rightSplit = BCCubicRightSplit(curve, 0.5);
+    XCTAssertEqualFloat2(rightSplit.a, right.a);
+    XCTAssertEqualFloat2(rightSplit.b, right.b);
+    XCTAssertEqualFloat2(rightSplit.c, right.c);
+    XCTAssertEqualFloat2(rightSplit.d, right.d);
+}
+
+//only do this test in release mode
+//this test is slow
+static void testLengthPerformance(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    //generate 100 curves
+    BCCubic curves[100];
+    for (int i = 0; i < 100; i++) {
+        curves[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    const int iterations = 100000;
+    float r = 0;
+    const double start = BCTestNow();
+    for (int i = 0; i < iterations; i++) {
+        for (int c = 0; c < 100; c++) {
+            r += BCCubicLength(curves[c]);
+        }
+    }
+    const double elapsed = BCTestNow() - start;
+    printf("    length: %.2f ns/call (%f)\n", elapsed / (iterations * 100.0) * 1e9, r);
+#endif
+}
+
+static void testLengthAccuratePerformance(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    BCCubic curves[100];
+    for (int i = 0; i < 100; i++) {
+        curves[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    const int iterations = 10000;
+    float r = 0;
+    const double start = BCTestNow();
+    for (int i = 0; i < iterations; i++) {
+        for (int c = 0; c < 100; c++) {
+            r += BCCubicLengthWithStrategy(curves[c], 0.01, BCStrategyAccurate);
+        }
+    }
+    const double elapsed = BCTestNow() - start;
+    printf("    length accurate: %.2f ns/call (%f)\n", elapsed / (iterations * 100.0) * 1e9, r);
+#endif
+}
+
+static void testParameterization(void) {
+    BCCubic cubic = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(66.6667,0), bc_make_float2(100,0));
+    const float parameterization = BCCubicArclengthParameterization(cubic, 50, 0.01);
+    XCTAssertEqualWithAccuracy(parameterization, 0.289, 0.01);
+
+    //due to mt2-99, we want to be allowed to parameterize slightly out of range
+    XCTAssertEqual(BCCubicArclengthParameterization(cubic, BCCubicLength(cubic)+0.5, 0.000000001), 1);
+}
+
+static void testTangent(void) {
+    bc_float2_t a = bc_make_float2(192,341);
+    bc_float2_t nearA = bc_make_float2(193.83,344.26);
+    BCCubic c = CubicMake(a, bc_make_float2(375,667), nearA, nearA);
+    XCTAssert(BCCubicIsNearlyLinear(c, 0.01) != 0);
+    BCCubicNormalize(&c, 6);
+    XCTAssertEqual(BCCubicTangent(c, 0.5), 1.0592812f);
+
+    //here are some tangents we've found to be "bad" with other approaches
+    const float t1 = BCCubicTangent(c, 0.10);
+    const float t2 = BCCubicTangent(c, 0.13);
+    XCTAssertEqualWithAccuracy(t1, t2, 0.1);
+
+    bc_float2_t b = bc_make_float2(375,667);
+    bc_float2_t nearB = bc_make_float2(376,668);
+    BCCubic d = CubicMake(bc_make_float2(192,341), b, nearB, nearB);
+    BCCubicNormalize(&d, 5);
+    const float d1 = BCCubicTangent(d, 0.94);
+    const float d2 = BCCubicTangent(d, 0.95);
+    XCTAssertEqualWithAccuracy(d1, d2, 0.1);
+}
+
+static void testCurvatureError(void) {
+    const float m = BCNormalizationDistanceForCubicCurvatureError(20, 2 * BC_M_PI_F / 360, 0.02);
+    XCTAssertEqualWithAccuracy(m, 2.87, 0.01);
+}
+
+static void testAlignedForCurvature(void) {
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(20,0), bc_make_float2(5,0), bc_make_float2(17,0));
+    XCTAssert(BCCubicIsNormalizedForCurvature(c, 2 * BC_M_PI_F / 360, 0.02) == 1);
+    BCAlignedCubic a = BCAlignedCubicMake(c);
+    XCTAssert(BCAlignedCubicIsNormalizedForCurvature(a, 2 * BC_M_PI_F / 360, 0.02) == 1);
+
+    BCCubic badCubic = CubicMake(bc_make_float2(0,0), bc_make_float2(20,0), bc_make_float2(2,0), bc_make_float2(17,0));
+    XCTAssert(BCCubicIsNormalizedForCurvature(badCubic, 2 * BC_M_PI_F / 360, 0.02) == 0);
+    BCAlignedCubic badA = BCAlignedCubicMake(badCubic);
+    XCTAssert(BCAlignedCubicIsNormalizedForCurvature(badA, 2 * BC_M_PI_F / 360, 0.02) == 0);
+}
+
+static void testLayout(void) {
+    //the portable backend must lay these out the same way as simd.h, so that
+    //buffers can be shared with Swift and Metal
+    _Static_assert(sizeof(bc_float2_t) == 8 && _Alignof(bc_float2_t) == 8, "bc_float2_t layout");
+    _Static_assert(sizeof(bc_float4_t) == 16 && _Alignof(bc_float4_t) == 16, "bc_float4_t layout");
+    _Static_assert(sizeof(BCCubic) == 32, "BCCubic layout");
+    _Static_assert(offsetof(BCCubic, b) == 8 && offsetof(BCCubic, c) == 16 && offsetof(BCCubic, d) == 24, "BCCubic layout");
+    _Static_assert(sizeof(BCRect) == 24, "BCRect layout");
+    _Static_assert(offsetof(BCRect, lengths) == 8 && offsetof(BCRect, angle) == 16, "BCRect layout");
+    _Static_assert(sizeof(BCAlignedRect) == 16, "BCAlignedRect layout");
+    _Static_assert(sizeof(BCCubic2) == 64, "BCCubic2 layout");
+}
+
+static const BCTestCase tests[] = {
+    {"testTangents", testTangents},
+    {"testEvaluate", testEvaluate},
+    {"testNormalize", testNormalize},
+    {"testConnectingTangents", testConnectingTangents},
+    {"testConnectingCubics", testConnectingCubics},
+    {"testConnectingLines", testConnectingLines},
+    {"testConnectingCubicToPoint", testConnectingCubicToPoint},
+    {"testLength", testLength},
+    {"testAlignedRect", testAlignedRect},
+    {"testSplit", testSplit},
+    {"testLengthPerformance", testLengthPerformance},
+    {"testLengthWithStrategy", testLengthWithStrategy},
+    {"testLengthAccuratePerformance", testLengthAccuratePerformance},
+    {"testParametrization", testParameterization},
+    {"testTangent", testTangent},
+    {"testCurvatureError", testCurvatureError},
+    {"testAlignedForCurvature", testAlignedForCurvature},
+    {"testLayout", testLayout},
+};
+BC_TEST_SUITE(CubicTests, tests);
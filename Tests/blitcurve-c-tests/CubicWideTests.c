@@ -0,0 +1,128 @@
+// CubicWideTests.c: BCCubic4 and BCCubic8 tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include "BCTestSupport.h"
+
+static void assertCubicsEqual(BCCubic a, BCCubic b, float accuracy) {
+    XCTAssertEqualFloat2WithAccuracy(a.a, b.a, accuracy);
+    XCTAssertEqualFloat2WithAccuracy(a.b, b.b, accuracy);
+    XCTAssertEqualFloat2WithAccuracy(a.c, b.c, accuracy);
+    XCTAssertEqualFloat2WithAccuracy(a.d, b.d, accuracy);
+}
+
+static void testCubic4(void) {
+    BCCubic cubics[4];
+    bc_float4_t t;
+    for (int i = 0; i < 4; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        t[i] = BCTestRandom(0, 1);
+    }
+    const BCCubic4 c = BCCubic4Pack(cubics);
+    BCCubic unpacked[4];
+    BCCubic4Unpack(c, unpacked);
+
+    const bc_float8_t evaluated = BCCubic4Evaluate(c, t);
+    const bc_float8_t prime = BCCubic4EvaluatePrime(c, t);
+    const bc_float4_t length = BCCubic4Length(c);
+    BCCubic left[4];
+    BCCubic right[4];
+    BCCubic4Unpack(BCCubic4LeftSplit(c, t), left);
+    BCCubic4Unpack(BCCubic4RightSplit(c, t), right);
+    BCAlignedRect rects[4];
+    BCCubic4AlignedRects(c, BCStrategyFastest, rects);
+    BCAlignedRect accurate[4];
+    BCCubic4AlignedRects(c, BCStrategyAccurate, accurate);
+
+    for (int i = 0; i < 4; i++) {
+        assertCubicsEqual(unpacked[i], cubics[i], 0);
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(evaluated[2*i], evaluated[2*i+1]), BCCubicEvaluate(cubics[i], t[i]), 0.001);
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(prime[2*i], prime[2*i+1]), BCCubicEvaluatePrime(cubics[i], t[i]), 0.01);
+        XCTAssertEqualWithAccuracy(length[i], BCCubicLength(cubics[i]), 0.001);
+        assertCubicsEqual(left[i], BCCubicLeftSplit(cubics[i], t[i]), 0.01);
+        assertCubicsEqual(right[i], BCCubicRightSplit(cubics[i], t[i]), 0.01);
+        const BCAlignedRect scalar = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest);
+        XCTAssertEqualFloat2(rects[i].min, scalar.min);
+        XCTAssertEqualFloat2(rects[i].max, scalar.max);
+        const BCAlignedRect scalarAccurate = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyAccurate);
+        XCTAssertEqualFloat2WithAccuracy(accurate[i].min, scalarAccurate.min, 0.001);
+        XCTAssertEqualFloat2WithAccuracy(accurate[i].max, scalarAccurate.max, 0.001);
+    }
+}
+
+static void testCubic8(void) {
+    BCCubic cubics[8];
+    bc_float8_t t;
+    for (int i = 0; i < 8; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        t[i] = BCTestRandom(0, 1);
+    }
+    const BCCubic8 c = BCCubic8Pack(cubics);
+    BCCubic unpacked[8];
+    BCCubic8Unpack(c, unpacked);
+
+    const bc_float16_t evaluated = BCCubic8Evaluate(c, t);
+    const bc_float16_t prime = BCCubic8EvaluatePrime(c, t);
+    const bc_float8_t length = BCCubic8Length(c);
+    BCCubic left[8];
+    BCCubic right[8];
+    BCCubic8Unpack(BCCubic8LeftSplit(c, t), left);
+    BCCubic8Unpack(BCCubic8RightSplit(c, t), right);
+    BCAlignedRect rects[8];
+    BCCubic8AlignedRects(c, BCStrategyFastest, rects);
+    BCAlignedRect accurate[8];
+    BCCubic8AlignedRects(c, BCStrategyAccurate, accurate);
+
+    for (int i = 0; i < 8; i++) {
+        assertCubicsEqual(unpacked[i], cubics[i], 0);
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(evaluated[2*i], evaluated[2*i+1]), BCCubicEvaluate(cubics[i], t[i]), 0.001);
+        XCTAssertEqualFloat2WithAccuracy(bc_make_float2(prime[2*i], prime[2*i+1]), BCCubicEvaluatePrime(cubics[i], t[i]), 0.01);
+        XCTAssertEqualWithAccuracy(length[i], BCCubicLength(cubics[i]), 0.001);
+        assertCubicsEqual(left[i], BCCubicLeftSplit(cubics[i], t[i]), 0.01);
+        assertCubicsEqual(right[i], BCCubicRightSplit(cubics[i], t[i]), 0.01);
+        const BCAlignedRect scalar = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyFastest);
+        XCTAssertEqualFloat2(rects[i].min, scalar.min);
+        XCTAssertEqualFloat2(rects[i].max, scalar.max);
+        const BCAlignedRect scalarAccurate = BCAlignedRectCreateFromCubic(cubics[i], BCStrategyAccurate);
+        XCTAssertEqualFloat2WithAccuracy(accurate[i].min, scalarAccurate.min, 0.001);
+        XCTAssertEqualFloat2WithAccuracy(accurate[i].max, scalarAccurate.max, 0.001);
+    }
+}
+
+static void testLengthBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    const size_t count = 1000000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    BCCubic8 *packed = malloc(sizeof(BCCubic8) * count / 8);
+    for (size_t i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    for (size_t i = 0; i < count / 8; i++) {
+        packed[i] = BCCubic8Pack(cubics + i * 8);
+    }
+    float r = 0;
+    double start = BCTestNow();
+    for (size_t i = 0; i < count; i++) {
+        r += BCCubicLength(cubics[i]);
+    }
+    const double scalar = BCTestNow() - start;
+    bc_float8_t r8 = 0;
+    start = BCTestNow();
+    for (size_t i = 0; i < count / 8; i++) {
+        r8 += BCCubic8Length(packed[i]);
+    }
+    const double wide = BCTestNow() - start;
+    printf("    length: BCCubic %.2f ns/cubic, BCCubic8 %.2f ns/cubic (%f %f)\n", scalar / count * 1e9, wide / count * 1e9, r, r8[0]);
+    free(cubics);
+    free(packed);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testCubic4", testCubic4},
+    {"testCubic8", testCubic8},
+    {"testLengthBench", testLengthBench},
+};
+BC_TEST_SUITE(CubicWideTests, tests);
@@ -0,0 +1,300 @@
+// DistanceFieldTests.c: BCCubicDistanceField and BCCubicStrokeCoverage tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "BCTestSupport.h"
+
+//4 cubics approximating a circle, counterclockwise, or clockwise if reversed
+static void circle(bc_float2_t center, float radius, bool reversed, BCCubic *output) {
+    const float k = 0.5522847498f * radius;
+    const bc_float2_t axes[5] = {bc_make_float2(1,0), bc_make_float2(0,1), bc_make_float2(-1,0), bc_make_float2(0,-1), bc_make_float2(1,0)};
+    for (int i = 0; i < 4; i++) {
+        const bc_float2_t from = center + radius * axes[i];
+        const bc_float2_t to = center + radius * axes[i + 1];
+        BCCubic c = CubicMake(from, to, from + k * axes[i + 1], to + k * axes[i]);
+        if (reversed) {
+            c = CubicMake(c.b, c.a, c.d, c.c);
+        }
+        output[i] = c;
+    }
+}
+
+static bc_float2_t pixelCenter(BCAlignedRect bounds, uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
+    const bc_float2_t size = (bounds.max - bounds.min) / bc_make_float2(width, height);
+    return bounds.min + (bc_make_float2(x, y) + 0.5f) * size;
+}
+
+static void testLine(void) {
+    BCCubic line = CubicMake(bc_make_float2(-10,8.25), bc_make_float2(30,8.25), bc_make_float2(0,8.25), bc_make_float2(20,8.25));
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(20,20));
+    bc_float_t field[20 * 20];
+    XCTAssertTrue(BCCubicDistanceField(&line, 1, bounds, 20, 20, 4, false, 1, field));
+    for (int y = 0; y < 20; y++) {
+        const float expected = fminf(fabsf(y + 0.5f - 8.25f), 4);
+        for (int x = 0; x < 20; x++) {
+            XCTAssertEqualWithAccuracy(field[y * 20 + x], expected, 1e-4);
+        }
+    }
+}
+
+static void testCircle(void) {
+    const bc_float2_t center = bc_make_float2(32.3, 30.7);
+    const float radius = 20;
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(64,64));
+    BCCubic cubics[4];
+    bc_float_t *field = malloc(sizeof(bc_float_t) * 64 * 64);
+    for (int reversed = 0; reversed < 2; reversed++) {
+        circle(center, radius, reversed, cubics);
+        XCTAssertTrue(BCCubicDistanceField(cubics, 4, bounds, 64, 64, 6, true, 0, field));
+        for (uint32_t y = 0; y < 64; y++) {
+            for (uint32_t x = 0; x < 64; x++) {
+                const float exact = bc_distance(pixelCenter(bounds, 64, 64, x, y), center) - radius;
+                const float expected = fmaxf(fminf(exact, 6), -6);
+                //the cubic circle is within 0.00027 radius, and flattening within 1/16 pixel
+                XCTAssertEqualWithAccuracy(field[y * 64 + x], expected, 0.07);
+            }
+        }
+    }
+    free(field);
+}
+
+static void testRandom(void) {
+    const int count = 20;
+    BCCubic cubics[count];
+    for (int i = 0; i < count; i++) {
+        bc_float2_t p[4];
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(-10, 90), BCTestRandom(-10, 90));
+        for (int k = 0; k < 4; k++) {
+            p[k] = origin + bc_make_float2(BCTestRandom(0, 30), BCTestRandom(0, 30));
+        }
+        cubics[i] = CubicMake(p[0], p[1], p[2], p[3]);
+    }
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(100,50));
+    const uint32_t width = 77;
+    const uint32_t height = 41;
+    bc_float_t *field = malloc(sizeof(bc_float_t) * width * height);
+    bc_float_t *threaded = malloc(sizeof(bc_float_t) * width * height);
+    XCTAssertTrue(BCCubicDistanceField(cubics, count, bounds, width, height, 10, false, 1, field));
+    //the reference is much finer polylines
+    const size_t capacity = BCCubicFlattenBatchUpperBound(cubics, count, 0.001);
+    bc_float2_t *points = malloc(sizeof(bc_float2_t) * capacity);
+    size_t offsets[count + 1];
+    BCCubicFlattenBatch(cubics, count, 0.001, points, NULL, capacity, offsets);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const bc_float2_t p = pixelCenter(bounds, width, height, x, y);
+            float expected = 10;
+            for (int i = 0; i < count; i++) {
+                for (size_t k = offsets[i]; k + 1 < offsets[i + 1]; k++) {
+                    const bc_float2_t ab = points[k + 1] - points[k];
+                    const float lengthSquared = bc_dot(ab, ab);
+                    const float h = lengthSquared > 0 ? bc_clamp(bc_dot(p - points[k], ab) / lengthSquared, 0.0f, 1.0f) : 0;
+                    expected = fminf(expected, bc_distance(p, points[k] + h * ab));
+                }
+            }
+            //flattening is within 1/16 of the smaller pixel side, which is 50/41
+            XCTAssertEqualWithAccuracy(field[y * width + x], expected, 0.08);
+        }
+    }
+    free(points);
+    XCTAssertTrue(BCCubicDistanceField(cubics, count, bounds, width, height, 10, false, 4, threaded));
+    XCTAssertTrue(memcmp(field, threaded, sizeof(bc_float_t) * width * height) == 0);
+    //no cubics
+    XCTAssertTrue(BCCubicDistanceField(cubics, 0, bounds, width, height, 10, true, 1, field));
+    XCTAssertEqual(field[0], 10);
+    XCTAssertEqual(field[width * height - 1], 10);
+    free(field);
+    free(threaded);
+}
+
+//a closed polygon of line cubics, counterclockwise, or clockwise if reversed
+static void polygon(const bc_float2_t *points, int count, bool reversed, BCCubic *output) {
+    for (int i = 0; i < count; i++) {
+        const bc_float2_t from = points[i];
+        const bc_float2_t to = points[(i + 1) % count];
+        BCCubic c = CubicMake(from, to, from + (to - from) / 3, from + 2 * (to - from) / 3);
+        if (reversed) {
+            c = CubicMake(c.b, c.a, c.d, c.c);
+        }
+        output[i] = c;
+    }
+}
+
+//signed distance to an axis-aligned square, in coordinates relative to its center
+static float squareDistance(bc_float2_t p, float half) {
+    const bc_float2_t q = bc_make_float2(fabsf(p.x) - half, fabsf(p.y) - half);
+    const float outside = bc_length(bc_make_float2(fmaxf(q.x, 0), fmaxf(q.y, 0)));
+    return outside + fminf(fmaxf(q.x, q.y), 0);
+}
+
+static void testVertexOnPixelCenter(void) {
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(8,8));
+    const bc_float2_t square[4] = {bc_make_float2(2.5,2.5), bc_make_float2(5.5,2.5), bc_make_float2(5.5,5.5), bc_make_float2(2.5,5.5)};
+    //a diamond has a vertex where the contour turns back on each row it starts or ends on
+    const bc_float2_t diamond[4] = {bc_make_float2(4.5,1.5), bc_make_float2(7.5,4.5), bc_make_float2(4.5,7.5), bc_make_float2(1.5,4.5)};
+    BCCubic cubics[4];
+    bc_float_t field[8 * 8];
+    for (int reversed = 0; reversed < 2; reversed++) {
+        polygon(square, 4, reversed, cubics);
+        XCTAssertTrue(BCCubicDistanceField(cubics, 4, bounds, 8, 8, 4, true, 1, field));
+        for (uint32_t y = 0; y < 8; y++) {
+            for (uint32_t x = 0; x < 8; x++) {
+                const float expected = squareDistance(pixelCenter(bounds, 8, 8, x, y) - 4, 1.5);
+                XCTAssertEqualWithAccuracy(field[y * 8 + x], expected, 1e-4);
+            }
+        }
+        //rows through the vertexes are outside to the right
+        XCTAssertEqual(field[2 * 8 + 6], 1);
+        XCTAssertEqual(field[2 * 8 + 7], 2);
+        XCTAssertEqual(field[5 * 8 + 6], 1);
+        XCTAssertEqual(field[5 * 8 + 7], 2);
+
+        polygon(diamond, 4, reversed, cubics);
+        XCTAssertTrue(BCCubicDistanceField(cubics, 4, bounds, 8, 8, 4, true, 1, field));
+        for (uint32_t y = 0; y < 8; y++) {
+            for (uint32_t x = 0; x < 8; x++) {
+                const bc_float2_t p = pixelCenter(bounds, 8, 8, x, y) - 4.5f;
+                const bc_float2_t rotated = bc_make_float2(p.x + p.y, p.x - p.y) / sqrtf(2);
+                const float expected = squareDistance(rotated, 3 / sqrtf(2));
+                XCTAssertEqualWithAccuracy(field[y * 8 + x], fminf(expected, 4), 1e-4);
+            }
+        }
+    }
+}
+
+static void testStrokeLine(void) {
+    BCCubic line = CubicMake(bc_make_float2(-10,8.25), bc_make_float2(30,8.25), bc_make_float2(0,8.25), bc_make_float2(20,8.25));
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(20,20));
+    bc_float_t coverage[20 * 20];
+    XCTAssertTrue(BCCubicStrokeCoverage(&line, 1, 2, bounds, 20, 20, BCCoverageFormatFloat, 1, coverage));
+    for (int y = 0; y < 20; y++) {
+        const float expected = fmaxf(fminf(1.5f - fabsf(y + 0.5f - 8.25f), 1), 0);
+        for (int x = 0; x < 20; x++) {
+            XCTAssertEqualWithAccuracy(coverage[y * 20 + x], expected, 1e-4);
+        }
+    }
+    //a hairline is a pixel wide, and fainter
+    XCTAssertTrue(BCCubicStrokeCoverage(&line, 1, 0.5, bounds, 20, 20, BCCoverageFormatFloat, 1, coverage));
+    for (int y = 0; y < 20; y++) {
+        const float expected = 0.5f * fmaxf(1 - fabsf(y + 0.5f - 8.25f), 0);
+        XCTAssertEqualWithAccuracy(coverage[y * 20 + 7], expected, 1e-4);
+    }
+}
+
+static void testStrokeRandom(void) {
+    const int count = 20;
+    BCCubic cubics[count];
+    for (int i = 0; i < count; i++) {
+        bc_float2_t p[4];
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(-10, 90), BCTestRandom(-10, 90));
+        for (int k = 0; k < 4; k++) {
+            p[k] = origin + bc_make_float2(BCTestRandom(0, 30), BCTestRandom(0, 30));
+        }
+        cubics[i] = CubicMake(p[0], p[1], p[2], p[3]);
+    }
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(100,50));
+    const uint32_t width = 77;
+    const uint32_t height = 41;
+    const float strokeWidth = 3;
+    bc_float_t *field = malloc(sizeof(bc_float_t) * width * height);
+    bc_float_t *coverage = malloc(sizeof(bc_float_t) * width * height);
+    uint8_t *bytes = malloc(width * height);
+    uint8_t *threaded = malloc(width * height);
+    XCTAssertTrue(BCCubicDistanceField(cubics, count, bounds, width, height, 10, false, 1, field));
+    XCTAssertTrue(BCCubicStrokeCoverage(cubics, count, strokeWidth, bounds, width, height, BCCoverageFormatFloat, 1, coverage));
+    XCTAssertTrue(BCCubicStrokeCoverage(cubics, count, strokeWidth, bounds, width, height, BCCoverageFormatByte, 1, bytes));
+    XCTAssertTrue(BCCubicStrokeCoverage(cubics, count, strokeWidth, bounds, width, height, BCCoverageFormatByte, 4, threaded));
+    //the filter is the larger pixel side
+    const float filter = 100.0f / 77;
+    for (size_t i = 0; i < width * height; i++) {
+        const float expected = fmaxf(fminf((strokeWidth / 2 + filter / 2 - field[i]) / filter, 1), 0);
+        XCTAssertEqualWithAccuracy(coverage[i], expected, 1e-4);
+        XCTAssertEqual(bytes[i], (uint8_t) (coverage[i] * 255 + 0.5f));
+    }
+    XCTAssertTrue(memcmp(bytes, threaded, width * height) == 0);
+    //no cubics
+    XCTAssertTrue(BCCubicStrokeCoverage(cubics, 0, strokeWidth, bounds, width, height, BCCoverageFormatByte, 1, bytes));
+    XCTAssertEqual(bytes[0], 0);
+    XCTAssertEqual(bytes[width * height - 1], 0);
+    free(field);
+    free(coverage);
+    free(bytes);
+    free(threaded);
+}
+
+static void testDistanceFieldBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    //1000 shapes on a 1024x1024 atlas
+    const int shapes = 1000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * shapes * 4);
+    for (int i = 0; i < shapes; i++) {
+        circle(bc_make_float2(BCTestRandom(0, 1024), BCTestRandom(0, 1024)), BCTestRandom(4, 24), i % 2, cubics + 4 * i);
+    }
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(1024,1024));
+    bc_float_t *field = malloc(sizeof(bc_float_t) * 1024 * 1024);
+    double start = BCTestNow();
+    BCCubicDistanceField(cubics, shapes * 4, bounds, 1024, 1024, 8, true, 1, field);
+    const double elapsed = BCTestNow() - start;
+    //brute force: the nearest of 64 samples per cubic, for one row
+    start = BCTestNow();
+    float sum = 0;
+    for (uint32_t x = 0; x < 1024; x++) {
+        const bc_float2_t p = pixelCenter(bounds, 1024, 1024, x, 512);
+        float best = INFINITY;
+        for (int i = 0; i < shapes * 4; i++) {
+            for (int k = 0; k < 64; k++) {
+                best = fminf(best, bc_distance(BCCubicEvaluate(cubics[i], k / 63.0f), p));
+            }
+        }
+        sum += best;
+    }
+    const double bruteForce = (BCTestNow() - start) * 1024;
+    printf("    distance field: %.1f ms for 1024x1024 from %d cubics on 1 thread, brute force ~%.0f ms (%f %f)\n", elapsed * 1e3, shapes * 4, bruteForce * 1e3, field[512 * 1024], sum);
+    free(cubics);
+    free(field);
+#endif
+}
+
+static void testStrokeCoverageBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    //4000 random strokes on a 1024x1024 canvas
+    const int count = 4000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    for (int i = 0; i < count; i++) {
+        const bc_float2_t origin = bc_make_float2(BCTestRandom(0, 1024), BCTestRandom(0, 1024));
+        bc_float2_t p[4];
+        for (int k = 0; k < 4; k++) {
+            p[k] = origin + bc_make_float2(BCTestRandom(-40, 40), BCTestRandom(-40, 40));
+        }
+        cubics[i] = CubicMake(p[0], p[1], p[2], p[3]);
+    }
+    const BCAlignedRect bounds = AlignedRectMake(bc_make_float2(0,0), bc_make_float2(1024,1024));
+    uint8_t *coverage = malloc(1024 * 1024);
+    double start = BCTestNow();
+    BCCubicStrokeCoverage(cubics, count, 2, bounds, 1024, 1024, BCCoverageFormatByte, 1, coverage);
+    const double elapsed = BCTestNow() - start;
+    size_t covered = 0;
+    for (size_t i = 0; i < 1024 * 1024; i++) { covered += coverage[i] != 0; }
+    printf("    stroke coverage: %.1f ms for 1024x1024 from %d cubics on 1 thread, %.0f%% of pixels covered\n", elapsed * 1e3, count, covered * 100.0 / (1024 * 1024));
+    free(cubics);
+    free(coverage);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testCircle", testCircle},
+    {"testRandom", testRandom},
+    {"testVertexOnPixelCenter", testVertexOnPixelCenter},
+    {"testStrokeLine", testStrokeLine},
+    {"testStrokeRandom", testStrokeRandom},
+    {"testDistanceFieldBench", testDistanceFieldBench},
+    {"testStrokeCoverageBench", testStrokeCoverageBench},
+};
+BC_TEST_SUITE(DistanceFieldTests, tests);
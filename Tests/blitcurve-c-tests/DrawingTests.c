@@ -0,0 +1,162 @@
+//DrawingTests.c: Drawing tests
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCTestSupport.h"
+
+static float distanceToSegment(bc_float2_t p, bc_float2_t a, bc_float2_t b) {
+    const bc_float2_t ab = b - a;
+    const float lengthSquared = bc_dot(ab, ab);
+    const float t = lengthSquared > 0 ? bc_clamp(bc_dot(p - a, ab) / lengthSquared, 0.0f, 1.0f) : 0;
+    return bc_distance(p, a + t * ab);
+}
+
+static void testMakeClamped(void) {
+    BCCubic c = BCCubicMakeWithLine(BCLineMakeWithPointAndAngle(bc_make_float2(0,0), 0.2, 10));
+    bc_float2_t v1 = BCCubicVertexMakeClampedParameterization(c, 0, 4, -1, 10, 0.01, 0.1);
+    XCTAssertEqualFloat2(v1, c.a);
+    bc_float2_t v2 = BCCubicVertexMakeClampedParameterization(c, 3, 4, -1, 10, 0.01, 0.1);
+    XCTAssertEqualFloat2(v2, c.b);
+}
+
+static void testParameterRange(void) {
+    BCCubic c = CubicMake(bc_make_float2(120,60), bc_make_float2(220,40), bc_make_float2(35,200), bc_make_float2(220,260));
+    BCCubicParameterRange range = BCCubicParameterRangeMakeClampedParameterization(c, 20, 150, 0.01, 0.1);
+    XCTAssertEqual(range.minT, BCCubicArclengthParameterization(c, 20, 0.01));
+    XCTAssertEqual(range.maxT, BCCubicArclengthParameterization(c, 150, 0.01));
+    for (uint8_t v = 0; v < 64; v++) {
+        XCTAssertEqualFloat2(BCCubicVertexMake(c, v, 64, range), BCCubicVertexMakeClampedParameterization(c, v, 64, 20, 150, 0.01, 0.1));
+    }
+    //range is widened to minimumDelta
+    BCCubicParameterRange narrow = BCCubicParameterRangeMakeClampedParameterization(c, 100, 100, 0.01, 0.1);
+    XCTAssertEqualWithAccuracy(narrow.maxT - narrow.minT, 0.2, 0.0001);
+    for (uint8_t v = 0; v < 8; v++) {
+        XCTAssertEqualFloat2(BCCubicVertexMake(c, v, 8, narrow), BCCubicVertexMakeClampedParameterization(c, v, 8, 100, 100, 0.01, 0.1));
+    }
+}
+
+static void testParameterRangeBatch(void) {
+    //several groups of 8, and a partial group
+    enum { count = 43 };
+    BCCubic cubics[count];
+    bc_float_t starts[count];
+    bc_float_t ends[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        starts[i] = BCTestRandom(-10, 50);
+        ends[i] = starts[i] + BCTestRandom(0, 200);
+    }
+    BCCubicParameterRange output[count];
+    BCCubicParameterRangeMakeClampedParameterizationBatch(cubics, starts, ends, count, 0.01, 0.05, output);
+    for (int i = 0; i < count; i++) {
+        BCCubicParameterRange expected = BCCubicParameterRangeMakeClampedParameterization(cubics[i], starts[i], ends[i], 0.01, 0.05);
+        XCTAssertEqual(output[i].minT, expected.minT);
+        XCTAssertEqual(output[i].maxT, expected.maxT);
+    }
+}
+
+static void testParameterRangeBatchReversed(void) {
+#if BC_CHECK_LEVEL != BC_CHECK_RETURN
+    XCTSkip("Requires BC_CHECK_LEVEL of BC_CHECK_RETURN");
+#else
+    enum { count = 19 };
+    BCCubic cubics[count];
+    bc_float_t starts[count];
+    bc_float_t ends[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        starts[i] = BCTestRandom(10, 50);
+        //every other range is slightly reversed, so widening alone would make it look valid
+        ends[i] = i % 2 ? starts[i] - 0.5f : starts[i] + 20;
+    }
+    BCCubicParameterRange output[count];
+    BCCubicParameterRangeMakeClampedParameterizationBatch(cubics, starts, ends, count, 0.01, 0.1, output);
+    for (int i = 0; i < count; i++) {
+        BCCubicParameterRange expected = BCCubicParameterRangeMakeClampedParameterization(cubics[i], starts[i], ends[i], 0.01, 0.1);
+        XCTAssertEqual(output[i].minT, expected.minT);
+        XCTAssertEqual(output[i].maxT, expected.maxT);
+        if (i % 2) { XCTAssertEqual(output[i].minT, -1 - BCErrorArgRelationship); }
+    }
+#endif
+}
+
+static void testParameterRangeBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    enum { count = 1000, vertexes = 64 };
+    BCCubic cubics[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    bc_float2_t r = 0;
+    double start = BCTestNow();
+    for (int i = 0; i < count; i++) {
+        for (uint8_t v = 0; v < vertexes; v++) {
+            r += BCCubicVertexMakeClampedParameterization(cubics[i], v, vertexes, 10, 60, 0.01, 0.01);
+        }
+    }
+    const double perVertex = BCTestNow() - start;
+    start = BCTestNow();
+    for (int i = 0; i < count; i++) {
+        BCCubicParameterRange range = BCCubicParameterRangeMakeClampedParameterization(cubics[i], 10, 60, 0.01, 0.01);
+        for (uint8_t v = 0; v < vertexes; v++) {
+            r += BCCubicVertexMake(cubics[i], v, vertexes, range);
+        }
+    }
+    const double perInstance = BCTestNow() - start;
+    bc_float_t starts[count];
+    bc_float_t ends[count];
+    for (int i = 0; i < count; i++) {
+        starts[i] = 10;
+        ends[i] = 60;
+    }
+    BCCubicParameterRange ranges[count];
+    start = BCTestNow();
+    BCCubicParameterRangeMakeClampedParameterizationBatch(cubics, starts, ends, count, 0.01, 0.01, ranges);
+    for (int i = 0; i < count; i++) {
+        for (uint8_t v = 0; v < vertexes; v++) {
+            r += BCCubicVertexMake(cubics[i], v, vertexes, ranges[i]);
+        }
+    }
+    const double batch = BCTestNow() - start;
+    printf("    clamped vertexes: per-vertex search %.2f ns/vertex, per-instance range %.2f ns/vertex, batch range %.2f ns/vertex (%f)\n", perVertex / (count * vertexes) * 1e9, perInstance / (count * vertexes) * 1e9, batch / (count * vertexes) * 1e9, r.x);
+#endif
+}
+
+static void testVertexBudget(void) {
+    //straight, even with uneven control points
+    BCCubic line = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(5,0), bc_make_float2(90,0));
+    XCTAssertEqual(BCCubicVertexBudget(line, 10, 0.1, 255), 2);
+    const float tolerances[3] = {1, 0.25, 0.05};
+    for (int c = 0; c < 50; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        const float scale = BCTestRandom(0.1, 4);
+        for (int k = 0; k < 3; k++) {
+            const uint8_t n = BCCubicVertexBudget(cubic, scale, tolerances[k], 255);
+            XCTAssertLessThanOrEqual(2, n);
+            //every point of the cubic between two vertexes is near their segment, on screen
+            for (uint8_t v = 1; v < n; v++) {
+                const bc_float2_t a = BCCubicVertexMake(cubic, v - 1, n, 0, 1);
+                const bc_float2_t b = BCCubicVertexMake(cubic, v, n, 0, 1);
+                for (int j = 1; j < 8; j++) {
+                    const float t = BCVertexToBezierParameter(v - 1, n) + j / 8.0f / (n - 1);
+                    XCTAssertLessThanOrEqual(distanceToSegment(BCCubicEvaluate(cubic, t), a, b) * scale, tolerances[k] * 1.001 + 0.0001);
+                }
+            }
+        }
+        //finer tolerance and larger scale don't use fewer vertexes
+        XCTAssertLessThanOrEqual(BCCubicVertexBudget(cubic, scale, 1, 255), BCCubicVertexBudget(cubic, scale, 0.05, 255));
+        XCTAssertLessThanOrEqual(BCCubicVertexBudget(cubic, scale, 0.25, 255), BCCubicVertexBudget(cubic, scale * 2, 0.25, 255));
+        XCTAssertLessThanOrEqual(BCCubicVertexBudget(cubic, 1000, 0.001, 16), 16);
+    }
+}
+
+static const BCTestCase tests[] = {
+    {"testMakeClamped", testMakeClamped},
+    {"testParameterRange", testParameterRange},
+    {"testParameterRangeBatch", testParameterRangeBatch},
+    {"testParameterRangeBatchReversed", testParameterRangeBatchReversed},
+    {"testParameterRangeBench", testParameterRangeBench},
+    {"testVertexBudget", testVertexBudget},
+};
+BC_TEST_SUITE(DrawingTests, tests);
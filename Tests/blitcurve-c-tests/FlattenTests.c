@@ -0,0 +1,122 @@
+// FlattenTests.c: BCCubicFlatten tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static float distanceToSegment(bc_float2_t p, bc_float2_t a, bc_float2_t b) {
+    const bc_float2_t ab = b - a;
+    const float lengthSquared = bc_dot(ab, ab);
+    const float t = lengthSquared > 0 ? bc_clamp(bc_dot(p - a, ab) / lengthSquared, 0.0f, 1.0f) : 0;
+    return bc_distance(p, a + t * ab);
+}
+
+static void testLine(void) {
+    BCCubic line = CubicMake(bc_make_float2(0,0), bc_make_float2(100,0), bc_make_float2(33,0), bc_make_float2(66,0));
+    bc_float2_t output[8];
+    XCTAssertEqual(BCCubicFlatten(line, 0.1, output, NULL, 8), 2);
+    XCTAssertEqualFloat2(output[0], line.a);
+    XCTAssertEqualFloat2(output[1], line.b);
+    //the bound assumes the worst case for the parameterization
+    XCTAssertLessThanOrEqual(2, BCCubicFlattenUpperBound(line, 0.1));
+}
+
+static void testTolerance(void) {
+    bc_float2_t output[1024];
+    bc_float_t parameters[1024];
+    const float tolerances[3] = {1, 0.1, 0.01};
+    for (int c = 0; c < 50; c++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        for (int k = 0; k < 3; k++) {
+            const size_t count = BCCubicFlatten(cubic, tolerances[k], output, parameters, 1024);
+            XCTAssertLessThanOrEqual(count, BCCubicFlattenUpperBound(cubic, tolerances[k]));
+            XCTAssertEqualFloat2(output[0], cubic.a);
+            XCTAssertEqualFloat2(output[count - 1], cubic.b);
+            XCTAssertEqual(parameters[count - 1], 1);
+            for (size_t i = 1; i < count; i++) {
+                XCTAssertLessThan(parameters[i - 1], parameters[i]);
+                XCTAssertEqualFloat2WithAccuracy(output[i], BCCubicEvaluate(cubic, parameters[i]), 0.001);
+                //every point of the cubic between two vertexes is near their segment
+                for (int j = 1; j < 8; j++) {
+                    const float t = parameters[i - 1] + (parameters[i] - parameters[i - 1]) * j / 8;
+                    XCTAssertLessThanOrEqual(distanceToSegment(BCCubicEvaluate(cubic, t), output[i - 1], output[i]), tolerances[k] * 1.001 + 0.0001);
+                }
+            }
+        }
+    }
+}
+
+static void testCapacity(void) {
+    BCCubic cubic = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    bc_float2_t full[1024];
+    const size_t count = BCCubicFlatten(cubic, 0.01, full, NULL, 1024);
+    bc_float2_t partial[3];
+    XCTAssertEqual(BCCubicFlatten(cubic, 0.01, partial, NULL, 3), count);
+    for (int i = 0; i < 3; i++) {
+        XCTAssertEqualFloat2(partial[i], full[i]);
+    }
+}
+
+static void testBatch(void) {
+    enum { count = 9 };
+    BCCubic cubics[count];
+    for (int c = 0; c < count; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    const size_t bound = BCCubicFlattenBatchUpperBound(cubics, count, 0.1);
+    bc_float2_t *output = malloc(bound * sizeof(bc_float2_t));
+    size_t offsets[count + 1];
+    const size_t total = BCCubicFlattenBatch(cubics, count, 0.1, output, NULL, bound, offsets);
+    XCTAssertLessThanOrEqual(total, bound);
+    XCTAssertEqual(offsets[0], 0);
+    XCTAssertEqual(offsets[count], total);
+    for (int c = 0; c < count; c++) {
+        bc_float2_t scalar[1024];
+        const size_t n = BCCubicFlatten(cubics[c], 0.1, scalar, NULL, 1024);
+        XCTAssertEqual(offsets[c + 1] - offsets[c], n);
+        for (size_t i = 0; i < n; i++) {
+            XCTAssertEqualFloat2(output[offsets[c] + i], scalar[i]);
+        }
+    }
+    free(output);
+}
+
+//compare against the uniform vertex count that guarantees the same error
+static void testFlattenBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Not running benchmark in a debug build");
+#else
+    enum { cubicCount = 1000 };
+    BCCubic cubics[cubicCount];
+    for (int c = 0; c < cubicCount; c++) {
+        cubics[c] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+    }
+    const float tolerance = 0.1;
+    size_t uniform = 0;
+    for (int c = 0; c < cubicCount; c++) {
+        //for n uniform segments the error is at most max|B''| / (8n²)
+        const bc_float2_t d0 = cubics[c].a - 2 * cubics[c].c + cubics[c].d;
+        const bc_float2_t d1 = cubics[c].c - 2 * cubics[c].d + cubics[c].b;
+        const float secondDerivative = 6 * bc_max(bc_length(d0), bc_length(d1));
+        uniform += (size_t) ceilf(sqrtf(secondDerivative / (8 * tolerance))) + 1;
+    }
+    bc_float2_t output[1024];
+    size_t adaptive = 0;
+    const double start = BCTestNow();
+    for (int c = 0; c < cubicCount; c++) {
+        adaptive += BCCubicFlatten(cubics[c], tolerance, output, NULL, 1024);
+    }
+    const double elapsed = BCTestNow() - start;
+    printf("    flatten: %.2f points/cubic adaptive, %.2f points/cubic uniform, %.2f ns/point (%f)\n", (double) adaptive / cubicCount, (double) uniform / cubicCount, elapsed / adaptive * 1e9, output[0].x);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testTolerance", testTolerance},
+    {"testCapacity", testCapacity},
+    {"testBatch", testBatch},
+    {"testFlattenBench", testFlattenBench},
+};
+BC_TEST_SUITE(FlattenTests, tests);
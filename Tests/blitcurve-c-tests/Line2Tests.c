@@ -0,0 +1,18 @@
+// Line2Tests.c: Line2 tests
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCTestSupport.h"
+
+static void testLine(void) {
+    BCLine2 l = BCLine2MakeWithPointAndAngle(bc_make_float4(0,0,0,0), bc_make_float2(BC_M_PI_F/2,BC_M_PI_F/4), bc_make_float2(12,13));
+    XCTAssertEqualFloat4WithAccuracy(l.a, bc_make_float4(0,0,0,0), 0);
+    XCTAssert(BCIsNearlyEqual2(l.b.lo, bc_make_float2(0,12)));
+
+    const float side = sqrtf(13*13/2.0);
+    XCTAssert(BCIsNearlyEqual2(l.b.hi, bc_make_float2(side, side)));
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+};
+BC_TEST_SUITE(Line2Tests, tests);
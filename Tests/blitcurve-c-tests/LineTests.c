@@ -0,0 +1,69 @@
+// LineTests.c: Line tests
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCTestSupport.h"
+
+static void testLine(void) {
+    BCLine l = BCLineMakeWithPointAndAngle(bc_make_float2(0,0), BC_M_PI_F / 2, 12);
+    XCTAssertEqualFloat2(l.a, bc_make_float2(0,0));
+    XCTAssert(BCIsNearlyEqual2(l.b, bc_make_float2(0,12)));
+
+    BCLine l2 = BCLineMakeWithPointAndAngle(bc_make_float2(0,0), BC_M_PI_F / 4, 12);
+    XCTAssertEqualFloat2(l2.a, bc_make_float2(0,0));
+    const float side = sqrtf(12*12/2);
+    XCTAssert(BCIsNearlyEqual2(l2.b, bc_make_float2(side, side)));
+}
+
+static void testSlope(void) {
+    BCLine l2 = BCLineMakeWithPointAndAngle(bc_make_float2(0,0), BC_M_PI_F / 4, 12);
+    XCTAssert(BCIsNearlyEqual(BCLineSlope(l2), 1));
+}
+
+static void testYIntercept(void) {
+    BCLine l2 = BCLineMakeWithPointAndAngle(bc_make_float2(0,0), BC_M_PI_F / 4, 12);
+    XCTAssertEqual(BCLineYIntercept(l2), 0);
+}
+
+static void testLength(void) {
+    BCLine l2 = LineMake(bc_make_float2(0,0), bc_make_float2(3,3));
+    XCTAssert(BCIsNearlyEqual(BCLineLength(l2), 4.24264));
+
+    BCLine l0 = LineMake(bc_make_float2(0,0), bc_make_float2(0,0));
+    XCTAssertEqual(BCLineLength(l0), 0);
+}
+
+static void testTangent(void) {
+    BCLine l2 = LineMake(bc_make_float2(0,0), bc_make_float2(3,3));
+    XCTAssert(BCIsNearlyEqual(BCLineTangent(l2), BC_M_PI_F / 4));
+}
+
+static void testEvaluate(void) {
+    BCLine l = LineMake(bc_make_float2(0,0), bc_make_float2(100,100));
+    XCTAssertEqualFloat2(BCLineEvaluate(l, 0), l.a);
+    XCTAssertEqualFloat2(BCLineEvaluate(l, 1), l.b);
+    XCTAssertEqualFloat2(BCLineEvaluate(l, 0.5), bc_make_float2(50,50));
+
+    //try a line with 0-length
+    BCLine l0 = LineMake(bc_make_float2(0,0), bc_make_float2(0,0));
+    XCTAssertEqualFloat2(BCLineEvaluate(l0, 0), bc_make_float2(0,0));
+    XCTAssertEqualFloat2(BCLineEvaluate(l0, 1), bc_make_float2(0,0));
+    XCTAssertEqualFloat2(BCLineEvaluate(l0, 0.5), bc_make_float2(0,0));
+}
+
+static void testArcLengthParameterization(void) {
+    BCLine l = LineMake(bc_make_float2(0,0), bc_make_float2(100,100));
+    XCTAssertEqual(BCLineArclengthParameterization(l, 0), 0);
+    XCTAssertEqual(1, BCLineArclengthParameterization(l, BCLineLength(l)));
+    XCTAssertEqualWithAccuracy(0.5, BCLineArclengthParameterization(l, 70.71067), 0.1);
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testSlope", testSlope},
+    {"testYIntercept", testYIntercept},
+    {"testLength", testLength},
+    {"testTangent", testTangent},
+    {"testEvaluate", testEvaluate},
+    {"testArcLengthParametrization", testArcLengthParameterization},
+};
+BC_TEST_SUITE(LineTests, tests);
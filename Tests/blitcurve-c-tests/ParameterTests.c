@@ -0,0 +1,26 @@
+// ParameterTests.c: Tests for BCBezierParameter
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCTestSupport.h"
+
+static void testVertexID(void) {
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)0, 5), 0);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)1, 5), 0.25);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)2, 5), 0.5);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)3, 5), 0.75);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)4, 5), 1);
+}
+
+static void testVertexIDBounds(void) {
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)0, 5, 0.5, 3.0), 0.5);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)1, 5, 0.5, 3.0), 1.125);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)2, 5, 0.5, 3.0), 1.75);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)3, 5, 0.5, 3.0), 2.375);
+    XCTAssertEqual(BCVertexToBezierParameter((uint16_t)4, 5, 0.5, 3.0), 3);
+}
+
+static const BCTestCase tests[] = {
+    {"testVertexID", testVertexID},
+    {"testVertexIDBounds", testVertexIDBounds},
+};
+BC_TEST_SUITE(ParameterTests, tests);
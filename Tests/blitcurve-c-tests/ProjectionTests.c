@@ -0,0 +1,166 @@
+// ProjectionTests.c: BCCubicProject tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+//distance to the nearest of many samples
+static float denseDistance(BCCubic cubic, bc_float2_t point) {
+    float best = INFINITY;
+    for (int i = 0; i <= 10000; i++) {
+        best = fminf(best, bc_distance(BCCubicEvaluate(cubic, i / 10000.0f), point));
+    }
+    return best;
+}
+
+static void testLine(void) {
+    BCCubic line = CubicMake(bc_make_float2(0,0), bc_make_float2(10,0), bc_make_float2(2,0), bc_make_float2(8,0));
+    BCCubicProjection p = BCCubicProject(line, bc_make_float2(5,3));
+    XCTAssertEqualFloat2WithAccuracy(p.point, bc_make_float2(5,0), 1e-4);
+    XCTAssertEqualWithAccuracy(p.distance, 3, 1e-4);
+    XCTAssertEqualFloat2WithAccuracy(BCCubicEvaluate(line, p.t), p.point, 1e-4);
+    //beyond the ends
+    p = BCCubicProject(line, bc_make_float2(-5,1));
+    XCTAssertEqual(p.t, 0);
+    XCTAssertEqualFloat2WithAccuracy(p.point, line.a, 0);
+    p = BCCubicProject(line, bc_make_float2(12,-1));
+    XCTAssertEqual(p.t, 1);
+    XCTAssertEqualWithAccuracy(p.distance, sqrtf(5), 1e-5);
+}
+
+static void testRandom(void) {
+    for (int trial = 0; trial < 500; trial++) {
+        BCCubic cubic = BCTestRandomCubic(bc_make_float2(0,0), 100);
+        bc_float2_t point = bc_make_float2(BCTestRandom(-20,120), BCTestRandom(-20,120));
+        BCCubicProjection p = BCCubicProject(cubic, point);
+        XCTAssertEqualFloat2WithAccuracy(BCCubicEvaluate(cubic, p.t), p.point, 1e-3);
+        XCTAssertEqualWithAccuracy(bc_distance(p.point, point), p.distance, 1e-3);
+        const float dense = denseDistance(cubic, point);
+        //dense samples are up to ~0.03 apart on these cubics
+        XCTAssertLessThanOrEqual(p.distance, dense + 1e-3);
+        XCTAssertLessThanOrEqual(dense, p.distance + 0.03);
+    }
+}
+
+static void testBatch(void) {
+    BCCubic cubic = BCTestRandomCubic(bc_make_float2(0,0), 100);
+    const int count = 101;
+    bc_float2_t points[count];
+    for (int i = 0; i < count; i++) {
+        points[i] = bc_make_float2(BCTestRandom(-20,120), BCTestRandom(-20,120));
+    }
+    BCCubicProjection output[count];
+    BCCubicProjectPoints(cubic, points, count, output);
+    for (int i = 0; i < count; i++) {
+        BCCubicProjection p = BCCubicProject(cubic, points[i]);
+        XCTAssertEqualWithAccuracy(output[i].t, p.t, 1e-6);
+        XCTAssertEqualWithAccuracy(output[i].distance, p.distance, 1e-4);
+        XCTAssertEqualFloat2WithAccuracy(output[i].point, p.point, 1e-4);
+    }
+}
+
+static void testProjectCubics(void) {
+    const int count = 101;
+    BCCubic cubics[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0,0), 100);
+    }
+    const bc_float2_t point = bc_make_float2(BCTestRandom(-20,120), BCTestRandom(-20,120));
+    BCCubicProjection output[count];
+    BCCubicProjectCubics(cubics, count, point, output);
+    for (int i = 0; i < count; i++) {
+        BCCubicProjection p = BCCubicProject(cubics[i], point);
+        XCTAssertEqualWithAccuracy(output[i].t, p.t, 1e-6);
+        XCTAssertEqualWithAccuracy(output[i].distance, p.distance, 1e-4);
+        XCTAssertEqualFloat2WithAccuracy(output[i].point, p.point, 1e-4);
+    }
+}
+
+static void testNearest(void) {
+    const int count = 200;
+    BCCubic cubics[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 1000), BCTestRandom(0, 1000)), 20);
+    }
+    for (int trial = 0; trial < 100; trial++) {
+        bc_float2_t point = bc_make_float2(BCTestRandom(0,1000), BCTestRandom(0,1000));
+        size_t expected = count;
+        float expectedDistance = INFINITY;
+        for (int i = 0; i < count; i++) {
+            const float d = BCCubicProject(cubics[i], point).distance;
+            if (d < expectedDistance) {
+                expectedDistance = d;
+                expected = i;
+            }
+        }
+        BCCubicProjection p;
+        XCTAssertEqual(BCCubicNearest(cubics, count, point, BC_FLOAT_LARGE, &p), expected);
+        XCTAssertEqual(p.distance, expectedDistance);
+        //limited
+        const size_t limited = BCCubicNearest(cubics, count, point, expectedDistance / 2, &p);
+        XCTAssertEqual(limited, count);
+    }
+    BCCubicProjection p;
+    XCTAssertEqual(BCCubicNearest(cubics, 0, bc_make_float2(0,0), BC_FLOAT_LARGE, &p), 0);
+}
+
+static void testProjectionBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const int count = 100000;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    bc_float2_t *points = malloc(sizeof(bc_float2_t) * count);
+    BCCubicProjection *output = malloc(sizeof(BCCubicProjection) * count);
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(BCTestRandom(0, 10000), BCTestRandom(0, 10000)), 20);
+        points[i] = bc_make_float2(BCTestRandom(0, 10000), BCTestRandom(0, 10000));
+    }
+    //sampling at 256 points, as callers did before
+    double start = BCTestNow();
+    float sampled = 0;
+    for (int i = 0; i < 10000; i++) {
+        float best = INFINITY;
+        for (int k = 0; k < 256; k++) {
+            best = fminf(best, bc_distance(BCCubicEvaluate(cubics[i], k / 255.0f), points[i]));
+        }
+        sampled += best;
+    }
+    const double samplingTime = (BCTestNow() - start) / 10000;
+    start = BCTestNow();
+    float projected = 0;
+    for (int i = 0; i < count; i++) {
+        projected += BCCubicProject(cubics[i], points[i]).distance;
+    }
+    const double projectTime = (BCTestNow() - start) / count;
+    start = BCTestNow();
+    BCCubicProjectPoints(cubics[0], points, count, output);
+    const double batchTime = (BCTestNow() - start) / count;
+    start = BCTestNow();
+    BCCubicProjectCubics(cubics, count, points[0], output);
+    const double cubicsTime = (BCTestNow() - start) / count;
+    //nearest cubic to each of 100 points, with and without early-out
+    start = BCTestNow();
+    size_t found = 0;
+    for (int i = 0; i < 100; i++) {
+        BCCubicProjection p;
+        found += BCCubicNearest(cubics, count, points[i], BC_FLOAT_LARGE, &p);
+    }
+    const double nearestTime = (BCTestNow() - start) / 100;
+    printf("    project: %.1f ns sampling, %.1f ns project, %.1f ns/point batch, %.1f ns/cubic batch, %.2f ms nearest of %d (%f %f %zu)\n", samplingTime * 1e9, projectTime * 1e9, batchTime * 1e9, cubicsTime * 1e9, nearestTime * 1e3, count, sampled, projected, found);
+    free(cubics);
+    free(points);
+    free(output);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testRandom", testRandom},
+    {"testBatch", testBatch},
+    {"testProjectCubics", testProjectCubics},
+    {"testNearest", testNearest},
+    {"testProjectionBench", testProjectionBench},
+};
+BC_TEST_SUITE(ProjectionTests, tests);
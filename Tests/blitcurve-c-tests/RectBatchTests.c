@@ -0,0 +1,81 @@
+// RectBatchTests.c: BCRectBatch tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include "BCTestSupport.h"
+
+static BCRect randomRect(float world) {
+    return RectMake(bc_make_float2(BCTestRandom(0, world), BCTestRandom(0, world)), bc_make_float2(BCTestRandom(0.5, 10), BCTestRandom(0.5, 10)), BCTestRandom(-4, 4));
+}
+
+static void testIntersectsBatch(void) {
+    const size_t count = 1003;
+    BCRect rects[1003];
+    BCPreparedRect prepared[1003];
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(100); }
+    BCPreparedRectMakeBatch(rects, count, prepared);
+    for (size_t i = 0; i < count; i++) {
+        const BCPreparedRect expected = BCPreparedRectMake(rects[i]);
+        XCTAssertEqualFloat4WithAccuracy(prepared[i].points.a_b, expected.points.a_b, 0);
+        XCTAssertEqualFloat2(prepared[i].rotation, expected.rotation);
+    }
+    uint8_t mask[126];
+    for (int r = 0; r < 20; r++) {
+        const BCRect rect = randomRect(100);
+        //1003 is not a multiple of 8, so the last byte is partial
+        const size_t hits = BCPreparedRectIntersectsBatch(BCPreparedRectMake(rect), prepared, count, mask);
+        size_t expectedHits = 0;
+        for (size_t i = 0; i < count; i++) {
+            const bool expected = BCRectIntersects(rect, rects[i]);
+            XCTAssertEqual((mask[i / 8] >> (i % 8)) & 1, expected);
+            expectedHits += expected;
+        }
+        XCTAssertEqual(hits, expectedHits);
+        XCTAssertEqual(mask[125] >> 3, 0);
+    }
+    XCTAssertEqual(BCPreparedRectIntersectsBatch(prepared[0], NULL, 0, NULL), 0);
+}
+
+static void testIntersectsBatchBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const size_t count = 100000;
+    BCRect *rects = malloc(sizeof(BCRect) * count);
+    BCPreparedRect *prepared = malloc(sizeof(BCPreparedRect) * count);
+    uint8_t *mask = malloc((count + 7) / 8);
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(1000); }
+    BCPreparedRectMakeBatch(rects, count, prepared);
+    const int queries = 20;
+    size_t plainHits = 0;
+    double start = BCTestNow();
+    for (int q = 0; q < queries; q++) {
+        for (size_t i = 0; i < count; i++) { plainHits += BCRectIntersects(rects[q], rects[i]); }
+    }
+    const double plain = BCTestNow() - start;
+    size_t preparedHits = 0;
+    start = BCTestNow();
+    for (int q = 0; q < queries; q++) {
+        for (size_t i = 0; i < count; i++) { preparedHits += BCPreparedRectIntersects(prepared[q], prepared[i]); }
+    }
+    const double scalar = BCTestNow() - start;
+    size_t batchHits = 0;
+    start = BCTestNow();
+    for (int q = 0; q < queries; q++) {
+        batchHits += BCPreparedRectIntersectsBatch(prepared[q], prepared, count, mask);
+    }
+    const double batch = BCTestNow() - start;
+    XCTAssertEqual(plainHits, batchHits);
+    const double tests = (double) queries * count;
+    printf("    rect intersects: %.2f ns/test BCRectIntersects, %.2f ns/test prepared, %.2f ns/test prepared batch (%zu, %zu)\n", plain / tests * 1e9, scalar / tests * 1e9, batch / tests * 1e9, preparedHits, batchHits);
+    free(mask);
+    free(prepared);
+    free(rects);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testIntersectsBatch", testIntersectsBatch},
+    {"testIntersectsBatchBench", testIntersectsBatchBench},
+};
+BC_TEST_SUITE(RectBatchTests, tests);
@@ -0,0 +1,153 @@
+// RectBroadPhaseTests.c: BCRectBroadPhase tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+static BCRect randomRect(float world, float size) {
+    return RectMake(bc_make_float2(BCTestRandom(0, world), BCTestRandom(0, world)), bc_make_float2(BCTestRandom(1, size), BCTestRandom(1, size)), BCTestRandom(0, 2 * M_PI));
+}
+
+static int comparePairs(const void *l, const void *r) {
+    const BCRectPair *a = l;
+    const BCRectPair *b = r;
+    if (a->a != b->a) { return a->a < b->a ? -1 : 1; }
+    if (a->b != b->b) { return a->b < b->b ? -1 : 1; }
+    return 0;
+}
+
+static size_t bruteForcePairs(const BCRect *rects, size_t count, BCRectPair *pairs) {
+    size_t found = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        for (uint32_t j = i + 1; j < count; j++) {
+            if (BCRectIntersects(rects[i], rects[j])) {
+                pairs[found].a = i;
+                pairs[found].b = j;
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+static void testPairs(void) {
+    const size_t count = 2000;
+    BCRect *rects = malloc(sizeof(BCRect) * count);
+    for (size_t i = 0; i < count; i++) {
+        //a few large rects span many cells
+        rects[i] = randomRect(1000, i % 100 == 0 ? 300 : 30);
+    }
+    const size_t capacity = 100000;
+    BCRectPair *expected = malloc(sizeof(BCRectPair) * capacity);
+    BCRectPair *pairs = malloc(sizeof(BCRectPair) * capacity);
+    const size_t expectedCount = bruteForcePairs(rects, count, expected);
+    XCTAssertGreaterThan(expectedCount, 100);
+    const float cellSizes[] = {0, 5, 100};
+    const unsigned threads[] = {1, 4, 0};
+    for (int c = 0; c < 3; c++) {
+        for (int t = 0; t < 3; t++) {
+            const size_t found = BCRectIntersectingPairs(rects, count, cellSizes[c], threads[t], pairs, capacity);
+            XCTAssertEqual(found, expectedCount);
+            qsort(pairs, found, sizeof(BCRectPair), comparePairs);
+            for (size_t i = 0; i < found && i < expectedCount; i++) {
+                XCTAssertEqual(pairs[i].a, expected[i].a);
+                XCTAssertEqual(pairs[i].b, expected[i].b);
+            }
+        }
+    }
+    //truncated output still reports every pair
+    XCTAssertEqual(BCRectIntersectingPairs(rects, count, 0, 4, pairs, 10), expectedCount);
+    XCTAssertEqual(BCRectIntersectingPairs(rects, count, 0, 4, NULL, 0), expectedCount);
+    free(pairs);
+    free(expected);
+    free(rects);
+}
+
+static void testFlags(void) {
+    const size_t count = 1500;
+    BCRect *rects = malloc(sizeof(BCRect) * count);
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(1000, 20); }
+    bool *hits = malloc(sizeof(bool) * count);
+    const size_t hitCount = BCRectIntersectingFlags(rects, count, 0, 0, hits);
+    size_t expectedCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool expected = false;
+        for (size_t j = 0; j < count && !expected; j++) {
+            expected = i != j && BCRectIntersects(rects[i], rects[j]);
+        }
+        XCTAssertEqual(hits[i], expected);
+        expectedCount += expected;
+    }
+    XCTAssertEqual(hitCount, expectedCount);
+    XCTAssertGreaterThan(hitCount, 0);
+    free(hits);
+    free(rects);
+}
+
+static void testDegenerate(void) {
+    BCRectPair pairs[4];
+    bool hits[3];
+    XCTAssertEqual(BCRectIntersectingPairs(NULL, 0, 0, 0, pairs, 4), 0);
+    const BCRect one = RectMake(bc_make_float2(0, 0), bc_make_float2(1, 1), 0);
+    XCTAssertEqual(BCRectIntersectingFlags(&one, 1, 0, 0, hits), 0);
+    XCTAssertFalse(hits[0]);
+    //all rects at the same place, so the grid is a single cell
+    const BCRect same[3] = {one, one, one};
+    XCTAssertEqual(BCRectIntersectingPairs(same, 3, 0, 0, pairs, 4), 3);
+    XCTAssertEqual(BCRectIntersectingFlags(same, 3, 0, 0, hits), 3);
+}
+
+static void testNonFinite(void) {
+#if BC_CHECK_LEVEL != BC_CHECK_RETURN
+    XCTSkip("Requires BC_CHECK_LEVEL of BC_CHECK_RETURN");
+#else
+    BCRectPair pairs[4];
+    bool hits[2];
+    //an infinite extent can't be gridded, so this returns rather than growing the cells forever
+    const BCRect rects[2] = {RectMake(bc_make_float2(0, 0), bc_make_float2(1, 1), 0), RectMake(bc_make_float2(INFINITY, 0), bc_make_float2(1, 1), 0)};
+    XCTAssertEqual(BCRectIntersectingPairs(rects, 2, 0, 0, pairs, 4), 0);
+    XCTAssertEqual(BCRectIntersectingFlags(rects, 2, 0, 0, hits), 0);
+#endif
+}
+
+static void testBroadPhaseBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const size_t count = 100000;
+    BCRect *rects = malloc(sizeof(BCRect) * count);
+    //about as dense as the RectIntersect demo
+    for (size_t i = 0; i < count; i++) { rects[i] = randomRect(10000, 30); }
+    bool *hits = malloc(sizeof(bool) * count);
+    double start = BCTestNow();
+    const size_t single = BCRectIntersectingFlags(rects, count, 0, 1, hits);
+    const double singleTime = BCTestNow() - start;
+    start = BCTestNow();
+    const size_t threaded = BCRectIntersectingFlags(rects, count, 0, 0, hits);
+    const double threadedTime = BCTestNow() - start;
+    XCTAssertEqual(single, threaded);
+    //the quadratic loop, on a sample of rects
+    const size_t sample = 200;
+    size_t bruteHits = 0;
+    start = BCTestNow();
+    for (size_t i = 0; i < sample; i++) {
+        for (size_t j = 0; j < count; j++) {
+            bruteHits += i != j && BCRectIntersects(rects[i], rects[j]);
+        }
+    }
+    const double bruteTime = (BCTestNow() - start) / sample * count / 2;
+    printf("    rect broad phase: %zu rects, %.2f ms 1 thread, %.2f ms all threads, ~%.0f ms quadratic (%zu, %zu)\n", count, singleTime * 1e3, threadedTime * 1e3, bruteTime * 1e3, threaded, bruteHits);
+    free(hits);
+    free(rects);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testPairs", testPairs},
+    {"testFlags", testFlags},
+    {"testDegenerate", testDegenerate},
+    {"testNonFinite", testNonFinite},
+    {"testBroadPhaseBench", testBroadPhaseBench},
+};
+BC_TEST_SUITE(RectBroadPhaseTests, tests);
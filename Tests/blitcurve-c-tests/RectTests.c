@@ -0,0 +1,153 @@
+// RectTests.c: Rect tests
+// ©2021 DrewCrawfordApps LLC
+
+#include "BCTestSupport.h"
+
+static void testPointInside(void) {
+    BCRect rect = RectMake(bc_make_float2(25,25), bc_make_float2(50,50), 0);
+    BC3Points points3 = BCRectGet3Points(rect);
+    XCTAssert(BCRectIsPointOnOrInside(points3, bc_make_float2(50,50)));
+    XCTAssert(BCRectIsPointOnOrInside(points3, bc_make_float2(0,0)));
+    XCTAssert(!BCRectIsPointOnOrInside(points3, bc_make_float2(101,90)));
+    XCTAssert(!BCRectIsPointOnOrInside(points3, bc_make_float2(-1,90)));
+}
+
+static void testPoints(void) {
+    //we expect '0' to mean "pointing to the right" here.
+    BCRect rect = RectMake(bc_make_float2(0,0), bc_make_float2(5,10), 0);
+    BC4Points points = BCRectGet4Points(rect);
+    XCTAssertEqualFloat2(points.a_b.lo, bc_make_float2(5,-2.5)); //a
+    XCTAssertEqualFloat2(points.a_b.hi, bc_make_float2(5,2.5)); //b
+    XCTAssertEqualFloat2(points.c_d.lo, bc_make_float2(-5,2.5)); //c
+    XCTAssertEqualFloat2(points.c_d.hi, bc_make_float2(-5,-2.5)); //d
+
+    BC3Points points3 = BCRectGet3Points(rect);
+    XCTAssertEqualFloat2(points3.a_b.lo, bc_make_float2(5,-2.5)); //a
+    XCTAssertEqualFloat2(points3.a_b.hi, bc_make_float2(5,2.5)); //b
+    XCTAssertEqualFloat2(points3.c, bc_make_float2(-5,2.5)); //c
+}
+
+static void testPointsWithRotation(void) {
+    //This test case also checks the rotation, by providing a non-zero angle
+    BCRect r = RectMake(bc_make_float2(58.491684, 109.1976), bc_make_float2(1.675, 3.85), -2.0864184);
+    BC4Points points = BCRectGet4Points(r);
+
+    XCTAssertEqualFloat4WithAccuracy(points.a_b, bc_make_float4(56.8139, 107.93583, 58.271126, 107.109924), 0);
+    XCTAssertEqualFloat4WithAccuracy(points.c_d, bc_make_float4(60.169468, 110.45937, 58.712242, 111.28528), 0);
+
+    BC3Points points3 = BCRectGet3Points(r);
+    XCTAssertEqualFloat4WithAccuracy(points.a_b, points3.a_b, 0);
+    XCTAssertEqualFloat2(points.c_d.lo, points3.c);
+}
+
+static void testIntersection(void) {
+    {
+        BCRect r = RectMake(bc_make_float2(10,10), bc_make_float2(1,1), 0);
+        BCRect r2 = RectMake(bc_make_float2(15,15), bc_make_float2(1,1), 0);
+        XCTAssert(!BCRectIntersects(r, r2));
+    }
+
+    {
+        BCRect ra = RectMake(bc_make_float2(15,15), bc_make_float2(1.675,3.85), 1.05);
+        BCRect rb = RectMake(bc_make_float2(15,15), bc_make_float2(1.675,3.85), 2.619);
+        XCTAssert(BCRectIntersects(ra, rb));
+    }
+
+    {
+        //counterexample we found to previous algorithm
+        BCRect ra1 = RectMake(bc_make_float2(14.661654,14.333334), bc_make_float2(1,1), BC_M_PI_F);
+        BCRect ra2 = RectMake(bc_make_float2(15,15), bc_make_float2(1,1), 0);
+        XCTAssert(BCRectIntersects(ra1, ra2));
+    }
+
+    {
+        //new counterexample
+        BCRect rb1 = RectMake(bc_make_float2(17.517986,16.417912), bc_make_float2(3.094170,1), 0);
+        BCRect rb2 = RectMake(bc_make_float2(15.873606,15.882353), bc_make_float2(1,1), 0);
+        XCTAssert(!BCRectIntersects(rb1, rb2));
+    }
+
+    //new counterexample
+    {
+        BCRect rb1 = RectMake(bc_make_float2(14.6999248,13.713236), bc_make_float2(1,1), 0);
+        BCRect rb2 = RectMake(bc_make_float2(13.686131,13.886792), bc_make_float2(1.045455,0.220588), 0);
+        XCTAssert(!BCRectIntersects(rb1, rb2));
+    }
+
+    //new counterexample
+    {
+        BCRect rb1 = RectMake(bc_make_float2(15.555555,13.509434), bc_make_float2(0.763889,1.869369), 0);
+        BCRect rb2 = RectMake(bc_make_float2(14.617533,14.051095), bc_make_float2(1,1.480582), 0);
+        XCTAssert(BCRectIntersects(rb1, rb2));
+    }
+
+    //new counterexample
+    {
+        BCRect rb1 = RectMake(bc_make_float2(14.456929,13.791821), bc_make_float2(1,1), 0);
+        BCRect rb2 = RectMake(bc_make_float2(15,15), bc_make_float2(1,1), 0);
+        XCTAssert(!BCRectIntersects(rb1, rb2));
+    }
+
+    //new counterexample
+    {
+        BCRect rb1 = RectMake(bc_make_float2(10,10), bc_make_float2(1,1), 0);
+        BCRect rb2 = RectMake(bc_make_float2(10.992657,11.697417), bc_make_float2(2.592592,1), 0.760294);
+        XCTAssert(!BCRectIntersects(rb1, rb2));
+    }
+}
+
+static void testContainsPoint(void) {
+    //should intersect from (x:9.5,y:7.5) to (x:10.5, y:12.5)
+    BCRect r = RectMake(bc_make_float2(10,10), bc_make_float2(5,1), 0);
+
+    XCTAssert(BCRectContainsPoint(r, bc_make_float2(10,10)));
+    XCTAssert(BCRectContainsPoint(r, bc_make_float2(9.6,7.6)));
+    XCTAssert(BCRectContainsPoint(r, bc_make_float2(9.6,12.4)));
+    XCTAssert(BCRectContainsPoint(r, bc_make_float2(10.4,7.6)));
+    XCTAssert(BCRectContainsPoint(r, bc_make_float2(10.4,12.4)));
+
+    //x out of range
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(9.4,7.6)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(9.4,12.4)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(10.6,7.6)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(10.6,12.4)));
+
+    //y out of range
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(9.6,7.4)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(9.6,12.6)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(10.4,7.4)));
+    XCTAssertFalse(BCRectContainsPoint(r, bc_make_float2(10.4,12.6)));
+
+    //rotation test.  If we rotate slightly -, rect should go counterclockwise and capture this
+    BCRect rotated = RectMake(r.center, r.lengths, -0.1);
+    XCTAssert(BCRectContainsPoint(rotated, bc_make_float2(10.6,12.3)));
+}
+
+static void testPreparedIntersection(void) {
+    //the counterexamples from testIntersection
+    const BCRect cases[][2] = {
+        {RectMake(bc_make_float2(10,10), bc_make_float2(1,1), 0), RectMake(bc_make_float2(15,15), bc_make_float2(1,1), 0)},
+        {RectMake(bc_make_float2(15,15), bc_make_float2(1.675,3.85), 1.05), RectMake(bc_make_float2(15,15), bc_make_float2(1.675,3.85), 2.619)},
+        {RectMake(bc_make_float2(14.661654,14.333334), bc_make_float2(1,1), BC_M_PI_F), RectMake(bc_make_float2(15,15), bc_make_float2(1,1), 0)},
+        {RectMake(bc_make_float2(17.517986,16.417912), bc_make_float2(3.094170,1), 0), RectMake(bc_make_float2(15.873606,15.882353), bc_make_float2(1,1), 0)},
+        {RectMake(bc_make_float2(14.6999248,13.713236), bc_make_float2(1,1), 0), RectMake(bc_make_float2(13.686131,13.886792), bc_make_float2(1.045455,0.220588), 0)},
+    };
+    for (int i = 0; i < 5; i++) {
+        XCTAssertEqual(BCPreparedRectIntersects(BCPreparedRectMake(cases[i][0]), BCPreparedRectMake(cases[i][1])), BCRectIntersects(cases[i][0], cases[i][1]));
+    }
+    for (int i = 0; i < 10000; i++) {
+        const BCRect a = RectMake(bc_make_float2(BCTestRandom(0,20),BCTestRandom(0,20)), bc_make_float2(BCTestRandom(0.1,5),BCTestRandom(0.1,5)), BCTestRandom(-4,4));
+        const BCRect b = RectMake(bc_make_float2(BCTestRandom(0,20),BCTestRandom(0,20)), bc_make_float2(BCTestRandom(0.1,5),BCTestRandom(0.1,5)), BCTestRandom(-4,4));
+        XCTAssertEqual(BCPreparedRectIntersects(BCPreparedRectMake(a), BCPreparedRectMake(b)), BCRectIntersects(a, b));
+    }
+}
+
+static const BCTestCase tests[] = {
+    {"testPointInside", testPointInside},
+    {"testPoints", testPoints},
+    {"testPointsWithRotation", testPointsWithRotation},
+    {"testIntersection", testIntersection},
+    {"testContainsPoint", testContainsPoint},
+    {"testPreparedIntersection", testPreparedIntersection},
+};
+BC_TEST_SUITE(RectTests, tests);
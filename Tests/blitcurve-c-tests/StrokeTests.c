@@ -0,0 +1,152 @@
+// StrokeTests.c: BCCubicStrokeBatch tests
+// ©2021 DrewCrawfordApps LLC
+
+#include <stdlib.h>
+#include <math.h>
+#include "BCTestSupport.h"
+
+//the offset by hand, with BCCubicTangent
+static void tangentStroke(BCCubic c, bc_float_t width, uint8_t vertexesPerCubic, bc_float2_t *output) {
+    for (uint8_t v = 0; v < vertexesPerCubic; v++) {
+        const bc_float_t t = BCVertexToBezierParameter(v, vertexesPerCubic);
+        const bc_float2_t p = BCCubicVertexMake(c, v, vertexesPerCubic, 0, 1);
+        const bc_float_t angle = BCCubicTangent(c, t);
+        const bc_float2_t offset = width / 2 * bc_make_float2(-sinf(angle), cosf(angle));
+        output[2 * v] = p + offset;
+        output[2 * v + 1] = p - offset;
+    }
+}
+
+static void testLine(void) {
+    BCCubic line = CubicMake(bc_make_float2(0,5), bc_make_float2(9,5), bc_make_float2(3,5), bc_make_float2(6,5));
+    const bc_float_t width = 2;
+    bc_float2_t output[20];
+    XCTAssertTrue(BCCubicStrokeBatch(&line, &width, 1, 10, 4, output));
+    for (int v = 0; v < 10; v++) {
+        XCTAssertEqualFloat2WithAccuracy(output[2 * v], bc_make_float2(v, 6), 1e-5);
+        XCTAssertEqualFloat2WithAccuracy(output[2 * v + 1], bc_make_float2(v, 4), 1e-5);
+    }
+}
+
+static void testMatchesTangent(void) {
+    const int count = 50;
+    BCCubic cubics[count];
+    bc_float_t widths[count];
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        widths[i] = BCTestRandom(0.5, 10);
+    }
+    //whole groups of 8, and a partial group
+    const uint8_t sizes[3] = {2, 16, 13};
+    for (int s = 0; s < 3; s++) {
+        const uint8_t n = sizes[s];
+        bc_float2_t *output = malloc(sizeof(bc_float2_t) * count * BCCubicStrokeVertexCount(n));
+        XCTAssertTrue(BCCubicStrokeBatch(cubics, widths, count, n, 4, output));
+        bc_float2_t expected[2 * 16];
+        for (int i = 0; i < count; i++) {
+            tangentStroke(cubics[i], widths[i], n, expected);
+            for (size_t v = 0; v < BCCubicStrokeVertexCount(n); v++) {
+                XCTAssertEqualFloat2WithAccuracy(output[i * BCCubicStrokeVertexCount(n) + v], expected[v], 1e-3);
+            }
+        }
+        free(output);
+    }
+}
+
+static void testVanishingDerivative(void) {
+    //c is on a, so the derivative at t=0 is 0, and the direction is toward d
+    BCCubic c = CubicMake(bc_make_float2(0,0), bc_make_float2(10,10), bc_make_float2(0,0), bc_make_float2(10,0));
+    const bc_float_t width = 2;
+    bc_float2_t output[8];
+    XCTAssertTrue(BCCubicStrokeBatch(&c, &width, 1, 4, 4, output));
+    XCTAssertEqualFloat2WithAccuracy(output[0], bc_make_float2(0,1), 1e-6);
+    XCTAssertEqualFloat2WithAccuracy(output[1], bc_make_float2(0,-1), 1e-6);
+    //a point has no offset
+    BCCubic point = CubicMake(bc_make_float2(3,4), bc_make_float2(3,4), bc_make_float2(3,4), bc_make_float2(3,4));
+    XCTAssertTrue(BCCubicStrokeBatch(&point, &width, 1, 4, 4, output));
+    for (int v = 0; v < 8; v++) {
+        XCTAssertEqualFloat2WithAccuracy(output[v], point.a, 1e-5);
+    }
+}
+
+static void testJoin(void) {
+    //a right turn to the left, and a line that doesn't connect
+    BCCubic cubics[3] = {
+        CubicMake(bc_make_float2(0,0), bc_make_float2(10,0), bc_make_float2(3,0), bc_make_float2(6,0)),
+        CubicMake(bc_make_float2(10,0), bc_make_float2(10,10), bc_make_float2(10,3), bc_make_float2(10,6)),
+        CubicMake(bc_make_float2(20,0), bc_make_float2(30,0), bc_make_float2(23,0), bc_make_float2(26,0)),
+    };
+    const bc_float_t widths[3] = {2, 4, 2};
+    bc_float2_t output[3 * 8];
+    XCTAssertTrue(BCCubicStrokeBatch(cubics, widths, 3, 4, 4, output));
+    //both strips end on the diagonal through the corner, each at its own width
+    XCTAssertEqualFloat2WithAccuracy(output[6], bc_make_float2(9,1), 1e-5);
+    XCTAssertEqualFloat2WithAccuracy(output[7], bc_make_float2(11,-1), 1e-5);
+    XCTAssertEqualFloat2WithAccuracy(output[8], bc_make_float2(8,2), 1e-5);
+    XCTAssertEqualFloat2WithAccuracy(output[9], bc_make_float2(12,-2), 1e-5);
+    //unjoined ends are square
+    XCTAssertEqualFloat2WithAccuracy(output[14], bc_make_float2(8,10), 1e-5);
+    XCTAssertEqualFloat2WithAccuracy(output[16], bc_make_float2(20,1), 1e-5);
+    //a limit of 1 clips the miter to the half width
+    XCTAssertTrue(BCCubicStrokeBatch(cubics, widths, 3, 4, 1, output));
+    XCTAssertEqualWithAccuracy(bc_distance(output[6], cubics[0].b), 1, 1e-5);
+    XCTAssertEqualWithAccuracy(bc_distance(output[9], cubics[0].b), 2, 1e-5);
+}
+
+static void testIndexes(void) {
+    uint16_t indexes[18];
+    XCTAssertEqual(BCCubicStrokeIndexes(4, indexes), 18);
+    const uint16_t expected[18] = {0,1,2, 2,1,3, 2,3,4, 4,3,5, 4,5,6, 6,5,7};
+    for (int i = 0; i < 18; i++) {
+        XCTAssertEqual(indexes[i], expected[i]);
+    }
+    //triangles are wound as the strip: counterclockwise for a stroke to the right
+    BCCubic line = CubicMake(bc_make_float2(0,0), bc_make_float2(9,0), bc_make_float2(3,0), bc_make_float2(6,0));
+    const bc_float_t width = 2;
+    bc_float2_t vertexes[8];
+    XCTAssertTrue(BCCubicStrokeBatch(&line, &width, 1, 4, 4, vertexes));
+    for (int i = 0; i < 18; i += 3) {
+        const bc_float2_t u = vertexes[indexes[i + 1]] - vertexes[indexes[i]];
+        const bc_float2_t w = vertexes[indexes[i + 2]] - vertexes[indexes[i]];
+        XCTAssertLessThanOrEqual(0, u.x * w.y - u.y * w.x);
+    }
+}
+
+static void testStrokeBench(void) {
+#ifndef NDEBUG
+    XCTSkip("Benchmark requires release build");
+#else
+    const int count = 100000;
+    const uint8_t n = 32;
+    BCCubic *cubics = malloc(sizeof(BCCubic) * count);
+    bc_float_t *widths = malloc(sizeof(bc_float_t) * count);
+    bc_float2_t *output = malloc(sizeof(bc_float2_t) * count * BCCubicStrokeVertexCount(n));
+    for (int i = 0; i < count; i++) {
+        cubics[i] = BCTestRandomCubic(bc_make_float2(0, 0), 100);
+        widths[i] = BCTestRandom(0.5, 10);
+    }
+    double start = BCTestNow();
+    for (int i = 0; i < count; i++) {
+        tangentStroke(cubics[i], widths[i], n, output + i * BCCubicStrokeVertexCount(n));
+    }
+    const double tangentTime = (BCTestNow() - start) / count / n;
+    const bc_float2_t tangentSample = output[count];
+    start = BCTestNow();
+    BCCubicStrokeBatch(cubics, widths, count, n, 4, output);
+    const double batchTime = (BCTestNow() - start) / count / n;
+    printf("    stroke: %.2f ns/sample with BCCubicTangent, %.2f ns/sample batch (%f %f)\n", tangentTime * 1e9, batchTime * 1e9, tangentSample.x, output[count].x);
+    free(cubics);
+    free(widths);
+    free(output);
+#endif
+}
+
+static const BCTestCase tests[] = {
+    {"testLine", testLine},
+    {"testMatchesTangent", testMatchesTangent},
+    {"testVanishingDerivative", testVanishingDerivative},
+    {"testJoin", testJoin},
+    {"testIndexes", testIndexes},
+    {"testStrokeBench", testStrokeBench},
+};
+BC_TEST_SUITE(StrokeTests, tests);
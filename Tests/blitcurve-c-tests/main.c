@@ -0,0 +1,89 @@
+// main.c: C test runner
+// ©2021 DrewCrawfordApps LLC
+
+/*
+ Usage: blitcurve-c-tests [suite [test]]
+ With no arguments, all suites are run.
+ */
+#include <string.h>
+#include "BCTestSupport.h"
+
+unsigned long __bc_test_failures = 0;
+
+//test manifest, as XCTestManifests.swift
+extern const BCTestSuite AlignedCubicCacheTests;
+extern const BCTestSuite AlignedCubicTests;
+extern const BCTestSuite AlignedRectSweepTests;
+extern const BCTestSuite AlignedRectTests;
+extern const BCTestSuite AlignedRectTreeTests;
+extern const BCTestSuite ArclengthParameterizationTests;
+extern const BCTestSuite ArclengthSamplerTests;
+extern const BCTestSuite ArclengthTableTests;
+extern const BCTestSuite CheckLevelTests;
+extern const BCTestSuite CubicBatchTests;
+extern const BCTestSuite CubicIntersectionTests;
+extern const BCTestSuite CubicTests;
+extern const BCTestSuite CubicWideTests;
+extern const BCTestSuite DistanceFieldTests;
+extern const BCTestSuite DrawingTests;
+extern const BCTestSuite FlattenTests;
+extern const BCTestSuite Line2Tests;
+extern const BCTestSuite LineTests;
+extern const BCTestSuite ParameterTests;
+extern const BCTestSuite ProjectionTests;
+extern const BCTestSuite RectBatchTests;
+extern const BCTestSuite RectBroadPhaseTests;
+extern const BCTestSuite RectTests;
+extern const BCTestSuite StrokeTests;
+
+static const BCTestSuite *allTests[] = {
+    &AlignedCubicCacheTests,
+    &AlignedCubicTests,
+    &AlignedRectSweepTests,
+    &AlignedRectTests,
+    &AlignedRectTreeTests,
+    &ArclengthParameterizationTests,
+    &ArclengthSamplerTests,
+    &ArclengthTableTests,
+    &CheckLevelTests,
+    &CubicBatchTests,
+    &CubicIntersectionTests,
+    &CubicTests,
+    &CubicWideTests,
+    &DistanceFieldTests,
+    &DrawingTests,
+    &FlattenTests,
+    &Line2Tests,
+    &LineTests,
+    &ParameterTests,
+    &ProjectionTests,
+    &RectBatchTests,
+    &RectBroadPhaseTests,
+    &RectTests,
+    &StrokeTests,
+};
+
+int main(int argc, const char *argv[]) {
+    const char *suiteFilter = argc > 1 ? argv[1] : NULL;
+    const char *testFilter = argc > 2 ? argv[2] : NULL;
+    unsigned long ran = 0;
+    for (size_t s = 0; s < sizeof(allTests) / sizeof(allTests[0]); s++) {
+        const BCTestSuite *suite = allTests[s];
+        if (suiteFilter && strcmp(suiteFilter, suite->name) != 0) { continue; }
+        for (size_t t = 0; t < suite->count; t++) {
+            const BCTestCase test = suite->tests[t];
+            if (testFilter && strcmp(testFilter, test.name) != 0) { continue; }
+            const unsigned long failuresBefore = __bc_test_failures;
+            printf("Test Case '%s.%s' started.\n", suite->name, test.name);
+            test.function();
+            printf("Test Case '%s.%s' %s.\n", suite->name, test.name, __bc_test_failures == failuresBefore ? "passed" : "failed");
+            ran++;
+        }
+    }
+    if (ran == 0) {
+        printf("No tests matched.\n");
+        return 1;
+    }
+    printf("Executed %lu tests, with %lu failures\n", ran, __bc_test_failures);
+    return __bc_test_failures == 0 ? 0 : 1;
+}